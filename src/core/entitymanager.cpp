@@ -14,12 +14,14 @@
 #include <QUrl>
 #include <QTextCodec>
 #include "util/util.h"
+#include "util/threads/futures.h"
 #include "interfaces/structures.h"
 #include "interfaces/idownload.h"
 #include "interfaces/ientityhandler.h"
 #include "interfaces/entitytesthandleresult.h"
 #include "interfaces/an/entityfields.h"
 #include "core.h"
+#include "entityresolver.h"
 #include "pluginmanager.h"
 #include "xmlsettingsmanager.h"
 #include "handlerchoicedialog.h"
@@ -35,12 +37,23 @@ namespace LC
 	namespace
 	{
 		template<typename T, typename F>
-		QObjectList GetSubtype (const Entity& e, F&& queryFunc)
+		QObjectList GetSubtype (const Entity& e, EntityCapability::Kind kind, F&& queryFunc)
 		{
 			auto pm = Core::Instance ().GetPluginManager ();
+			const auto& resolver = pm->GetEntityResolver ();
+			const auto& declared = resolver.GetDeclaredPriorities (e, kind);
+			const auto& queried = resolver.GetQueriedPlugins (e, kind);
+
 			QMap<int, QObjectList> result;
 			for (const auto& plugin : pm->GetAllCastableRoots<T> ())
 			{
+				if (resolver.IsDeclaring (plugin) && !queried.contains (plugin))
+				{
+					if (const auto priority = declared.value (plugin); priority > 0)
+						result [priority] << plugin;
+					continue;
+				}
+
 				EntityTestHandleResult r;
 				try
 				{
@@ -83,6 +96,7 @@ namespace LC
 			if (!(e.Parameters_ & TaskParameter::OnlyHandle))
 			{
 				auto sub = GetSubtype<IDownload*> (e,
+						EntityCapability::Kind::Download,
 						[] (const Entity& e, IDownload *dl) { return dl->CouldDownload (e); });
 				removeUnwanted (sub);
 				if (downloaders)
@@ -92,6 +106,7 @@ namespace LC
 			if (!(e.Parameters_ & TaskParameter::OnlyDownload))
 			{
 				auto sub = GetSubtype<IEntityHandler*> (e,
+						EntityCapability::Kind::Handle,
 						[] (const Entity& e, IEntityHandler *eh) { return eh->CouldHandle (e); });
 				removeUnwanted (sub);
 				if (handlers)
@@ -101,6 +116,22 @@ namespace LC
 			return result;
 		}
 
+		/** Resolves the handlers using only the declared capabilities,
+		 * which is safe to do in any thread.
+		 */
+		std::optional<QObjectList> TryGetObjects (QObject *self, const Entity& e)
+		{
+			const auto pm = Core::Instance ().GetPluginManager ();
+			auto resolution = pm->GetEntityResolver ().TryResolve (e);
+			if (!resolution)
+				return {};
+
+			auto result = resolution->Downloaders_ + resolution->Handlers_;
+			if (e.Additional_ [IgnoreSelf].toBool ())
+				result.removeAll (self);
+			return result;
+		}
+
 		bool NoHandlersAvailable (const Entity& e)
 		{
 			if (!(e.Parameters_ & FromUserInitiated) ||
@@ -245,6 +276,10 @@ namespace LC
 
 	bool EntityManager::CouldHandle (const Entity& e)
 	{
+		if (QThread::currentThread () != thread ())
+			if (const auto handlers = TryGetObjects (Plugin_, e))
+				return !handlers->isEmpty ();
+
 		if (const auto res = EnsureUiThread ([=, this] { return CouldHandle (e); }))
 			return *res;
 
@@ -263,6 +298,10 @@ namespace LC
 
 	bool EntityManager::HandleEntity (Entity e, QObject *desired)
 	{
+		if (QThread::currentThread () != thread ())
+			if (const auto res = TryHandleOffThread (e, desired))
+				return *res;
+
 		if (const auto res = EnsureUiThread ([=, this] { return HandleEntity (e, desired); }))
 			return *res;
 
@@ -295,6 +334,20 @@ namespace LC
 		return false;
 	}
 
+	QFuture<bool> EntityManager::HandleEntityAsync (Entity e, QObject *desired)
+	{
+		if (QThread::currentThread () != thread ())
+			if (const auto res = TryHandleOffThread (e, desired))
+				return Util::MakeReadyFuture (*res);
+
+		QFutureInterface<bool> promise;
+		promise.reportStarted ();
+		QMetaObject::invokeMethod (this,
+				[=, this] () mutable { Util::ReportFutureResult (promise, &EntityManager::HandleEntity, this, e, desired); },
+				Qt::QueuedConnection);
+		return promise.future ();
+	}
+
 	QList<QObject*> EntityManager::GetPossibleHandlers (const Entity& e)
 	{
 		const auto pm = Core::Instance ().GetPluginManager ();
@@ -324,6 +377,31 @@ namespace LC
 		return res;
 	}
 
+	std::optional<bool> EntityManager::TryHandleOffThread (const Entity& e, QObject *desired)
+	{
+		if (desired)
+			return {};
+
+		const auto& handlers = TryGetObjects (Plugin_, e);
+		if (!handlers)
+			return {};
+
+		// Both falling back to the external handlers and asking the user
+		// to choose the handler are done in the UI thread.
+		const bool fromUser = e.Parameters_ & FromUserInitiated;
+		if (handlers->isEmpty ())
+			return fromUser ? std::optional<bool> {} : false;
+		if (fromUser && !(e.Parameters_ & AutoAccept))
+			return {};
+
+		// The handlers are known to exist, so the result is known as well,
+		// and there is no need to wait for the UI thread to handle it.
+		QMetaObject::invokeMethod (this,
+				[=, this] { HandleEntity (e, desired); },
+				Qt::QueuedConnection);
+		return true;
+	}
+
 	namespace
 	{
 		constexpr auto AllowedStage = PluginManager::InitStage::BeforeSecond;
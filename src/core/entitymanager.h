@@ -35,12 +35,15 @@ namespace LC
 
 		DelegationResult DelegateEntity (Entity, QObject* = nullptr) override;
 		Q_INVOKABLE bool HandleEntity (LC::Entity, QObject* = nullptr) override;
+		QFuture<bool> HandleEntityAsync (LC::Entity, QObject* = nullptr) override;
 		Q_INVOKABLE bool CouldHandle (const LC::Entity&) override;
 		QList<QObject*> GetPossibleHandlers (const Entity&) override;
 	private:
 		template<typename F>
 		std::optional<bool> EnsureUiThread (F&&);
 
+		std::optional<bool> TryHandleOffThread (const Entity&, QObject*);
+
 		bool CheckInitStage (const Entity&, QObject*, QVector<QueueEntry>&);
 		void RunQueues ();
 	};
@@ -0,0 +1,274 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "entityresolver.h"
+#include <algorithm>
+#include <QUrl>
+#include <QtDebug>
+#include "interfaces/idownload.h"
+#include "interfaces/ientityhandler.h"
+
+namespace LC
+{
+	uint qHash (const EntityResolver::Shape& shape, uint seed)
+	{
+		return ::qHash (shape.Type_, seed) ^
+				::qHash (shape.Mime_, seed) ^
+				::qHash (shape.Scheme_, seed) ^
+				::qHash (shape.Parameters_, seed) ^
+				::qHash (shape.Fields_.join ('\n'), seed);
+	}
+
+	void EntityResolver::Rebuild (const QObjectList& plugins)
+	{
+		QWriteLocker locker { &SnapshotLock_ };
+
+		Capabilities_.clear ();
+		DeclaringPlugins_.clear ();
+		Downloaders_.clear ();
+		Handlers_.clear ();
+		HasUndeclaredDownloaders_ = false;
+		HasUndeclaredHandlers_ = false;
+		RelevantFields_.clear ();
+
+		for (const auto plugin : plugins)
+		{
+			const bool isDownloader = qobject_cast<IDownload*> (plugin);
+			const bool isHandler = qobject_cast<IEntityHandler*> (plugin);
+			if (!isDownloader && !isHandler)
+				continue;
+
+			if (isDownloader)
+				Downloaders_ << plugin;
+			if (isHandler)
+				Handlers_ << plugin;
+
+			const auto ihec = qobject_cast<IHaveEntityCapabilities*> (plugin);
+			if (!ihec)
+			{
+				HasUndeclaredDownloaders_ = HasUndeclaredDownloaders_ || isDownloader;
+				HasUndeclaredHandlers_ = HasUndeclaredHandlers_ || isHandler;
+				continue;
+			}
+
+			DeclaringPlugins_ << plugin;
+			for (const auto& cap : ihec->GetEntityCapabilities ())
+			{
+				Capabilities_.append ({ plugin, cap });
+				for (const auto& field : cap.RequiredFields_)
+					RelevantFields_ << field;
+			}
+		}
+
+		{
+			QMutexLocker cacheLocker { &CacheLock_ };
+			ShapeCache_.clear ();
+		}
+
+		IsReady_ = true;
+
+		qDebug () << Q_FUNC_INFO
+				<< DeclaringPlugins_.size ()
+				<< "plugins declare"
+				<< Capabilities_.size ()
+				<< "capabilities";
+	}
+
+	void EntityResolver::Clear ()
+	{
+		QWriteLocker locker { &SnapshotLock_ };
+
+		IsReady_ = false;
+		Capabilities_.clear ();
+		DeclaringPlugins_.clear ();
+		Downloaders_.clear ();
+		Handlers_.clear ();
+		RelevantFields_.clear ();
+
+		QMutexLocker cacheLocker { &CacheLock_ };
+		ShapeCache_.clear ();
+	}
+
+	bool EntityResolver::IsDeclaring (QObject *plugin) const
+	{
+		QReadLocker locker { &SnapshotLock_ };
+		return DeclaringPlugins_.contains (plugin);
+	}
+
+	QHash<QObject*, int> EntityResolver::GetDeclaredPriorities (const Entity& e, Kind kind) const
+	{
+		QReadLocker locker { &SnapshotLock_ };
+		return GetPriorities (e, kind);
+	}
+
+	QSet<QObject*> EntityResolver::GetQueriedPlugins (const Entity& e, Kind kind) const
+	{
+		QReadLocker locker { &SnapshotLock_ };
+		return GetQueried (e, kind);
+	}
+
+	namespace
+	{
+		QObjectList GetBest (const QObjectList& plugins, const QHash<QObject*, int>& priorities)
+		{
+			if (priorities.isEmpty ())
+				return {};
+
+			const auto best = *std::max_element (priorities.begin (), priorities.end ());
+
+			QObjectList result;
+			for (const auto plugin : plugins)
+				if (priorities.value (plugin) == best)
+					result << plugin;
+			return result;
+		}
+	}
+
+	std::optional<EntityResolution> EntityResolver::TryResolve (const Entity& e) const
+	{
+		QReadLocker locker { &SnapshotLock_ };
+		if (!IsReady_)
+			return {};
+
+		const bool needDownloaders = !(e.Parameters_ & OnlyHandle);
+		const bool needHandlers = !(e.Parameters_ & OnlyDownload);
+		if ((needDownloaders && HasUndeclaredDownloaders_) ||
+				(needHandlers && HasUndeclaredHandlers_))
+			return {};
+
+		if ((needDownloaders && !GetQueried (e, Kind::Download).isEmpty ()) ||
+				(needHandlers && !GetQueried (e, Kind::Handle).isEmpty ()))
+			return {};
+
+		EntityResolution result;
+		if (needDownloaders)
+			result.Downloaders_ = GetBest (Downloaders_, GetPriorities (e, Kind::Download));
+		if (needHandlers)
+			result.Handlers_ = GetBest (Handlers_, GetPriorities (e, Kind::Handle));
+		return result;
+	}
+
+	auto EntityResolver::GetShape (const Entity& e) const -> Shape
+	{
+		const auto type = e.Entity_.userType ();
+
+		QStringList fields;
+		for (auto i = e.Additional_.begin (), end = e.Additional_.end (); i != end; ++i)
+			if (RelevantFields_.contains (i.key ()))
+				fields << i.key ();
+
+		return
+		{
+			type,
+			e.Mime_,
+			type == QMetaType::QUrl ? e.Entity_.toUrl ().scheme () : QString {},
+			static_cast<int> (e.Parameters_),
+			fields
+		};
+	}
+
+	namespace
+	{
+		bool MatchesMime (const QStringList& patterns, const QString& mime)
+		{
+			if (patterns.isEmpty ())
+				return true;
+
+			return std::any_of (patterns.begin (), patterns.end (),
+					[&mime] (const QString& pattern)
+					{
+						return pattern.endsWith ('*') ?
+								mime.startsWith (pattern.chopped (1)) :
+								mime == pattern;
+					});
+		}
+
+		bool Matches (const EntityCapability& cap, int type, const QString& mime,
+				const QString& scheme, TaskParameters params, const QStringList& fields)
+		{
+			if (!MatchesMime (cap.Mimes_, mime))
+				return false;
+
+			if (!cap.Schemes_.isEmpty () &&
+					(type != QMetaType::QUrl || !cap.Schemes_.contains (scheme)))
+				return false;
+
+			if ((params & cap.RequiredParameters_) != cap.RequiredParameters_ ||
+					(params & cap.ForbiddenParameters_))
+				return false;
+
+			return std::all_of (cap.RequiredFields_.begin (), cap.RequiredFields_.end (),
+					[&fields] (const QString& field) { return fields.contains (field); });
+		}
+	}
+
+	QList<int> EntityResolver::GetMatchingCapabilities (const Entity& e) const
+	{
+		const auto& shape = GetShape (e);
+
+		QMutexLocker locker { &CacheLock_ };
+		if (const auto pos = ShapeCache_.find (shape); pos != ShapeCache_.end ())
+			return *pos;
+
+		QList<int> result;
+		for (int i = 0; i < Capabilities_.size (); ++i)
+			if (Matches (Capabilities_.at (i).Cap_,
+					shape.Type_,
+					shape.Mime_,
+					shape.Scheme_,
+					TaskParameters { QFlag { shape.Parameters_ } },
+					shape.Fields_))
+				result << i;
+
+		// The shapes are mostly determined by the MIMEs and additional
+		// fields used by the plugins, so this limit is only reached if
+		// something is wrong with some plugin.
+		constexpr auto MaxCachedShapes = 4096;
+		if (ShapeCache_.size () >= MaxCachedShapes)
+			ShapeCache_.clear ();
+		ShapeCache_ [shape] = result;
+		return result;
+	}
+
+	QHash<QObject*, int> EntityResolver::GetPriorities (const Entity& e, Kind kind) const
+	{
+		QHash<QObject*, int> result;
+		for (const auto idx : GetMatchingCapabilities (e))
+		{
+			const auto& [plugin, cap] = Capabilities_.at (idx);
+			if (cap.Kind_ != kind || cap.NeedsQuery_ || cap.Priority_ <= 0)
+				continue;
+
+			if (cap.Priority_ <= result.value (plugin))
+				continue;
+
+			if (cap.Predicate_ && !cap.Predicate_ (e))
+				continue;
+
+			result [plugin] = cap.Priority_;
+		}
+		return result;
+	}
+
+	QSet<QObject*> EntityResolver::GetQueried (const Entity& e, Kind kind) const
+	{
+		QSet<QObject*> result;
+		for (const auto idx : GetMatchingCapabilities (e))
+		{
+			const auto& [plugin, cap] = Capabilities_.at (idx);
+			if (cap.Kind_ != kind || !cap.NeedsQuery_ || result.contains (plugin))
+				continue;
+
+			if (cap.Predicate_ && !cap.Predicate_ (e))
+				continue;
+
+			result << plugin;
+		}
+		return result;
+	}
+}
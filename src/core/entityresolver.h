@@ -0,0 +1,123 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <optional>
+#include <QHash>
+#include <QMutex>
+#include <QObjectList>
+#include <QReadWriteLock>
+#include <QSet>
+#include "interfaces/ihaveentitycapabilities.h"
+
+namespace LC
+{
+	/** @brief The plugins that could handle an entity.
+	 *
+	 * Both lists only contain the plugins with the highest priority.
+	 */
+	struct EntityResolution
+	{
+		QObjectList Downloaders_;
+		QObjectList Handlers_;
+	};
+
+	/** @brief Evaluates the capabilities declared by the plugins.
+	 *
+	 * The resolver keeps a snapshot of the capabilities declared via
+	 * IHaveEntityCapabilities by the IEntityHandler and IDownload
+	 * plugins, so that they can be evaluated from any thread.
+	 *
+	 * The results of matching the declarative part of the capabilities
+	 * are cached by the shape of the entity: its type, MIME, URL scheme,
+	 * parameters and the additional fields required by any capability.
+	 */
+	class EntityResolver
+	{
+	public:
+		using Kind = EntityCapability::Kind;
+	private:
+		mutable QReadWriteLock SnapshotLock_;
+		bool IsReady_ = false;
+
+		struct DeclaredCapability
+		{
+			QObject *Plugin_;
+			EntityCapability Cap_;
+		};
+		QList<DeclaredCapability> Capabilities_;
+		QSet<QObject*> DeclaringPlugins_;
+		QObjectList Downloaders_;
+		QObjectList Handlers_;
+		bool HasUndeclaredDownloaders_ = false;
+		bool HasUndeclaredHandlers_ = false;
+		QSet<QString> RelevantFields_;
+
+		struct Shape
+		{
+			int Type_;
+			QString Mime_;
+			QString Scheme_;
+			int Parameters_;
+			QStringList Fields_;
+
+			bool operator== (const Shape&) const = default;
+		};
+		friend uint qHash (const Shape&, uint);
+
+		mutable QMutex CacheLock_;
+		mutable QHash<Shape, QList<int>> ShapeCache_;
+	public:
+		/** Refreshes the snapshot of the capabilities from the given
+		 * \em plugins. Should be called in the GUI thread whenever the
+		 * set of the plugins changes.
+		 */
+		void Rebuild (const QObjectList& plugins);
+
+		/** Drops the snapshot, for instance, before the plugins are
+		 * unloaded, since it refers to the plugins' code. TryResolve()
+		 * fails until the next Rebuild().
+		 */
+		void Clear ();
+
+		/** Returns whether the \em plugin has declared its capabilities
+		 * and thus shouldn't be asked via CouldHandle().
+		 */
+		bool IsDeclaring (QObject *plugin) const;
+
+		/** Returns the priorities with which the plugins declaring their
+		 * capabilities could process the entity \em e in the given way.
+		 */
+		QHash<QObject*, int> GetDeclaredPriorities (const Entity& e, Kind) const;
+
+		/** Returns the plugins declaring their capabilities that still
+		 * have to be asked via CouldHandle() or CouldDownload() whether
+		 * they could process the entity \em e in the given way.
+		 *
+		 * @sa EntityCapability::NeedsQuery_
+		 */
+		QSet<QObject*> GetQueriedPlugins (const Entity& e, Kind) const;
+
+		/** Resolves the handlers for the entity \em e using only the
+		 * declared capabilities. Returns an empty optional if some of
+		 * the plugins have to be asked via CouldHandle() or
+		 * CouldDownload() in the GUI thread: either some plugins don't
+		 * declare their capabilities at all, or some of the capabilities
+		 * matching the entity need a query.
+		 *
+		 * This function is thread-safe.
+		 */
+		std::optional<EntityResolution> TryResolve (const Entity& e) const;
+	private:
+		Shape GetShape (const Entity&) const;
+		QList<int> GetMatchingCapabilities (const Entity&) const;
+		QHash<QObject*, int> GetPriorities (const Entity&, Kind) const;
+		QSet<QObject*> GetQueried (const Entity&, Kind) const;
+	};
+}
@@ -0,0 +1,233 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "plugininitscheduler.h"
+#include <algorithm>
+#include <numeric>
+#include <QEventLoop>
+#include <QtConcurrentRun>
+#include <QtDebug>
+#include <util/threads/futures.h>
+#include <interfaces/iinfo.h>
+#include <interfaces/ihavebackgroundinit.h>
+#include "plugintreebuilder.h"
+
+namespace LC
+{
+	namespace
+	{
+		struct BackgroundInitResult
+		{
+			std::optional<QString> Error_;
+			qint64 Msecs_ = 0;
+		};
+
+		BackgroundInitResult RunBackgroundInit (IHaveBackgroundInit *ibi)
+		{
+			QElapsedTimer timer;
+			timer.start ();
+
+			BackgroundInitResult result;
+			try
+			{
+				ibi->BackgroundInit ();
+			}
+			catch (const std::exception& e)
+			{
+				result.Error_ = QString::fromUtf8 (e.what ());
+			}
+			catch (...)
+			{
+				result.Error_ = QString { "unknown exception" };
+			}
+			result.Msecs_ = timer.elapsed ();
+			return result;
+		}
+
+		QString GetName (QObject *plugin)
+		{
+			const auto ii = qobject_cast<IInfo*> (plugin);
+			return ii ? ii->GetName () : plugin->objectName ();
+		}
+
+		const char* GetStageName (PluginInitScheduler::Stage stage)
+		{
+			switch (stage)
+			{
+			case PluginInitScheduler::Stage::Init:
+				return "init";
+			case PluginInitScheduler::Stage::BackgroundInit:
+				return "background init";
+			case PluginInitScheduler::Stage::SecondInit:
+				return "second init";
+			}
+
+			return "unknown stage";
+		}
+	}
+
+	PluginInitScheduler::PluginInitScheduler (const PluginTreeBuilder& builder, QObject *parent)
+	: QObject { parent }
+	, Builder_ { builder }
+	, TraceTimings_ { qgetenv ("LC_TRACE_PLUGININIT") == "1" }
+	{
+		SinceStart_.start ();
+	}
+
+	void PluginInitScheduler::HandleInitialized (QObject *plugin)
+	{
+		if (Nodes_.contains (plugin))
+			return;
+
+		auto& node = Nodes_ [plugin];
+
+		// The plugins are initialized in the dependency order, so all the
+		// dependencies of this plugin are already known here.
+		for (const auto dep : Builder_.GetDependencies (plugin))
+		{
+			if (Done_.contains (dep) || !Nodes_.contains (dep))
+				continue;
+
+			node.PendingDeps_ << dep;
+			Nodes_ [dep].Dependents_ << plugin;
+		}
+
+		if (node.PendingDeps_.isEmpty ())
+			Start (plugin);
+	}
+
+	QObjectList PluginInitScheduler::WaitForBackgroundInits ()
+	{
+		if (Done_.size () < Nodes_.size ())
+		{
+			// The user input is held back until the second stage is
+			// done, but the events posted by the plugins are processed.
+			QEventLoop loop;
+			WaitLoop_ = &loop;
+			loop.exec (QEventLoop::ExcludeUserInputEvents);
+			WaitLoop_ = nullptr;
+		}
+
+		return Failed_ + Skipped_;
+	}
+
+	void PluginInitScheduler::DumpTimings () const
+	{
+		if (!TraceTimings_)
+			return;
+
+		auto plugins = Timings_.keys ();
+		const auto total = [this] (QObject *plugin)
+		{
+			const auto& times = Timings_ [plugin];
+			return std::accumulate (times.begin (), times.end (), qint64 { 0 });
+		};
+		std::sort (plugins.begin (), plugins.end (),
+				[&total] (QObject *left, QObject *right) { return total (left) > total (right); });
+
+		qDebug () << "plugins initialization took" << SinceStart_.elapsed () << "ms; the slowest plugins are:";
+		for (const auto plugin : plugins.mid (0, 15))
+		{
+			const auto& times = Timings_ [plugin];
+			qDebug () << "\t" << GetName (plugin)
+					<< total (plugin) << "ms:"
+					<< times [static_cast<int> (Stage::Init)] << "ms init,"
+					<< times [static_cast<int> (Stage::BackgroundInit)] << "ms background init,"
+					<< times [static_cast<int> (Stage::SecondInit)] << "ms second init";
+		}
+	}
+
+	void PluginInitScheduler::Start (QObject *plugin)
+	{
+		if (Nodes_ [plugin].Skip_)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "skipping"
+					<< plugin
+					<< "since some of its dependencies have failed to initialize";
+			Skipped_ << plugin;
+			MarkDone (plugin, true);
+			return;
+		}
+
+		const auto ibi = qobject_cast<IHaveBackgroundInit*> (plugin);
+		if (!ibi)
+		{
+			MarkDone (plugin, false);
+			return;
+		}
+
+		if (TraceTimings_)
+			qDebug () << "starting background init of" << GetName (plugin);
+
+		Util::Sequence (this, QtConcurrent::run (&Pool_, RunBackgroundInit, ibi)) >>
+				[this, plugin] (const BackgroundInitResult& result)
+				{
+					HandleBackgroundFinished (plugin, result.Error_, result.Msecs_);
+				};
+	}
+
+	void PluginInitScheduler::HandleBackgroundFinished (QObject *plugin, const std::optional<QString>& error, qint64 msecs)
+	{
+		RecordTiming (plugin, Stage::BackgroundInit, msecs);
+
+		if (error)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "while initializing"
+					<< plugin
+					<< "in background got"
+					<< *error;
+			Failed_ << plugin;
+		}
+
+		MarkDone (plugin, error.has_value ());
+	}
+
+	void PluginInitScheduler::MarkDone (QObject *plugin, bool failed)
+	{
+		Done_ << plugin;
+
+		for (const auto dependent : Nodes_ [plugin].Dependents_)
+		{
+			auto& node = Nodes_ [dependent];
+			node.PendingDeps_.removeAll (plugin);
+
+			// The dependents of a failed plugin are dropped from the
+			// initialization along with it.
+			if (failed)
+				node.Skip_ = true;
+
+			if (node.PendingDeps_.isEmpty ())
+				Start (dependent);
+		}
+
+		if (WaitLoop_ && Done_.size () == Nodes_.size ())
+			WaitLoop_->quit ();
+	}
+
+	void PluginInitScheduler::RecordTiming (QObject *plugin, Stage stage, qint64 msecs)
+	{
+		if (!TraceTimings_)
+			return;
+
+		auto pos = Timings_.find (plugin);
+		if (pos == Timings_.end ())
+			pos = Timings_.insert (plugin, { 0, 0, 0 });
+		(*pos) [static_cast<int> (stage)] = msecs;
+
+		qDebug () << GetStageName (stage)
+				<< "of"
+				<< GetName (plugin)
+				<< "took"
+				<< msecs
+				<< "ms, at"
+				<< SinceStart_.elapsed ()
+				<< "ms since start";
+	}
+}
@@ -0,0 +1,116 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <array>
+#include <optional>
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <util/sll/util.h>
+
+class QEventLoop;
+
+namespace LC
+{
+	class PluginTreeBuilder;
+
+	/** @brief Runs the background initialization of the plugins.
+	 *
+	 * The plugins are passed to HandleInitialized() once their
+	 * IInfo::Init() succeeds. The IHaveBackgroundInit::BackgroundInit()
+	 * of a plugin is then run in a thread pool as soon as the background
+	 * initialization of all the plugins it depends on is done, while the
+	 * GUI thread proceeds with initializing the rest of the plugins.
+	 *
+	 * If the LC_TRACE_PLUGININIT environment variable is set to 1, the
+	 * time taken by each initialization stage of each plugin is logged,
+	 * along with the slowest plugins once the initialization is done.
+	 */
+	class PluginInitScheduler : public QObject
+	{
+	public:
+		enum class Stage
+		{
+			Init,
+			BackgroundInit,
+			SecondInit
+		};
+	private:
+		const PluginTreeBuilder& Builder_;
+		const bool TraceTimings_;
+
+		QThreadPool Pool_;
+
+		struct Node
+		{
+			QObjectList PendingDeps_;
+			QObjectList Dependents_;
+			bool Skip_ = false;
+		};
+		QHash<QObject*, Node> Nodes_;
+		QSet<QObject*> Done_;
+		QObjectList Failed_;
+		QObjectList Skipped_;
+
+		QEventLoop *WaitLoop_ = nullptr;
+
+		QHash<QObject*, std::array<qint64, 3>> Timings_;
+		QElapsedTimer SinceStart_;
+	public:
+		explicit PluginInitScheduler (const PluginTreeBuilder&, QObject* = nullptr);
+
+		/** Runs \em f, recording the time it took as the time of the
+		 * given \em stage of the \em plugin if tracing is enabled.
+		 */
+		template<typename F>
+		void Measure (QObject *plugin, Stage stage, F&& f)
+		{
+			if (!TraceTimings_)
+			{
+				f ();
+				return;
+			}
+
+			QElapsedTimer timer;
+			timer.start ();
+			const auto guard = Util::MakeScopeGuard ([&] { RecordTiming (plugin, stage, timer.elapsed ()); });
+			f ();
+		}
+
+		/** Schedules the background initialization of the \em plugin
+		 * whose IInfo::Init() has just succeeded.
+		 */
+		void HandleInitialized (QObject *plugin);
+
+		/** Processes the events until all the scheduled background
+		 * initializations finish and returns the plugins that have
+		 * failed to initialize along with the plugins that have been
+		 * skipped since they depend on the failed ones.
+		 *
+		 * IInfo::Init() of all the returned plugins has succeeded, so
+		 * they still need to be released.
+		 *
+		 * The user input events are excluded while waiting, but the
+		 * queued calls, timers and other events posted by the plugins
+		 * are processed.
+		 */
+		QObjectList WaitForBackgroundInits ();
+
+		void DumpTimings () const;
+	private:
+		void Start (QObject*);
+		void HandleBackgroundFinished (QObject*, const std::optional<QString>& error, qint64 msecs);
+		void MarkDone (QObject*, bool failed);
+
+		void RecordTiming (QObject*, Stage, qint64);
+	};
+}
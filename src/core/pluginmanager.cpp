@@ -35,12 +35,15 @@
 #include <interfaces/ipluginadaptor.h>
 #include <interfaces/ihaveshortcuts.h>
 #include <interfaces/ishutdownlistener.h>
+#include <interfaces/ihavebackgroundinit.h>
 #include "core.h"
 #include "pluginmanager.h"
 #include "mainwindow.h"
 #include "xmlsettingsmanager.h"
 #include "coreproxy.h"
 #include "plugintreebuilder.h"
+#include "plugininitscheduler.h"
+#include "entityresolver.h"
 #include "config.h"
 #include "coreinstanceobject.h"
 #include "shortcutmanager.h"
@@ -62,6 +65,7 @@ namespace LC
 	: QAbstractItemModel (parent)
 	, DBusMode_ (static_cast<Application*> (qApp)->GetParsedArguments ().Multiprocess_)
 	, PluginTreeBuilder_ (new PluginTreeBuilder)
+	, EntityResolver_ (new EntityResolver)
 	{
 		Headers_ << tr ("Name")
 			<< tr ("Description");
@@ -377,7 +381,7 @@ namespace LC
 		}
 	};
 
-	QObject* PluginManager::TryFirstInit (QObjectList ordered, PluginLoadProcess *proc)
+	QObject* PluginManager::TryFirstInit (QObjectList ordered, PluginLoadProcess *proc, PluginInitScheduler& scheduler)
 	{
 		QSettings settings (QCoreApplication::organizationName (),
 				QCoreApplication::applicationName () + "-pg");
@@ -391,7 +395,8 @@ namespace LC
 			try
 			{
 				qDebug () << "Initializing" << ii->GetName ();
-				ii->Init (ii->GetProxy ());
+				scheduler.Measure (obj, PluginInitScheduler::Stage::Init, [ii] { ii->Init (ii->GetProxy ()); });
+				scheduler.HandleInitialized (obj);
 
 				const auto& path = GetPluginLibraryPath (obj);
 				if (path.isEmpty ())
@@ -474,7 +479,40 @@ namespace LC
 		const auto sndInitProc = std::make_shared<PluginLoadProcess> (tr ("Plugins initialization: second stage..."),
 					ordered.size ());
 
-		const auto& failed = FirstInitAll (fstInitProc.get ());
+		PluginInitScheduler scheduler { *PluginTreeBuilder_ };
+		auto failed = FirstInitAll (fstInitProc.get (), scheduler);
+
+		const auto& failedInBackground = scheduler.WaitForBackgroundInits ();
+		if (!failedInBackground.isEmpty ())
+		{
+			CacheValid_ = false;
+
+			auto dropped = PluginTreeBuilder_->GetResult ();
+			for (const auto obj : failedInBackground)
+				PluginTreeBuilder_->RemoveObject (obj);
+			PluginTreeBuilder_->Calculate ();
+
+			const auto& remaining = PluginTreeBuilder_->GetResult ();
+			dropped.erase (std::remove_if (dropped.begin (), dropped.end (),
+						[&remaining] (QObject *obj) { return remaining.contains (obj); }),
+					dropped.end ());
+
+			// All the dropped plugins have been initialized by now, so
+			// they are released in the reverse order, dependents first.
+			std::for_each (dropped.rbegin (), dropped.rend (),
+					[this] (QObject *obj)
+					{
+						try
+						{
+							ReleasePlugin (obj);
+						}
+						catch (const std::exception&)
+						{
+							// Already logged by ReleasePlugin().
+						}
+					});
+			failed << dropped;
+		}
 
 		SetInitStage (InitStage::BeforeSecond);
 
@@ -505,7 +543,7 @@ namespace LC
 			try
 			{
 				qDebug () << "second init" << ii->GetName ();
-				ii->SecondInit ();
+				scheduler.Measure (obj, PluginInitScheduler::Stage::SecondInit, [ii] { ii->SecondInit (); });
 			}
 			catch (const std::exception& e)
 			{
@@ -525,11 +563,15 @@ namespace LC
 
 		SetInitStage (InitStage::Complete);
 
+		scheduler.DumpTimings ();
+
 		TryUnload (failed);
 	}
 
 	void PluginManager::Release ()
 	{
+		EntityResolver_->Clear ();
+
 		auto ordered = PluginTreeBuilder_->GetResult ();
 		std::reverse (ordered.begin (), ordered.end ());
 
@@ -660,6 +702,8 @@ namespace LC
 		try
 		{
 			qobject_cast<IInfo*> (object)->Init (CoreProxy::UnsafeWithoutDeps ());
+			if (const auto ibi = qobject_cast<IHaveBackgroundInit*> (object))
+				ibi->BackgroundInit ();
 			qobject_cast<IInfo*> (object)->SecondInit ();
 			Core::Instance ().PostSecondInit (object);
 
@@ -690,11 +734,21 @@ namespace LC
 			throw;
 		}
 
+		EntityResolver_->Rebuild (GetAllPlugins ());
+
 		emit pluginInjected (object);
 	}
 
 	void PluginManager::ReleasePlugin (QObject *object)
 	{
+		// The capabilities of the plugin might refer to its code.
+		if (InitStage_ >= InitStage::BeforeSecond)
+		{
+			auto plugins = GetAllPlugins ();
+			plugins.removeAll (object);
+			EntityResolver_->Rebuild (plugins);
+		}
+
 		try
 		{
 			qDebug () << "Releasing"
@@ -773,12 +827,21 @@ namespace LC
 		return InitStage_;
 	}
 
+	EntityResolver& PluginManager::GetEntityResolver () const
+	{
+		return *EntityResolver_;
+	}
+
 	void PluginManager::SetInitStage (PluginManager::InitStage stage)
 	{
 		if (InitStage_ == stage)
 			return;
 
 		InitStage_ = stage;
+
+		if (stage >= InitStage::BeforeSecond)
+			EntityResolver_->Rebuild (GetAllPlugins ());
+
 		emit initStageChanged (stage);
 	}
 
@@ -1145,14 +1208,14 @@ namespace LC
 		}
 	}
 
-	QObjectList PluginManager::FirstInitAll (PluginLoadProcess *proc)
+	QObjectList PluginManager::FirstInitAll (PluginLoadProcess *proc, PluginInitScheduler& scheduler)
 	{
 		QObjectList ordered = PluginTreeBuilder_->GetResult ();
 		QObjectList initialized;
 		QObjectList failedList;
 
 		QObject *failed = 0;
-		while ((failed = TryFirstInit (ordered, proc)))
+		while ((failed = TryFirstInit (ordered, proc, scheduler)))
 		{
 			CacheValid_ = false;
 
@@ -23,6 +23,8 @@ namespace LC
 {
 	class MainWindow;
 	class PluginTreeBuilder;
+	class PluginInitScheduler;
+	class EntityResolver;
 
 	class PluginManager : public QAbstractItemModel
 						, public IPluginsManager
@@ -50,6 +52,7 @@ namespace LC
 		mutable QMap<QByteArray, QObject*> PluginID2PluginCache_;
 
 		std::shared_ptr<PluginTreeBuilder> PluginTreeBuilder_;
+		std::shared_ptr<EntityResolver> EntityResolver_;
 
 		mutable bool CacheValid_ = false;
 		mutable QObjectList SortedCache_;
@@ -117,6 +120,11 @@ namespace LC
 		const QStringList& GetPluginLoadErrors () const;
 
 		InitStage GetInitStage () const;
+
+		/** Returns the resolver for the entity handling capabilities
+		 * declared by the currently loaded plugins.
+		 */
+		EntityResolver& GetEntityResolver () const;
 	private:
 		void SetInitStage (InitStage);
 
@@ -137,14 +145,17 @@ namespace LC
 		/** Tries to perform IInfo::Init() on all plugins. Returns the
 		 * list of plugins that failed.
 		 */
-		QList<QObject*> FirstInitAll (PluginLoadProcess*);
+		QList<QObject*> FirstInitAll (PluginLoadProcess*, PluginInitScheduler&);
 
 		/** Tries to perform IInfo::Init() on plugins and returns the
 		 * first plugin that has failed to initialize. This function
 		 * stops initializing plugins upon first failure. If all plugins
 		 * were initialized successfully, this function returns NULL.
+		 *
+		 * The successfully initialized plugins are passed to the
+		 * scheduler to run their background initialization.
 		 */
-		QObject* TryFirstInit (QObjectList, PluginLoadProcess*);
+		QObject* TryFirstInit (QObjectList, PluginLoadProcess*, PluginInitScheduler&);
 
 		/** Plainly tries to find a corresponding QPluginLoader and
 		 * unload the corresponding library.
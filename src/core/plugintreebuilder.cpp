@@ -189,6 +189,23 @@ namespace LC
 		return Result_;
 	}
 
+	QObjectList PluginTreeBuilder::GetDependencies (QObject *object) const
+	{
+		const auto pos = Object2Vertex_.find (object);
+		if (pos == Object2Vertex_.end ())
+			return {};
+
+		QObjectList result;
+		OutEdgeIterator_t ei, ei_end;
+		for (boost::tie (ei, ei_end) = boost::out_edges (*pos, Graph_); ei != ei_end; ++ei)
+		{
+			const auto& dep = Graph_ [boost::target (*ei, Graph_)];
+			if (dep.IsFulfilled_ && !result.contains (dep.Object_))
+				result << dep.Object_;
+		}
+		return result;
+	}
+
 	void PluginTreeBuilder::CreateGraph ()
 	{
 		for (const auto object : Instances_)
@@ -66,6 +66,11 @@ namespace LC
 		void RemoveObject (QObject*);
 		void Calculate ();
 		QObjectList GetResult () const;
+
+		/** Returns the plugins the given \em object directly depends on
+		 * according to the last Calculate() call.
+		 */
+		QObjectList GetDependencies (QObject *object) const;
 	private:
 		void CreateGraph ();
 		QMap<Edge_t, QPair<Vertex_t, Vertex_t>> MakeEdges ();
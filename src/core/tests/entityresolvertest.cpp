@@ -0,0 +1,248 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "entityresolvertest.h"
+#include <QtTest>
+#include <interfaces/entitytesthandleresult.h>
+#include "entityresolver.h"
+
+QTEST_APPLESS_MAIN (LC::EntityResolverTest)
+
+namespace LC
+{
+	EntityTestHandleResult FakeHandler::CouldHandle (const Entity&) const
+	{
+		return {};
+	}
+
+	void FakeHandler::Handle (Entity)
+	{
+	}
+
+	FakeDeclaringHandler::FakeDeclaringHandler (QList<EntityCapability> caps)
+	: Caps_ { std::move (caps) }
+	{
+	}
+
+	QList<EntityCapability> FakeDeclaringHandler::GetEntityCapabilities () const
+	{
+		return Caps_;
+	}
+
+	namespace
+	{
+		EntityCapability MakeCap (const QStringList& mimes, int priority)
+		{
+			EntityCapability cap;
+			cap.Mimes_ = mimes;
+			cap.Priority_ = priority;
+			return cap;
+		}
+
+		Entity MakeEntity (const QString& mime, TaskParameters params = NoParameters)
+		{
+			Entity e;
+			e.Entity_ = QString { "entity" };
+			e.Mime_ = mime;
+			e.Parameters_ = params | OnlyHandle;
+			return e;
+		}
+
+		QObjectList Resolve (const EntityResolver& resolver, const Entity& e)
+		{
+			const auto& resolution = resolver.TryResolve (e);
+			if (!resolution)
+				return { nullptr };
+			return resolution->Handlers_;
+		}
+	}
+
+	void EntityResolverTest::testBestPriority ()
+	{
+		FakeDeclaringHandler high { { MakeCap ({ "x-test/a" }, EntityTestHandleResult::PHigh) } };
+		FakeDeclaringHandler ideal
+		{
+			{
+				MakeCap ({ "x-test/a" }, EntityTestHandleResult::PLow),
+				MakeCap ({ "x-test/a" }, EntityTestHandleResult::PIdeal)
+			}
+		};
+		FakeDeclaringHandler otherIdeal { { MakeCap ({ "x-test/b" }, EntityTestHandleResult::PIdeal) } };
+		FakeDeclaringHandler none { { MakeCap ({ "x-test/a", "x-test/b" }, EntityTestHandleResult::PNone) } };
+
+		EntityResolver resolver;
+		resolver.Rebuild ({ &high, &ideal, &otherIdeal, &none });
+
+		QCOMPARE (Resolve (resolver, MakeEntity ("x-test/a")), QObjectList { &ideal });
+		QCOMPARE (Resolve (resolver, MakeEntity ("x-test/b")), QObjectList { &otherIdeal });
+		QCOMPARE (Resolve (resolver, MakeEntity ("x-test/c")), QObjectList {});
+
+		const auto& priorities = resolver.GetDeclaredPriorities (MakeEntity ("x-test/a"), EntityResolver::Kind::Handle);
+		QCOMPARE (priorities.value (&high), static_cast<int> (EntityTestHandleResult::PHigh));
+		QCOMPARE (priorities.value (&ideal), static_cast<int> (EntityTestHandleResult::PIdeal));
+		QVERIFY (!priorities.contains (&none));
+
+		FakeDeclaringHandler alsoIdeal { { MakeCap ({ "x-test/a" }, EntityTestHandleResult::PIdeal) } };
+		resolver.Rebuild ({ &high, &ideal, &alsoIdeal });
+		QCOMPARE (Resolve (resolver, MakeEntity ("x-test/a")), (QObjectList { &ideal, &alsoIdeal }));
+	}
+
+	void EntityResolverTest::testMimePatterns ()
+	{
+		FakeDeclaringHandler prefix { { MakeCap ({ "x-test/notification*" }, EntityTestHandleResult::PNormal) } };
+		FakeDeclaringHandler any { { MakeCap ({}, EntityTestHandleResult::PLow) } };
+
+		EntityResolver resolver;
+		resolver.Rebuild ({ &prefix, &any });
+
+		QCOMPARE (Resolve (resolver, MakeEntity ("x-test/notification")), QObjectList { &prefix });
+		QCOMPARE (Resolve (resolver, MakeEntity ("x-test/notification-rule")), QObjectList { &prefix });
+		QCOMPARE (Resolve (resolver, MakeEntity ("x-test/notify")), QObjectList { &any });
+	}
+
+	void EntityResolverTest::testNeedsQuery ()
+	{
+		auto queried = MakeCap ({ "x-test/file" }, EntityTestHandleResult::PIdeal);
+		queried.NeedsQuery_ = true;
+		FakeDeclaringHandler stateful { { queried, MakeCap ({ "x-test/a" }, EntityTestHandleResult::PHigh) } };
+		FakeDeclaringHandler plain { { MakeCap ({ "x-test/file", "x-test/a" }, EntityTestHandleResult::PLow) } };
+
+		EntityResolver resolver;
+		resolver.Rebuild ({ &stateful, &plain });
+
+		const auto& file = MakeEntity ("x-test/file");
+		QVERIFY (!resolver.TryResolve (file));
+		QCOMPARE (resolver.GetQueriedPlugins (file, EntityResolver::Kind::Handle), QSet<QObject*> { &stateful });
+
+		// The queried capability gives no declared priority, so that the
+		// plugin's CouldHandle() decides.
+		const auto& priorities = resolver.GetDeclaredPriorities (file, EntityResolver::Kind::Handle);
+		QVERIFY (!priorities.contains (&stateful));
+		QVERIFY (priorities.contains (&plain));
+
+		// Only the entities in the scope of the queried capability need the GUI thread.
+		QCOMPARE (Resolve (resolver, MakeEntity ("x-test/a")), QObjectList { &stateful });
+		QVERIFY (resolver.GetQueriedPlugins (MakeEntity ("x-test/a"), EntityResolver::Kind::Handle).isEmpty ());
+
+		// Handlers don't matter for the entities that are only downloaded.
+		auto download = file;
+		download.Parameters_ = OnlyDownload;
+		QVERIFY (resolver.TryResolve (download));
+	}
+
+	void EntityResolverTest::testUndeclared ()
+	{
+		FakeDeclaringHandler declaring { { MakeCap ({ "x-test/a" }, EntityTestHandleResult::PIdeal) } };
+		FakeHandler undeclared;
+
+		EntityResolver resolver;
+		resolver.Rebuild ({ &declaring, &undeclared });
+
+		QVERIFY (!resolver.TryResolve (MakeEntity ("x-test/a")));
+		QVERIFY (resolver.IsDeclaring (&declaring));
+		QVERIFY (!resolver.IsDeclaring (&undeclared));
+	}
+
+	void EntityResolverTest::testFieldsAndParameters ()
+	{
+		auto fields = MakeCap ({ "x-test/a" }, EntityTestHandleResult::PHigh);
+		fields.RequiredFields_ = QStringList { "Foo", "Bar" };
+		auto params = MakeCap ({ "x-test/a" }, EntityTestHandleResult::PNormal);
+		params.RequiredParameters_ = FromUserInitiated;
+		params.ForbiddenParameters_ = Internal;
+
+		FakeDeclaringHandler withFields { { fields } };
+		FakeDeclaringHandler withParams { { params } };
+
+		EntityResolver resolver;
+		resolver.Rebuild ({ &withFields, &withParams });
+
+		auto e = MakeEntity ("x-test/a", FromUserInitiated);
+		QCOMPARE (Resolve (resolver, e), QObjectList { &withParams });
+
+		e.Additional_ ["Foo"] = 1;
+		QCOMPARE (Resolve (resolver, e), QObjectList { &withParams });
+
+		e.Additional_ ["Bar"] = 2;
+		QCOMPARE (Resolve (resolver, e), QObjectList { &withFields });
+
+		e.Additional_.remove ("Foo");
+		e.Parameters_ |= Internal;
+		QCOMPARE (Resolve (resolver, e), QObjectList {});
+
+		e.Parameters_ &= ~Internal;
+		QCOMPARE (Resolve (resolver, e), QObjectList { &withParams });
+
+		e.Parameters_ &= ~FromUserInitiated;
+		QCOMPARE (Resolve (resolver, e), QObjectList {});
+	}
+
+	void EntityResolverTest::testPredicate ()
+	{
+		auto cap = MakeCap ({ "x-test/a" }, EntityTestHandleResult::PIdeal);
+		cap.Predicate_ = [] (const Entity& e) { return e.Entity_.toString ().startsWith ("good"); };
+		FakeDeclaringHandler picky { { cap } };
+
+		EntityResolver resolver;
+		resolver.Rebuild ({ &picky });
+
+		// Both entities have the same shape, so the predicate isn't cached.
+		auto good = MakeEntity ("x-test/a");
+		good.Entity_ = QString { "good entity" };
+		auto bad = MakeEntity ("x-test/a");
+		bad.Entity_ = QString { "bad entity" };
+
+		for (int i = 0; i < 2; ++i)
+		{
+			QCOMPARE (Resolve (resolver, good), QObjectList { &picky });
+			QCOMPARE (Resolve (resolver, bad), QObjectList {});
+		}
+	}
+
+	void EntityResolverTest::testRebuild ()
+	{
+		FakeDeclaringHandler first { { MakeCap ({ "x-test/a" }, EntityTestHandleResult::PHigh) } };
+		FakeDeclaringHandler second { { MakeCap ({ "x-test/b" }, EntityTestHandleResult::PHigh) } };
+
+		EntityResolver resolver;
+		resolver.Rebuild ({ &first, &second });
+
+		const auto& e = MakeEntity ("x-test/a");
+		QCOMPARE (Resolve (resolver, e), QObjectList { &first });
+
+		second.Caps_ = { MakeCap ({ "x-test/a" }, EntityTestHandleResult::PIdeal) };
+		resolver.Rebuild ({ &first, &second });
+		QCOMPARE (Resolve (resolver, e), QObjectList { &second });
+
+		resolver.Rebuild ({ &first });
+		QCOMPARE (Resolve (resolver, e), QObjectList { &first });
+
+		first.Caps_.first ().NeedsQuery_ = true;
+		resolver.Rebuild ({ &first });
+		QVERIFY (!resolver.TryResolve (e));
+	}
+
+	void EntityResolverTest::testClear ()
+	{
+		FakeDeclaringHandler handler { { MakeCap ({ "x-test/a" }, EntityTestHandleResult::PHigh) } };
+
+		EntityResolver resolver;
+		QVERIFY (!resolver.TryResolve (MakeEntity ("x-test/a")));
+
+		resolver.Rebuild ({ &handler });
+		QCOMPARE (Resolve (resolver, MakeEntity ("x-test/a")), QObjectList { &handler });
+
+		resolver.Clear ();
+		QVERIFY (!resolver.TryResolve (MakeEntity ("x-test/a")));
+		QVERIFY (!resolver.IsDeclaring (&handler));
+		QVERIFY (resolver.GetDeclaredPriorities (MakeEntity ("x-test/a"), EntityResolver::Kind::Handle).isEmpty ());
+
+		resolver.Rebuild ({ &handler });
+		QCOMPARE (Resolve (resolver, MakeEntity ("x-test/a")), QObjectList { &handler });
+	}
+}
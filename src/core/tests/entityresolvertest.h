@@ -0,0 +1,53 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
+
+namespace LC
+{
+	class FakeHandler : public QObject
+					  , public IEntityHandler
+	{
+		Q_OBJECT
+		Q_INTERFACES (IEntityHandler)
+	public:
+		EntityTestHandleResult CouldHandle (const Entity&) const override;
+		void Handle (Entity) override;
+	};
+
+	class FakeDeclaringHandler : public FakeHandler
+							   , public IHaveEntityCapabilities
+	{
+		Q_OBJECT
+		Q_INTERFACES (IHaveEntityCapabilities)
+	public:
+		QList<EntityCapability> Caps_;
+
+		explicit FakeDeclaringHandler (QList<EntityCapability>);
+
+		QList<EntityCapability> GetEntityCapabilities () const override;
+	};
+
+	class EntityResolverTest : public QObject
+	{
+		Q_OBJECT
+	private slots:
+		void testBestPriority ();
+		void testMimePatterns ();
+		void testNeedsQuery ();
+		void testUndeclared ();
+		void testFieldsAndParameters ();
+		void testPredicate ();
+		void testRebuild ();
+		void testClear ();
+	};
+}
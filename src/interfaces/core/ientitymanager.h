@@ -87,6 +87,28 @@ public:
 	 */
 	virtual bool HandleEntity (LC::Entity entity, QObject *desired = nullptr) = 0;
 
+	/** @brief Handles the given entity without blocking the caller.
+	 *
+	 * This function is similar to HandleEntity(), but it never waits
+	 * for the UI thread, which HandleEntity() has to do when called
+	 * from another thread unless all the plugins that could handle the
+	 * entity have declared their capabilities via
+	 * IHaveEntityCapabilities. Thus this function is preferable for
+	 * emitting lots of entities from worker threads.
+	 *
+	 * The entity is handled in the UI thread some time after this
+	 * function returns, even if it is called from the UI thread.
+	 *
+	 * @param[in] entity The entity to handle.
+	 * @param[in] desired The object to try first.
+	 *
+	 * @return The future with the result of handling the entity, the
+	 * same as the return value of HandleEntity().
+	 *
+	 * @sa HandleEntity(), IHaveEntityCapabilities
+	 */
+	virtual QFuture<bool> HandleEntityAsync (LC::Entity entity, QObject *desired = nullptr) = 0;
+
 	/** @brief Queries whether the given entity can be handled at all.
 	 *
 	 * @param[in] entity The entity to test.
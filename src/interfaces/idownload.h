@@ -69,7 +69,30 @@ public:
 		}
 	};
 
-	struct Success {};
+	/** @brief Describes a successfully finished download.
+	 *
+	 * The HTTP-related fields are only filled by the downloaders that
+	 * support them and only for HTTP(S) downloads, otherwise they are
+	 * left default-constructed.
+	 */
+	struct Success
+	{
+		/** @brief The status code of the final HTTP response, or 0.
+		 *
+		 * Notably, this is 304 for a conditional request (as set up via
+		 * the <code>HttpHeaders</code> entity map) if the resource hasn't
+		 * been modified. In this case the resulting file is empty.
+		 */
+		int HttpStatusCode_ = 0;
+
+		/** @brief The ETag header of the final HTTP response.
+		 */
+		QByteArray ETag_;
+
+		/** @brief The Last-Modified header of the final HTTP response.
+		 */
+		QByteArray LastModified_;
+	};
 
 	using Result = LC::Util::Either<Error, Success>;
 
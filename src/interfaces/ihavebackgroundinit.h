@@ -0,0 +1,62 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <QtPlugin>
+
+/** @brief Interface for plugins doing a part of their initialization
+ * in a background thread.
+ *
+ * Opening databases, reading caches and similar work done during
+ * startup doesn't need the GUI thread. A plugin implementing this
+ * interface declares that such work, moved from IInfo::Init() to
+ * BackgroundInit(), is safe to run concurrently with the
+ * initialization of other plugins.
+ *
+ * BackgroundInit() is called in a thread from a pool after the
+ * plugin's IInfo::Init() has returned and after the BackgroundInit()
+ * of all the plugins it depends on (both via IInfo::Needs() and
+ * IPlugin2) has finished. All the BackgroundInit() calls are finished
+ * before the first IInfo::SecondInit() is called.
+ *
+ * The IInfo::Init() of the plugins depending on this one is not
+ * delayed until its BackgroundInit() finishes. Thus the plugin must
+ * be usable from other plugins' IInfo::Init() while its
+ * BackgroundInit() is still running, for instance, by serving the
+ * requests from the data loaded in IInfo::Init() or by guarding the
+ * state that BackgroundInit() sets up.
+ *
+ * The events are processed while waiting for the BackgroundInit()
+ * calls to finish, except for the user input. So the queued calls,
+ * timers and other events posted from IInfo::Init() of any plugin
+ * may be delivered before IInfo::SecondInit() of the other plugins.
+ *
+ * @sa IInfo
+ */
+class Q_DECL_EXPORT IHaveBackgroundInit
+{
+public:
+	virtual ~IHaveBackgroundInit () {}
+
+	/** @brief Performs the thread-safe part of the initialization.
+	 *
+	 * This function is called in a non-GUI thread, so it must not
+	 * create any widgets or touch the objects living in other
+	 * threads, including the objects of other plugins.
+	 *
+	 * Throwing an exception from this function is treated the same
+	 * way as throwing it from IInfo::Init(): the plugin and the
+	 * plugins depending on it aren't initialized further. Since
+	 * their IInfo::Init() has already been called, their
+	 * IInfo::Release() is called before they are unloaded.
+	 */
+	virtual void BackgroundInit () = 0;
+};
+
+Q_DECLARE_INTERFACE (IHaveBackgroundInit, "org.Deviant.LeechCraft.IHaveBackgroundInit/1.0")
@@ -0,0 +1,136 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <QList>
+#include <QStringList>
+#include <QtPlugin>
+#include "structures.h"
+#include "entitytesthandleresult.h"
+
+namespace LC
+{
+	/** @brief Describes a kind of entities a plugin can handle.
+	 *
+	 * An entity matches the capability if it matches all of the
+	 * non-empty conditions of the capability.
+	 *
+	 * @sa IHaveEntityCapabilities
+	 */
+	struct EntityCapability
+	{
+		/** @brief Whether the capability is for handling or downloading.
+		 */
+		enum class Kind
+		{
+			/** The entity is handled via IEntityHandler::Handle().
+			 */
+			Handle,
+
+			/** The entity is downloaded via IDownload::AddJob().
+			 */
+			Download
+		};
+
+		Kind Kind_ = Kind::Handle;
+
+		/** @brief The MIME types of the matching entities.
+		 *
+		 * A trailing <code>*</code> matches any suffix, so that, for
+		 * example, <code>x-leechcraft/notification*</code> matches all
+		 * the kinds of notifications. The empty list matches any MIME.
+		 */
+		QStringList Mimes_;
+
+		/** @brief The URL schemes of the matching entities.
+		 *
+		 * If this list is non-empty, only the entities holding a QUrl
+		 * with one of these schemes match.
+		 */
+		QStringList Schemes_;
+
+		/** @brief The keys that should be present in the
+		 * Entity::Additional_ map of the matching entities.
+		 */
+		QStringList RequiredFields_;
+
+		/** @brief The task parameters that should all be set.
+		 */
+		TaskParameters RequiredParameters_ = NoParameters;
+
+		/** @brief The task parameters that should all be unset.
+		 */
+		TaskParameters ForbiddenParameters_ = NoParameters;
+
+		/** @brief The priority with which the matching entities are
+		 * handled.
+		 *
+		 * @sa EntityTestHandleResult::HandlePriority_
+		 */
+		int Priority_ = EntityTestHandleResult::PNormal;
+
+		/** @brief Whether the plugin still has to be asked about the
+		 * matching entities.
+		 *
+		 * If this is set, the capability only narrows down the entities
+		 * the plugin could take, and the plugin's CouldHandle() or
+		 * CouldDownload() is called in the GUI thread for the entities
+		 * matching it, while the Priority_ is ignored. This is useful
+		 * when the decision depends on something that can't be checked
+		 * from any thread, like the plugin's state or a file contents.
+		 */
+		bool NeedsQuery_ = false;
+
+		/** @brief An optional additional check on the entity.
+		 *
+		 * The predicate is only called for the entities matching the
+		 * rest of the conditions. It may be called from any thread, so
+		 * it must be thread-safe.
+		 */
+		std::function<bool (const Entity&)> Predicate_;
+	};
+}
+
+/** @brief Interface for entity handlers declaring what they can handle.
+ *
+ * An IEntityHandler or IDownload plugin implementing this interface
+ * declares the kinds of entities it can handle as a list of
+ * capabilities instead of being asked via IEntityHandler::CouldHandle()
+ * or IDownload::CouldDownload() for each entity. The plugin's
+ * CouldHandle() and CouldDownload() are then only called for the
+ * entities matching its capabilities with EntityCapability::NeedsQuery_
+ * set.
+ *
+ * Contrary to CouldHandle(), the capabilities are evaluated in the
+ * thread emitting the entity, and the results of their declarative
+ * part are cached for entities of the same shape (type, MIME, URL
+ * scheme, parameters and relevant additional fields). An entity is
+ * resolved without waiting for the GUI thread if all the handlers (or
+ * downloaders, if the entity may be downloaded) declare their
+ * capabilities, and none of the matching capabilities needs a query.
+ *
+ * The capabilities are queried once the plugins are initialized and
+ * are not expected to change afterwards.
+ *
+ * @sa LC::EntityCapability
+ */
+class Q_DECL_EXPORT IHaveEntityCapabilities
+{
+public:
+	virtual ~IHaveEntityCapabilities () {}
+
+	/** @brief Returns the capabilities of this plugin.
+	 *
+	 * @return The list of the capabilities of this plugin.
+	 */
+	virtual QList<LC::EntityCapability> GetEntityCapabilities () const = 0;
+};
+
+Q_DECLARE_INTERFACE (IHaveEntityCapabilities, "org.Deviant.LeechCraft.IHaveEntityCapabilities/1.0")
@@ -118,6 +118,15 @@ namespace LC::AdvancedNotifications
 		GeneralHandler_->Handle (e);
 	}
 
+	QList<EntityCapability> Plugin::GetEntityCapabilities () const
+	{
+		EntityCapability cap;
+		cap.Mimes_ = QStringList { Mimes::Notification + '*' };
+		cap.RequiredFields_ = QStringList { AN::EF::SenderID, AN::EF::EventID, AN::EF::EventCategory };
+		cap.Priority_ = EntityTestHandleResult::PIdeal;
+		return { cap };
+	}
+
 	Util::XmlSettingsDialog_ptr Plugin::GetSettingsDialog () const
 	{
 		return SettingsDialog_;
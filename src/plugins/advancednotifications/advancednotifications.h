@@ -13,6 +13,7 @@
 #include <QAction>
 #include <interfaces/iinfo.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/ihavesettings.h>
 #include <interfaces/iactionsexporter.h>
 #include <interfaces/iquarkcomponentprovider.h>
@@ -27,6 +28,7 @@ namespace LC::AdvancedNotifications
 	class Plugin : public QObject
 				 , public IInfo
 				 , public IEntityHandler
+				 , public IHaveEntityCapabilities
 				 , public IHaveSettings
 				 , public IActionsExporter
 				 , public IQuarkComponentProvider
@@ -36,6 +38,7 @@ namespace LC::AdvancedNotifications
 		Q_OBJECT
 		Q_INTERFACES (IInfo
 				IEntityHandler
+				IHaveEntityCapabilities
 				IHaveSettings
 				IActionsExporter
 				IQuarkComponentProvider
@@ -63,6 +66,8 @@ namespace LC::AdvancedNotifications
 		EntityTestHandleResult CouldHandle (const Entity&) const override;
 		void Handle (Entity) override;
 
+		QList<EntityCapability> GetEntityCapabilities () const override;
+
 		Util::XmlSettingsDialog_ptr GetSettingsDialog () const override;
 
 		QList<QAction*> GetActions (ActionsEmbedPlace) const override;
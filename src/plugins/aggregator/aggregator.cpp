@@ -224,6 +224,19 @@ namespace Aggregator
 		return ReprManager_;
 	}
 
+	namespace
+	{
+		bool IsFeedPage (const Entity& e)
+		{
+			const auto& pageData = e.Additional_ ["URLData"].toString ();
+			QXmlStreamReader xmlReader (pageData);
+			if (!xmlReader.readNextStartElement ())
+				return false;
+
+			return xmlReader.name () == "rss" || xmlReader.name () == "atom";
+		}
+	}
+
 	EntityTestHandleResult Aggregator::CouldHandle (const Entity& e) const
 	{
 		if (!e.Entity_.canConvert<QUrl> ())
@@ -239,12 +252,7 @@ namespace Aggregator
 					url.scheme () != "https")
 				return {};
 
-			const auto& pageData = e.Additional_ ["URLData"].toString ();
-			QXmlStreamReader xmlReader (pageData);
-			if (!xmlReader.readNextStartElement ())
-				return {};
-
-			return xmlReader.name () == "rss" || xmlReader.name () == "atom" ?
+			return IsFeedPage (e) ?
 					EntityTestHandleResult { EntityTestHandleResult::PIdeal } :
 					EntityTestHandleResult {};
 		}
@@ -292,6 +300,38 @@ namespace Aggregator
 			AddFeed ({ .URL_ = af.GetURL (), .Tags_ = af.GetTags (), .UpdatesManager_ = *UpdatesManager_ });
 	}
 
+	QList<EntityCapability> Aggregator::GetEntityCapabilities () const
+	{
+		EntityCapability opml;
+		opml.Mimes_ = QStringList { "text/x-opml" };
+		opml.Schemes_ = QStringList { "file", "http", "https", "itpc" };
+		opml.Priority_ = EntityTestHandleResult::PIdeal;
+
+		EntityCapability page;
+		page.Mimes_ = QStringList { "text/xml" };
+		page.Schemes_ = QStringList { "http", "https" };
+		page.RequiredFields_ = QStringList { "URLData" };
+		page.Priority_ = EntityTestHandleResult::PIdeal;
+		page.Predicate_ = &IsFeedPage;
+
+		EntityCapability feedUrls;
+		feedUrls.Schemes_ = QStringList { "feed", "itpc" };
+		feedUrls.Priority_ = EntityTestHandleResult::PIdeal;
+		feedUrls.Predicate_ = [] (const Entity& e) { return e.Mime_ != "text/xml"; };
+
+		EntityCapability links;
+		links.Mimes_ = QStringList { "application/atom+xml", "application/rss+xml" };
+		links.Schemes_ = QStringList { "http", "https" };
+		links.Priority_ = EntityTestHandleResult::PIdeal;
+		links.Predicate_ = [] (const Entity& e)
+		{
+			const auto& linkRel = e.Additional_ ["LinkRel"].toString ();
+			return linkRel.isEmpty () || linkRel == "alternate";
+		};
+
+		return { opml, page, feedUrls, links };
+	}
+
 	void Aggregator::SetShortcut (const QByteArray& name, const QKeySequences_t& shortcuts)
 	{
 		ShortcutMgr_->SetShortcut (name, shortcuts);
@@ -16,6 +16,7 @@
 #include <interfaces/ihavesettings.h>
 #include <interfaces/ihaveshortcuts.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/structures.h>
 #include <interfaces/iactionsexporter.h>
 #include <interfaces/istartupwizard.h>
@@ -49,6 +50,7 @@ namespace Aggregator
 					 , public IHaveSettings
 					 , public IJobHolder
 					 , public IEntityHandler
+					 , public IHaveEntityCapabilities
 					 , public IHaveShortcuts
 					 , public IActionsExporter
 					 , public IStartupWizard
@@ -61,6 +63,7 @@ namespace Aggregator
 				IHaveSettings
 				IJobHolder
 				IEntityHandler
+				IHaveEntityCapabilities
 				IHaveShortcuts
 				IStartupWizard
 				IActionsExporter
@@ -112,6 +115,8 @@ namespace Aggregator
 		EntityTestHandleResult CouldHandle (const Entity&) const override;
 		void Handle (Entity) override;
 
+		QList<EntityCapability> GetEntityCapabilities () const override;
+
 		void SetShortcut (const QByteArray&, const QKeySequences_t&) override;
 		QMap<QByteArray, ActionInfo> GetActionInfo () const override;
 
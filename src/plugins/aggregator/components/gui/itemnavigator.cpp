@@ -66,10 +66,20 @@ namespace LC::Aggregator
 
 	bool ItemNavigator::MoveToNextUnreadInChannel () const
 	{
-		const auto rc = View_.model ()->rowCount ();
-		const auto& current = View_.currentIndex ();
-		const auto startRow = current.isValid () ? current.row () + 1 : 0;
-		return startRow <= rc && MoveToUnreadSibling (v::iota (startRow, rc));
+		auto& model = *View_.model ();
+		while (true)
+		{
+			const auto rc = model.rowCount ();
+			const auto& current = View_.currentIndex ();
+			const auto startRow = current.isValid () ? current.row () + 1 : 0;
+			if (startRow <= rc && MoveToUnreadSibling (v::iota (startRow, rc)))
+				return true;
+
+			// The fetched rows might get sorted anywhere, so rescan them all.
+			if (!model.canFetchMore ({}))
+				return false;
+			model.fetchMore ({});
+		}
 	}
 
 	template<typename Range>
@@ -0,0 +1,161 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "itemswindow.h"
+#include <algorithm>
+#include <tuple>
+
+namespace LC::Aggregator
+{
+	namespace
+	{
+		// Matches the order of StorageBackend::GetItemsPage(), undated items last.
+		auto GetOrderKey (const QDateTime& pubDate, IDType_t itemId)
+		{
+			return std::tuple { pubDate.isValid (), pubDate.isValid () ? pubDate.toMSecsSinceEpoch () : 0, itemId };
+		}
+	}
+
+	ItemsWindow::ItemsWindow (PageFetcher_f fetcher, const QVector<IDType_t>& channels, bool unreadOnly, int pageSize)
+	: Fetcher_ { std::move (fetcher) }
+	, PageSize_ { pageSize }
+	, UnreadOnly_ { unreadOnly }
+	{
+		Cursors_.reserve (channels.size ());
+		for (auto channel : channels)
+			Cursors_.push_back ({ .ChannelID_ = channel });
+	}
+
+	bool ItemsWindow::CanFetchMore () const
+	{
+		return std::any_of (Cursors_.begin (), Cursors_.end (),
+				[] (const Cursor& cursor) { return !cursor.Exhausted_ || !cursor.Pending_.empty (); });
+	}
+
+	items_shorts_t ItemsWindow::FetchMore ()
+	{
+		items_shorts_t result;
+		result.reserve (PageSize_);
+
+		while (result.size () < PageSize_)
+		{
+			Cursor *newest = nullptr;
+			for (auto& cursor : Cursors_)
+			{
+				if (cursor.Pending_.empty () && !cursor.Exhausted_)
+					Refill (cursor);
+
+				if (!cursor.Pending_.empty () &&
+						(!newest || IsNewer (cursor.Pending_.front (), newest->Pending_.front ())))
+					newest = &cursor;
+			}
+
+			if (!newest)
+				break;
+
+			result << std::move (newest->Pending_.front ());
+			newest->Pending_.pop_front ();
+		}
+
+		return result;
+	}
+
+	namespace
+	{
+		bool IsNewerThanKey (const ItemShort& item, const StorageBackend::ItemsPageKey& key)
+		{
+			return GetOrderKey (item.PubDate_, item.ItemID_) > GetOrderKey (key.PubDate_, key.ItemID_);
+		}
+	}
+
+	ItemsWindow::Placement ItemsWindow::Place (const ItemShort& item)
+	{
+		const auto cursor = std::find_if (Cursors_.begin (), Cursors_.end (),
+				[&item] (const Cursor& cursor) { return cursor.ChannelID_ == item.ChannelID_; });
+		if (cursor == Cursors_.end ())
+			return Placement::Outside;
+
+		auto& pending = cursor->Pending_;
+		if (pending.empty ())
+		{
+			if (cursor->Exhausted_ || (cursor->FetchedUpTo_ && IsNewerThanKey (item, *cursor->FetchedUpTo_)))
+				return Placement::Released;
+			return Placement::Outside;
+		}
+
+		if (IsNewer (item, pending.front ()))
+			return Placement::Released;
+
+		const auto pos = std::find_if (pending.begin (), pending.end (),
+				[&item] (const ItemShort& other) { return other.ItemID_ == item.ItemID_; });
+		if (pos != pending.end ())
+		{
+			*pos = item;
+			return Placement::Pending;
+		}
+
+		if (!cursor->Exhausted_ && IsNewer (pending.back (), item))
+			return Placement::Outside;
+		if (UnreadOnly_ && !item.Unread_)
+			return Placement::Outside;
+
+		pending.insert (std::lower_bound (pending.begin (), pending.end (), item, &ItemsWindow::IsNewer), item);
+		return Placement::Pending;
+	}
+
+	void ItemsWindow::SetUnreadOnly ()
+	{
+		UnreadOnly_ = true;
+		for (auto& cursor : Cursors_)
+			std::erase_if (cursor.Pending_, [] (const ItemShort& item) { return !item.Unread_; });
+	}
+
+	void ItemsWindow::SetUnread (IDType_t itemId, bool unread)
+	{
+		for (auto& cursor : Cursors_)
+			for (auto& item : cursor.Pending_)
+				if (item.ItemID_ == itemId)
+				{
+					item.Unread_ = unread;
+					return;
+				}
+	}
+
+	void ItemsWindow::RemoveItems (const QSet<IDType_t>& ids)
+	{
+		for (auto& cursor : Cursors_)
+			std::erase_if (cursor.Pending_, [&ids] (const ItemShort& item) { return ids.contains (item.ItemID_); });
+	}
+
+	void ItemsWindow::RemoveChannels (const QSet<IDType_t>& ids)
+	{
+		Cursors_.erase (std::remove_if (Cursors_.begin (), Cursors_.end (),
+					[&ids] (const Cursor& cursor) { return ids.contains (cursor.ChannelID_); }),
+				Cursors_.end ());
+	}
+
+	bool ItemsWindow::IsNewer (const ItemShort& left, const ItemShort& right)
+	{
+		return GetOrderKey (left.PubDate_, left.ItemID_) > GetOrderKey (right.PubDate_, right.ItemID_);
+	}
+
+	void ItemsWindow::Refill (Cursor& cursor)
+	{
+		const auto& page = Fetcher_ (cursor.ChannelID_,
+				{ .After_ = cursor.FetchedUpTo_, .Limit_ = PageSize_, .UnreadOnly_ = UnreadOnly_ });
+		if (page.size () < PageSize_)
+			cursor.Exhausted_ = true;
+		if (page.isEmpty ())
+			return;
+
+		cursor.Pending_.insert (cursor.Pending_.end (), page.begin (), page.end ());
+
+		const auto& last = page.back ();
+		cursor.FetchedUpTo_ = { last.PubDate_, last.ItemID_ };
+	}
+}
@@ -0,0 +1,102 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <optional>
+#include <QSet>
+#include <QVector>
+#include "storagebackend.h"
+
+namespace LC::Aggregator
+{
+	/** @brief Pages the short items of a set of channels.
+	 *
+	 * The window releases the items of its channels from the newest to
+	 * the oldest (as ordered by StorageBackend::ItemsPageKey) in pages,
+	 * merging the per-channel pages as it goes, so that only the items
+	 * that have been released so far need to be kept in a model.
+	 *
+	 * The pages are fetched via the page fetcher function, which is
+	 * typically StorageBackend::GetItemsPage().
+	 */
+	class Q_DECL_EXPORT ItemsWindow
+	{
+	public:
+		using PageFetcher_f = std::function<items_shorts_t (IDType_t, const StorageBackend::ItemsPageQuery&)>;
+
+		/** @brief Where an updated item belongs with respect to the window.
+		 */
+		enum class Placement
+		{
+			/** @brief The item is among the items released so far.
+			 */
+			Released,
+
+			/** @brief The item will be released by a later FetchMore().
+			 */
+			Pending,
+
+			/** @brief The item is either not in the window or not fetched yet.
+			 */
+			Outside
+		};
+	private:
+		struct Cursor
+		{
+			IDType_t ChannelID_;
+			std::deque<ItemShort> Pending_ {};
+			std::optional<StorageBackend::ItemsPageKey> FetchedUpTo_ {};
+			bool Exhausted_ = false;
+		};
+
+		const PageFetcher_f Fetcher_;
+		const int PageSize_;
+		bool UnreadOnly_;
+
+		QVector<Cursor> Cursors_;
+	public:
+		ItemsWindow (PageFetcher_f, const QVector<IDType_t>& channels, bool unreadOnly, int pageSize);
+
+		bool CanFetchMore () const;
+
+		/** @brief Releases the next page of the items.
+		 *
+		 * @return The next at most pageSize items, from the newest to the
+		 * oldest.
+		 */
+		items_shorts_t FetchMore ();
+
+		/** @brief Places a new or updated item into the window.
+		 *
+		 * If the item belongs to the items that are fetched but not
+		 * released yet, it is updated or inserted there, so that it is
+		 * released by a later FetchMore().
+		 *
+		 * @param[in] item The new or updated item.
+		 * @return Where the item belongs.
+		 */
+		Placement Place (const ItemShort& item);
+
+		/** @brief Only fetches unread items from now on.
+		 *
+		 * The read items that are pending release are dropped.
+		 */
+		void SetUnreadOnly ();
+
+		void SetUnread (IDType_t itemId, bool unread);
+		void RemoveItems (const QSet<IDType_t>&);
+		void RemoveChannels (const QSet<IDType_t>&);
+
+		static bool IsNewer (const ItemShort&, const ItemShort&);
+	private:
+		void Refill (Cursor&);
+	};
+}
@@ -0,0 +1,278 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "itemswindow_test.h"
+#include <tuple>
+#include <QtTest>
+#include <QTemporaryDir>
+#include <components/models/itemswindow.h>
+#include <sqlstoragebackend.h>
+
+namespace LC::Aggregator
+{
+	namespace
+	{
+		const QDateTime Base { QDate { 2020, 10, 5 }, QTime { 10, 0 }, Qt::UTC };
+
+		ItemShort MakeItem (IDType_t id, IDType_t channel, int minutes, bool unread = true)
+		{
+			return
+			{
+				.ItemID_ = id,
+				.ChannelID_ = channel,
+				.Title_ = "Item " + QString::number (id),
+				.URL_ = {},
+				.Categories_ = {},
+				.PubDate_ = Base.addSecs (minutes * 60),
+				.Unread_ = unread,
+			};
+		}
+
+		class FakeStorage
+		{
+			QHash<IDType_t, items_shorts_t> Channels_;
+		public:
+			void Add (const ItemShort& item)
+			{
+				auto& items = Channels_ [item.ChannelID_];
+				items.insert (std::lower_bound (items.begin (), items.end (), item, &ItemsWindow::IsNewer), item);
+			}
+
+			items_shorts_t GetItemsPage (IDType_t channel, const StorageBackend::ItemsPageQuery& query) const
+			{
+				items_shorts_t result;
+				for (const auto& item : Channels_.value (channel))
+				{
+					if (result.size () == query.Limit_)
+						break;
+					if (query.UnreadOnly_ && !item.Unread_)
+						continue;
+					if (query.After_ &&
+							!ItemsWindow::IsNewer ({ .ItemID_ = query.After_->ItemID_, .PubDate_ = query.After_->PubDate_ }, item))
+						continue;
+					result << item;
+				}
+				return result;
+			}
+
+			ItemsWindow MakeWindow (const QVector<IDType_t>& channels, bool unreadOnly, int pageSize) const
+			{
+				return
+				{
+					[this] (IDType_t channel, const StorageBackend::ItemsPageQuery& query) { return GetItemsPage (channel, query); },
+					channels,
+					unreadOnly,
+					pageSize
+				};
+			}
+		};
+
+		QVector<IDType_t> Ids (const items_shorts_t& items)
+		{
+			QVector<IDType_t> result;
+			for (const auto& item : items)
+				result << item.ItemID_;
+			return result;
+		}
+	}
+
+	ItemsWindowTest::ItemsWindowTest () = default;
+	ItemsWindowTest::~ItemsWindowTest () = default;
+
+	void ItemsWindowTest::initTestCase ()
+	{
+		// The SQL storage lives in the user's home, so don't touch the real one.
+		Home_ = std::make_unique<QTemporaryDir> ();
+		QVERIFY (Home_->isValid ());
+		qputenv ("HOME", Home_->path ().toUtf8 ());
+	}
+
+	void ItemsWindowTest::testSingleChannel ()
+	{
+		FakeStorage storage;
+		for (IDType_t id = 1; id <= 5; ++id)
+			storage.Add (MakeItem (id, 1, id));
+
+		auto window = storage.MakeWindow ({ 1 }, false, 2);
+		QVERIFY (window.CanFetchMore ());
+		QCOMPARE (Ids (window.FetchMore ()), (QVector<IDType_t> { 5, 4 }));
+		QCOMPARE (Ids (window.FetchMore ()), (QVector<IDType_t> { 3, 2 }));
+		QVERIFY (window.CanFetchMore ());
+		QCOMPARE (Ids (window.FetchMore ()), (QVector<IDType_t> { 1 }));
+		QVERIFY (!window.CanFetchMore ());
+		QVERIFY (window.FetchMore ().isEmpty ());
+	}
+
+	void ItemsWindowTest::testMergesChannels ()
+	{
+		FakeStorage storage;
+		for (IDType_t id = 1; id <= 5; ++id)
+		{
+			storage.Add (MakeItem (id, 1, (id - 1) * 2));
+			storage.Add (MakeItem (id + 10, 2, (id - 1) * 2 + 1));
+		}
+
+		auto window = storage.MakeWindow ({ 1, 2 }, false, 3);
+		QCOMPARE (Ids (window.FetchMore ()), (QVector<IDType_t> { 15, 5, 14 }));
+		QCOMPARE (Ids (window.FetchMore ()), (QVector<IDType_t> { 4, 13, 3 }));
+		QCOMPARE (Ids (window.FetchMore ()), (QVector<IDType_t> { 12, 2, 11 }));
+		QCOMPARE (Ids (window.FetchMore ()), (QVector<IDType_t> { 1 }));
+		QVERIFY (!window.CanFetchMore ());
+
+		auto single = storage.MakeWindow ({ 1, 2 }, false, 3);
+		single.RemoveChannels ({ 2 });
+		QCOMPARE (Ids (single.FetchMore ()), (QVector<IDType_t> { 5, 4, 3 }));
+	}
+
+	void ItemsWindowTest::testUnreadOnly ()
+	{
+		FakeStorage storage;
+		for (IDType_t id = 1; id <= 6; ++id)
+			storage.Add (MakeItem (id, 1, id, id % 2));
+
+		auto unreadWindow = storage.MakeWindow ({ 1 }, true, 2);
+		QCOMPARE (Ids (unreadWindow.FetchMore ()), (QVector<IDType_t> { 5, 3 }));
+		QCOMPARE (Ids (unreadWindow.FetchMore ()), (QVector<IDType_t> { 1 }));
+		QVERIFY (!unreadWindow.CanFetchMore ());
+
+		auto window = storage.MakeWindow ({ 1 }, false, 3);
+		QCOMPARE (Ids (window.FetchMore ()), (QVector<IDType_t> { 6, 5, 4 }));
+		window.SetUnreadOnly ();
+		QCOMPARE (Ids (window.FetchMore ()), (QVector<IDType_t> { 3, 1 }));
+
+		// already fetched read items are dropped as well
+		FakeStorage merged;
+		merged.Add (MakeItem (1, 1, 10));
+		merged.Add (MakeItem (2, 1, 0, false));
+		merged.Add (MakeItem (11, 2, 5));
+		merged.Add (MakeItem (12, 2, 4, false));
+		merged.Add (MakeItem (13, 2, 3));
+
+		auto mergedWindow = merged.MakeWindow ({ 1, 2 }, false, 2);
+		QCOMPARE (Ids (mergedWindow.FetchMore ()), (QVector<IDType_t> { 1, 11 }));
+		mergedWindow.SetUnreadOnly ();
+		QCOMPARE (Ids (mergedWindow.FetchMore ()), (QVector<IDType_t> { 13 }));
+		QVERIFY (!mergedWindow.CanFetchMore ());
+	}
+
+	void ItemsWindowTest::testPlace ()
+	{
+		using P = ItemsWindow::Placement;
+
+		FakeStorage storage;
+		for (IDType_t id = 1; id <= 5; ++id)
+		{
+			storage.Add (MakeItem (id, 1, id * 2));
+			storage.Add (MakeItem (id + 10, 2, id * 2 - 1));
+		}
+
+		auto window = storage.MakeWindow ({ 1, 2 }, false, 3);
+		QCOMPARE (Ids (window.FetchMore ()), (QVector<IDType_t> { 5, 15, 4 }));
+
+		// channel 1 has 3 pending, channel 2 has 14 and 13 pending
+		QCOMPARE (window.Place (MakeItem (100, 1, 7)), P::Released);
+		QCOMPARE (window.Place (MakeItem (101, 1, 5)), P::Outside);
+		QCOMPARE (window.Place (MakeItem (102, 2, 6)), P::Pending);
+		QCOMPARE (window.Place (MakeItem (13, 2, 5, false)), P::Pending);
+		QCOMPARE (window.Place (MakeItem (200, 99, 100)), P::Outside);
+
+		const auto& page = window.FetchMore ();
+		QCOMPARE (Ids (page), (QVector<IDType_t> { 14, 102, 3 }));
+
+		const auto& rest = window.FetchMore ();
+		QCOMPARE (Ids (rest), (QVector<IDType_t> { 13, 2, 12 }));
+		QVERIFY (!rest [0].Unread_);
+	}
+
+	namespace
+	{
+		constexpr IDType_t BenchChannelId = 1;
+		constexpr int BenchPageSize = 200;
+
+		int GetBenchItemsCount ()
+		{
+			bool ok = false;
+			const auto count = qEnvironmentVariableIntValue ("LC_AGGREGATOR_BENCH_ITEMS", &ok);
+			return ok && count > 0 ? count : 100000;
+		}
+	}
+
+	const std::shared_ptr<StorageBackend>& ItemsWindowTest::GetBenchStorage ()
+	{
+		if (BenchSB_)
+			return BenchSB_;
+
+		const auto sb = std::make_shared<SQLStorageBackend> (StorageBackend::SBSQLite, "_ItemsWindowBench");
+		sb->Prepare ();
+
+		Feed feed { 1, "https://example.com/feed", Base };
+
+		const auto channel = std::make_shared<Channel> ();
+		channel->ChannelID_ = BenchChannelId;
+		channel->FeedID_ = feed.FeedID_;
+		channel->Title_ = "Large channel";
+
+		const auto count = GetBenchItemsCount ();
+		channel->Items_.reserve (count);
+		for (int i = 0; i < count; ++i)
+		{
+			const auto item = std::make_shared<Item> ();
+			item->ItemID_ = i + 1;
+			item->ChannelID_ = BenchChannelId;
+			item->Title_ = "Item " + QString::number (i);
+			item->Link_ = "https://example.com/items/" + QString::number (i);
+			item->PubDate_ = Base.addSecs (i * 60);
+			item->Unread_ = i % 3;
+			channel->Items_.push_back (item);
+		}
+		feed.Channels_.push_back (channel);
+
+		sb->AddFeed (feed);
+
+		BenchSB_ = sb;
+		return BenchSB_;
+	}
+
+	void ItemsWindowTest::benchFirstPage_data ()
+	{
+		QTest::addColumn<bool> ("windowed");
+
+		QTest::newRow ("full") << false;
+		QTest::newRow ("windowed") << true;
+	}
+
+	/* Measures the time to get the items for the first paint of a channel.
+	 *
+	 * Set LC_AGGREGATOR_BENCH_ITEMS to change the number of items in the
+	 * channel, 100000 by default.
+	 */
+	void ItemsWindowTest::benchFirstPage ()
+	{
+		QFETCH (bool, windowed);
+
+		const auto& sb = GetBenchStorage ();
+		const auto count = GetBenchItemsCount ();
+
+		QBENCHMARK
+		{
+			if (windowed)
+			{
+				ItemsWindow window
+				{
+					[&sb] (IDType_t channel, const StorageBackend::ItemsPageQuery& query) { return sb->GetItemsPage (channel, query); },
+					{ BenchChannelId },
+					false,
+					BenchPageSize
+				};
+				QCOMPARE (window.FetchMore ().size (), std::min (count, BenchPageSize));
+			}
+			else
+				QCOMPARE (sb->GetItems (BenchChannelId).size (), count);
+		}
+	}
+}
@@ -0,0 +1,44 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <QObject>
+
+class QTemporaryDir;
+
+namespace LC::Aggregator
+{
+	class StorageBackend;
+
+	class Q_DECL_EXPORT ItemsWindowTest : public QObject
+	{
+		Q_OBJECT
+
+		std::unique_ptr<QTemporaryDir> Home_;
+		std::shared_ptr<StorageBackend> BenchSB_;
+	public:
+		ItemsWindowTest ();
+		~ItemsWindowTest () override;
+	private slots:
+		void initTestCase ();
+
+		void testSingleChannel ();
+		void testMergesChannels ();
+		void testUnreadOnly ();
+		void testPlace ();
+
+		void benchFirstPage_data ();
+		void benchFirstPage ();
+	private:
+		const std::shared_ptr<StorageBackend>& GetBenchStorage ();
+	};
+}
+
+using TheTestObject = LC::Aggregator::ItemsWindowTest;
@@ -8,9 +8,11 @@
 
 #include "atom.h"
 #include <QDomDocument>
+#include <QXmlStreamReader>
 #include <util/sll/domchildrenrange.h>
 #include <util/sll/prelude.h>
 #include <util/sll/qtutil.h>
+#include "streamutils.h"
 #include "utils.h"
 
 namespace LC::Aggregator::Parsers
@@ -65,18 +67,59 @@ namespace LC::Aggregator::Parsers
 			return item;
 		}
 
-		Channel_ptr ParseAtomChannelCommon (const QDomElement& root, IDType_t feedId)
+		void FillAtomChannelCommon (Channel& chan, const QDomElement& root)
+		{
+			chan.Title_ = root.firstChildElement ("title"_qs).text ().trimmed ();
+			if (chan.Title_.isEmpty ())
+				chan.Title_ = QObject::tr ("(No title)");
+			chan.LastBuild_ = QDateTime::fromString (root.firstChildElement ("updated"_qs).text (), Qt::ISODateWithMs);
+			chan.Link_ = GetLink (root);
+			chan.Author_ = ParseAtomAuthor (root);
+			if (chan.Author_.isEmpty ())
+				chan.Author_ = GetAuthor (root);
+		}
+
+		void FillAtom03Channel (Channel& chan, const QDomElement& root)
+		{
+			FillAtomChannelCommon (chan, root);
+			chan.Description_ = root.firstChildElement ("tagline"_qs).text ();
+		}
+
+		void FillAtom10Channel (Channel& chan, const QDomElement& root)
+		{
+			FillAtomChannelCommon (chan, root);
+			chan.Description_ = root.firstChildElement ("subtitle"_qs).text ();
+			if (chan.Author_.isEmpty ())
+			{
+				const auto& author = root.firstChildElement ("author"_qs);
+				const auto& name = author.firstChildElement ("name"_qs).text ();
+				const auto& email = author.firstChildElement ("email"_qs).text ();
+				if (!name.isEmpty () && !email.isEmpty ())
+					chan.Author_ = name + " (" + email + ")";
+				else if (!name.isEmpty ())
+					chan.Author_ = name;
+				else if (!email.isEmpty ())
+					chan.Author_ = email;
+			}
+		}
+
+		template<typename ItemParser, typename ChannelFiller>
+		channels_container_t StreamAtomDocument (QXmlStreamReader& reader, const QDomElement& rootStart,
+				IDType_t feedId, const EmitItem_f& emitItem, ItemParser parseItem, ChannelFiller fillChannel)
 		{
 			auto chan = std::make_shared<Channel> (Channel::CreateForFeed (feedId));
-			chan->Title_ = root.firstChildElement ("title"_qs).text ().trimmed ();
-			if (chan->Title_.isEmpty ())
-				chan->Title_ = QObject::tr ("(No title)");
-			chan->LastBuild_ = QDateTime::fromString (root.firstChildElement ("updated"_qs).text (), Qt::ISODateWithMs);
-			chan->Link_ = GetLink (root);
-			chan->Author_ = ParseAtomAuthor (root);
-			if (chan->Author_.isEmpty ())
-				chan->Author_ = GetAuthor (root);
-			return chan;
+
+			auto root = rootStart;
+			ReadStreamedChildren (reader, root, "entry"_qs,
+					[&] (const QDomElement& entry)
+					{
+						const auto& item = parseItem (entry, chan->ChannelID_);
+						chan->Items_.push_back (item);
+						return emitItem (*item);
+					});
+			fillChannel (*chan, root);
+
+			return { chan };
 		}
 
 		bool IsAtom03 (const QDomElement& root)
@@ -102,10 +145,10 @@ namespace LC::Aggregator::Parsers
 		if (!IsAtom03 (root))
 			return {};
 
-		auto chan = ParseAtomChannelCommon (root, feedId);
-		chan->Description_ = root.firstChildElement ("tagline"_qs).text ();
+		auto chan = std::make_shared<Channel> (Channel::CreateForFeed (feedId));
 		chan->Items_ = Util::MapAs<QVector> (Util::DomChildren (root, "entry"_qs),
 				[cid = chan->ChannelID_] (const QDomElement& entry) { return Parse03Item (entry, cid); });
+		FillAtom03Channel (*chan, root);
 
 		return { { chan } };
 	}
@@ -116,24 +159,29 @@ namespace LC::Aggregator::Parsers
 		if (!IsAtom10 (root))
 			return {};
 
-		auto chan = ParseAtomChannelCommon (root, feedId);
-		chan->Description_ = root.firstChildElement ("subtitle"_qs).text ();
-		if (chan->Author_.isEmpty ())
-		{
-			const auto& author = root.firstChildElement ("author"_qs);
-			const auto& name = author.firstChildElement ("name"_qs).text ();
-			const auto& email = author.firstChildElement ("email"_qs).text ();
-			if (!name.isEmpty () && !email.isEmpty ())
-				chan->Author_ = name + " (" + email + ")";
-			else if (!name.isEmpty ())
-				chan->Author_ = name;
-			else if (!email.isEmpty ())
-				chan->Author_ = email;
-		}
-
+		auto chan = std::make_shared<Channel> (Channel::CreateForFeed (feedId));
 		chan->Items_ = Util::MapAs<QVector> (Util::DomChildren (root, "entry"_qs),
 				[cid = chan->ChannelID_] (const QDomElement& entry) { return Parse10Item (entry, cid); });
+		FillAtom10Channel (*chan, root);
 
 		return { { chan } };
 	}
+
+	std::optional<channels_container_t> Atom03 (QXmlStreamReader& reader, const QDomElement& root,
+			IDType_t feedId, const EmitItem_f& emitItem)
+	{
+		if (!IsAtom03 (root))
+			return {};
+
+		return StreamAtomDocument (reader, root, feedId, emitItem, &Parse03Item, &FillAtom03Channel);
+	}
+
+	std::optional<channels_container_t> Atom10 (QXmlStreamReader& reader, const QDomElement& root,
+			IDType_t feedId, const EmitItem_f& emitItem)
+	{
+		if (!IsAtom10 (root))
+			return {};
+
+		return StreamAtomDocument (reader, root, feedId, emitItem, &Parse10Item, &FillAtom10Channel);
+	}
 }
@@ -10,11 +10,16 @@
 
 #include <optional>
 #include "channel.h"
+#include "streamutils.h"
 
 class QDomDocument;
+class QXmlStreamReader;
 
 namespace LC::Aggregator::Parsers
 {
 	std::optional<channels_container_t> Atom03 (const QDomDocument& doc, IDType_t feedId);
 	std::optional<channels_container_t> Atom10 (const QDomDocument& doc, IDType_t feedId);
+
+	std::optional<channels_container_t> Atom03 (QXmlStreamReader&, const QDomElement& root, IDType_t feedId, const EmitItem_f&);
+	std::optional<channels_container_t> Atom10 (QXmlStreamReader&, const QDomElement& root, IDType_t feedId, const EmitItem_f&);
 }
@@ -7,7 +7,10 @@
  **********************************************************************/
 
 #include "parse.h"
+#include <QDomDocument>
+#include <QXmlStreamReader>
 #include <QtDebug>
+#include <util/sll/either.h>
 #include <util/sll/qtutil.h>
 #include "atom.h"
 #include "rss.h"
@@ -22,16 +25,21 @@ namespace LC::Aggregator::Parsers
 			return std::move (title).trimmed ().simplified ();
 		}
 
+		void FixChannelLink (Channel& channel)
+		{
+			if (channel.Link_.isEmpty ())
+			{
+				qWarning () << "detected empty link for"
+					<< channel.Title_;
+				channel.Link_ = "about:blank"_qs;
+			}
+		}
+
 		void PostprocessParsed (channels_container_t& channels)
 		{
 			for (const auto& newChannel : channels)
 			{
-				if (newChannel->Link_.isEmpty ())
-				{
-					qWarning () << "detected empty link for"
-						<< newChannel->Title_;
-					newChannel->Link_ = "about:blank"_qs;
-				}
+				FixChannelLink (*newChannel);
 				for (const auto& item : newChannel->Items_)
 					item->Title_ = FixItemTitle (std::move (item->Title_));
 			}
@@ -40,7 +48,8 @@ namespace LC::Aggregator::Parsers
 
 	std::optional<channels_container_t> TryParse (const QDomDocument& doc, IDType_t feedId)
 	{
-		static const std::array parsers
+		using Parser_f = std::optional<channels_container_t> (*) (const QDomDocument&, IDType_t);
+		static const std::array<Parser_f, 5> parsers
 		{
 			&Atom10,
 			&Rss20,
@@ -58,4 +67,54 @@ namespace LC::Aggregator::Parsers
 
 		return {};
 	}
+
+	StreamParseResult_t TryParseStream (QIODevice& device, IDType_t feedId, const ItemHandler_f& handler)
+	{
+		QXmlStreamReader reader { &device };
+
+		const auto makeXmlError = [&reader]
+		{
+			return StreamParseResult_t::Left (XmlError { reader.errorString (), reader.lineNumber (), reader.columnNumber () });
+		};
+
+		if (!reader.readNextStartElement ())
+			return reader.hasError () ?
+					makeXmlError () :
+					StreamParseResult_t::Left (UnknownFormat {});
+
+		QDomDocument doc;
+		const auto& root = MakeElement (reader, doc);
+
+		const auto emitItem = [&handler] (Item& item)
+		{
+			item.Title_ = FixItemTitle (std::move (item.Title_));
+			return !handler || handler (item);
+		};
+
+		using Parser_f = std::optional<channels_container_t> (*) (QXmlStreamReader&, const QDomElement&, IDType_t, const EmitItem_f&);
+		static const std::array<Parser_f, 5> parsers
+		{
+			&Atom10,
+			&Rss20,
+			&Atom03,
+			&Rss091,
+			&Rss10,
+		};
+
+		for (auto parser : parsers)
+			if (auto res = parser (reader, root, feedId, emitItem))
+			{
+				// the rest of the document still has to be well-formed
+				while (!reader.atEnd ())
+					reader.readNext ();
+				if (reader.hasError ())
+					return makeXmlError ();
+
+				for (const auto& channel : *res)
+					FixChannelLink (*channel);
+				return StreamParseResult_t::Right (std::move (*res));
+			}
+
+		return StreamParseResult_t::Left (UnknownFormat {});
+	}
 }
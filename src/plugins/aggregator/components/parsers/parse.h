@@ -8,12 +8,50 @@
 
 #pragma once
 
+#include <functional>
 #include <optional>
+#include <variant>
+#include <util/sll/eitherfwd.h>
 #include "channel.h"
 
 class QDomDocument;
+class QIODevice;
 
 namespace LC::Aggregator::Parsers
 {
-	std::optional<channels_container_t> TryParse (const QDomDocument& doc, IDType_t feedId);
+	Q_DECL_EXPORT std::optional<channels_container_t> TryParse (const QDomDocument& doc, IDType_t feedId);
+
+	/** @brief Called for each item as soon as it is parsed.
+	 *
+	 * The channel the item belongs to has only its IDs set at this point,
+	 * the rest of its metadata is parsed after all of its items.
+	 *
+	 * Returning false skips the remaining items of the same channel,
+	 * without parsing them at all.
+	 */
+	using ItemHandler_f = std::function<bool (const Item&)>;
+
+	struct XmlError
+	{
+		QString Message_;
+		qint64 Line_;
+		qint64 Column_;
+	};
+
+	struct UnknownFormat {};
+
+	using StreamParseError_t = std::variant<XmlError, UnknownFormat>;
+	using StreamParseResult_t = Util::Either<StreamParseError_t, channels_container_t>;
+
+	/** @brief Parses the feed while reading it from the device.
+	 *
+	 * Unlike TryParse(), the whole document is never built in memory:
+	 * each item is parsed as soon as it is read and then passed to the
+	 * handler, and only the channel-level elements are retained.
+	 *
+	 * Unless the handler stops early, the result is the same as with
+	 * TryParse() on the same document.
+	 */
+	Q_DECL_EXPORT StreamParseResult_t TryParseStream (QIODevice& device, IDType_t feedId,
+			const ItemHandler_f& handler = {});
 }
@@ -8,11 +8,14 @@
 
 #include "rss.h"
 #include <QDomDocument>
+#include <QSet>
+#include <QXmlStreamReader>
 #include <QtDebug>
 #include <util/sll/domchildrenrange.h>
 #include <util/sll/prelude.h>
 #include <util/sll/qtutil.h>
 #include "mediarss.h"
+#include "streamutils.h"
 #include "utils.h"
 
 namespace LC::Aggregator::Parsers
@@ -89,14 +92,30 @@ namespace LC::Aggregator::Parsers
 			return result;
 		}
 
-		Channel_ptr ParseRssChannelMetadata (const QDomElement& channel, IDType_t feedId)
+		void FillRssChannelMetadata (Channel& chan, const QDomElement& channel)
 		{
-			auto chan = std::make_shared<Channel> (Channel::CreateForFeed (feedId));
-			chan->Title_ = channel.firstChildElement ("title"_qs).text ().trimmed ();
-			chan->Description_ = channel.firstChildElement ("description"_qs).text ();
-			chan->Link_ = GetLink (channel);
-			chan->PixmapURL_ = channel.firstChildElement ("image"_qs).firstChildElement ("url"_qs).text ();
-			return chan;
+			chan.Title_ = channel.firstChildElement ("title"_qs).text ().trimmed ();
+			chan.Description_ = channel.firstChildElement ("description"_qs).text ();
+			chan.Link_ = GetLink (channel);
+			chan.PixmapURL_ = channel.firstChildElement ("image"_qs).firstChildElement ("url"_qs).text ();
+		}
+
+		// expects the items to be already parsed
+		void FillRssChannel (Channel& chan, const QDomElement& channel)
+		{
+			FillRssChannelMetadata (chan, channel);
+			chan.Language_ = channel.firstChildElement ("language"_qs).text ();
+			chan.Author_ = GetAuthor (channel);
+			if (chan.Author_.isEmpty ())
+				chan.Author_ = channel.firstChildElement ("managingEditor"_qs).text ();
+			if (chan.Author_.isEmpty ())
+				chan.Author_ = channel.firstChildElement ("webMaster"_qs).text ();
+
+			chan.LastBuild_ = ParseRfc822Lax (channel.firstChildElement ("lastBuildDate"_qs).text ());
+			if (!chan.LastBuild_.isValid ())
+				chan.LastBuild_ = chan.Items_.isEmpty () ?
+						QDateTime::currentDateTime () :
+						chan.Items_.front ()->PubDate_;
 		}
 
 		channels_container_t ParseRssDocument (const QDomElement& root, IDType_t feedId)
@@ -104,22 +123,37 @@ namespace LC::Aggregator::Parsers
 			channels_container_t channels;
 			for (const auto& channel : Util::DomChildren (root, "channel"_qs))
 			{
-				auto chan = ParseRssChannelMetadata (channel, feedId);
-				chan->Language_ = channel.firstChildElement ("language"_qs).text ();
-				chan->Author_ = GetAuthor (channel);
-				if (chan->Author_.isEmpty ())
-					chan->Author_ = channel.firstChildElement ("managingEditor"_qs).text ();
-				if (chan->Author_.isEmpty ())
-					chan->Author_ = channel.firstChildElement ("webMaster"_qs).text ();
+				auto chan = std::make_shared<Channel> (Channel::CreateForFeed (feedId));
 				chan->Items_ = Util::MapAs<QVector> (Util::DomChildren (channel, "item"_qs),
 						[cid = chan->ChannelID_] (const QDomElement& item) { return ParseRssItem (item, cid); });
+				FillRssChannel (*chan, channel);
+				channels.push_back (chan);
+			}
+			return channels;
+		}
 
-				chan->LastBuild_ = ParseRfc822Lax (channel.firstChildElement ("lastBuildDate"_qs).text ());
-				if (!chan->LastBuild_.isValid ())
-					chan->LastBuild_ = chan->Items_.isEmpty () ?
-							QDateTime::currentDateTime () :
-							chan->Items_.front ()->PubDate_;
+		channels_container_t StreamRssDocument (QXmlStreamReader& reader, QDomDocument& doc,
+				IDType_t feedId, const EmitItem_f& emitItem)
+		{
+			channels_container_t channels;
+			while (reader.readNextStartElement ())
+			{
+				if (reader.name () != "channel"_ql)
+				{
+					reader.skipCurrentElement ();
+					continue;
+				}
 
+				auto chan = std::make_shared<Channel> (Channel::CreateForFeed (feedId));
+				auto channel = MakeElement (reader, doc);
+				ReadStreamedChildren (reader, channel, "item"_qs,
+						[&] (const QDomElement& itemElem)
+						{
+							const auto& item = ParseRssItem (itemElem, chan->ChannelID_);
+							chan->Items_.push_back (item);
+							return emitItem (*item);
+						});
+				FillRssChannel (*chan, channel);
 				channels.push_back (chan);
 			}
 			return channels;
@@ -144,27 +178,42 @@ namespace LC::Aggregator::Parsers
 		return ParseRssDocument (root, feedId);
 	}
 
-	namespace NS
+	std::optional<channels_container_t> Rss091 (QXmlStreamReader& reader, const QDomElement& root,
+			IDType_t feedId, const EmitItem_f& emitItem)
 	{
-		const QString RDF = "http://www.w3.org/1999/02/22-rdf-syntax-ns#"_qs;
+		if (!IsRss091 (root))
+			return {};
+
+		auto doc = root.ownerDocument ();
+		return StreamRssDocument (reader, doc, feedId, emitItem);
 	}
 
-	std::optional<channels_container_t> Rss10 (const QDomDocument& doc, IDType_t feedId)
+	std::optional<channels_container_t> Rss20 (QXmlStreamReader& reader, const QDomElement& root,
+			IDType_t feedId, const EmitItem_f& emitItem)
 	{
-		const auto& root = doc.documentElement ();
-		if (!IsRss10 (root))
+		if (!IsRss20 (root))
 			return {};
 
-		channels_container_t channels;
+		auto doc = root.ownerDocument ();
+		return StreamRssDocument (reader, doc, feedId, emitItem);
+	}
 
-		QHash<QString, Channel_ptr> item2Channel;
-		for (const auto& channel : Util::DomChildren (root, "channel"_qs))
+	namespace NS
+	{
+		const QString RDF = "http://www.w3.org/1999/02/22-rdf-syntax-ns#"_qs;
+	}
+
+	namespace
+	{
+		Channel_ptr ParseRdfChannel (const QDomElement& channel, IDType_t feedId,
+				QHash<QString, Channel_ptr>& item2Channel)
 		{
 			const auto& seqs = channel.firstChildElement ("items"_qs).elementsByTagNameNS (NS::RDF, "Seq"_qs);
 			if (seqs.isEmpty ())
-				continue;
+				return {};
 
-			auto chan = ParseRssChannelMetadata (channel, feedId);
+			auto chan = std::make_shared<Channel> (Channel::CreateForFeed (feedId));
+			FillRssChannelMetadata (*chan, channel);
 			chan->LastBuild_ = GetDCDateTime (channel);
 
 			const auto& seqElem = seqs.at (0).toElement ();
@@ -172,21 +221,98 @@ namespace LC::Aggregator::Parsers
 			for (int i = 0; i < lis.size (); ++i)
 				item2Channel [lis.at (i).toElement ().attribute ("resource"_qs)] = chan;
 
-			channels.push_back (chan);
+			return chan;
+		}
+
+		Item_ptr ParseRdfItem (const QDomElement& itemDescr, IDType_t channelId)
+		{
+			auto item = ParseCommonRssRdfItem (itemDescr, channelId);
+			item->PubDate_ = GetDCDateTime (itemDescr);
+			return item;
 		}
+	}
+
+	std::optional<channels_container_t> Rss10 (const QDomDocument& doc, IDType_t feedId)
+	{
+		const auto& root = doc.documentElement ();
+		if (!IsRss10 (root))
+			return {};
+
+		channels_container_t channels;
+
+		QHash<QString, Channel_ptr> item2Channel;
+		for (const auto& channel : Util::DomChildren (root, "channel"_qs))
+			if (const auto& chan = ParseRdfChannel (channel, feedId, item2Channel))
+				channels.push_back (chan);
 
 		for (const auto& itemDescr : Util::DomChildren (root, "item"_qs))
 		{
 			const auto& about = itemDescr.attributeNS (NS::RDF, "about"_qs);
-			auto& chan = item2Channel.value (about);
+			const auto& chan = item2Channel.value (about);
 			if (!chan)
 				continue;
 
-			auto item = ParseCommonRssRdfItem (itemDescr, chan->ChannelID_);
-			item->PubDate_ = GetDCDateTime (itemDescr);
-			chan->Items_.push_back (std::move (item));
+			chan->Items_.push_back (ParseRdfItem (itemDescr, chan->ChannelID_));
 		}
 
-		return {};
+		return channels;
+	}
+
+	std::optional<channels_container_t> Rss10 (QXmlStreamReader& reader, const QDomElement& root,
+			IDType_t feedId, const EmitItem_f& emitItem)
+	{
+		if (!IsRss10 (root))
+			return {};
+
+		auto doc = root.ownerDocument ();
+
+		channels_container_t channels;
+		QHash<QString, Channel_ptr> item2Channel;
+		QSet<IDType_t> stoppedChannels;
+
+		/* Items are matched to the channels listing them, so the ones coming
+		 * before their channel have to wait for it. To keep the items order
+		 * the same as in the document, all the following ones wait as well.
+		 */
+		QVector<QDomElement> pending;
+
+		const auto handleItem = [&] (const QDomElement& itemDescr)
+		{
+			const auto& chan = item2Channel.value (itemDescr.attributeNS (NS::RDF, "about"_qs));
+			if (!chan || stoppedChannels.contains (chan->ChannelID_))
+				return;
+
+			const auto& item = ParseRdfItem (itemDescr, chan->ChannelID_);
+			chan->Items_.push_back (item);
+			if (!emitItem (*item))
+				stoppedChannels << chan->ChannelID_;
+		};
+
+		while (reader.readNextStartElement ())
+		{
+			if (reader.name () == "channel"_ql)
+			{
+				if (const auto& chan = ParseRdfChannel (ReadElement (reader, doc), feedId, item2Channel))
+					channels.push_back (chan);
+			}
+			else if (reader.name () == "item"_ql)
+			{
+				const auto& about = reader.attributes ().value (NS::RDF, "about"_qs).toString ();
+				const auto& chan = item2Channel.value (about);
+				if (pending.isEmpty () && chan && stoppedChannels.contains (chan->ChannelID_))
+					reader.skipCurrentElement ();
+				else if (pending.isEmpty () && chan)
+					handleItem (ReadElement (reader, doc));
+				else
+					pending << ReadElement (reader, doc);
+			}
+			else
+				reader.skipCurrentElement ();
+		}
+
+		for (const auto& itemDescr : pending)
+			handleItem (itemDescr);
+
+		return channels;
 	}
 }
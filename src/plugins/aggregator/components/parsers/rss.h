@@ -10,12 +10,18 @@
 
 #include <optional>
 #include "channel.h"
+#include "streamutils.h"
 
 class QDomDocument;
+class QXmlStreamReader;
 
 namespace LC::Aggregator::Parsers
 {
 	std::optional<channels_container_t> Rss091 (const QDomDocument& doc, IDType_t feedId);
 	std::optional<channels_container_t> Rss10 (const QDomDocument& doc, IDType_t feedId);
 	std::optional<channels_container_t> Rss20 (const QDomDocument& doc, IDType_t feedId);
+
+	std::optional<channels_container_t> Rss091 (QXmlStreamReader&, const QDomElement& root, IDType_t feedId, const EmitItem_f&);
+	std::optional<channels_container_t> Rss10 (QXmlStreamReader&, const QDomElement& root, IDType_t feedId, const EmitItem_f&);
+	std::optional<channels_container_t> Rss20 (QXmlStreamReader&, const QDomElement& root, IDType_t feedId, const EmitItem_f&);
 }
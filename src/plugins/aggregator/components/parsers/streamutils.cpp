@@ -0,0 +1,159 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "streamutils.h"
+#include <array>
+#include <QDomDocument>
+#include <QXmlStreamReader>
+#include <util/sll/qtutil.h>
+
+namespace LC::Aggregator::Parsers
+{
+	QDomElement MakeElement (const QXmlStreamReader& reader, QDomDocument& doc)
+	{
+		auto elem = doc.createElementNS (reader.namespaceUri ().toString (), reader.qualifiedName ().toString ());
+		for (const auto& attr : reader.attributes ())
+			elem.setAttributeNS (attr.namespaceUri ().toString (), attr.qualifiedName ().toString (), attr.value ().toString ());
+		return elem;
+	}
+
+	QDomElement ReadElement (QXmlStreamReader& reader, QDomDocument& doc)
+	{
+		const auto root = MakeElement (reader, doc);
+
+		auto current = root;
+		int depth = 1;
+		while (depth && !reader.atEnd ())
+			switch (reader.readNext ())
+			{
+			case QXmlStreamReader::StartElement:
+			{
+				const auto& child = MakeElement (reader, doc);
+				current.appendChild (child);
+				current = child;
+				++depth;
+				break;
+			}
+			case QXmlStreamReader::EndElement:
+				current = current.parentNode ().toElement ();
+				--depth;
+				break;
+			case QXmlStreamReader::Characters:
+				// QDomDocument::setContent() drops whitespace-only text nodes too
+				if (reader.isCDATA ())
+					current.appendChild (doc.createCDATASection (reader.text ().toString ()));
+				else if (!reader.isWhitespace ())
+					current.appendChild (doc.createTextNode (reader.text ().toString ()));
+				break;
+			default:
+				break;
+			}
+
+		return root;
+	}
+
+	namespace NS
+	{
+		const QString DC = "http://purl.org/dc/elements/1.1/"_qs;
+		const QString ITunes = "http://www.itunes.com/dtds/podcast-1.0.dtd"_qs;
+	}
+
+	namespace
+	{
+		/* GetAuthor() searches among all the descendants, so an author
+		 * mentioned only in an item ends up as the channel author. To keep
+		 * that, the first element of each kind GetAuthor() checks is copied
+		 * from the streamed children into the parent, at the same position
+		 * in document order.
+		 */
+		class AuthorsKeeper
+		{
+			std::array<bool, 3> Seen_ {};
+		public:
+			void Note (const QDomElement& child)
+			{
+				for (size_t i = 0; i < Seen_.size (); ++i)
+					if (!Seen_ [i] && !Find (child, i).isNull ())
+						Seen_ [i] = true;
+			}
+
+			void Keep (QDomElement& parent, const QDomElement& child)
+			{
+				QDomElement holder;
+				for (size_t i = 0; i < Seen_.size (); ++i)
+				{
+					if (Seen_ [i])
+						continue;
+
+					const auto& found = Find (child, i);
+					if (found.isNull ())
+						continue;
+
+					if (holder.isNull ())
+					{
+						holder = parent.ownerDocument ().createElement ("lc_streamed_authors"_qs);
+						parent.appendChild (holder);
+					}
+					holder.appendChild (found.cloneNode (true));
+					Seen_ [i] = true;
+				}
+			}
+		private:
+			static QDomElement Find (const QDomElement& elem, size_t kind)
+			{
+				const auto matches = [&] (const QDomElement& candidate)
+				{
+					switch (kind)
+					{
+					case 0:
+						return candidate.namespaceURI () == NS::ITunes && candidate.localName () == "author"_ql;
+					case 1:
+						return candidate.namespaceURI () == NS::DC && candidate.localName () == "creator"_ql;
+					default:
+						return candidate.tagName () == "author"_ql;
+					}
+				};
+				if (matches (elem))
+					return elem;
+
+				const auto& nodes = kind == 0 ?
+						elem.elementsByTagNameNS (NS::ITunes, "author"_qs) :
+						kind == 1 ?
+							elem.elementsByTagNameNS (NS::DC, "creator"_qs) :
+							elem.elementsByTagName ("author"_qs);
+				return nodes.isEmpty () ? QDomElement {} : nodes.at (0).toElement ();
+			}
+		};
+	}
+
+	void ReadStreamedChildren (QXmlStreamReader& reader, QDomElement& parent, const QString& childName,
+			const std::function<bool (const QDomElement&)>& handler)
+	{
+		auto doc = parent.ownerDocument ();
+
+		AuthorsKeeper authors;
+		bool skipping = false;
+		while (reader.readNextStartElement ())
+		{
+			if (reader.name () != childName)
+			{
+				const auto& child = ReadElement (reader, doc);
+				authors.Note (child);
+				parent.appendChild (child);
+			}
+			else if (skipping)
+				reader.skipCurrentElement ();
+			else
+			{
+				const auto& child = ReadElement (reader, doc);
+				authors.Keep (parent, child);
+				skipping = !handler (child);
+			}
+		}
+	}
+}
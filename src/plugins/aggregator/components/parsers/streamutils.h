@@ -0,0 +1,55 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <QDomElement>
+
+class QXmlStreamReader;
+
+namespace LC::Aggregator
+{
+	struct Item;
+}
+
+namespace LC::Aggregator::Parsers
+{
+	/** @brief Passes a freshly parsed item further, returns false to skip the rest.
+	 */
+	using EmitItem_f = std::function<bool (Item&)>;
+
+	/** @brief Creates the element the reader is currently at, without any children.
+	 *
+	 * The element gets the same namespace URI, name and attributes as it
+	 * would get from QDomDocument::setContent() with namespace processing
+	 * enabled.
+	 */
+	QDomElement MakeElement (const QXmlStreamReader&, QDomDocument&);
+
+	/** @brief Reads the current element along with its whole subtree.
+	 *
+	 * The reader is expected to be at the start of the element and is
+	 * left at its end.
+	 */
+	QDomElement ReadElement (QXmlStreamReader&, QDomDocument&);
+
+	/** @brief Reads the children of the current element into the parent.
+	 *
+	 * The children whose local name is childName are passed to the handler
+	 * one by one instead of being added to the parent, so only one of them
+	 * is kept in memory at a time. Once the handler returns false, the
+	 * rest of them are skipped without being built at all.
+	 *
+	 * The elements GetAuthor() looks for are kept from the handled
+	 * children, so that GetAuthor() on the parent gives the same result
+	 * as on the whole element.
+	 */
+	void ReadStreamedChildren (QXmlStreamReader&, QDomElement& parent, const QString& childName,
+			const std::function<bool (const QDomElement&)>& handler);
+}
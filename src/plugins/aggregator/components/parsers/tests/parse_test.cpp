@@ -0,0 +1,401 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "parse_test.h"
+#include <QtTest>
+#include <QBuffer>
+#include <QDomDocument>
+#include <util/sll/either.h>
+#include <components/parsers/parse.h>
+
+namespace LC::Aggregator::Parsers
+{
+	namespace
+	{
+		const IDType_t FeedId = 1;
+
+		std::optional<channels_container_t> ParseDom (const QByteArray& data)
+		{
+			QDomDocument doc;
+			if (!doc.setContent (data, true))
+				return {};
+			return TryParse (doc, FeedId);
+		}
+
+		StreamParseResult_t ParseStream (QByteArray data, const ItemHandler_f& handler = {})
+		{
+			QBuffer buffer { &data };
+			buffer.open (QIODevice::ReadOnly);
+			return TryParseStream (buffer, FeedId, handler);
+		}
+
+		void CompareItems (const Item& item, const Item& ref)
+		{
+			QCOMPARE (item.Title_, ref.Title_);
+			QCOMPARE (item.Link_, ref.Link_);
+			QCOMPARE (item.Description_, ref.Description_);
+			QCOMPARE (item.Author_, ref.Author_);
+			QCOMPARE (item.Categories_, ref.Categories_);
+			QCOMPARE (item.Guid_, ref.Guid_);
+			QCOMPARE (item.PubDate_, ref.PubDate_);
+			QCOMPARE (item.NumComments_, ref.NumComments_);
+			QCOMPARE (item.CommentsLink_, ref.CommentsLink_);
+			QCOMPARE (item.CommentsPageLink_, ref.CommentsPageLink_);
+			QCOMPARE (item.Latitude_, ref.Latitude_);
+			QCOMPARE (item.Longitude_, ref.Longitude_);
+
+			QCOMPARE (item.Enclosures_.size (), ref.Enclosures_.size ());
+			for (int i = 0; i < item.Enclosures_.size (); ++i)
+			{
+				QCOMPARE (item.Enclosures_ [i].URL_, ref.Enclosures_ [i].URL_);
+				QCOMPARE (item.Enclosures_ [i].Type_, ref.Enclosures_ [i].Type_);
+				QCOMPARE (item.Enclosures_ [i].Length_, ref.Enclosures_ [i].Length_);
+				QCOMPARE (item.Enclosures_ [i].Lang_, ref.Enclosures_ [i].Lang_);
+			}
+
+			QCOMPARE (item.MRSSEntries_.size (), ref.MRSSEntries_.size ());
+			for (int i = 0; i < item.MRSSEntries_.size (); ++i)
+			{
+				const auto& entry = item.MRSSEntries_ [i];
+				const auto& refEntry = ref.MRSSEntries_ [i];
+				QCOMPARE (entry.URL_, refEntry.URL_);
+				QCOMPARE (entry.Type_, refEntry.Type_);
+				QCOMPARE (entry.Title_, refEntry.Title_);
+				QCOMPARE (entry.Description_, refEntry.Description_);
+				QCOMPARE (entry.Rating_, refEntry.Rating_);
+				QCOMPARE (entry.Thumbnails_.size (), refEntry.Thumbnails_.size ());
+				QCOMPARE (entry.Credits_.size (), refEntry.Credits_.size ());
+			}
+		}
+
+		void CompareChannels (const channels_container_t& channels, const channels_container_t& ref)
+		{
+			QCOMPARE (channels.size (), ref.size ());
+			for (size_t i = 0; i < channels.size (); ++i)
+			{
+				const auto& chan = *channels [i];
+				const auto& refChan = *ref [i];
+				QCOMPARE (chan.Title_, refChan.Title_);
+				QCOMPARE (chan.Link_, refChan.Link_);
+				QCOMPARE (chan.Description_, refChan.Description_);
+				QCOMPARE (chan.Author_, refChan.Author_);
+				QCOMPARE (chan.Language_, refChan.Language_);
+				QCOMPARE (chan.LastBuild_, refChan.LastBuild_);
+				QCOMPARE (chan.PixmapURL_, refChan.PixmapURL_);
+
+				QCOMPARE (chan.Items_.size (), refChan.Items_.size ());
+				for (int j = 0; j < chan.Items_.size (); ++j)
+				{
+					QCOMPARE (chan.Items_ [j]->ChannelID_, chan.ChannelID_);
+					CompareItems (*chan.Items_ [j], *refChan.Items_ [j]);
+				}
+			}
+		}
+
+		const QByteArray Rss20Podcast = R"(<?xml version="1.0" encoding="UTF-8"?>
+<rss version="2.0"
+		xmlns:itunes="http://www.itunes.com/dtds/podcast-1.0.dtd"
+		xmlns:media="http://search.yahoo.com/mrss/"
+		xmlns:dc="http://purl.org/dc/elements/1.1/"
+		xmlns:content="http://purl.org/rss/1.0/modules/content/"
+		xmlns:slash="http://purl.org/rss/1.0/modules/slash/"
+		xmlns:wfw="http://wellformedweb.org/CommentAPI/"
+		xmlns:georss="http://www.georss.org/georss"
+		xmlns:atom="http://www.w3.org/2005/Atom">
+	<channel>
+		<title>  Some podcast  </title>
+		<atom:link href="http://example.org/feed.xml" rel="self" type="application/rss+xml"/>
+		<link>http://example.org/</link>
+		<description>A <![CDATA[<b>podcast</b>]]> about things</description>
+		<language>en</language>
+		<image><url>http://example.org/logo.png</url></image>
+		<item>
+			<title>  First
+				episode </title>
+			<link>http://example.org/1</link>
+			<guid>ep-1</guid>
+			<pubDate>Mon, 05 Oct 2020 10:00:00 +0000</pubDate>
+			<description>Short one</description>
+			<content:encoded><![CDATA[<p>The <i>long</i> description &amp; more</p>]]></content:encoded>
+			<itunes:author>The Host</itunes:author>
+			<itunes:duration>01:02:03</itunes:duration>
+			<itunes:keywords>tech</itunes:keywords>
+			<category>news</category>
+			<dc:subject>science</dc:subject>
+			<slash:comments>12</slash:comments>
+			<wfw:commentRss>http://example.org/1/comments.xml</wfw:commentRss>
+			<comments>http://example.org/1#comments</comments>
+			<georss:point>45.5 -122.6</georss:point>
+			<enclosure url="http://example.org/1.mp3" length="12345" type="audio/mpeg"/>
+			<media:group>
+				<media:title>Group title</media:title>
+				<media:content url="http://example.org/1.ogg" type="audio/ogg" fileSize="100">
+					<media:thumbnail url="http://example.org/1.jpg" width="10" height="20"/>
+				</media:content>
+			</media:group>
+			<media:content url="http://example.org/1-hq.mp3" type="audio/mpeg">
+				<media:credit role="host">Someone</media:credit>
+				<media:rating scheme="urn:simple">nonadult</media:rating>
+			</media:content>
+		</item>
+		<item>
+			<title>Second &amp;quot;episode&amp;quot;</title>
+			<link>http://example.org/2</link>
+			<pubDate>Tue, 06 Oct 2020 10:00:00 +0000</pubDate>
+			<description>Another one</description>
+			<dc:creator>Guest</dc:creator>
+		</item>
+		<lastBuildDate>Wed, 07 Oct 2020 10:00:00 +0000</lastBuildDate>
+	</channel>
+</rss>
+)";
+
+		const QByteArray Rss20NoBuildDate = R"(<?xml version="1.0"?>
+<rss version="2.0">
+	<channel>
+		<title>No build date</title>
+		<item>
+			<title>Only</title>
+			<link>http://example.org/only</link>
+			<author>someone@example.org</author>
+			<pubDate>Mon, 05 Oct 2020 10:00:00 +0000</pubDate>
+		</item>
+		<webMaster>webmaster@example.org</webMaster>
+	</channel>
+</rss>
+)";
+
+		const QByteArray Rss091 = R"(<?xml version="1.0"?>
+<rss version="0.91">
+	<channel>
+		<title>Old school</title>
+		<link>http://example.org/</link>
+		<description>RSS 0.91</description>
+		<managingEditor>editor@example.org</managingEditor>
+		<lastBuildDate>Mon, 05 Oct 2020 10:00:00 +0000</lastBuildDate>
+		<item>
+			<title>Item</title>
+			<link>http://example.org/item</link>
+			<description>Text &amp;euro; text</description>
+		</item>
+	</channel>
+</rss>
+)";
+
+		const QByteArray Rss10 = R"(<?xml version="1.0"?>
+<rdf:RDF
+		xmlns:rdf="http://www.w3.org/1999/02/22-rdf-syntax-ns#"
+		xmlns:dc="http://purl.org/dc/elements/1.1/"
+		xmlns="http://purl.org/rss/1.0/">
+	<channel rdf:about="http://example.org/">
+		<title>RDF channel</title>
+		<link>http://example.org/</link>
+		<description>RSS 1.0</description>
+		<dc:date>2020-10-05T10:00:00Z</dc:date>
+		<items>
+			<rdf:Seq>
+				<rdf:li resource="http://example.org/a"/>
+				<rdf:li resource="http://example.org/b"/>
+			</rdf:Seq>
+		</items>
+	</channel>
+	<item rdf:about="http://example.org/a">
+		<title>A</title>
+		<link>http://example.org/a</link>
+		<dc:date>2020-10-05T10:00:00Z</dc:date>
+	</item>
+	<item rdf:about="http://example.org/unlisted">
+		<title>Unlisted</title>
+		<link>http://example.org/unlisted</link>
+	</item>
+	<item rdf:about="http://example.org/b">
+		<title>B</title>
+		<link>http://example.org/b</link>
+		<dc:date>2020-10-06T10:00:00Z</dc:date>
+	</item>
+</rdf:RDF>
+)";
+
+		const QByteArray Atom10 = R"(<?xml version="1.0" encoding="utf-8"?>
+<feed xmlns="http://www.w3.org/2005/Atom" xmlns:dc="http://purl.org/dc/elements/1.1/">
+	<title>Atom feed</title>
+	<subtitle>Subtitle</subtitle>
+	<link href="http://example.org/feed" rel="self"/>
+	<link href="http://example.org/"/>
+	<updated>2020-10-05T10:00:00Z</updated>
+	<id>urn:uuid:60a76c80-d399-11d9-b93C-0003939e0af6</id>
+	<entry>
+		<title type="html">Entry &amp;lt;one&amp;gt;</title>
+		<link href="http://example.org/1"/>
+		<link rel="enclosure" href="http://example.org/1.mp3" type="audio/mpeg" length="42" hreflang="en"/>
+		<id>urn:uuid:1</id>
+		<updated>2020-10-05T10:00:00.123Z</updated>
+		<author><name>Entry Author</name><email>author@example.org</email></author>
+		<summary>Summary</summary>
+		<content type="html">Some &lt;b&gt;content&lt;/b&gt; which is longer</content>
+		<category term="cat"/>
+	</entry>
+	<entry>
+		<title>Entry two</title>
+		<link href="http://example.org/2"/>
+		<id>urn:uuid:2</id>
+		<updated>2020-10-06T10:00:00Z</updated>
+		<dc:creator>Creator</dc:creator>
+	</entry>
+</feed>
+)";
+
+		const QByteArray Atom03 = R"(<?xml version="1.0" encoding="utf-8"?>
+<feed version="0.3" xmlns="http://purl.org/atom/ns#">
+	<title>Atom 0.3 feed</title>
+	<tagline>Tagline</tagline>
+	<link rel="alternate" type="text/html" href="http://example.org/"/>
+	<modified>2020-10-05T10:00:00Z</modified>
+	<author><name>Feed Author</name></author>
+	<entry>
+		<title mode="escaped" type="text/html">Escaped &amp;amp; title</title>
+		<link rel="alternate" type="text/html" href="http://example.org/1"/>
+		<id>tag:example.org,2020:1</id>
+		<issued>2020-10-05T10:00:00Z</issued>
+		<modified>2020-10-05T11:00:00Z</modified>
+		<content type="text/html" mode="escaped">Content</content>
+	</entry>
+</feed>
+)";
+
+		QByteArray MakeLargeFeed (int itemsCount)
+		{
+			QByteArray result = R"(<?xml version="1.0" encoding="UTF-8"?>
+<rss version="2.0" xmlns:itunes="http://www.itunes.com/dtds/podcast-1.0.dtd" xmlns:media="http://search.yahoo.com/mrss/">
+	<channel>
+		<title>Large podcast</title>
+		<link>http://example.org/</link>
+		<description>Large podcast</description>
+)";
+
+			const auto& descr = QByteArray { "Lorem ipsum dolor sit amet, consectetur adipiscing elit. " }.repeated (20);
+			const auto& date = QDateTime { QDate { 2020, 10, 5 }, QTime { 10, 0 }, Qt::UTC };
+			for (int i = 0; i < itemsCount; ++i)
+			{
+				const auto& num = QByteArray::number (i);
+				result += "<item><title>Episode " + num + "</title>"
+						"<link>http://example.org/" + num + "</link>"
+						"<guid>ep-" + num + "</guid>"
+						"<pubDate>" + date.addSecs (-3600 * i).toString (Qt::RFC2822Date).toUtf8 () + "</pubDate>"
+						"<description><![CDATA[<p>" + descr + "</p>]]></description>"
+						"<itunes:duration>00:42:00</itunes:duration>"
+						"<enclosure url=\"http://example.org/" + num + ".mp3\" length=\"40000000\" type=\"audio/mpeg\"/>"
+						"<media:content url=\"http://example.org/" + num + ".ogg\" type=\"audio/ogg\"/>"
+						"</item>\n";
+			}
+
+			result += "</channel></rss>";
+			return result;
+		}
+
+		int GetLargeFeedItemsCount ()
+		{
+			bool ok = false;
+			const auto count = qEnvironmentVariableIntValue ("LC_AGGREGATOR_BENCH_ITEMS", &ok);
+			return ok ? count : 10000;
+		}
+	}
+
+	void ParseTest::testStreamSameAsDom_data ()
+	{
+		QTest::addColumn<QByteArray> ("feed");
+
+		QTest::newRow ("rss 2.0 podcast") << Rss20Podcast;
+		QTest::newRow ("rss 2.0 without build date") << Rss20NoBuildDate;
+		QTest::newRow ("rss 0.91") << Rss091;
+		QTest::newRow ("rss 1.0") << Rss10;
+		QTest::newRow ("atom 1.0") << Atom10;
+		QTest::newRow ("atom 0.3") << Atom03;
+		QTest::newRow ("large") << MakeLargeFeed (100);
+	}
+
+	void ParseTest::testStreamSameAsDom ()
+	{
+		QFETCH (QByteArray, feed);
+
+		const auto& dom = ParseDom (feed);
+		QVERIFY (dom);
+		QVERIFY (!dom->empty ());
+
+		QVector<QString> handledTitles;
+		const auto& stream = ParseStream (feed,
+				[&] (const Item& item)
+				{
+					handledTitles << item.Title_;
+					return true;
+				});
+		QVERIFY (stream.IsRight ());
+
+		CompareChannels (stream.GetRight (), *dom);
+
+		QVector<QString> parsedTitles;
+		for (const auto& chan : stream.GetRight ())
+			for (const auto& item : chan->Items_)
+				parsedTitles << item->Title_;
+		QCOMPARE (handledTitles, parsedTitles);
+	}
+
+	void ParseTest::testStreamStopsEarly ()
+	{
+		int handled = 0;
+		const auto& stream = ParseStream (MakeLargeFeed (100),
+				[&] (const Item&) { return ++handled < 3; });
+		QVERIFY (stream.IsRight ());
+		QCOMPARE (handled, 3);
+
+		const auto& channels = stream.GetRight ();
+		QCOMPARE (channels.size (), size_t { 1 });
+		QCOMPARE (channels [0]->Items_.size (), 3);
+		QCOMPARE (channels [0]->Title_, QString { "Large podcast" });
+	}
+
+	void ParseTest::testStreamXmlError ()
+	{
+		auto feed = Rss20Podcast;
+		feed.replace ("</channel>", "</chanel>");
+
+		const auto& stream = ParseStream (feed);
+		QVERIFY (stream.IsLeft ());
+		QVERIFY (std::holds_alternative<XmlError> (stream.GetLeft ()));
+
+		const auto& unknown = ParseStream (R"(<?xml version="1.0"?><html><body/></html>)");
+		QVERIFY (unknown.IsLeft ());
+		QVERIFY (std::holds_alternative<UnknownFormat> (unknown.GetLeft ()));
+	}
+
+	void ParseTest::benchLargeFeed_data ()
+	{
+		QTest::addColumn<bool> ("stream");
+
+		QTest::newRow ("dom") << false;
+		QTest::newRow ("stream") << true;
+	}
+
+	/* Set LC_AGGREGATOR_BENCH_ITEMS to change the number of items in the
+	 * generated feed, 10000 by default (about 20 MiB).
+	 */
+	void ParseTest::benchLargeFeed ()
+	{
+		QFETCH (bool, stream);
+
+		const auto& feed = MakeLargeFeed (GetLargeFeedItemsCount ());
+
+		QBENCHMARK
+		{
+			if (stream)
+				QVERIFY (ParseStream (feed).IsRight ());
+			else
+				QVERIFY (ParseDom (feed));
+		}
+	}
+}
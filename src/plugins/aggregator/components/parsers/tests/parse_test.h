@@ -0,0 +1,30 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <QObject>
+
+namespace LC::Aggregator::Parsers
+{
+	class Q_DECL_EXPORT ParseTest : public QObject
+	{
+		Q_OBJECT
+	private slots:
+		void testStreamSameAsDom_data ();
+		void testStreamSameAsDom ();
+
+		void testStreamStopsEarly ();
+		void testStreamXmlError ();
+
+		void benchLargeFeed_data ();
+		void benchLargeFeed ();
+	};
+}
+
+using TheTestObject = LC::Aggregator::Parsers::ParseTest;
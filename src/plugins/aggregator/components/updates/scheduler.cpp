@@ -0,0 +1,192 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "scheduler.h"
+#include <QtDebug>
+
+namespace LC::Aggregator
+{
+	namespace
+	{
+		constexpr qint64 HostBackoffBase = 30;
+		constexpr qint64 HostBackoffMax = 30 * 60;
+
+		constexpr qint64 FeedBackoffBase = 30 * 60;
+		constexpr qint64 FeedBackoffMax = 24 * 60 * 60;
+
+		bool IsAfter (const QDateTime& backoffEnd, const QDateTime& now)
+		{
+			return backoffEnd.isValid () && backoffEnd > now;
+		}
+
+		QDateTime GetBackoffEnd (const QDateTime& now, int failures, qint64 base, qint64 max)
+		{
+			const auto shift = std::min (failures - 1, 20);
+			return now.addSecs (std::min (base << shift, max));
+		}
+	}
+
+	UpdatesScheduler::UpdatesScheduler (Limits limits)
+	: Limits_ { limits }
+	{
+	}
+
+	void UpdatesScheduler::SetLimits (Limits limits)
+	{
+		Limits_ = limits;
+	}
+
+	bool UpdatesScheduler::Enqueue (IDType_t feedId, const QString& host, const QDateTime& now, BackoffPolicy policy)
+	{
+		if (Queued_.contains (feedId) || InFlight_.contains (feedId))
+			return false;
+
+		if (policy == BackoffPolicy::Respect)
+		{
+			const auto feedState = Feeds_.constFind (feedId);
+			if (feedState != Feeds_.constEnd () && IsAfter (feedState->SkipUntil_, now))
+				return false;
+		}
+
+		auto& hostState = Hosts_ [host];
+		if (hostState.Queue_.isEmpty ())
+			HostsOrder_ << host;
+		hostState.Queue_.enqueue (feedId);
+
+		Queued_ [feedId] = host;
+		return true;
+	}
+
+	QList<IDType_t> UpdatesScheduler::TakeReady (const QDateTime& now)
+	{
+		QList<IDType_t> result;
+
+		// the number of hosts visited in a row without taking anything from them
+		int idleHosts = 0;
+		while (InFlight_.size () < Limits_.Total_ &&
+				idleHosts < HostsOrder_.size ())
+		{
+			NextHostIdx_ %= HostsOrder_.size ();
+			const auto hostIdx = NextHostIdx_++;
+
+			const auto& hostName = HostsOrder_ [hostIdx];
+			auto& host = Hosts_ [hostName];
+			if (host.InFlight_ >= GetHostLimit (host) ||
+					IsAfter (host.BlockedUntil_, now))
+			{
+				++idleHosts;
+				continue;
+			}
+
+			idleHosts = 0;
+
+			const auto feedId = host.Queue_.dequeue ();
+			Queued_.remove (feedId);
+			InFlight_ [feedId] = hostName;
+			++host.InFlight_;
+			result << feedId;
+
+			if (host.Queue_.isEmpty ())
+			{
+				HostsOrder_.removeAt (hostIdx);
+				NextHostIdx_ = hostIdx;
+			}
+		}
+
+		return result;
+	}
+
+	void UpdatesScheduler::Finish (IDType_t feedId, Outcome outcome, const QDateTime& now)
+	{
+		const auto inFlightPos = InFlight_.find (feedId);
+		if (inFlightPos == InFlight_.end ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "feed"
+					<< feedId
+					<< "is not being fetched";
+			return;
+		}
+
+		const auto hostName = *inFlightPos;
+		InFlight_.erase (inFlightPos);
+
+		auto& host = Hosts_ [hostName];
+		--host.InFlight_;
+
+		switch (outcome)
+		{
+		case Outcome::Success:
+			host.Failures_ = 0;
+			host.BlockedUntil_ = {};
+			Feeds_.remove (feedId);
+			break;
+		case Outcome::FeedError:
+		{
+			host.Failures_ = 0;
+			host.BlockedUntil_ = {};
+
+			auto& feed = Feeds_ [feedId];
+			feed.SkipUntil_ = GetBackoffEnd (now, ++feed.Failures_, FeedBackoffBase, FeedBackoffMax);
+			break;
+		}
+		case Outcome::HostError:
+		{
+			host.BlockedUntil_ = GetBackoffEnd (now, ++host.Failures_, HostBackoffBase, HostBackoffMax);
+
+			auto& feed = Feeds_ [feedId];
+			feed.SkipUntil_ = GetBackoffEnd (now, ++feed.Failures_, FeedBackoffBase, FeedBackoffMax);
+			break;
+		}
+		}
+
+		DropIdleHost (hostName);
+	}
+
+	std::optional<QDateTime> UpdatesScheduler::GetNextWakeup (const QDateTime& now) const
+	{
+		std::optional<QDateTime> result;
+		for (const auto& hostName : HostsOrder_)
+		{
+			const auto& blockedUntil = Hosts_.constFind (hostName)->BlockedUntil_;
+			if (IsAfter (blockedUntil, now) && (!result || blockedUntil < *result))
+				result = blockedUntil;
+		}
+		return result;
+	}
+
+	int UpdatesScheduler::GetQueueDepth () const
+	{
+		return Queued_.size ();
+	}
+
+	int UpdatesScheduler::GetInFlightCount () const
+	{
+		return InFlight_.size ();
+	}
+
+	bool UpdatesScheduler::IsIdle () const
+	{
+		return Queued_.isEmpty () && InFlight_.isEmpty ();
+	}
+
+	int UpdatesScheduler::GetHostLimit (const HostState& host) const
+	{
+		return host.Failures_ ? 1 : Limits_.PerHost_;
+	}
+
+	void UpdatesScheduler::DropIdleHost (const QString& hostName)
+	{
+		const auto pos = Hosts_.find (hostName);
+		if (pos != Hosts_.end () &&
+				pos->Queue_.isEmpty () &&
+				!pos->InFlight_ &&
+				!pos->Failures_)
+			Hosts_.erase (pos);
+	}
+}
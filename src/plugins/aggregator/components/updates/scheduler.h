@@ -0,0 +1,123 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <optional>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QQueue>
+#include <QString>
+#include "common.h"
+
+namespace LC::Aggregator
+{
+	/** @brief Decides which feeds to fetch next.
+	 *
+	 * The scheduler keeps a queue of feeds per host and releases them
+	 * round-robin across hosts, so that no more than Limits::Total_ feeds
+	 * are fetched at once, and no more than Limits::PerHost_ of them from
+	 * the same host.
+	 *
+	 * Failed fetches are backed off: a host-level failure (like a network
+	 * or a server error) blocks the host for exponentially increasing
+	 * intervals and limits it to a single fetch at a time until it
+	 * succeeds again, while a feed-level failure (like a parse error)
+	 * makes the feed skip periodic updates for exponentially increasing
+	 * intervals.
+	 *
+	 * The scheduler does no I/O itself and takes the current time as a
+	 * parameter.
+	 */
+	class Q_DECL_EXPORT UpdatesScheduler
+	{
+	public:
+		struct Limits
+		{
+			int Total_;
+			int PerHost_;
+		};
+
+		enum class Outcome
+		{
+			Success,
+			FeedError,
+			HostError
+		};
+	private:
+		struct HostState
+		{
+			QQueue<IDType_t> Queue_;
+			int InFlight_ = 0;
+			int Failures_ = 0;
+			QDateTime BlockedUntil_;
+		};
+
+		struct FeedState
+		{
+			int Failures_ = 0;
+			QDateTime SkipUntil_;
+		};
+
+		Limits Limits_;
+
+		QHash<QString, HostState> Hosts_;
+		QList<QString> HostsOrder_;
+		int NextHostIdx_ = 0;
+
+		QHash<IDType_t, QString> Queued_;
+		QHash<IDType_t, QString> InFlight_;
+		QHash<IDType_t, FeedState> Feeds_;
+	public:
+		explicit UpdatesScheduler (Limits);
+
+		void SetLimits (Limits);
+
+		/** @brief Whether the periodic updates should respect feed backoff.
+		 */
+		enum class BackoffPolicy
+		{
+			Respect,
+			Ignore
+		};
+
+		/** @brief Adds the feed to the queue of the given host.
+		 *
+		 * @return false if the feed is already queued or being fetched, or
+		 * if it is backed off and the policy is BackoffPolicy::Respect.
+		 */
+		bool Enqueue (IDType_t feedId, const QString& host, const QDateTime& now, BackoffPolicy);
+
+		/** @brief Returns the feeds that should be fetched right now.
+		 *
+		 * The returned feeds are considered to be in flight until
+		 * Finish() is called for them.
+		 */
+		QList<IDType_t> TakeReady (const QDateTime& now);
+
+		void Finish (IDType_t feedId, Outcome, const QDateTime& now);
+
+		/** @brief Returns when TakeReady() may return something again.
+		 *
+		 * This is the earliest time a currently blocked host having
+		 * queued feeds is unblocked, or an empty optional if there is no
+		 * such host. Otherwise, TakeReady() only needs to be called again
+		 * after Finish() or Enqueue().
+		 */
+		std::optional<QDateTime> GetNextWakeup (const QDateTime& now) const;
+
+		int GetQueueDepth () const;
+		int GetInFlightCount () const;
+
+		bool IsIdle () const;
+	private:
+		int GetHostLimit (const HostState&) const;
+		void DropIdleHost (const QString&);
+	};
+}
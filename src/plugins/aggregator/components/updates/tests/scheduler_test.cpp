@@ -0,0 +1,135 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "scheduler_test.h"
+#include <QtTest>
+#include <components/updates/scheduler.h>
+
+namespace LC::Aggregator
+{
+	namespace
+	{
+		const QDateTime Now { QDate { 2020, 10, 5 }, QTime { 10, 0 }, Qt::UTC };
+
+		using Policy = UpdatesScheduler::BackoffPolicy;
+		using Outcome = UpdatesScheduler::Outcome;
+	}
+
+	void SchedulerTest::testLimits ()
+	{
+		UpdatesScheduler sched { { .Total_ = 3, .PerHost_ = 2 } };
+		for (IDType_t id = 0; id < 4; ++id)
+			sched.Enqueue (id, "a.org", Now, Policy::Respect);
+		for (IDType_t id = 10; id < 14; ++id)
+			sched.Enqueue (id, "b.org", Now, Policy::Respect);
+
+		auto ready = sched.TakeReady (Now);
+		QCOMPARE (ready.size (), 3);
+		QCOMPARE (sched.GetInFlightCount (), 3);
+		QCOMPARE (sched.GetQueueDepth (), 5);
+
+		QVERIFY (sched.TakeReady (Now).isEmpty ());
+
+		sched.Finish (ready [0], Outcome::Success, Now);
+		QCOMPARE (sched.TakeReady (Now).size (), 1);
+
+		// per-host cap: only a.org feeds are left
+		UpdatesScheduler single { { .Total_ = 10, .PerHost_ = 2 } };
+		for (IDType_t id = 0; id < 5; ++id)
+			single.Enqueue (id, "a.org", Now, Policy::Respect);
+		QCOMPARE (single.TakeReady (Now), (QList<IDType_t> { 0, 1 }));
+		QVERIFY (single.TakeReady (Now).isEmpty ());
+		single.Finish (1, Outcome::Success, Now);
+		QCOMPARE (single.TakeReady (Now), (QList<IDType_t> { 2 }));
+	}
+
+	void SchedulerTest::testHostsRoundRobin ()
+	{
+		UpdatesScheduler sched { { .Total_ = 3, .PerHost_ = 10 } };
+		for (IDType_t id = 0; id < 10; ++id)
+			sched.Enqueue (id, "big.org", Now, Policy::Respect);
+		sched.Enqueue (100, "small1.org", Now, Policy::Respect);
+		sched.Enqueue (200, "small2.org", Now, Policy::Respect);
+
+		auto ready = sched.TakeReady (Now);
+		std::sort (ready.begin (), ready.end ());
+		QCOMPARE (ready, (QList<IDType_t> { 0, 100, 200 }));
+
+		for (auto id : ready)
+			sched.Finish (id, Outcome::Success, Now);
+
+		QCOMPARE (sched.TakeReady (Now), (QList<IDType_t> { 1, 2, 3 }));
+	}
+
+	void SchedulerTest::testNoDuplicates ()
+	{
+		UpdatesScheduler sched { { .Total_ = 1, .PerHost_ = 1 } };
+		QVERIFY (sched.Enqueue (1, "a.org", Now, Policy::Respect));
+		QVERIFY (!sched.Enqueue (1, "a.org", Now, Policy::Ignore));
+		QCOMPARE (sched.TakeReady (Now), (QList<IDType_t> { 1 }));
+		QVERIFY (!sched.Enqueue (1, "a.org", Now, Policy::Ignore));
+
+		sched.Finish (1, Outcome::Success, Now);
+		QVERIFY (sched.IsIdle ());
+		QVERIFY (sched.Enqueue (1, "a.org", Now, Policy::Respect));
+	}
+
+	void SchedulerTest::testHostBackoff ()
+	{
+		UpdatesScheduler sched { { .Total_ = 10, .PerHost_ = 5 } };
+		for (IDType_t id = 0; id < 10; ++id)
+			sched.Enqueue (id, "flaky.org", Now, Policy::Respect);
+		sched.Enqueue (100, "good.org", Now, Policy::Respect);
+
+		const auto& ready = sched.TakeReady (Now);
+		QCOMPARE (ready.size (), 6);
+		QVERIFY (ready.contains (100));
+
+		sched.Finish (0, Outcome::HostError, Now);
+
+		const auto wakeup = sched.GetNextWakeup (Now);
+		QVERIFY (wakeup);
+		QVERIFY (*wakeup > Now);
+
+		// blocked until the backoff expires, even though there's room
+		for (auto id : ready)
+			if (id != 0)
+				sched.Finish (id, id == 100 ? Outcome::Success : Outcome::HostError, Now);
+		QVERIFY (sched.TakeReady (Now).isEmpty ());
+
+		// after the backoff the host is limited to a single fetch at a time
+		const auto later = Now.addDays (1);
+		QVERIFY (!sched.GetNextWakeup (later));
+		QCOMPARE (sched.TakeReady (later).size (), 1);
+		QVERIFY (sched.TakeReady (later).isEmpty ());
+	}
+
+	void SchedulerTest::testFeedBackoff ()
+	{
+		UpdatesScheduler sched { { .Total_ = 10, .PerHost_ = 5 } };
+		sched.Enqueue (1, "a.org", Now, Policy::Respect);
+		QCOMPARE (sched.TakeReady (Now), (QList<IDType_t> { 1 }));
+		sched.Finish (1, Outcome::FeedError, Now);
+
+		QVERIFY (!sched.Enqueue (1, "a.org", Now, Policy::Respect));
+		QVERIFY (sched.Enqueue (1, "a.org", Now, Policy::Ignore));
+		QCOMPARE (sched.TakeReady (Now), (QList<IDType_t> { 1 }));
+		sched.Finish (1, Outcome::FeedError, Now);
+
+		// the second failure backs off for longer than the first one
+		const auto firstBackoffEnd = Now.addSecs (30 * 60);
+		QVERIFY (!sched.Enqueue (1, "a.org", firstBackoffEnd.addSecs (1), Policy::Respect));
+
+		const auto later = Now.addDays (2);
+		QVERIFY (sched.Enqueue (1, "a.org", later, Policy::Respect));
+		QCOMPARE (sched.TakeReady (later), (QList<IDType_t> { 1 }));
+		sched.Finish (1, Outcome::Success, later);
+
+		QVERIFY (sched.Enqueue (1, "a.org", later, Policy::Respect));
+	}
+}
@@ -0,0 +1,27 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <QObject>
+
+namespace LC::Aggregator
+{
+	class Q_DECL_EXPORT SchedulerTest : public QObject
+	{
+		Q_OBJECT
+	private slots:
+		void testLimits ();
+		void testHostsRoundRobin ();
+		void testNoDuplicates ();
+		void testHostBackoff ();
+		void testFeedBackoff ();
+	};
+}
+
+using TheTestObject = LC::Aggregator::SchedulerTest;
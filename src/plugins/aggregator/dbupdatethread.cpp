@@ -164,50 +164,14 @@ namespace LC::Aggregator
 			{
 				const auto& ourChannel = SB_->GetChannel (ourChannelId);
 
-				int newItems = 0;
-				int updatedItems = 0;
-
-				for (const auto& itemPtr : channel.Items_)
-				{
-					auto& item = *itemPtr;
-					if (const auto& ourItemId = FindOurItem (item, ourChannel.ChannelID_);
-						const auto& ourItem = SB_->GetItem (*ourItemId))
-					{
-						if (UpdateItem (item, *ourItem))
-							++updatedItems;
-					}
-					else
-					{
-						item.ChannelID_ = ourChannel.ChannelID_;
-						AddItem (item, ourChannel);
-						++newItems;
-					}
-				}
-
-				SB_->TrimChannel (ourChannelId, FeedSettings_.ItemAge_, FeedSettings_.NumItems_);
-
-				NotifyUpdates (newItems, updatedItems, channel);
-			}
-
-			std::optional<IDType_t> FindOurItem (const Item& item, IDType_t channelId) const
-			{
-				if (const auto id = SB_->FindItem (item.Title_, item.Link_, channelId))
-					return id;
-				if (const auto id = SB_->FindItemByLink (item.Link_, channelId))
-					return id;
-
-				if (!item.Link_.isEmpty ())
-					return {};
-
-				return SB_->FindItemByTitle (item.Title_, channelId);
-			}
-
-			void AddItem (Item& item, const Channel& channel) const
-			{
-				SB_->AddItem (item);
+				const auto& [added, updatedCount] = SB_->MergeChannelSnapshot (ourChannelId, channel.Items_,
+						{ .ItemAge_ = FeedSettings_.ItemAge_, .NumItems_ = FeedSettings_.NumItems_ });
 
 				if (FeedSettings_.AutoDownloadEnclosures_)
-					DownloadEnclosures (item.Enclosures_, channel.Tags_);
+					for (const auto& item : added)
+						DownloadEnclosures (item.Enclosures_, ourChannel.Tags_);
+
+				NotifyUpdates (added.size (), updatedCount, channel);
 			}
 
 			void DownloadEnclosures (const QList<Enclosure>& enclosures, const QStringList& tags) const
@@ -222,42 +186,6 @@ namespace LC::Aggregator
 				}
 			}
 
-			bool UpdateItem (const Item& item, Item ourItem) const
-			{
-				if (!IsModified (ourItem, item))
-					return false;
-
-				static const bool debugDiffs = qgetenv ("LC_AGGREGATOR_DUMP_DIFFS") == "1";
-				if (debugDiffs)
-					Diff (ourItem, item);
-
-				ourItem.Description_ = item.Description_;
-				ourItem.Categories_ = item.Categories_;
-				ourItem.NumComments_ = item.NumComments_;
-				ourItem.CommentsLink_ = item.CommentsLink_;
-				ourItem.CommentsPageLink_ = item.CommentsPageLink_;
-				ourItem.Latitude_ = item.Latitude_;
-				ourItem.Longitude_ = item.Longitude_;
-
-				for (auto enc : item.Enclosures_)
-					if (!ourItem.Enclosures_.contains (enc))
-					{
-						enc.ItemID_ = ourItem.ItemID_;
-						ourItem.Enclosures_ << enc;
-					}
-
-				for (auto entry : item.MRSSEntries_)
-					if (!ourItem.MRSSEntries_.contains (entry))
-					{
-						entry.ItemID_ = ourItem.ItemID_;
-						ourItem.MRSSEntries_ << entry;
-					}
-
-				SB_->UpdateItem (ourItem);
-
-				return true;
-			}
-
 			void NotifyUpdates (int newItems, int updatedItems, const Channel& channel) const
 			{
 				const auto& method = XmlSettingsManager::Instance ().property ("NotificationsFeedUpdateBehavior").toString ();
@@ -26,6 +26,8 @@ namespace Aggregator
 		std::optional<QStringList> GetFeedTags (IDType_t) const override { return {}; }
 		void SetFeedTags (IDType_t, const QStringList&) override {}
 		void SetFeedURL (IDType_t, const QString&) override {}
+		std::optional<Feed::FetchState> GetFeedFetchState (IDType_t) const override { return {}; }
+		void SetFeedFetchState (const Feed::FetchState&) override {}
 		channels_shorts_t GetChannels (IDType_t) const override { return {}; }
 		Channel GetChannel (IDType_t) const override { return {}; }
 		std::optional<IDType_t> FindChannel (const QString&, const QString&, IDType_t) const override { return {}; }
@@ -38,6 +40,8 @@ namespace Aggregator
 		void SetChannelTitle (IDType_t, const QString&) override {}
 		void SetChannelLink (IDType_t, const QString&) override {}
 		items_shorts_t GetItems (IDType_t) const override { return {}; }
+		items_shorts_t GetItemsPage (IDType_t, const ItemsPageQuery&) const override { return {}; }
+		QSet<QString> GetItemsCategories (IDType_t) const override { return {}; }
 		int GetUnreadItemsCount (IDType_t) const override { return {}; }
 		int GetTotalItemsCount (IDType_t) const override { return {}; }
 		std::optional<Item> GetItem (IDType_t) const override { return {}; }
@@ -49,6 +53,7 @@ namespace Aggregator
 		void AddItem (const Item&) override {}
 		void UpdateItem (const Item&) override {}
 		void SetItemUnread (IDType_t, IDType_t, bool) override {}
+		MergeResult MergeChannelSnapshot (IDType_t, const items_container_t&, const TrimParams&) override { return {}; }
 		void RemoveItems (const QSet<IDType_t>&) override {}
 		void RemoveChannel (IDType_t) override {}
 		void RemoveFeed (IDType_t) override {}
@@ -25,7 +25,6 @@
 #include <util/sll/prelude.h>
 #include "channelsmodel.h"
 #include "storagebackendmanager.h"
-#include "itemutils.h"
 
 namespace LC
 {
@@ -471,7 +470,7 @@ namespace Aggregator
 					[&sb] (const QModelIndex& index)
 					{
 						const auto channelId = index.data (ChannelRoles::ChannelID).value<IDType_t> ();
-						return ItemUtils::GetCategories (sb->GetItems (channelId));
+						return sb->GetItemsCategories (channelId);
 					}).values ();
 		}
 	}
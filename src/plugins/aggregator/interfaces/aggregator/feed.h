@@ -67,6 +67,30 @@ namespace Aggregator
 			bool AutoDownloadEnclosures_ = false;
 		};
 
+		/** @brief Contains the state of the last successful fetch of a feed.
+		 *
+		 * This is used to issue conditional requests and to detect that
+		 * the feed contents haven't changed since they were last stored.
+		 */
+		struct FetchState
+		{
+			/** @brief ID of the corresponding feed.
+			 */
+			IDType_t FeedID_ = IDNotFound;
+
+			/** @brief The ETag header of the last response, if any.
+			 */
+			QString ETag_;
+
+			/** @brief The Last-Modified header of the last response, if any.
+			 */
+			QString LastModified_;
+
+			/** @brief The hash of the last response body.
+			 */
+			QByteArray ContentHash_;
+		};
+
 		IDType_t FeedID_;
 		QString URL_;
 		QDateTime LastUpdate_;
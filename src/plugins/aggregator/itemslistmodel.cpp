@@ -14,6 +14,7 @@
 #include <QtDebug>
 #include <interfaces/core/iiconthememanager.h>
 #include "components/parsers/utils.h"
+#include "itemutils.h"
 #include "storagebackendmanager.h"
 #include "tooltipbuilder.h"
 #include "xmlsettingsmanager.h"
@@ -66,9 +67,20 @@ namespace Aggregator
 		return CurrentItems_ [index.row ()];
 	}
 
-	const items_shorts_t& ItemsListModel::GetAllItems () const
+	QSet<QString> ItemsListModel::GetAllCategories () const
 	{
-		return CurrentItems_;
+		if (!Window_)
+			return ItemUtils::GetCategories (CurrentItems_);
+
+		QSet<QString> result;
+		for (auto channel : CurrentChannels_)
+			result += GetSB ()->GetItemsCategories (channel);
+		return result;
+	}
+
+	namespace
+	{
+		constexpr auto ItemsPageSize = 200;
 	}
 
 	void ItemsListModel::SetChannels (const QVector<IDType_t>& channels)
@@ -77,10 +89,10 @@ namespace Aggregator
 
 		CurrentChannels_ = channels;
 
-		CurrentItems_.clear ();
-
-		for (auto channel : channels)
-			CurrentItems_ += GetSB ()->GetItems (channel);
+		Window_.emplace ([this] (IDType_t channel, const StorageBackend::ItemsPageQuery& query)
+					{ return GetSB ()->GetItemsPage (channel, query); },
+				channels, UnreadOnly_, ItemsPageSize);
+		CurrentItems_ = Window_->FetchMore ();
 
 		endResetModel ();
 	}
@@ -89,6 +101,7 @@ namespace Aggregator
 	{
 		beginResetModel ();
 
+		Window_.reset ();
 		CurrentItems_.clear ();
 
 		const auto& sb = GetSB ();
@@ -99,8 +112,29 @@ namespace Aggregator
 		endResetModel ();
 	}
 
+	void ItemsListModel::SetUnreadOnly (bool unreadOnly)
+	{
+		if (UnreadOnly_ == unreadOnly)
+			return;
+
+		UnreadOnly_ = unreadOnly;
+		if (!Window_)
+			return;
+
+		// The read items that are already shown are left for the filter
+		// model to hide, while turning the mode off has to fetch the read
+		// items that have been skipped.
+		if (UnreadOnly_)
+			Window_->SetUnreadOnly ();
+		else
+			SetChannels (CurrentChannels_);
+	}
+
 	void ItemsListModel::RemoveItems (const QSet<IDType_t>& ids)
 	{
+		if (Window_)
+			Window_->RemoveItems (ids);
+
 		auto remainingCount = ids.size ();
 
 		for (auto i = CurrentItems_.begin (); i != CurrentItems_.end () && remainingCount; )
@@ -123,6 +157,9 @@ namespace Aggregator
 
 	void ItemsListModel::RemoveChannel (IDType_t channelId)
 	{
+		if (Window_)
+			Window_->RemoveChannels ({ channelId });
+
 		RemoveChunked ([channelId] (const ItemShort& item) { return item.ChannelID_ == channelId; });
 	}
 
@@ -135,6 +172,9 @@ namespace Aggregator
 		for (const auto& chan : sb->GetChannels (feedId))
 			channelIds << chan.ChannelID_;
 
+		if (Window_)
+			Window_->RemoveChannels (channelIds);
+
 		RemoveChunked ([&channelIds] (const ItemShort& item) { return channelIds.contains (item.ChannelID_); });
 	}
 
@@ -167,6 +207,12 @@ namespace Aggregator
 		// Item is new
 		if (pos == CurrentItems_.end ())
 		{
+			// Items that haven't been fetched yet will be fetched in order.
+			if (Window_ && Window_->Place (is) != ItemsWindow::Placement::Released)
+				return;
+			if (Window_ && UnreadOnly_ && !is.Unread_)
+				return;
+
 			int row = CurrentItems_.size ();
 			beginInsertRows ({}, row, row);
 			CurrentItems_.push_back (std::move (is));
@@ -341,6 +387,26 @@ namespace Aggregator
 		return parent.isValid () ? 0 : CurrentItems_.size ();
 	}
 
+	bool ItemsListModel::canFetchMore (const QModelIndex& parent) const
+	{
+		return !parent.isValid () && Window_ && Window_->CanFetchMore ();
+	}
+
+	void ItemsListModel::fetchMore (const QModelIndex& parent)
+	{
+		if (parent.isValid () || !Window_)
+			return;
+
+		auto page = Window_->FetchMore ();
+		if (page.isEmpty ())
+			return;
+
+		const auto rc = CurrentItems_.size ();
+		beginInsertRows ({}, rc, rc + page.size () - 1);
+		CurrentItems_ += page;
+		endInsertRows ();
+	}
+
 	StorageBackend_ptr ItemsListModel::GetSB () const
 	{
 		if (!SB_.hasLocalData ())
@@ -356,7 +422,11 @@ namespace Aggregator
 		const auto pos = std::find_if (CurrentItems_.begin (), CurrentItems_.end (),
 				[&itemId] (const ItemShort& itemShort) { return itemShort.ItemID_ == itemId; });
 		if (pos == CurrentItems_.end ())
+		{
+			if (Window_)
+				Window_->SetUnread (itemId, unread);
 			return;
+		}
 
 		pos->Unread_ = unread;
 
@@ -14,6 +14,7 @@
 #include <QIcon>
 #include <QThreadStorage>
 #include "interfaces/aggregator/iitemsmodel.h"
+#include "components/models/itemswindow.h"
 #include "item.h"
 #include "channel.h"
 #include "storagebackend.h"
@@ -34,6 +35,9 @@ namespace Aggregator
 		QVector<IDType_t> CurrentChannels_;
 		items_shorts_t CurrentItems_;
 
+		std::optional<ItemsWindow> Window_;
+		bool UnreadOnly_ = false;
+
 		const QIcon StarredIcon_;
 		const QIcon UnreadIcon_;
 		const QIcon ReadIcon_;
@@ -45,9 +49,10 @@ namespace Aggregator
 		QAbstractItemModel& GetQModel () override;
 
 		const ItemShort& GetItem (const QModelIndex&) const;
-		const items_shorts_t& GetAllItems () const;
+		QSet<QString> GetAllCategories () const;
 		void SetChannels (const QVector<IDType_t>&) override;
 		void SetItems (const QList<IDType_t>&);
+		void SetUnreadOnly (bool);
 		void ItemDataUpdated (const Item&);
 
 		int columnCount (const QModelIndex& = QModelIndex ()) const override;
@@ -57,6 +62,8 @@ namespace Aggregator
 		QModelIndex index (int, int, const QModelIndex& = QModelIndex()) const override;
 		QModelIndex parent (const QModelIndex&) const override;
 		int rowCount (const QModelIndex& = QModelIndex ()) const override;
+		bool canFetchMore (const QModelIndex&) const override;
+		void fetchMore (const QModelIndex&) override;
 	private:
 		void RemoveItems (const QSet<IDType_t>&);
 		void RemoveChannel (IDType_t);
@@ -38,7 +38,6 @@
 #include "itemslistmodel.h"
 #include "channelsmodel.h"
 #include "storagebackendmanager.h"
-#include "itemutils.h"
 
 namespace LC::Aggregator
 {
@@ -92,7 +91,11 @@ namespace LC::Aggregator
 			.Parent_ = this,
 			.ShortcutsMgr_ = deps.ShortcutsMgr_,
 			.UpdatesManager_ = deps.UpdatesManager_,
-			.SetHideRead_ = [this] (bool hide) { Impl_->ItemsFilterModel_->SetHideRead (hide); },
+			.SetHideRead_ = [this] (bool hide)
+			{
+				Impl_->ItemsModel_->SetUnreadOnly (hide);
+				Impl_->ItemsFilterModel_->SetHideRead (hide);
+			},
 			.SetShowTape_ = [this] (bool tape) { SetTapeMode (tape); },
 			.GetSelection_ = [this] { return Impl_->Ui_.Items_->selectionModel ()->selectedRows (); },
 			.ItemNavigator_ = ItemNavigator
@@ -121,6 +124,7 @@ namespace LC::Aggregator
 
 		const auto& proxy = GetProxyHolder ();
 		Impl_->ItemsModel_ = std::make_unique<ItemsListModel> (proxy->GetIconThemeManager ());
+		Impl_->ItemsModel_->SetUnreadOnly (XmlSettingsManager::Instance ().Property ("HideReadItems", false).toBool ());
 
 		Impl_->Ui_.Items_->setAcceptDrops (false);
 
@@ -251,8 +255,7 @@ namespace LC::Aggregator
 		Impl_->Ui_.Items_->scrollToTop ();
 		RenderSelectedItems ();
 
-		const auto& items = Impl_->ItemsModel_->GetAllItems ();
-		const auto& allCategories = ItemUtils::GetCategories (items).values ();
+		const auto& allCategories = Impl_->ItemsModel_->GetAllCategories ().values ();
 		Impl_->ItemCategorySelector_->SetPossibleSelections (allCategories);
 	}
 
@@ -291,6 +291,12 @@ DEFINE_STRUCT (FeedSettingsR, "feeds_settings", Feed::FeedSettings,
 		(SAME_NAME (oral::NotNull<int>, ItemAge_))
 		(SAME_NAME (oral::NotNull<bool>, AutoDownloadEnclosures_))
 		)
+DEFINE_STRUCT (FeedFetchStateR, "feeds_fetch_states", Feed::FetchState,
+		(SAME_NAME (oral::Unique<oral::References<&FeedR::FeedID_>>, FeedID_))
+		(SAME_NAME (QString, ETag_))
+		(SAME_NAME (QString, LastModified_))
+		(SAME_NAME (QByteArray, ContentHash_))
+		)
 DEFINE_STRUCT (ChannelR, "channels", Channel,
 		(SAME_NAME (PKey_t, ChannelID_))
 		(SAME_NAME (oral::References<&FeedR::FeedID_>, FeedID_))
@@ -495,11 +501,13 @@ namespace LC::Aggregator
 				[&]<typename Impl> (Impl)
 				{
 					oral::AdaptPtrs<Impl> (DB_,
-							Feeds_, FeedsSettings_, Channels_, Items_, Enclosures_,
+							Feeds_, FeedsSettings_, FeedsFetchStates_, Channels_, Items_, Enclosures_,
 							MRSSEntries_, MRSSThumbnails_, MRSSCredits_, MRSSComments_, MRSSPeerLinks_, MRSSScenes_,
 							Items2Tags_, Feeds2Tags_);
 				});
 
+		Util::RunTextQuery (DB_, "CREATE INDEX IF NOT EXISTS items_channel_pubdate ON items (channel_id, pub_date, item_id);"_qs);
+
 		DBRemover_ = Util::MakeScopeGuard ([conn = DB_.connectionName ()] { QSqlDatabase::removeDatabase (conn); });
 	}
 
@@ -646,7 +654,29 @@ namespace LC::Aggregator
 
 	void SQLStorageBackend::SetFeedURL (IDType_t feedId, const QString& url)
 	{
+		Util::DBLock lock { DB_ };
+		lock.Init ();
+
 		Feeds_->Update (sph::f<&FeedR::URL_> = url, sph::f<&FeedR::FeedID_> == feedId);
+		FeedsFetchStates_->DeleteBy (sph::f<&FeedFetchStateR::FeedID_> == feedId);
+
+		lock.Good ();
+	}
+
+	std::optional<Feed::FetchState> SQLStorageBackend::GetFeedFetchState (IDType_t feedId) const
+	{
+		return FeedsFetchStates_->SelectOne (sph::f<&FeedFetchStateR::FeedID_> == feedId) * &FeedFetchStateR::ToOrig;
+	}
+
+	void SQLStorageBackend::SetFeedFetchState (const Feed::FetchState& state)
+	{
+		WithType (Type_,
+				[&] (auto impl)
+				{
+					FeedsFetchStates_->Insert (impl,
+							FeedFetchStateR::FromOrig (state),
+							oral::InsertAction::Replace::Fields<&FeedFetchStateR::FeedID_>);
+				});
 	}
 
 	channels_shorts_t SQLStorageBackend::GetChannels (IDType_t feedId) const
@@ -802,20 +832,110 @@ namespace LC::Aggregator
 		emit channelDataUpdated (GetChannel (id));
 	}
 
-	items_shorts_t SQLStorageBackend::GetItems (IDType_t channelId) const
+	namespace
 	{
-		constexpr auto shortFields = sph::fields<
-					&ItemR::ItemID_,
-					&ItemR::ChannelID_,
-					&ItemR::Title_,
-					&ItemR::URL_,
-					&ItemR::Category_,
-					&ItemR::PubDate_,
-					&ItemR::Unread_
+		constexpr auto ItemShortFields = sph::fields<
+					&SQLStorageBackend::ItemR::ItemID_,
+					&SQLStorageBackend::ItemR::ChannelID_,
+					&SQLStorageBackend::ItemR::Title_,
+					&SQLStorageBackend::ItemR::URL_,
+					&SQLStorageBackend::ItemR::Category_,
+					&SQLStorageBackend::ItemR::PubDate_,
+					&SQLStorageBackend::ItemR::Unread_
 				>;
-		auto rawTuples = Items_->Select (shortFields, sph::f<&ItemR::ChannelID_> == channelId);
-		return Util::MapAs<QVector> (std::move (rawTuples),
-				[]<typename Tup> (Tup&& tup) { return std::make_from_tuple<ItemShort> (std::forward<Tup> (tup)); });
+
+		items_shorts_t ToItemShorts (auto&& rawTuples)
+		{
+			return Util::MapAs<QVector> (std::forward<decltype (rawTuples)> (rawTuples),
+					[]<typename Tup> (Tup&& tup) { return std::make_from_tuple<ItemShort> (std::forward<Tup> (tup)); });
+		}
+	}
+
+	items_shorts_t SQLStorageBackend::GetItems (IDType_t channelId) const
+	{
+		return ToItemShorts (Items_->Select (ItemShortFields, sph::f<&ItemR::ChannelID_> == channelId));
+	}
+
+	namespace
+	{
+		items_shorts_t SelectItemsPage (const QSqlDatabase& db, const QString& where,
+				const QString& order, const QVariantMap& binds, int limit)
+		{
+			QSqlQuery query { db };
+			query.prepare ("SELECT item_id, channel_id, title, url, category, pub_date, unread FROM items "
+					"WHERE " + where + " ORDER BY " + order + " LIMIT " + QString::number (limit));
+			for (auto i = binds.begin (), end = binds.end (); i != end; ++i)
+				query.bindValue (i.key (), i.value ());
+			Util::DBLock::Execute (query);
+
+			items_shorts_t result;
+			while (query.next ())
+				result.push_back ({
+						query.value (0).value<IDType_t> (),
+						query.value (1).value<IDType_t> (),
+						query.value (2).toString (),
+						query.value (3).toString (),
+						oral::FromVariant<ItemCategories> {} (query.value (4)),
+						oral::FromVariant<QDateTime> {} (query.value (5)),
+						query.value (6).toBool ()
+					});
+			return result;
+		}
+	}
+
+	/* The items without a publication date have NULL in pub_date. They go
+	 * after all the dated ones, ordered by their IDs, and each part is
+	 * fetched by its own query so that both use the pub_date index.
+	 * oral can't express IS NULL, hence the handwritten queries.
+	 */
+	items_shorts_t SQLStorageBackend::GetItemsPage (IDType_t channelId, const ItemsPageQuery& query) const
+	{
+		QString filter = "channel_id = :channel_id"_qs;
+		QVariantMap binds { { ":channel_id"_qs, channelId } };
+		if (query.UnreadOnly_)
+		{
+			filter += " AND unread = :unread"_qs;
+			binds [":unread"_qs] = true;
+		}
+
+		const bool isAfterUndated = query.After_ && !query.After_->PubDate_.isValid ();
+
+		items_shorts_t result;
+		if (!isAfterUndated)
+		{
+			auto datedBinds = binds;
+			auto where = filter + " AND pub_date IS NOT NULL"_qs;
+			if (query.After_)
+			{
+				where += " AND (pub_date < :pub_date_before OR (pub_date = :pub_date_same AND item_id < :item_id))"_qs;
+				const auto& pubDate = oral::ToVariant<QDateTime> {} (query.After_->PubDate_);
+				datedBinds [":pub_date_before"_qs] = pubDate;
+				datedBinds [":pub_date_same"_qs] = pubDate;
+				datedBinds [":item_id"_qs] = query.After_->ItemID_;
+			}
+
+			result = SelectItemsPage (DB_, where, "pub_date DESC, item_id DESC"_qs, datedBinds, query.Limit_);
+			if (result.size () == query.Limit_)
+				return result;
+		}
+
+		auto where = filter + " AND pub_date IS NULL"_qs;
+		if (isAfterUndated)
+		{
+			where += " AND item_id < :item_id"_qs;
+			binds [":item_id"_qs] = query.After_->ItemID_;
+		}
+		result += SelectItemsPage (DB_, where, "item_id DESC"_qs, binds, query.Limit_ - result.size ());
+		return result;
+	}
+
+	QSet<QString> SQLStorageBackend::GetItemsCategories (IDType_t channelId) const
+	{
+		QSet<QString> result;
+		for (const auto& categories : Items_->Select (sph::fields<&ItemR::Category_>, sph::f<&ItemR::ChannelID_> == channelId))
+			for (const auto& category : categories.Categories_)
+				result << category;
+		return result;
 	}
 
 	int SQLStorageBackend::GetUnreadItemsCount (IDType_t channelId) const
@@ -855,14 +975,202 @@ namespace LC::Aggregator
 	}
 
 	void SQLStorageBackend::UpdateItem (const Item& item)
+	{
+		RewriteItem (item);
+
+		emit itemDataUpdated (item);
+	}
+
+	void SQLStorageBackend::RewriteItem (const Item& item)
 	{
 		Items_->Update (ItemR::FromOrig (item));
 
-		Enclosures_->DeleteBy (sph::f<&ItemR::ItemID_> == item.ItemID_);
+		Enclosures_->DeleteBy (sph::f<&EnclosureR::ItemID_> == item.ItemID_);
 		WriteEnclosures (item.Enclosures_);
 		WriteMRSSEntries (item.MRSSEntries_);
+	}
 
-		emit itemDataUpdated (item);
+	namespace
+	{
+		class ItemsMatcher
+		{
+			QHash<std::pair<QString, QString>, IDType_t> ByTitleLink_;
+			QHash<QString, IDType_t> ByLink_;
+			QHash<QString, IDType_t> ByTitle_;
+		public:
+			// The first added item wins, like with the FindItem*() family.
+			void Add (IDType_t id, const QString& title, const QString& link)
+			{
+				AddNew (ByTitleLink_, std::pair { title, link }, id);
+				if (!link.isEmpty ())
+					AddNew (ByLink_, link, id);
+				AddNew (ByTitle_, title, id);
+			}
+
+			std::optional<IDType_t> Find (const Item& item) const
+			{
+				if (const auto it = ByTitleLink_.constFind ({ item.Title_, item.Link_ }); it != ByTitleLink_.cend ())
+					return *it;
+				if (const auto it = ByLink_.constFind (item.Link_); it != ByLink_.cend ())
+					return *it;
+
+				if (!item.Link_.isEmpty ())
+					return {};
+
+				if (const auto it = ByTitle_.constFind (item.Title_); it != ByTitle_.cend ())
+					return *it;
+				return {};
+			}
+		private:
+			template<typename K>
+			static void AddNew (QHash<K, IDType_t>& hash, const K& key, IDType_t id)
+			{
+				if (!hash.contains (key))
+					hash.insert (key, id);
+			}
+		};
+	}
+
+	StorageBackend::MergeResult SQLStorageBackend::MergeChannelSnapshot (IDType_t channelId,
+			const items_container_t& items, const TrimParams& trim)
+	{
+		Util::DBLock lock { DB_ };
+		lock.Init ();
+
+		ItemsMatcher matcher;
+		for (const auto& [id, title, link] : Items_->Select (sph::fields<&ItemR::ItemID_, &ItemR::Title_, &ItemR::URL_>,
+				sph::f<&ItemR::ChannelID_> == channelId))
+			matcher.Add (id, title, link);
+
+		std::optional<QHash<IDType_t, Item>> fullItems;
+		QSet<IDType_t> hookedItems;
+
+		MergeResult result;
+		QList<Item> updated;
+		for (const auto& itemPtr : items)
+		{
+			auto& item = *itemPtr;
+			const auto ourId = matcher.Find (item);
+			if (!ourId)
+			{
+				item.ChannelID_ = channelId;
+				matcher.Add (item.ItemID_, item.Title_, item.Link_);
+				result.Added_ << item;
+				continue;
+			}
+
+			if (!fullItems)
+			{
+				fullItems = GetFullChannelItems (channelId);
+				for (const auto& added : result.Added_)
+					fullItems->insert (added.ItemID_, added);
+			}
+
+			const auto ourPos = fullItems->find (*ourId);
+			if (ourPos == fullItems->end ())
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "item"
+						<< *ourId
+						<< "has disappeared from channel"
+						<< channelId;
+				continue;
+			}
+
+			if (!hookedItems.contains (*ourId))
+			{
+				emit hookItemLoad (std::make_shared<Util::DefaultHookProxy> (), &*ourPos);
+				hookedItems << *ourId;
+			}
+
+			if (auto merged = MergeItem (*ourPos, item))
+			{
+				*ourPos = *merged;
+
+				const auto updatedPos = std::find_if (updated.begin (), updated.end (),
+						[id = *ourId] (const Item& other) { return other.ItemID_ == id; });
+				if (updatedPos == updated.end ())
+					updated << std::move (*merged);
+				else
+					*updatedPos = std::move (*merged);
+			}
+		}
+
+		WriteItems (result.Added_);
+		RewriteItems (updated);
+
+		TrimChannel (channelId, trim.ItemAge_, trim.NumItems_);
+
+		lock.Good ();
+
+		result.UpdatedCount_ = updated.size ();
+
+		int unreadDelta = 0;
+		for (const auto& item : result.Added_)
+		{
+			emit itemDataUpdated (item);
+			unreadDelta += item.Unread_;
+		}
+		for (const auto& item : updated)
+			emit itemDataUpdated (item);
+
+		if (unreadDelta)
+			emit channelUnreadCountUpdated (channelId, UnreadDelta { unreadDelta });
+
+		return result;
+	}
+
+	namespace
+	{
+		template<typename RecType, typename FieldType>
+		auto GroupByID (const QList<RecType>& records, FieldType RecType::* idField)
+		{
+			QHash<IDType_t, QList<decltype (records.front ().ToOrig ())>> result;
+			for (const auto& rec : records)
+				result [*(rec.*idField)] << rec.ToOrig ();
+			return result;
+		}
+	}
+
+	QHash<IDType_t, Item> SQLStorageBackend::GetFullChannelItems (IDType_t channelId) const
+	{
+		const auto inChannel = sph::f<&ItemR::ChannelID_> == channelId;
+		const auto mrssInChannel = sph::f<&MRSSEntryR::ItemID_> == sph::f<&ItemR::ItemID_> && inChannel;
+
+		auto enclosures = GroupByID (Enclosures_->Select (sph::f<&EnclosureR::ItemID_> == sph::f<&ItemR::ItemID_> && inChannel),
+				&EnclosureR::ItemID_);
+		auto mrssEntries = GroupByID (MRSSEntries_->Select (mrssInChannel),
+				&MRSSEntryR::ItemID_);
+
+		auto thumbnails = GroupByID (MRSSThumbnails_->Select (sph::f<&MRSSThumbnailR::MrssID_> == sph::f<&MRSSEntryR::MrssID_> && mrssInChannel),
+				&MRSSThumbnailR::MrssID_);
+		auto credits = GroupByID (MRSSCredits_->Select (sph::f<&MRSSCreditR::MrssID_> == sph::f<&MRSSEntryR::MrssID_> && mrssInChannel),
+				&MRSSCreditR::MrssID_);
+		auto comments = GroupByID (MRSSComments_->Select (sph::f<&MRSSCommentR::MrssID_> == sph::f<&MRSSEntryR::MrssID_> && mrssInChannel),
+				&MRSSCommentR::MrssID_);
+		auto peerLinks = GroupByID (MRSSPeerLinks_->Select (sph::f<&MRSSPeerLinkR::MrssID_> == sph::f<&MRSSEntryR::MrssID_> && mrssInChannel),
+				&MRSSPeerLinkR::MrssID_);
+		auto scenes = GroupByID (MRSSScenes_->Select (sph::f<&MRSSSceneR::MrssID_> == sph::f<&MRSSEntryR::MrssID_> && mrssInChannel),
+				&MRSSSceneR::MrssID_);
+
+		QHash<IDType_t, Item> result;
+		for (const auto& itemR : Items_->Select (inChannel))
+		{
+			auto item = itemR.ToOrig ();
+			item.Enclosures_ = enclosures.take (item.ItemID_);
+			item.MRSSEntries_ = mrssEntries.take (item.ItemID_);
+			for (auto& entry : item.MRSSEntries_)
+			{
+				const auto mrssId = entry.MRSSEntryID_;
+				entry.Thumbnails_ = thumbnails.take (mrssId);
+				entry.Credits_ = credits.take (mrssId);
+				entry.Comments_ = comments.take (mrssId);
+				entry.PeerLinks_ = peerLinks.take (mrssId);
+				entry.Scenes_ = scenes.take (mrssId);
+			}
+			result [item.ItemID_] = std::move (item);
+		}
+		return result;
 	}
 
 	void SQLStorageBackend::SetItemUnread (IDType_t channelId, IDType_t itemId, bool unread)
@@ -904,6 +1212,53 @@ namespace LC::Aggregator
 		emit hookItemAdded (std::make_shared<Util::DefaultHookProxy> (), item);
 	}
 
+	void SQLStorageBackend::WriteItems (const QList<Item>& items)
+	{
+		WithType (Type_,
+				[&] (auto impl)
+				{
+					Items_->Insert (impl, Util::Map (items, &ItemR::FromOrig), oral::InsertAction::Default);
+				});
+
+		QList<Enclosure> enclosures;
+		QList<MRSSEntry> mrssEntries;
+		for (const auto& item : items)
+		{
+			enclosures += item.Enclosures_;
+			mrssEntries += item.MRSSEntries_;
+		}
+		WriteEnclosures (enclosures);
+		WriteMRSSEntries (mrssEntries);
+
+		for (const auto& item : items)
+			emit hookItemAdded (std::make_shared<Util::DefaultHookProxy> (), item);
+	}
+
+	void SQLStorageBackend::RewriteItems (const QList<Item>& items)
+	{
+		if (items.isEmpty ())
+			return;
+
+		// oral prepares the UPDATE by the primary key once and reuses it
+		for (const auto& item : items)
+			Items_->Update (ItemR::FromOrig (item));
+
+		QStringList ids;
+		QList<Enclosure> enclosures;
+		QList<MRSSEntry> mrssEntries;
+		for (const auto& item : items)
+		{
+			ids << QString::number (item.ItemID_);
+			enclosures += item.Enclosures_;
+			mrssEntries += item.MRSSEntries_;
+		}
+
+		Util::RunTextQuery (DB_,
+				Util::ToString<"DELETE FROM " + EnclosureR::ClassName + " WHERE item_id IN ("> () + ids.join (", ") + ")");
+		WriteEnclosures (enclosures);
+		WriteMRSSEntries (mrssEntries);
+	}
+
 	void SQLStorageBackend::RemoveItems (const QSet<IDType_t>& items)
 	{
 		Util::DBLock lock (DB_);
@@ -1014,8 +1369,7 @@ namespace LC::Aggregator
 		WithType (Type_,
 				[&] (auto impl)
 				{
-					for (const auto& enclosure : enclosures)
-						Enclosures_->Insert (impl, EnclosureR::FromOrig (enclosure), oral::InsertAction::Replace::PKey);
+					Enclosures_->Insert (impl, Util::Map (enclosures, &EnclosureR::FromOrig), oral::InsertAction::Replace::PKey);
 				});
 	}
 
@@ -1029,8 +1383,7 @@ namespace LC::Aggregator
 		template<typename RecType>
 		void InsertList (auto impl, const oral::ObjectInfo_ptr<RecType>& records, const auto& origs)
 		{
-			for (const auto& orig : origs)
-				records->Insert (impl, RecType::FromOrig (orig), oral::InsertAction::Replace::PKey);
+			records->Insert (impl, Util::Map (origs, &RecType::FromOrig), oral::InsertAction::Replace::PKey);
 		}
 	}
 
@@ -1039,15 +1392,26 @@ namespace LC::Aggregator
 		WithType (Type_,
 				[&] (auto impl)
 				{
+					QList<MRSSThumbnail> thumbnails;
+					QList<MRSSCredit> credits;
+					QList<MRSSComment> comments;
+					QList<MRSSPeerLink> peerLinks;
+					QList<MRSSScene> scenes;
 					for (const auto& e : entries)
 					{
-						MRSSEntries_->Insert (impl, MRSSEntryR::FromOrig (e), oral::InsertAction::Replace::PKey);
-						InsertList (impl, MRSSThumbnails_, e.Thumbnails_);
-						InsertList (impl, MRSSCredits_, e.Credits_);
-						InsertList (impl, MRSSComments_, e.Comments_);
-						InsertList (impl, MRSSPeerLinks_, e.PeerLinks_);
-						InsertList (impl, MRSSScenes_, e.Scenes_);
+						thumbnails += e.Thumbnails_;
+						credits += e.Credits_;
+						comments += e.Comments_;
+						peerLinks += e.PeerLinks_;
+						scenes += e.Scenes_;
 					}
+
+					InsertList (impl, MRSSEntries_, entries);
+					InsertList (impl, MRSSThumbnails_, thumbnails);
+					InsertList (impl, MRSSCredits_, credits);
+					InsertList (impl, MRSSComments_, comments);
+					InsertList (impl, MRSSPeerLinks_, peerLinks);
+					InsertList (impl, MRSSScenes_, scenes);
 				});
 	}
 
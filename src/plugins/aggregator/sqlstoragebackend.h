@@ -16,7 +16,7 @@
 
 namespace LC::Aggregator
 {
-	class SQLStorageBackend : public StorageBackend
+	class Q_DECL_EXPORT SQLStorageBackend : public StorageBackend
 	{
 		Q_OBJECT
 
@@ -25,6 +25,7 @@ namespace LC::Aggregator
 	public:
 		struct FeedR;
 		struct FeedSettingsR;
+		struct FeedFetchStateR;
 		struct ChannelR;
 		struct ItemR;
 
@@ -45,6 +46,7 @@ namespace LC::Aggregator
 
 		Util::oral::ObjectInfo_ptr<FeedR> Feeds_;
 		Util::oral::ObjectInfo_ptr<FeedSettingsR> FeedsSettings_;
+		Util::oral::ObjectInfo_ptr<FeedFetchStateR> FeedsFetchStates_;
 		Util::oral::ObjectInfo_ptr<ChannelR> Channels_;
 		Util::oral::ObjectInfo_ptr<ItemR> Items_;
 		Util::oral::ObjectInfo_ptr<EnclosureR> Enclosures_;
@@ -70,6 +72,8 @@ namespace LC::Aggregator
 		std::optional<QStringList> GetFeedTags (IDType_t) const override;
 		void SetFeedTags (IDType_t, const QStringList&) override;
 		void SetFeedURL (IDType_t, const QString&) override;
+		std::optional<Feed::FetchState> GetFeedFetchState (IDType_t) const override;
+		void SetFeedFetchState (const Feed::FetchState&) override;
 
 		channels_shorts_t GetChannels (IDType_t) const override;
 		Channel GetChannel (IDType_t) const override;
@@ -84,6 +88,8 @@ namespace LC::Aggregator
 		void SetChannelLink (IDType_t, const QString&) override;
 
 		items_shorts_t GetItems (IDType_t) const override;
+		items_shorts_t GetItemsPage (IDType_t, const ItemsPageQuery&) const override;
+		QSet<QString> GetItemsCategories (IDType_t) const override;
 		int GetUnreadItemsCount (IDType_t) const override;
 		int GetTotalItemsCount (IDType_t) const override;
 		std::optional<Item> GetItem (IDType_t) const override;
@@ -94,6 +100,7 @@ namespace LC::Aggregator
 		void AddFeed (const Feed&) override;
 		void UpdateItem (const Item&) override;
 		void SetItemUnread (IDType_t, IDType_t, bool) override;
+		MergeResult MergeChannelSnapshot (IDType_t, const items_container_t&, const TrimParams&) override;
 		void AddChannel (const Channel&) override;
 		void AddItem (const Item&) override;
 		void RemoveItems (const QSet<IDType_t>&) override;
@@ -111,6 +118,10 @@ namespace LC::Aggregator
 		IDType_t GetHighestID (const PoolType&) const override;
 	private:
 		void WriteItem (const Item&);
+		void WriteItems (const QList<Item>&);
+		void RewriteItem (const Item&);
+		void RewriteItems (const QList<Item>&);
+		QHash<IDType_t, Item> GetFullChannelItems (IDType_t) const;
 		void WriteEnclosures (const QList<Enclosure>&);
 		void GetEnclosures (IDType_t, QList<Enclosure>&) const;
 		void WriteMRSSEntries (const QList<MRSSEntry>&);
@@ -47,5 +47,39 @@ namespace Aggregator
 
 		return result;
 	}
+
+	std::optional<Item> StorageBackend::MergeItem (Item ourItem, const Item& item)
+	{
+		if (!IsModified (ourItem, item))
+			return {};
+
+		static const bool debugDiffs = qgetenv ("LC_AGGREGATOR_DUMP_DIFFS") == "1";
+		if (debugDiffs)
+			Diff (ourItem, item);
+
+		ourItem.Description_ = item.Description_;
+		ourItem.Categories_ = item.Categories_;
+		ourItem.NumComments_ = item.NumComments_;
+		ourItem.CommentsLink_ = item.CommentsLink_;
+		ourItem.CommentsPageLink_ = item.CommentsPageLink_;
+		ourItem.Latitude_ = item.Latitude_;
+		ourItem.Longitude_ = item.Longitude_;
+
+		for (auto enc : item.Enclosures_)
+			if (!ourItem.Enclosures_.contains (enc))
+			{
+				enc.ItemID_ = ourItem.ItemID_;
+				ourItem.Enclosures_ << enc;
+			}
+
+		for (auto entry : item.MRSSEntries_)
+			if (!ourItem.MRSSEntries_.contains (entry))
+			{
+				entry.ItemID_ = ourItem.ItemID_;
+				ourItem.MRSSEntries_ << entry;
+			}
+
+		return ourItem;
+	}
 }
 }
@@ -33,7 +33,7 @@ namespace LC::Aggregator
 	 * Specifies interface for all storage backends. Includes functions for
 	 * appending, modifying and retrieving feeds, channels and items.
 	 */
-	class StorageBackend : public QObject
+	class Q_DECL_EXPORT StorageBackend : public QObject
 	{
 		Q_OBJECT
 	public:
@@ -104,8 +104,29 @@ namespace LC::Aggregator
 		virtual std::optional<QStringList> GetFeedTags (IDType_t feed) const = 0;
 		virtual void SetFeedTags (IDType_t feed, const QStringList& tags) = 0;
 
+		/** @brief Sets the feed's URL.
+		 *
+		 * This also drops the feed's fetch state, if any.
+		 *
+		 * @param[in] feed Feed's ID.
+		 * @param[in] url The new URL.
+		 */
 		virtual void SetFeedURL (IDType_t feed, const QString& url) = 0;
 
+		/** @brief Returns the state of the last successful fetch of the feed.
+		 *
+		 * @param[in] feed Feed's ID.
+		 * @return The fetch state, or an empty optional if the feed hasn't
+		 * been fetched yet.
+		 */
+		virtual std::optional<Feed::FetchState> GetFeedFetchState (IDType_t feed) const = 0;
+
+		/** @brief Sets the feed's fetch state replacing the old one.
+		 *
+		 * @param[in] state The new fetch state.
+		 */
+		virtual void SetFeedFetchState (const Feed::FetchState& state) = 0;
+
 		/** @brief Get all the channels of a feed in the container.
 		 *
 		 * Returns short information about channels in the storage which
@@ -171,6 +192,58 @@ namespace LC::Aggregator
 		 */
 		virtual items_shorts_t GetItems (IDType_t channelId) const = 0;
 
+		/** @brief The position of an item in the pages order.
+		 *
+		 * The pages are ordered by the publication date and then by the
+		 * item ID, both descending. The items without a publication date
+		 * go after all the dated ones, ordered by the item ID.
+		 */
+		struct ItemsPageKey
+		{
+			QDateTime PubDate_;
+			IDType_t ItemID_;
+		};
+
+		/** @brief Describes a page of items to be fetched.
+		 */
+		struct ItemsPageQuery
+		{
+			/** @brief Only the items strictly after this key are fetched.
+			 *
+			 * If empty, the page starts from the newest item.
+			 */
+			std::optional<ItemsPageKey> After_;
+
+			/** @brief The maximum number of items in the page.
+			 */
+			int Limit_;
+
+			/** @brief Whether only the unread items should be fetched.
+			 */
+			bool UnreadOnly_ = false;
+		};
+
+		/** @brief Returns a page of short items in a channel.
+		 *
+		 * The items are ordered from the newest to the oldest, as
+		 * described by ItemsPageKey. The next page can be requested by
+		 * passing the key of the last returned item in
+		 * ItemsPageQuery::After_. A page shorter than
+		 * ItemsPageQuery::Limit_ means there are no more items.
+		 *
+		 * @param[in] channelId The ID of the channel.
+		 * @param[in] query The page to fetch.
+		 * @return The short items in the page.
+		 */
+		virtual items_shorts_t GetItemsPage (IDType_t channelId, const ItemsPageQuery& query) const = 0;
+
+		/** @brief Returns all the categories of the items in a channel.
+		 *
+		 * @param[in] channelId The ID of the channel.
+		 * @return The set of the categories of all the items.
+		 */
+		virtual QSet<QString> GetItemsCategories (IDType_t channelId) const = 0;
+
 		/** @brief Counts unread items number in a given channel.
 		 *
 		 * @param[in] id Channel's ID.
@@ -306,6 +379,57 @@ namespace LC::Aggregator
 		 */
 		virtual void SetItemUnread (IDType_t channel, IDType_t item, bool unread) = 0;
 
+		/** @brief Limits on the items kept in a channel.
+		 */
+		struct TrimParams
+		{
+			/** @brief Max age of the read items, in days.
+			 */
+			int ItemAge_;
+
+			/** @brief Max number of the read items.
+			 */
+			int NumItems_;
+		};
+
+		/** @brief The outcome of MergeChannelSnapshot().
+		 */
+		struct MergeResult
+		{
+			/** @brief The items that have been added, with their IDs.
+			 */
+			QList<Item> Added_;
+
+			/** @brief The number of existing items that have been updated.
+			 */
+			int UpdatedCount_ = 0;
+		};
+
+		/** @brief Merges the freshly fetched items into a channel.
+		 *
+		 * Each of the \em items is matched against the items already in
+		 * the channel: first by both title and link, then by link, and,
+		 * if the item has no link, by title. Matched items are updated
+		 * as per MergeItem(), and the rest are added to the channel.
+		 * The channel is then trimmed according to \em trim.
+		 *
+		 * This is equivalent to a series of FindItem(), UpdateItem(),
+		 * AddItem() and TrimChannel() calls, but is expected to be done
+		 * in a single transaction with a fixed number of queries
+		 * regardless of the number of items.
+		 *
+		 * The itemDataUpdated() and channelUnreadCountUpdated() signals
+		 * are emitted after the changes are committed.
+		 *
+		 * @param[in] channelId The ID of the channel to merge into.
+		 * @param[in] items The items of the channel as fetched. The
+		 * channel IDs of the new items are updated to \em channelId.
+		 * @param[in] trim The limits to trim the channel to afterwards.
+		 * @return The added items and the number of updated ones.
+		 */
+		virtual MergeResult MergeChannelSnapshot (IDType_t channelId,
+				const items_container_t& items, const TrimParams& trim) = 0;
+
 		/** @brief Removes an already existing item.
 		 *
 		 * This function emits channelDataUpdated() and itemsRemoved()
@@ -391,6 +515,15 @@ namespace LC::Aggregator
 		 * @return highest channels id in the database or 0 if empty
 		 */
 		virtual IDType_t GetHighestID (const PoolType& type) const = 0;
+	protected:
+		/** @brief Merges a freshly fetched item into the stored one.
+		 *
+		 * @param[in] ourItem The item as stored.
+		 * @param[in] item The freshly fetched version of the item.
+		 * @return The item to store, or an empty optional if the item is
+		 * not modified.
+		 */
+		static std::optional<Item> MergeItem (Item ourItem, const Item& item);
 	signals:
 		void channelAdded (const Channel& channel) const;
 
@@ -0,0 +1,133 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "sqlstoragebackend_test.h"
+#include <QtTest>
+#include <QTemporaryDir>
+#include <components/models/itemswindow.h>
+#include <sqlstoragebackend.h>
+
+namespace LC::Aggregator
+{
+	namespace
+	{
+		const QDateTime Base { QDate { 2020, 10, 5 }, QTime { 10, 0 }, Qt::UTC };
+
+		Enclosure MakeEnclosure (IDType_t id, IDType_t itemId)
+		{
+			Enclosure result;
+			result.EnclosureID_ = id;
+			result.ItemID_ = itemId;
+			result.URL_ = "https://example.com/enclosures/" + QString::number (id);
+			result.Type_ = "audio/mpeg";
+			result.Length_ = id * 1024;
+			return result;
+		}
+
+		QVector<IDType_t> Ids (const items_shorts_t& items)
+		{
+			QVector<IDType_t> result;
+			for (const auto& item : items)
+				result << item.ItemID_;
+			return result;
+		}
+	}
+
+	SQLStorageBackendTest::SQLStorageBackendTest () = default;
+	SQLStorageBackendTest::~SQLStorageBackendTest () = default;
+
+	void SQLStorageBackendTest::initTestCase ()
+	{
+		// The SQL storage lives in the user's home, so don't touch the real one.
+		Home_ = std::make_unique<QTemporaryDir> ();
+		QVERIFY (Home_->isValid ());
+		qputenv ("HOME", Home_->path ().toUtf8 ());
+	}
+
+	void SQLStorageBackendTest::testUpdateItemReplacesEnclosures ()
+	{
+		SQLStorageBackend sb { StorageBackend::SBSQLite, "_EnclosuresTest" };
+		sb.Prepare ();
+
+		Feed feed { 1, "https://example.com/feed", Base };
+
+		const auto channel = std::make_shared<Channel> ();
+		channel->ChannelID_ = 1;
+		channel->FeedID_ = feed.FeedID_;
+		channel->Title_ = "Channel";
+
+		const auto item = std::make_shared<Item> ();
+		item->ItemID_ = 1;
+		item->ChannelID_ = channel->ChannelID_;
+		item->Title_ = "Item";
+		item->Link_ = "https://example.com/items/1";
+		item->PubDate_ = Base;
+		item->Enclosures_ = { MakeEnclosure (1, item->ItemID_), MakeEnclosure (2, item->ItemID_) };
+		channel->Items_.push_back (item);
+		feed.Channels_.push_back (channel);
+
+		sb.AddFeed (feed);
+		QCOMPARE (sb.GetItem (item->ItemID_)->Enclosures_.size (), 2);
+
+		auto updated = *item;
+		updated.Enclosures_ = { MakeEnclosure (3, item->ItemID_) };
+		sb.UpdateItem (updated);
+
+		const auto& stored = sb.GetItem (item->ItemID_);
+		QVERIFY (stored);
+		QCOMPARE (stored->Enclosures_, updated.Enclosures_);
+	}
+
+	void SQLStorageBackendTest::testUndatedItemsPages ()
+	{
+		SQLStorageBackend sb { StorageBackend::SBSQLite, "_UndatedTest" };
+		sb.Prepare ();
+
+		Feed feed { 2, "https://example.com/undated", Base };
+
+		const auto channel = std::make_shared<Channel> ();
+		channel->ChannelID_ = 2;
+		channel->FeedID_ = feed.FeedID_;
+		channel->Title_ = "Undated channel";
+
+		// Items 11 to 13 are dated, 14 to 17 have no publication date.
+		for (IDType_t id = 11; id <= 17; ++id)
+		{
+			const auto item = std::make_shared<Item> ();
+			item->ItemID_ = id;
+			item->ChannelID_ = channel->ChannelID_;
+			item->Title_ = "Item " + QString::number (id);
+			item->Link_ = "https://example.com/undated/" + QString::number (id);
+			if (id <= 13)
+				item->PubDate_ = Base.addSecs (id * 60);
+			item->Unread_ = id % 2;
+			channel->Items_.push_back (item);
+		}
+		feed.Channels_.push_back (channel);
+		sb.AddFeed (feed);
+
+		const auto fetcher = [&sb] (IDType_t channel, const StorageBackend::ItemsPageQuery& query)
+		{
+			return sb.GetItemsPage (channel, query);
+		};
+
+		ItemsWindow window { fetcher, { channel->ChannelID_ }, false, 2 };
+		QCOMPARE (Ids (window.FetchMore ()), (QVector<IDType_t> { 13, 12 }));
+		QCOMPARE (Ids (window.FetchMore ()), (QVector<IDType_t> { 11, 17 }));
+		QCOMPARE (Ids (window.FetchMore ()), (QVector<IDType_t> { 16, 15 }));
+		QCOMPARE (Ids (window.FetchMore ()), (QVector<IDType_t> { 14 }));
+		QVERIFY (!window.CanFetchMore ());
+
+		ItemsWindow unreadWindow { fetcher, { channel->ChannelID_ }, true, 2 };
+		QCOMPARE (Ids (unreadWindow.FetchMore ()), (QVector<IDType_t> { 13, 11 }));
+		QCOMPARE (Ids (unreadWindow.FetchMore ()), (QVector<IDType_t> { 17, 15 }));
+		QVERIFY (unreadWindow.CanFetchMore ());
+		QVERIFY (unreadWindow.FetchMore ().isEmpty ());
+		QVERIFY (!unreadWindow.CanFetchMore ());
+	}
+}
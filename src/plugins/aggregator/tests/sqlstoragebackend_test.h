@@ -0,0 +1,34 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <QObject>
+
+class QTemporaryDir;
+
+namespace LC::Aggregator
+{
+	class Q_DECL_EXPORT SQLStorageBackendTest : public QObject
+	{
+		Q_OBJECT
+
+		std::unique_ptr<QTemporaryDir> Home_;
+	public:
+		SQLStorageBackendTest ();
+		~SQLStorageBackendTest () override;
+	private slots:
+		void initTestCase ();
+
+		void testUpdateItemReplacesEnclosures ();
+		void testUndatedItemsPages ();
+	};
+}
+
+using TheTestObject = LC::Aggregator::SQLStorageBackendTest;
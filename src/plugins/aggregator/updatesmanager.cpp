@@ -7,8 +7,11 @@
  **********************************************************************/
 
 #include "updatesmanager.h"
+#include <algorithm>
+#include <QCryptographicHash>
 #include <QDateTime>
-#include <QDomDocument>
+#include <QFile>
+#include <QFileInfo>
 #include <QTimer>
 #include <interfaces/idownload.h>
 #include <interfaces/core/ientitymanager.h>
@@ -19,6 +22,7 @@
 #include <util/sys/paths.h>
 #include <util/xpc/util.h>
 #include "components/parsers/parse.h"
+#include "components/updates/scheduler.h"
 #include "dbupdatethread.h"
 #include "storagebackend.h"
 #include "storagebackendmanager.h"
@@ -42,37 +46,47 @@ namespace LC::Aggregator
 				return ParseResult::Left (UpdatesManager::tr ("Unable to open the temporary file."));
 			}
 
-			QDomDocument doc;
-			QString errorMsg;
-			int errorLine, errorColumn;
-			if (!doc.setContent (&file, true, &errorMsg, &errorLine, &errorColumn))
-			{
-				const auto& copyPath = Util::GetTemporaryName ("lc_aggregator_failed.XXXXXX");
-				file.copy (copyPath);
-				qWarning () << Q_FUNC_INFO
-						<< "error parsing XML for"
-						<< url
-						<< errorMsg
-						<< errorLine
-						<< errorColumn
-						<< "; copy at"
-						<< file.fileName ();
-				return ParseResult::Left (UpdatesManager::tr ("XML parse error for the feed %1.")
-						.arg (url));
-			}
-
-			if (auto maybeChannels = Parsers::TryParse (doc, feedId))
-				return ParseResult::Right (*maybeChannels);
+			auto result = Parsers::TryParseStream (file, feedId);
+			if (result.IsRight ())
+				return ParseResult::Right (std::move (result.GetRight ()));
 
 			const auto& copyPath = Util::GetTemporaryName ("lc_aggregator_failed.XXXXXX");
 			file.copy (copyPath);
-			qWarning () << Q_FUNC_INFO
-					<< "no parser for"
-					<< url
-					<< "; copy at"
-					<< copyPath;
-			return ParseResult::Left (UpdatesManager::tr ("Could not find parser to parse %1.")
-					.arg (url));
+
+			return Util::Visit (result.GetLeft (),
+					[&] (const Parsers::XmlError& error)
+					{
+						qWarning () << Q_FUNC_INFO
+								<< "error parsing XML for"
+								<< url
+								<< error.Message_
+								<< error.Line_
+								<< error.Column_
+								<< "; copy at"
+								<< copyPath;
+						return ParseResult::Left (UpdatesManager::tr ("XML parse error for the feed %1.")
+								.arg (url));
+					},
+					[&] (Parsers::UnknownFormat)
+					{
+						qWarning () << Q_FUNC_INFO
+								<< "no parser for"
+								<< url
+								<< "; copy at"
+								<< copyPath;
+						return ParseResult::Left (UpdatesManager::tr ("Could not find parser to parse %1.")
+								.arg (url));
+					});
+		}
+
+		UpdatesScheduler::Limits GetSchedulerLimits ()
+		{
+			auto& xsm = XmlSettingsManager::Instance ();
+			return
+			{
+				.Total_ = std::max (xsm.property ("MaxConcurrentUpdates").toInt (), 1),
+				.PerHost_ = std::max (xsm.property ("MaxConcurrentUpdatesPerHost").toInt (), 1),
+			};
 		}
 	}
 
@@ -83,7 +97,15 @@ namespace LC::Aggregator
 	, FeedsErrorManager_ { initParams.FeedsErrorManager_ }
 	, UpdateTimer_ { new QTimer { this } }
 	, CustomUpdateTimer_ { new QTimer { this } }
+	, SchedulerTimer_ { new QTimer { this } }
+	, Scheduler_ { GetSchedulerLimits () }
 	{
+		SchedulerTimer_->setSingleShot (true);
+		connect (SchedulerTimer_,
+				&QTimer::timeout,
+				this,
+				&UpdatesManager::PumpQueue);
+
 		UpdateTimer_->setSingleShot (true);
 		connect (UpdateTimer_,
 				&QTimer::timeout,
@@ -125,6 +147,13 @@ namespace LC::Aggregator
 					else
 						UpdateTimer_->stop ();
 				});
+
+		xsm.RegisterObject ({ "MaxConcurrentUpdates", "MaxConcurrentUpdatesPerHost" }, this,
+				[this]
+				{
+					Scheduler_.SetLimits (GetSchedulerLimits ());
+					SchedulerTimer_->start (0);
+				});
 	}
 
 	namespace
@@ -137,10 +166,24 @@ namespace LC::Aggregator
 
 	void UpdatesManager::UpdateFeeds ()
 	{
+		qDebug () << Q_FUNC_INFO
+				<< "fetch stats so far: downloaded"
+				<< Stats_.Downloaded_
+				<< "; not modified"
+				<< Stats_.NotModified_
+				<< "; unchanged"
+				<< Stats_.Unchanged_;
+
 		if (const auto sb = StorageBackendManager::Instance ().MakeStorageBackendForThread ())
 			for (const auto id : sb->GetFeedsIDs ())
 				if (!IsCustomTimer (*sb, id))
-					UpdateFeed (id);
+					ScheduleUpdate (id, UpdatesScheduler::BackoffPolicy::Respect);
+
+		qDebug () << Q_FUNC_INFO
+				<< "queued feeds:"
+				<< Scheduler_.GetQueueDepth ()
+				<< "; being fetched:"
+				<< Scheduler_.GetInFlightCount ();
 
 		XmlSettingsManager::Instance ().setProperty ("LastUpdateDateTime", QDateTime::currentDateTime ());
 		if (int interval = XmlSettingsManager::Instance ().property ("UpdateInterval").toInt ())
@@ -149,12 +192,17 @@ namespace LC::Aggregator
 
 	void UpdatesManager::UpdateFeed (IDType_t id)
 	{
-		if (UpdatesQueue_.isEmpty ())
-			QTimer::singleShot (500,
-					this,
-					&UpdatesManager::RotateUpdatesQueue);
+		ScheduleUpdate (id, UpdatesScheduler::BackoffPolicy::Ignore);
+	}
+
+	auto UpdatesManager::GetFetchStats () const -> const FetchStats&
+	{
+		return Stats_;
+	}
 
-		UpdatesQueue_ << id;
+	auto UpdatesManager::GetQueueStats () const -> QueueStats
+	{
+		return { Scheduler_.GetQueueDepth (), Scheduler_.GetInFlightCount (), LastRefreshTime_ };
 	}
 
 	void UpdatesManager::HandleCustomUpdates ()
@@ -174,29 +222,130 @@ namespace LC::Aggregator
 			if (!Updates_.contains (id) ||
 					Updates_ [id].secsTo (current) >= feedSettings->UpdateTimeout_ * 60)
 			{
-				UpdateFeed (id);
+				ScheduleUpdate (id, UpdatesScheduler::BackoffPolicy::Respect);
 				Updates_ [id] = QDateTime::currentDateTime ();
 			}
 		}
 	}
 
-	void UpdatesManager::RotateUpdatesQueue ()
+	void UpdatesManager::ScheduleUpdate (IDType_t feedId, UpdatesScheduler::BackoffPolicy policy)
 	{
 		const auto sb = StorageBackendManager::Instance ().MakeStorageBackendForThread ();
 		if (!sb)
 			return;
 
-		if (UpdatesQueue_.isEmpty ())
+		const auto& host = QUrl { sb->GetFeed (feedId).URL_ }.host ();
+
+		const bool wasIdle = Scheduler_.IsIdle ();
+		if (!Scheduler_.Enqueue (feedId, host, QDateTime::currentDateTimeUtc (), policy))
+			return;
+
+		if (wasIdle)
+			RefreshTimer_.start ();
+
+		// coalesces the enqueues done in a row, like from UpdateFeeds()
+		if (!SchedulerTimer_->isActive () || SchedulerTimer_->remainingTime () > 0)
+			SchedulerTimer_->start (0);
+	}
+
+	void UpdatesManager::PumpQueue ()
+	{
+		const auto& now = QDateTime::currentDateTimeUtc ();
+		for (const auto feedId : Scheduler_.TakeReady (now))
+			StartFetch (feedId);
+
+		// a fetch might have finished synchronously, scheduling another pump
+		if (SchedulerTimer_->isActive ())
+			return;
+
+		if (const auto wakeup = Scheduler_.GetNextWakeup (now))
+			SchedulerTimer_->start (std::max<qint64> (now.msecsTo (*wakeup), 0));
+	}
+
+	namespace
+	{
+		constexpr auto FetchTimeout = 10 * 60 * 1000;
+
+		bool IsHostError (const FeedsErrorManager::Error& error)
+		{
+			return Util::Visit (error,
+					[] (const IDownload::Error& downloadError)
+					{
+						switch (downloadError.Type_)
+						{
+						case IDownload::Error::Type::NetworkError:
+						case IDownload::Error::Type::ProxyError:
+						case IDownload::Error::Type::ServerError:
+						case IDownload::Error::Type::Unknown:
+							return true;
+						default:
+							return false;
+						}
+					},
+					[] (const FeedsErrorManager::ParseError&) { return false; });
+		}
+
+		UpdatesScheduler::Outcome GetOutcome (const QList<FeedsErrorManager::Error>& errors)
+		{
+			if (errors.isEmpty ())
+				return UpdatesScheduler::Outcome::Success;
+
+			return std::any_of (errors.begin (), errors.end (), &IsHostError) ?
+					UpdatesScheduler::Outcome::HostError :
+					UpdatesScheduler::Outcome::FeedError;
+		}
+	}
+
+	void UpdatesManager::FinishFetch (IDType_t feedId, quint64 token, std::optional<UpdatesScheduler::Outcome> outcome)
+	{
+		const auto tokenPos = InFlightTokens_.find (feedId);
+		if (tokenPos == InFlightTokens_.end () || *tokenPos != token)
+			return;
+		InFlightTokens_.erase (tokenPos);
+
+		if (!outcome)
+			outcome = GetOutcome (FeedsErrorManager_->GetFeedErrors (feedId));
+		Scheduler_.Finish (feedId, *outcome, QDateTime::currentDateTimeUtc ());
+
+		if (!Scheduler_.IsIdle ())
+		{
+			SchedulerTimer_->start (0);
 			return;
+		}
 
-		const auto feedId = UpdatesQueue_.takeFirst ();
+		LastRefreshTime_ = RefreshTimer_.elapsed ();
+		qDebug () << Q_FUNC_INFO
+				<< "refresh done in"
+				<< *LastRefreshTime_
+				<< "ms";
+	}
+
+	void UpdatesManager::StartFetch (IDType_t feedId)
+	{
+		const auto token = NextFetchToken_++;
+		InFlightTokens_ [feedId] = token;
 
-		if (!UpdatesQueue_.isEmpty ())
-			QTimer::singleShot (2000,
-					this,
-					&UpdatesManager::RotateUpdatesQueue);
+		const auto sb = StorageBackendManager::Instance ().MakeStorageBackendForThread ();
+		if (!sb)
+		{
+			FinishFetch (feedId, token, UpdatesScheduler::Outcome::FeedError);
+			return;
+		}
+
+		// a downloader might never report the result
+		QTimer::singleShot (FetchTimeout,
+				this,
+				[this, feedId, token]
+				{
+					qWarning () << Q_FUNC_INFO
+							<< "fetching"
+							<< feedId
+							<< "timed out";
+					FinishFetch (feedId, token, UpdatesScheduler::Outcome::HostError);
+				});
 
 		const auto& url = sb->GetFeed (feedId).URL_;
+		const auto& fetchState = sb->GetFeedFetchState (feedId);
 
 		auto filename = Util::GetTemporaryName ();
 
@@ -208,6 +357,17 @@ namespace LC::Aggregator
 					NotPersistent |
 					DoNotAnnounceEntity);
 
+		if (fetchState)
+		{
+			QVariantMap headers;
+			if (!fetchState->ETag_.isEmpty ())
+				headers ["If-None-Match"] = fetchState->ETag_.toLatin1 ();
+			if (!fetchState->LastModified_.isEmpty ())
+				headers ["If-Modified-Since"] = fetchState->LastModified_.toLatin1 ();
+			if (!headers.isEmpty ())
+				e.Additional_ ["HttpHeaders"] = headers;
+		}
+
 		auto emitError = [this] (const QString& body)
 		{
 			EntityManager_->HandleEntity (Util::MakeNotification ("Aggregator", body, Priority::Critical));
@@ -218,26 +378,93 @@ namespace LC::Aggregator
 		{
 			emitError (tr ("Could not find plugin for feed with URL %1")
 					.arg (url));
+			FinishFetch (feedId, token, UpdatesScheduler::Outcome::FeedError);
 			return;
 		}
 
 		Util::Sequence (this, delegateResult.DownloadResult_) >>
 				Util::Visitor
 				{
-					[=, this] (IDownload::Success)
-					{
-						Util::Visit (ParseChannels (filename, url, feedId),
-								[&] (const channels_container_t& channels)
-								{
-									FeedsErrorManager_->ClearFeedErrors (feedId);
-									DBUpThread_->UpdateFeed (channels, url);
-								},
-								[&] (const QString& error)
-								{
-									FeedsErrorManager_->AddFeedError (feedId, FeedsErrorManager::ParseError { error });
-								});
-					},
+					[=, this] (const IDownload::Success& success) { HandleDownloaded (feedId, url, filename, success, fetchState); },
 					[=, this] (const IDownload::Error& error) { FeedsErrorManager_->AddFeedError (feedId, error); }
-				}.Finally ([filename] { QFile::remove (filename); });
+				}.Finally ([=, this]
+						{
+							QFile::remove (filename);
+							FinishFetch (feedId, token);
+						});
+	}
+
+	namespace
+	{
+		QByteArray HashFile (const QString& path)
+		{
+			QFile file { path };
+			if (!file.open (QIODevice::ReadOnly))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to open"
+						<< path
+						<< file.errorString ();
+				return {};
+			}
+
+			QCryptographicHash hash { QCryptographicHash::Sha1 };
+			hash.addData (&file);
+			return hash.result ();
+		}
+	}
+
+	void UpdatesManager::HandleDownloaded (IDType_t feedId, const QString& url, const QString& filename,
+			const IDownload::Success& success, const std::optional<Feed::FetchState>& prevState)
+	{
+		// Downloaders not reporting the status code leave the file empty on a 304.
+		const bool wasConditional = prevState && (!prevState->ETag_.isEmpty () || !prevState->LastModified_.isEmpty ());
+		if (success.HttpStatusCode_ == 304 ||
+				(!success.HttpStatusCode_ && wasConditional && !QFileInfo { filename }.size ()))
+		{
+			++Stats_.NotModified_;
+			FeedsErrorManager_->ClearFeedErrors (feedId);
+			return;
+		}
+
+		++Stats_.Downloaded_;
+
+		const Feed::FetchState state
+		{
+			feedId,
+			QString::fromLatin1 (success.ETag_),
+			QString::fromLatin1 (success.LastModified_),
+			HashFile (filename)
+		};
+
+		if (prevState && !state.ContentHash_.isEmpty () && prevState->ContentHash_ == state.ContentHash_)
+		{
+			++Stats_.Unchanged_;
+			FeedsErrorManager_->ClearFeedErrors (feedId);
+
+			if (prevState->ETag_ != state.ETag_ || prevState->LastModified_ != state.LastModified_)
+				if (const auto sb = StorageBackendManager::Instance ().MakeStorageBackendForThread ())
+					sb->SetFeedFetchState (state);
+			return;
+		}
+
+		Util::Visit (ParseChannels (filename, url, feedId),
+				[&] (const channels_container_t& channels)
+				{
+					FeedsErrorManager_->ClearFeedErrors (feedId);
+
+					// The state is only stored once the update is applied,
+					// otherwise a failed update would never be retried.
+					Util::Sequence (this, DBUpThread_->UpdateFeed (channels, url)) >>
+							[state]
+							{
+								if (const auto sb = StorageBackendManager::Instance ().MakeStorageBackendForThread ())
+									sb->SetFeedFetchState (state);
+							};
+				},
+				[&] (const QString& error)
+				{
+					FeedsErrorManager_->AddFeedError (feedId, FeedsErrorManager::ParseError { error });
+				});
 	}
 }
@@ -9,10 +9,15 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <QCoreApplication>
+#include <QElapsedTimer>
 #include <QObject>
+#include <interfaces/idownload.h>
+#include "components/updates/scheduler.h"
 #include "common.h"
 #include "dbupdatethread.h"
+#include "feed.h"
 
 class QTimer;
 
@@ -33,9 +38,55 @@ namespace LC::Aggregator
 
 		QTimer * const UpdateTimer_;
 		QTimer * const CustomUpdateTimer_;
+		QTimer * const SchedulerTimer_;
+
+		UpdatesScheduler Scheduler_;
+		QHash<IDType_t, quint64> InFlightTokens_;
+		quint64 NextFetchToken_ = 0;
+
+		QElapsedTimer RefreshTimer_;
+		std::optional<qint64> LastRefreshTime_;
 
-		QList<IDType_t> UpdatesQueue_;
 		QMap<IDType_t, QDateTime> Updates_;
+	public:
+		/** @brief Counters of the conditional fetching savings.
+		 */
+		struct FetchStats
+		{
+			/** @brief Number of feeds downloaded in full.
+			 */
+			int Downloaded_ = 0;
+
+			/** @brief Number of 304 Not Modified responses.
+			 */
+			int NotModified_ = 0;
+
+			/** @brief Number of full downloads skipped due to an unchanged body.
+			 */
+			int Unchanged_ = 0;
+		};
+
+		/** @brief The state of the updates queue.
+		 */
+		struct QueueStats
+		{
+			/** @brief Number of feeds waiting to be fetched.
+			 */
+			int QueueDepth_ = 0;
+
+			/** @brief Number of feeds being fetched right now.
+			 */
+			int InFlight_ = 0;
+
+			/** @brief Duration of the last refresh, in milliseconds.
+			 *
+			 * A refresh lasts from the moment the first feed is queued
+			 * until the queue is drained and the last feed is fetched.
+			 */
+			std::optional<qint64> LastRefreshTime_;
+		};
+	private:
+		FetchStats Stats_;
 	public:
 		struct InitParams
 		{
@@ -48,8 +99,18 @@ namespace LC::Aggregator
 		void UpdateFeed (IDType_t);
 
 		void UpdateFeeds ();
+
+		const FetchStats& GetFetchStats () const;
+		QueueStats GetQueueStats () const;
 	private:
 		void HandleCustomUpdates ();
-		void RotateUpdatesQueue ();
+
+		void ScheduleUpdate (IDType_t, UpdatesScheduler::BackoffPolicy);
+		void PumpQueue ();
+		void StartFetch (IDType_t);
+		void FinishFetch (IDType_t, quint64 token, std::optional<UpdatesScheduler::Outcome> = {});
+
+		void HandleDownloaded (IDType_t, const QString& url, const QString& filename,
+				const IDownload::Success&, const std::optional<Feed::FetchState>& prevState);
 	};
 }
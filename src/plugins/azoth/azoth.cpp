@@ -13,11 +13,13 @@
 #include <QVBoxLayout>
 #include <QMenu>
 #include <QStringListModel>
+#include <QUrl>
 
 #ifdef ENABLE_MEDIACALLS
 #include <QAudioDeviceInfo>
 #endif
 
+#include <interfaces/entityconstants.h>
 #include <interfaces/entitytesthandleresult.h>
 #include <interfaces/imwproxy.h>
 #include <interfaces/ijobholderrepresentationhandler.h>
@@ -204,6 +206,29 @@ namespace Azoth
 		Core::Instance ().Handle (e);
 	}
 
+	QList<EntityCapability> Plugin::GetEntityCapabilities () const
+	{
+		EntityCapability imports;
+		imports.Mimes_ = QStringList
+		{
+			Mimes::PowerStateChanged,
+			"x-leechcraft/im-account-import",
+			"x-leechcraft/im-history-import"
+		};
+		imports.Priority_ = EntityTestHandleResult::PIdeal;
+
+		// The URIs are checked by the protocols, which live in the GUI thread.
+		EntityCapability uris;
+		uris.NeedsQuery_ = true;
+		uris.Predicate_ = [] (const Entity& e)
+		{
+			const auto& url = e.Entity_.toUrl ();
+			return e.Entity_.canConvert<QUrl> () && url.isValid () && !url.scheme ().isEmpty ();
+		};
+
+		return { imports, uris };
+	}
+
 	TabClasses_t Plugin::GetTabClasses () const
 	{
 		return TabClasses_;
@@ -18,6 +18,7 @@
 #include <interfaces/ijobholder.h>
 #include <interfaces/iactionsexporter.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/ihaveshortcuts.h>
 #include <interfaces/an/ianemitter.h>
 
@@ -40,6 +41,7 @@ namespace Azoth
 				 , public IJobHolder
 				 , public IActionsExporter
 				 , public IEntityHandler
+				 , public IHaveEntityCapabilities
 				 , public IHaveShortcuts
 				 , public IANEmitter
 	{
@@ -52,6 +54,7 @@ namespace Azoth
 				IJobHolder
 				IActionsExporter
 				IEntityHandler
+				IHaveEntityCapabilities
 				IHaveShortcuts
 				IANEmitter)
 
@@ -87,6 +90,8 @@ namespace Azoth
 		EntityTestHandleResult CouldHandle (const Entity&) const override;
 		void Handle (Entity) override;
 
+		QList<EntityCapability> GetEntityCapabilities () const override;
+
 		TabClasses_t GetTabClasses () const override;
 		void TabOpenRequested (const QByteArray&) override;
 
@@ -175,7 +175,7 @@ namespace ChatHistory
 	void Plugin::AddRawMessages (const QString& accountId, const QString& entryId,
 			const QString& visibleName, const QList<HistoryItem>& items)
 	{
-		StorageMgr_->AddLogItems (accountId, entryId, visibleName, items, true);
+		StorageMgr_->AddRawLogItems (accountId, entryId, visibleName, items);
 	}
 
 	void Plugin::initPlugin (QObject *proxy)
@@ -8,6 +8,7 @@
 
 #include "storage.h"
 #include <algorithm>
+#include <limits>
 #include <stdexcept>
 #include <QStringList>
 #include <QSqlDatabase>
@@ -32,6 +33,23 @@ namespace Azoth
 {
 namespace ChatHistory
 {
+	namespace
+	{
+		/* The position cache in azoth_history_blocks keeps the number of
+		 * messages per entry in every PositionBlockSize consecutive rowids,
+		 * so positions are counted over the blocks instead of the rows.
+		 * The one in azoth_history_days does the same for every day, since
+		 * the rowids of imported messages don't follow their dates.
+		 */
+		const qint64 PositionBlockSize = 4096;
+
+		const QStringList HistoryIndexes
+		{
+			"CREATE INDEX IF NOT EXISTS azoth_history_id_accountid ON azoth_history (Id, AccountId);",
+			"CREATE INDEX IF NOT EXISTS azoth_history_id_accountid_date ON azoth_history (Id, AccountId, Date);"
+		};
+	}
+
 	Storage::RawSearchResult::RawSearchResult (qint32 entryId, qint32 accountId, qint64 rowId)
 	: EntryID_ { entryId }
 	, AccountID_ { accountId }
@@ -45,11 +63,16 @@ namespace ChatHistory
 	}
 
 	Storage::Storage (QObject *parent)
+	: Storage (GetDatabasePath (), parent)
+	{
+	}
+
+	Storage::Storage (const QString& dbPath, QObject *parent)
 	: QObject (parent)
 	, DB_ (std::make_shared<QSqlDatabase> (QSqlDatabase::addDatabase ("QSQLITE",
 			Util::GenConnectionName ("Azoth.ChatHistory.HistoryConnection"))))
 	{
-		DB_->setDatabaseName (GetDatabasePath ());
+		DB_->setDatabaseName (dbPath);
 	}
 
 	QString Storage::GetDatabasePath ()
@@ -125,16 +148,34 @@ namespace ChatHistory
 				"WHERE azoth_acc2users2.UserId = azoth_users.Id AND azoth_acc2users2.AccountID = :account_id;");
 
 		RowID2Pos_ = QSqlQuery (*DB_);
-		RowID2Pos_.prepare ("SELECT COUNT(1) FROM azoth_history "
-				"WHERE Id = :entry_id "
-				"AND AccountID = :account_id "
-				"AND rowid > :rowid");
+		RowID2Pos_.prepare ("SELECT "
+				"(SELECT IFNULL(SUM(Count), 0) FROM azoth_history_blocks "
+					"WHERE Id = :entry_id "
+					"AND AccountId = :account_id "
+					"AND Block > :block) + "
+				"(SELECT COUNT(1) FROM azoth_history "
+					"WHERE Id = :entry_id_inner "
+					"AND AccountID = :account_id_inner "
+					"AND rowid > :rowid "
+					"AND rowid < :block_end);");
 
 		Date2Pos_ = QSqlQuery (*DB_);
-		Date2Pos_.prepare ("SELECT COUNT(1) FROM azoth_history "
+		Date2Pos_.prepare ("SELECT "
+				"(SELECT IFNULL(SUM(Count), 0) FROM azoth_history_days "
+					"WHERE Id = :entry_id "
+					"AND AccountId = :account_id "
+					"AND Day > :day) + "
+				"(SELECT COUNT(1) FROM azoth_history "
+					"WHERE Id = :entry_id_inner "
+					"AND AccountID = :account_id_inner "
+					"AND Date >= :date "
+					"AND Date < :next_day);");
+
+		BlockCountsGetter_ = QSqlQuery (*DB_);
+		BlockCountsGetter_.prepare ("SELECT Block, Count FROM azoth_history_blocks "
 				"WHERE Id = :entry_id "
-				"AND AccountID = :account_id "
-				"AND Date >= :date");
+				"AND AccountId = :account_id "
+				"ORDER BY Block DESC;");
 
 		GetMonthDates_ = QSqlQuery (*DB_);
 		GetMonthDates_.prepare ("SELECT Date FROM azoth_history "
@@ -172,6 +213,7 @@ namespace ChatHistory
 				"FROM azoth_history "
 				"WHERE Id = :entry_id "
 				"AND AccountID = :account_id "
+				"AND rowid < :upper_rowid "
 				"ORDER BY Rowid DESC LIMIT :limit OFFSET :offset;");
 
 		HistoryClearer_ = QSqlQuery (*DB_);
@@ -190,6 +232,12 @@ namespace ChatHistory
 		EntryCacheClearer_ = QSqlQuery (*DB_);
 		EntryCacheClearer_.prepare ("DELETE FROM azoth_entrycache WHERE Id = :user_id;");
 
+		if (HasFts_)
+			PrepareFullTextSearchers ();
+
+		// full scans are still useful as a baseline for benchmarking
+		UseFts_ = HasFts_ && !qEnvironmentVariableIsSet ("LC_AZOTH_CHATHISTORY_DISABLE_FTS");
+
 		try
 		{
 			Users_ = GetUsers ();
@@ -301,11 +349,15 @@ namespace ChatHistory
 
 		UpdateTables ();
 
-		if (!query.exec ("CREATE INDEX IF NOT EXISTS azoth_history_id_accountid ON azoth_history (Id, AccountId);"))
-		{
-			Util::DBLock::DumpError (query);
-			throw std::runtime_error ("Unable to index `azoth_history`.");
-		}
+		for (const auto& queryStr : HistoryIndexes)
+			if (!query.exec (queryStr))
+			{
+				Util::DBLock::DumpError (query);
+				throw std::runtime_error ("Unable to index `azoth_history`.");
+			}
+
+		InitializePositionCache ();
+		InitializeFullTextIndex ();
 
 		if (!hadAcc2User)
 			RegenUsersCache ();
@@ -348,6 +400,242 @@ namespace ChatHistory
 		}
 	}
 
+	void Storage::InitializePositionCache ()
+	{
+		const auto& tables = DB_->tables ();
+
+		/* Creates the table counting the messages of each entry by the
+		 * value of the key expression, stored in the given column, fills
+		 * it from the existing history and keeps it up to date by
+		 * triggers. The keyColumns are the columns the key depends on.
+		 */
+		auto createCache = [this, &tables] (const QString& table, const QString& column,
+				const QString& type, const QString& key, const QString& keyColumns)
+		{
+			if (tables.contains (table))
+				return;
+
+			const auto& increment = QString { "INSERT OR IGNORE INTO %1 (Id, AccountId, %2, Count) "
+						"VALUES (new.Id, new.AccountId, %3, 0); "
+					"UPDATE %1 SET Count = Count + 1 "
+						"WHERE Id = new.Id AND AccountId = new.AccountId AND %2 = %3; " }
+					.arg (table, column, key.arg ("new"));
+			const auto& decrement = QString { "UPDATE %1 SET Count = Count - 1 "
+						"WHERE Id = old.Id AND AccountId = old.AccountId AND %2 = %3; "
+					"DELETE FROM %1 "
+						"WHERE Id = old.Id AND AccountId = old.AccountId AND %2 = %3 AND Count <= 0; " }
+					.arg (table, column, key.arg ("old"));
+
+			const QStringList queries
+			{
+				"CREATE TABLE " + table + " ("
+					"Id INTEGER NOT NULL, "
+					"AccountId INTEGER NOT NULL, "
+					+ column + " " + type + " NOT NULL, "
+					"Count INTEGER NOT NULL, "
+					"PRIMARY KEY (Id, AccountId, " + column + ")"
+					") WITHOUT ROWID;",
+				"INSERT INTO " + table + " (Id, AccountId, " + column + ", Count) "
+					"SELECT Id, AccountId, " + key.arg ("azoth_history") + ", COUNT(1) FROM azoth_history "
+					"GROUP BY 1, 2, 3;",
+				"CREATE TRIGGER " + table + "_insert AFTER INSERT ON azoth_history BEGIN " +
+					increment +
+					"END;",
+				"CREATE TRIGGER " + table + "_delete AFTER DELETE ON azoth_history BEGIN " +
+					decrement +
+					"END;",
+				"CREATE TRIGGER " + table + "_update AFTER UPDATE OF " + keyColumns + " ON azoth_history BEGIN " +
+					decrement +
+					increment +
+					"END;"
+			};
+
+			QSqlQuery query { *DB_ };
+			for (const auto& queryStr : queries)
+				if (!query.exec (queryStr))
+				{
+					Util::DBLock::DumpError (query);
+					throw std::runtime_error ("Unable to create the position cache for `azoth_history`.");
+				}
+		};
+
+		createCache ("azoth_history_blocks", "Block", "INTEGER",
+				"%1.rowid / " + QString::number (PositionBlockSize), "Id, AccountId");
+		createCache ("azoth_history_days", "Day", "TEXT",
+				"substr(%1.Date, 1, 10)", "Id, AccountId, Date");
+	}
+
+	/* The full-text index is an external content FTS5 table over
+	 * azoth_history using the trigram tokenizer, so that it serves the
+	 * same LIKE and GLOB substring queries the search used to run over
+	 * the whole history table.
+	 *
+	 * The index is kept up to date by triggers. Messages that existed
+	 * before the index was created (those with rowid in (Done, Boundary]
+	 * of azoth_history_fts_state) are indexed incrementally by
+	 * BackfillFullTextIndex(), and the triggers skip them until then.
+	 */
+	void Storage::InitializeFullTextIndex ()
+	{
+		if (DB_->tables ().contains ("azoth_history_fts"))
+		{
+			HasFts_ = true;
+			FtsReady_ = IsFullTextIndexComplete ();
+			return;
+		}
+
+		QSqlQuery query { *DB_ };
+		if (!query.exec ("CREATE VIRTUAL TABLE azoth_history_fts USING fts5 "
+				"(Message, content='azoth_history', tokenize='trigram');"))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "FTS5 with the trigram tokenizer is unavailable, history search will be slow";
+			Util::DBLock::DumpError (query);
+			return;
+		}
+
+		const auto notBackfilled = [] (const QString& row)
+		{
+			return QString { "(%1.rowid > (SELECT Boundary FROM azoth_history_fts_state) "
+					"OR %1.rowid <= (SELECT Done FROM azoth_history_fts_state))" }
+					.arg (row);
+		};
+
+		const QStringList queries
+		{
+			"CREATE TABLE azoth_history_fts_state (Boundary INTEGER NOT NULL, Done INTEGER NOT NULL);",
+			"INSERT INTO azoth_history_fts_state (Boundary, Done) SELECT IFNULL(MAX(rowid), 0), 0 FROM azoth_history;",
+			"CREATE TRIGGER azoth_history_fts_insert AFTER INSERT ON azoth_history "
+				"WHEN " + notBackfilled ("new") + " BEGIN "
+				"INSERT INTO azoth_history_fts (rowid, Message) VALUES (new.rowid, new.Message); "
+				"END;",
+			"CREATE TRIGGER azoth_history_fts_delete AFTER DELETE ON azoth_history "
+				"WHEN " + notBackfilled ("old") + " BEGIN "
+				"INSERT INTO azoth_history_fts (azoth_history_fts, rowid, Message) VALUES ('delete', old.rowid, old.Message); "
+				"END;",
+			"CREATE TRIGGER azoth_history_fts_update AFTER UPDATE OF Message ON azoth_history "
+				"WHEN " + notBackfilled ("old") + " BEGIN "
+				"INSERT INTO azoth_history_fts (azoth_history_fts, rowid, Message) VALUES ('delete', old.rowid, old.Message); "
+				"INSERT INTO azoth_history_fts (rowid, Message) VALUES (new.rowid, new.Message); "
+				"END;"
+		};
+		for (const auto& queryStr : queries)
+			if (!query.exec (queryStr))
+			{
+				Util::DBLock::DumpError (query);
+				throw std::runtime_error ("Unable to create the full-text index for `azoth_history`.");
+			}
+
+		HasFts_ = true;
+		FtsReady_ = IsFullTextIndexComplete ();
+	}
+
+	bool Storage::IsFullTextIndexComplete ()
+	{
+		QSqlQuery query { *DB_ };
+		if (!query.exec ("SELECT Done >= Boundary FROM azoth_history_fts_state;") ||
+				!query.next ())
+		{
+			Util::DBLock::DumpError (query);
+			return false;
+		}
+
+		return query.value (0).toBool ();
+	}
+
+	namespace
+	{
+		QString MakeFullTextSearchQuery (const QString& fields, const QString& filter, const QString& op)
+		{
+			return "SELECT " + fields + " FROM azoth_history "
+					"WHERE rowid IN (SELECT rowid FROM azoth_history_fts WHERE Message " + op + " :text) " +
+					filter +
+					"ORDER BY rowid DESC "
+					"LIMIT 1 OFFSET :offset;";
+		}
+	}
+
+	void Storage::PrepareFullTextSearchers ()
+	{
+		auto prepare = [this] (FullTextSearchers& searchers, const QString& op)
+		{
+			searchers.ByEntry_ = QSqlQuery (*DB_);
+			searchers.ByEntry_.prepare (MakeFullTextSearchQuery ("rowid",
+					"AND Id = :entry_id AND AccountID = :account_id ", op));
+
+			searchers.ByAccount_ = QSqlQuery (*DB_);
+			searchers.ByAccount_.prepare (MakeFullTextSearchQuery ("rowid, Id",
+					"AND AccountID = :account_id ", op));
+
+			searchers.All_ = QSqlQuery (*DB_);
+			searchers.All_.prepare (MakeFullTextSearchQuery ("rowid, Id, AccountID", {}, op));
+		};
+
+		prepare (FtsSearchersCI_, "LIKE");
+		prepare (FtsSearchersCS_, "GLOB");
+	}
+
+	bool Storage::BackfillFullTextIndex ()
+	{
+		if (!HasFts_ || FtsReady_)
+			return false;
+
+		Util::DBLock lock (*DB_);
+		try
+		{
+			lock.Init ();
+		}
+		catch (const std::exception& e)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to start transaction:"
+					<< e.what ();
+			return false;
+		}
+
+		QSqlQuery query { *DB_ };
+		if (!query.exec ("SELECT Boundary, Done FROM azoth_history_fts_state;") ||
+				!query.next ())
+		{
+			Util::DBLock::DumpError (query);
+			return false;
+		}
+
+		const auto boundary = query.value (0).value<qint64> ();
+		const auto done = query.value (1).value<qint64> ();
+		query.finish ();
+
+		const qint64 chunkSize = 20000;
+		const auto upTo = std::min (done + chunkSize, boundary);
+
+		query.prepare ("INSERT INTO azoth_history_fts (rowid, Message) "
+				"SELECT rowid, Message FROM azoth_history WHERE rowid > :done AND rowid <= :up_to;");
+		query.bindValue (":done", done);
+		query.bindValue (":up_to", upTo);
+		if (!query.exec ())
+		{
+			Util::DBLock::DumpError (query);
+			return false;
+		}
+
+		query.prepare ("UPDATE azoth_history_fts_state SET Done = :up_to;");
+		query.bindValue (":up_to", upTo);
+		if (!query.exec ())
+		{
+			Util::DBLock::DumpError (query);
+			return false;
+		}
+
+		lock.Good ();
+
+		FtsReady_ = upTo >= boundary;
+		if (FtsReady_)
+			qDebug () << Q_FUNC_INFO
+					<< "full-text index is complete";
+
+		return !FtsReady_;
+	}
+
 	QHash<QString, qint32> Storage::GetUsers ()
 	{
 		if (!UserSelector_.exec ())
@@ -622,11 +910,105 @@ namespace ChatHistory
 		};
 	}
 
+	Storage::RawSearchResult Storage::SearchFullTextImpl (const QString& accountId,
+			const QString& entryId, const QString& text, int shift, bool cs)
+	{
+		auto& searchers = cs ? FtsSearchersCS_ : FtsSearchersCI_;
+
+		std::optional<qint32> intAccId;
+		if (!accountId.isEmpty ())
+		{
+			if (!Accounts_.contains (accountId))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "Accounts_ doesn't contain"
+						<< accountId
+						<< "; raw contents"
+						<< Accounts_;
+				return {};
+			}
+			intAccId = Accounts_ [accountId];
+		}
+
+		std::optional<qint32> intEntryId;
+		if (intAccId && !entryId.isEmpty ())
+		{
+			if (!Users_.contains (entryId))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "Users_ doesn't contain"
+						<< entryId
+						<< "; raw contents"
+						<< Users_;
+				return {};
+			}
+			intEntryId = Users_ [entryId];
+		}
+
+		auto& query = intEntryId ?
+				searchers.ByEntry_ :
+				(intAccId ? searchers.ByAccount_ : searchers.All_);
+		if (intEntryId)
+			query.bindValue (":entry_id", *intEntryId);
+		if (intAccId)
+			query.bindValue (":account_id", *intAccId);
+		query.bindValue (":text", cs ? '*' + text + '*' : '%' + text + '%');
+		query.bindValue (":offset", shift);
+		if (!query.exec ())
+		{
+			Util::DBLock::DumpError (query);
+			return {};
+		}
+		auto guard = CleanupQueryGuard (query);
+
+		if (!query.next ())
+			return {};
+
+		return
+		{
+			intEntryId ? *intEntryId : query.value (1).toInt (),
+			intAccId ? *intAccId : query.value (2).toInt (),
+			query.value (0).value<qint64> ()
+		};
+	}
+
+	std::optional<Storage::PageStart> Storage::GetPageStart (qint32 entryId, qint32 accountId, int offset)
+	{
+		BlockCountsGetter_.bindValue (":entry_id", entryId);
+		BlockCountsGetter_.bindValue (":account_id", accountId);
+		if (!BlockCountsGetter_.exec ())
+		{
+			Util::DBLock::DumpError (BlockCountsGetter_);
+			return PageStart { std::numeric_limits<qint64>::max (), offset };
+		}
+
+		int skipped = 0;
+		while (BlockCountsGetter_.next ())
+		{
+			const auto count = BlockCountsGetter_.value (1).toInt ();
+			if (skipped + count > offset)
+			{
+				const auto block = BlockCountsGetter_.value (0).value<qint64> ();
+				BlockCountsGetter_.finish ();
+				return PageStart { (block + 1) * PositionBlockSize, offset - skipped };
+			}
+
+			skipped += count;
+		}
+
+		return {};
+	}
+
 	SearchResult_t Storage::SearchRowIdImpl (qint32 accountId, qint32 entryId, qint64 rowId)
 	{
+		const auto block = rowId / PositionBlockSize;
+		RowID2Pos_.bindValue (":block", block);
+		RowID2Pos_.bindValue (":block_end", (block + 1) * PositionBlockSize);
 		RowID2Pos_.bindValue (":rowid", rowId);
 		RowID2Pos_.bindValue (":account_id", accountId);
 		RowID2Pos_.bindValue (":entry_id", entryId);
+		RowID2Pos_.bindValue (":account_id_inner", accountId);
+		RowID2Pos_.bindValue (":entry_id_inner", entryId);
 		if (!RowID2Pos_.exec ())
 		{
 			Util::DBLock::DumpError (RowID2Pos_);
@@ -644,9 +1026,15 @@ namespace ChatHistory
 
 	SearchResult_t Storage::SearchDateImpl (qint32 accountId, qint32 entryId, const QDateTime& dt)
 	{
+		// the dates are stored as ISO strings, so the days are their prefixes
+		const auto& day = dt.date ();
+		Date2Pos_.bindValue (":day", day.toString (Qt::ISODate));
+		Date2Pos_.bindValue (":next_day", day.addDays (1).toString (Qt::ISODate));
 		Date2Pos_.bindValue (":date", dt);
 		Date2Pos_.bindValue (":account_id", accountId);
 		Date2Pos_.bindValue (":entry_id", entryId);
+		Date2Pos_.bindValue (":account_id_inner", accountId);
+		Date2Pos_.bindValue (":entry_id_inner", entryId);
 		if (!Date2Pos_.exec ())
 		{
 			Util::DBLock::DumpError (Date2Pos_);
@@ -746,6 +1134,10 @@ namespace ChatHistory
 
 	namespace
 	{
+		const double FuzzyDateTolerance = 0.1;
+
+		const int MinRebuildIndexBatch = 10000;
+
 		void BindStrict (QSqlQuery& dumper, qint32 userId, qint32 accountId, const LogItem& logItem)
 		{
 			dumper.bindValue (":id", userId);
@@ -768,27 +1160,13 @@ namespace ChatHistory
 			dumper.bindValue (":date_inner", logItem.Date_);
 			dumper.bindValue (":direction_inner", ToVariant (logItem.Dir_));
 			dumper.bindValue (":message_inner", logItem.Message_);
-			dumper.bindValue (":tolerance", 0.1);
+			dumper.bindValue (":tolerance", FuzzyDateTolerance);
 		}
 	}
 
-	void Storage::AddMessages (const QString& accountID,
-			const QString& entryID, const QString& visibleName,
-			const QList<LogItem>& items, bool fuzzy)
+	std::optional<qint32> Storage::PrepareEntry (const QString& accountID,
+			const QString& entryID, const QString& visibleName)
 	{
-		Util::DBLock lock (*DB_);
-		try
-		{
-			lock.Init ();
-		}
-		catch (const std::exception& e)
-		{
-			qWarning () << Q_FUNC_INFO
-					<< "unable to start transaction:"
-					<< e.what ();
-			return;
-		}
-
 		if (!Accounts_.contains (accountID))
 			try
 			{
@@ -800,7 +1178,7 @@ namespace ChatHistory
 						<< accountID
 						<< "unable to add account ID to the DB:"
 						<< e.what ();
-				return;
+				return {};
 			}
 
 		if (!Users_.contains (entryID))
@@ -814,7 +1192,7 @@ namespace ChatHistory
 						<< entryID
 						<< "unable to add the user to the DB:"
 						<< e.what ();
-				return;
+				return {};
 			}
 
 		auto userId = Users_ [entryID];
@@ -828,14 +1206,38 @@ namespace ChatHistory
 			EntryCache_ [userId] = visibleName;
 		}
 
+		return userId;
+	}
+
+	void Storage::AddMessages (const QString& accountID,
+			const QString& entryID, const QString& visibleName,
+			const QList<LogItem>& items, bool fuzzy)
+	{
+		Util::DBLock lock (*DB_);
+		try
+		{
+			lock.Init ();
+		}
+		catch (const std::exception& e)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to start transaction:"
+					<< e.what ();
+			return;
+		}
+
+		const auto userId = PrepareEntry (accountID, entryID, visibleName);
+		if (!userId)
+			return;
+
 		for (const auto& logItem : items)
 		{
 			auto& query = fuzzy ? MessageDumperFuzzy_ : MessageDumper_;
 
 			if (fuzzy)
-				BindFuzzy (query, userId, Accounts_ [accountID], logItem);
+				BindFuzzy (query, *userId, Accounts_ [accountID], logItem);
 			else
-				BindStrict (query, userId, Accounts_ [accountID], logItem);
+				BindStrict (query, *userId, Accounts_ [accountID], logItem);
 
 			if (!query.exec ())
 			{
@@ -847,6 +1249,150 @@ namespace ChatHistory
 		lock.Good ();
 	}
 
+	namespace
+	{
+		bool ExecIngestQuery (QSqlQuery& query, const QString& text)
+		{
+			if (!query.exec (text))
+			{
+				Util::DBLock::DumpError (query);
+				return false;
+			}
+			return true;
+		}
+
+		/* Drops the staged rows duplicating either an earlier staged row or
+		 * a message already in the history, matched the same way as in
+		 * MessageDumperFuzzy_.
+		 */
+		const QString IngestDedupQuery = R"(
+				DELETE FROM azoth_history_ingest
+				WHERE EXISTS (
+					SELECT 1 FROM azoth_history_ingest AS other
+					WHERE other.rowid < azoth_history_ingest.rowid
+						AND other.Id = azoth_history_ingest.Id
+						AND other.AccountId = azoth_history_ingest.AccountId
+						AND other.Direction = azoth_history_ingest.Direction
+						AND other.Message = azoth_history_ingest.Message
+						AND abs(other.Date - azoth_history_ingest.Date) < :tolerance
+				) OR EXISTS (
+					SELECT 1 FROM azoth_history AS hist
+					WHERE hist.Id = azoth_history_ingest.Id
+						AND hist.AccountId = azoth_history_ingest.AccountId
+						AND hist.Direction = azoth_history_ingest.Direction
+						AND hist.Message = azoth_history_ingest.Message
+						AND abs(hist.Date - azoth_history_ingest.Date) < :tolerance_hist
+				);
+				)";
+	}
+
+	void Storage::AddMessagesBulk (const QList<LogItemsBatch>& batches)
+	{
+		Util::DBLock lock (*DB_);
+		try
+		{
+			lock.Init ();
+		}
+		catch (const std::exception& e)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to start transaction:"
+					<< e.what ();
+			return;
+		}
+
+		QSqlQuery query (*DB_);
+		if (!ExecIngestQuery (query, "CREATE TEMP TABLE IF NOT EXISTS azoth_history_ingest ("
+					"Id INTEGER, "
+					"AccountId INTEGER, "
+					"Date DATETIME, "
+					"Direction INTEGER, "
+					"Message TEXT, "
+					"Variant TEXT, "
+					"Type INTEGER, "
+					"RichMessage TEXT, "
+					"EscapePolicy VARCHAR(3));") ||
+				!ExecIngestQuery (query, "DROP INDEX IF EXISTS temp.azoth_history_ingest_key;") ||
+				!ExecIngestQuery (query, "DELETE FROM azoth_history_ingest;"))
+			return;
+
+		QSqlQuery stager (*DB_);
+		stager.prepare ("INSERT INTO azoth_history_ingest (Id, AccountId, Date, Direction, Message, Variant, Type, RichMessage, EscapePolicy) "
+				"VALUES (:id, :account_id, :date, :direction, :message, :variant, :type, :rich_message, :escape_policy);");
+
+		int staged = 0;
+		for (const auto& batch : batches)
+		{
+			const auto userId = PrepareEntry (batch.AccountId_, batch.EntryId_, batch.VisibleName_);
+			if (!userId)
+				return;
+
+			const auto accountId = Accounts_ [batch.AccountId_];
+			for (const auto& logItem : batch.Items_)
+			{
+				BindStrict (stager, *userId, accountId, logItem);
+				if (!stager.exec ())
+				{
+					Util::DBLock::DumpError (stager);
+					return;
+				}
+			}
+
+			staged += batch.Items_.size ();
+		}
+
+		if (!staged)
+		{
+			lock.Good ();
+			return;
+		}
+
+		if (!ExecIngestQuery (query, "CREATE INDEX temp.azoth_history_ingest_key "
+					"ON azoth_history_ingest (Id, AccountId, Direction, Message);"))
+			return;
+
+		QSqlQuery dedup (*DB_);
+		dedup.prepare (IngestDedupQuery);
+		dedup.bindValue (":tolerance", FuzzyDateTolerance);
+		dedup.bindValue (":tolerance_hist", FuzzyDateTolerance);
+		if (!dedup.exec ())
+		{
+			Util::DBLock::DumpError (dedup);
+			return;
+		}
+
+		/* Maintaining the index row by row is more expensive than rebuilding
+		 * it when the batch is comparable to the history itself, like
+		 * during the first sync or import. It isn't needed after the dedup
+		 * above anyway.
+		 */
+		if (!ExecIngestQuery (query, "SELECT max(rowid) FROM azoth_history;"))
+			return;
+		const auto historySize = query.next () ? query.value (0).toLongLong () : 0;
+		query.finish ();
+
+		const bool rebuildIndex = staged >= MinRebuildIndexBatch && staged * 4 >= historySize;
+		if (rebuildIndex &&
+				(!ExecIngestQuery (query, "DROP INDEX IF EXISTS azoth_history_id_accountid;") ||
+				 !ExecIngestQuery (query, "DROP INDEX IF EXISTS azoth_history_id_accountid_date;")))
+			return;
+
+		if (!ExecIngestQuery (query, "INSERT INTO azoth_history (Id, AccountID, Date, Direction, Message, Variant, Type, RichMessage, EscapePolicy) "
+					"SELECT Id, AccountId, Date, Direction, Message, Variant, Type, RichMessage, EscapePolicy "
+					"FROM azoth_history_ingest ORDER BY rowid;"))
+			return;
+
+		if (rebuildIndex)
+			for (const auto& queryStr : HistoryIndexes)
+				if (!ExecIngestQuery (query, queryStr))
+					return;
+
+		if (!ExecIngestQuery (query, "DELETE FROM azoth_history_ingest;"))
+			return;
+
+		lock.Good ();
+	}
+
 	IHistoryPlugin::MaxTimestampResult_t Storage::GetMaxTimestamp (const QString& accountId)
 	{
 		using R_t = IHistoryPlugin::MaxTimestampResult_t;
@@ -949,10 +1495,15 @@ namespace ChatHistory
 			return ChatLogsResult_t::Left ("Unknown user.");
 		}
 
+		const auto& pageStart = GetPageStart (Users_ [entryId], Accounts_ [accountId], amount * backpages);
+		if (!pageStart)
+			return ChatLogsResult_t::Right ({});
+
 		HistoryGetter_.bindValue (":entry_id", Users_ [entryId]);
 		HistoryGetter_.bindValue (":account_id", Accounts_ [accountId]);
+		HistoryGetter_.bindValue (":upper_rowid", pageStart->UpperRowId_);
 		HistoryGetter_.bindValue (":limit", amount);
-		HistoryGetter_.bindValue (":offset", amount * backpages);
+		HistoryGetter_.bindValue (":offset", pageStart->Offset_);
 
 		if (!HistoryGetter_.exec ())
 		{
@@ -981,7 +1532,10 @@ namespace ChatHistory
 			const QString& entryId, const QString& text, int shift, bool cs)
 	{
 		RawSearchResult res;
-		if (!accountId.isEmpty () && !entryId.isEmpty ())
+		// trigram index can't help with shorter strings
+		if (UseFts_ && FtsReady_ && text.size () >= 3)
+			res = SearchFullTextImpl (accountId, entryId, text, shift, cs);
+		else if (!accountId.isEmpty () && !entryId.isEmpty ())
 			res = SearchImpl (accountId, entryId, text, shift, cs);
 		else if (!accountId.isEmpty ())
 			res = SearchImpl (accountId, text, shift, cs);
@@ -44,6 +44,7 @@ namespace ChatHistory
 		QSqlQuery UsersForAccountGetter_;
 		QSqlQuery RowID2Pos_;
 		QSqlQuery Date2Pos_;
+		QSqlQuery BlockCountsGetter_;
 		QSqlQuery GetMonthDates_;
 		QSqlQuery LogsSearcher_;
 		QSqlQuery LogsSearcherWOContact_;
@@ -55,6 +56,19 @@ namespace ChatHistory
 		QSqlQuery EntryCacheGetter_;
 		QSqlQuery EntryCacheClearer_;
 
+		struct FullTextSearchers
+		{
+			QSqlQuery ByEntry_;
+			QSqlQuery ByAccount_;
+			QSqlQuery All_;
+		};
+		FullTextSearchers FtsSearchersCI_;
+		FullTextSearchers FtsSearchersCS_;
+
+		bool HasFts_ = false;
+		bool FtsReady_ = false;
+		bool UseFts_ = false;
+
 		QHash<QString, qint32> Users_;
 		QHash<QString, qint32> Accounts_;
 
@@ -73,6 +87,7 @@ namespace ChatHistory
 		};
 	public:
 		Storage (QObject* = nullptr);
+		explicit Storage (const QString& dbPath, QObject* = nullptr);
 
 		struct GeneralError
 		{
@@ -98,6 +113,15 @@ namespace ChatHistory
 		void AddMessages (const QString& accountId, const QString& entryId,
 				const QString& visibleName, const QList<LogItem>&, bool fuzzy);
 
+		/** @brief Adds the messages from several entries in one go.
+		 *
+		 * This is meant for archive syncs and imports: the messages are
+		 * deduplicated the same way as in AddMessages() with fuzzy set to
+		 * true, but as a whole in a single transaction via a temporary
+		 * staging table, instead of a subquery per message.
+		 */
+		void AddMessagesBulk (const QList<LogItemsBatch>&);
+
 		SearchResult_t Search (const QString& accountId, const QString& entryId,
 				const QString& text, int shift, bool cs);
 		SearchResult_t SearchDate (const QString& accountId,
@@ -109,15 +133,27 @@ namespace ChatHistory
 
 		void RegenUsersCache ();
 		void ClearHistory (const QString& accountId, const QString& entryId);
+
+		/** @brief Indexes the next chunk of the messages predating the full-text index.
+		 *
+		 * @return Whether there are more messages left to index.
+		 */
+		bool BackfillFullTextIndex ();
 	private:
 		void InitializeTables ();
 		void UpdateTables ();
+		void InitializePositionCache ();
+		void InitializeFullTextIndex ();
+		void PrepareFullTextSearchers ();
+		bool IsFullTextIndexComplete ();
 
 		QHash<QString, qint32> GetUsers ();
 		qint32 GetUserID (const QString&);
 		void AddUser (const QString& id, const QString& accountId);
 
 		void PrepareEntryCache ();
+		std::optional<qint32> PrepareEntry (const QString& accountId,
+				const QString& entryId, const QString& visibleName);
 
 		QHash<QString, qint32> GetAccounts ();
 		qint32 GetAccountID (const QString&);
@@ -126,6 +162,15 @@ namespace ChatHistory
 				const QString& text, int shift, bool cs);
 		RawSearchResult SearchImpl (const QString& accountId, const QString& text, int shift, bool cs);
 		RawSearchResult SearchImpl (const QString& text, int shift, bool cs);
+		RawSearchResult SearchFullTextImpl (const QString& accountId, const QString& entryId,
+				const QString& text, int shift, bool cs);
+
+		struct PageStart
+		{
+			qint64 UpperRowId_;
+			int Offset_;
+		};
+		std::optional<PageStart> GetPageStart (qint32 entryId, qint32 accountId, int offset);
 
 		SearchResult_t SearchRowIdImpl (qint32, qint32, qint64);
 		SearchResult_t SearchDateImpl (qint32, qint32, const QDateTime&);
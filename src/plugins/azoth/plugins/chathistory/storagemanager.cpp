@@ -8,7 +8,9 @@
 
 #include "storagemanager.h"
 #include <cmath>
+#include <utility>
 #include <QMessageBox>
+#include <QTimer>
 #include <util/util.h>
 #include <util/threads/futures.h>
 #include <util/threads/workerthreadbase.h>
@@ -40,6 +42,7 @@ namespace ChatHistory
 					if (res.IsRight ())
 					{
 						StorageThread_->SetPaused (false);
+						BackfillFullTextIndex ();
 						return;
 					}
 
@@ -149,6 +152,18 @@ namespace ChatHistory
 				fuzzy);
 	}
 
+	void StorageManager::AddRawLogItems (const QString& accountId, const QString& entryId,
+			const QString& visibleName, const QList<LogItem>& items)
+	{
+		if (items.isEmpty ())
+			return;
+
+		if (PendingRawItems_.isEmpty ())
+			QTimer::singleShot (0, this, [this] { FlushRawLogItems (); });
+
+		PendingRawItems_.push_back ({ accountId, entryId, visibleName, items });
+	}
+
 	QFuture<IHistoryPlugin::MaxTimestampResult_t> StorageManager::GetMaxTimestamp (const QString& accId)
 	{
 		return StorageThread_->ScheduleImpl (&Storage::GetMaxTimestamp, accId);
@@ -196,6 +211,22 @@ namespace ChatHistory
 		StorageThread_->ScheduleImpl (&Storage::RegenUsersCache);
 	}
 
+	void StorageManager::BackfillFullTextIndex ()
+	{
+		// one chunk at a time in the low priority lane, so that the other requests aren't blocked for long
+		Util::Sequence (this, StorageThread_->ScheduleImpl (StorageThread::Priority::Low, &Storage::BackfillFullTextIndex)) >>
+				[this] (bool hasMore)
+				{
+					if (hasMore)
+						BackfillFullTextIndex ();
+				};
+	}
+
+	void StorageManager::FlushRawLogItems ()
+	{
+		StorageThread_->ScheduleImpl (&Storage::AddMessagesBulk, std::exchange (PendingRawItems_, {}));
+	}
+
 	void StorageManager::StartStorage ()
 	{
 		StorageThread_->SetPaused (false);
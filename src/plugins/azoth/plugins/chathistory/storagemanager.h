@@ -26,12 +26,21 @@ namespace ChatHistory
 	{
 		const std::shared_ptr<StorageThread> StorageThread_;
 		LoggingStateKeeper * const LoggingStateKeeper_;
+
+		QList<LogItemsBatch> PendingRawItems_;
 	public:
 		StorageManager (LoggingStateKeeper*);
 
 		void Process (QObject*);
 		void AddLogItems (const QString&, const QString&, const QString&, const QList<LogItem>&, bool);
 
+		/** @brief Queues the history items coming from a server archive or an import.
+		 *
+		 * The items queued during the same event loop iteration are
+		 * written in a single bulk transaction.
+		 */
+		void AddRawLogItems (const QString&, const QString&, const QString&, const QList<LogItem>&);
+
 		QFuture<IHistoryPlugin::MaxTimestampResult_t> GetMaxTimestamp (const QString&);
 
 		QFuture<QStringList> GetOurAccounts ();
@@ -51,6 +60,8 @@ namespace ChatHistory
 		void RegenUsersCache ();
 	private:
 		void StartStorage ();
+		void BackfillFullTextIndex ();
+		void FlushRawLogItems ();
 		void HandleStorageError (const Storage::InitializationError_t&);
 		void HandleDumpFinished (qint64, qint64);
 	};
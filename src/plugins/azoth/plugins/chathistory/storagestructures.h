@@ -29,6 +29,14 @@ namespace ChatHistory
 	using LogItem = HistoryItem;
 	using LogList_t = QList<LogItem>;
 
+	struct LogItemsBatch
+	{
+		QString AccountId_;
+		QString EntryId_;
+		QString VisibleName_;
+		LogList_t Items_;
+	};
+
 	using UsersForAccountResult_t = Util::Either<QString, UsersForAccount>;
 
 	using ChatLogsResult_t = Util::Either<QString, LogList_t>;
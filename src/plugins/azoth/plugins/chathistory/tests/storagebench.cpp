@@ -0,0 +1,340 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "storagebench.h"
+#include <limits>
+#include <random>
+#include <QtTest>
+#include <QSqlQuery>
+#include "storage.h"
+
+QTEST_GUILESS_MAIN (LC::Azoth::ChatHistory::StorageBench)
+
+namespace LC::Azoth::ChatHistory
+{
+	namespace
+	{
+		const QString AccountId = "bench@example.org";
+		const int ContactsCount = 20;
+
+		QString GetEntryId (int idx)
+		{
+			return QString { "contact%1@example.org" }.arg (idx);
+		}
+
+		int GetMessagesCount ()
+		{
+			bool ok = false;
+			const auto count = qEnvironmentVariableIntValue ("LC_AZOTH_CHATHISTORY_BENCH_MESSAGES", &ok);
+			return ok ? count : 100000;
+		}
+	}
+
+	namespace
+	{
+		LogItem MakeItem (const QDateTime& date, const QString& text)
+		{
+			return
+			{
+				date,
+				IMessage::Direction::In,
+				text,
+				{},
+				IMessage::Type::ChatMessage,
+				{},
+				IMessage::EscapePolicy::Escape
+			};
+		}
+
+		int CountEntryMessages (Storage& storage, const QString& entryId)
+		{
+			const auto& logs = storage.GetChatLogs (AccountId, entryId, 0, std::numeric_limits<int>::max ());
+			return logs.IsRight () ? logs.GetRight ().size () : -1;
+		}
+
+		// Compares SearchDate() to counting the messages since each date.
+		void CheckDatePositions (Storage& storage, const QString& entryId, const QList<QDateTime>& dates)
+		{
+			QSqlQuery naive { storage.GetDB () };
+			naive.prepare ("SELECT COUNT(1) FROM azoth_history "
+					"WHERE Id = (SELECT Id FROM azoth_users WHERE EntryID = :entry_id) "
+					"AND Date >= :date;");
+			for (const auto& date : dates)
+			{
+				naive.bindValue (":entry_id", entryId);
+				naive.bindValue (":date", date);
+				QVERIFY (naive.exec () && naive.next ());
+
+				const auto& pos = storage.SearchDate (AccountId, entryId, date);
+				QVERIFY (pos.IsRight ());
+				QCOMPARE (pos.GetRight ().value_or (-1), naive.value (0).toInt ());
+				naive.finish ();
+			}
+		}
+	}
+
+	QString StorageBench::GetDBPath () const
+	{
+		return Dir_.filePath ("history.db");
+	}
+
+	/* The history is synthetic: messages of random words from a small
+	 * dictionary spread over several contacts, with a rare word in every
+	 * 10000th message. Set LC_AZOTH_CHATHISTORY_BENCH_MESSAGES to change
+	 * the history size (the default is 100000, use 10000000 to reproduce
+	 * the multi-GB case).
+	 */
+	void StorageBench::initTestCase ()
+	{
+		QVERIFY (Dir_.isValid ());
+
+		Storage storage { GetDBPath () };
+		QVERIFY (storage.Initialize ().IsRight ());
+
+		const QStringList words
+		{
+			"hello", "world", "meeting", "tomorrow", "lunch", "release", "build",
+			"thanks", "sure", "link", "review", "patch", "weekend", "coffee"
+		};
+
+		std::mt19937 gen { 42 };
+		std::uniform_int_distribution<int> wordDist { 0, static_cast<int> (words.size ()) - 1 };
+		std::uniform_int_distribution<int> lengthDist { 3, 15 };
+
+		const auto total = GetMessagesCount ();
+		const int batchSize = 10000;
+		auto date = QDateTime::currentDateTime ().addSecs (-total);
+		for (int batchStart = 0; batchStart < total; batchStart += batchSize)
+		{
+			QList<LogItem> items;
+			for (int i = batchStart; i < std::min (total, batchStart + batchSize); ++i)
+			{
+				QStringList msgWords;
+				for (int j = 0, length = lengthDist (gen); j < length; ++j)
+					msgWords << words.at (wordDist (gen));
+				if (!(i % 10000))
+					msgWords << "needle";
+
+				date = date.addSecs (1);
+				items.push_back ({
+						date,
+						i % 2 ? IMessage::Direction::In : IMessage::Direction::Out,
+						msgWords.join (' '),
+						{},
+						IMessage::Type::ChatMessage,
+						{},
+						IMessage::EscapePolicy::Escape
+					});
+			}
+
+			storage.AddMessages (AccountId, GetEntryId ((batchStart / batchSize) % ContactsCount), {}, items, false);
+		}
+
+		QCOMPARE (storage.GetAllHistoryCount ().value_or (0), total);
+	}
+
+	void StorageBench::benchSearch_data ()
+	{
+		QTest::addColumn<bool> ("fts");
+		QTest::addColumn<bool> ("withEntry");
+		QTest::addColumn<QString> ("text");
+
+		for (const auto fts : { false, true })
+		{
+			const auto prefix = fts ? "fts" : "scan";
+			QTest::addRow ("%s, entry, rare", prefix) << fts << true << "needle";
+			QTest::addRow ("%s, entry, missing", prefix) << fts << true << "nonexistent";
+			QTest::addRow ("%s, account, rare", prefix) << fts << false << "needle";
+			QTest::addRow ("%s, account, missing", prefix) << fts << false << "nonexistent";
+		}
+	}
+
+	void StorageBench::benchSearch ()
+	{
+		QFETCH (bool, fts);
+		QFETCH (bool, withEntry);
+		QFETCH (QString, text);
+
+		if (fts)
+			qunsetenv ("LC_AZOTH_CHATHISTORY_DISABLE_FTS");
+		else
+			qputenv ("LC_AZOTH_CHATHISTORY_DISABLE_FTS", "1");
+
+		Storage storage { GetDBPath () };
+		QVERIFY (storage.Initialize ().IsRight ());
+		while (storage.BackfillFullTextIndex ())
+			;
+
+		const auto& entryId = withEntry ? GetEntryId (0) : QString {};
+		QBENCHMARK
+		{
+			const auto& result = storage.Search (AccountId, entryId, text, 0, false);
+			QVERIFY (result.IsRight ());
+		}
+	}
+
+	void StorageBench::testPositions ()
+	{
+		Storage storage { GetDBPath () };
+		QVERIFY (storage.Initialize ().IsRight ());
+
+		const auto& entryId = GetEntryId (0);
+		const auto all = storage.GetChatLogs (AccountId, entryId, 0, std::numeric_limits<int>::max ()).GetRight ();
+		QVERIFY (!all.isEmpty ());
+
+		const int perPage = 100;
+		for (const auto page : { 0, 1, 7, (all.size () - 1) / perPage })
+		{
+			const auto logs = storage.GetChatLogs (AccountId, entryId, page, perPage).GetRight ();
+			const auto& expected = all.mid (page * perPage, perPage);
+			QCOMPARE (logs.size (), expected.size ());
+			for (int i = 0; i < logs.size (); ++i)
+				QCOMPARE (logs [i].Date_, expected [i].Date_);
+		}
+		QVERIFY (storage.GetChatLogs (AccountId, entryId, all.size () / perPage + 1, perPage).GetRight ().isEmpty ());
+
+		QList<QDateTime> dates;
+		for (const auto idx : { 0, 1, all.size () / 2, all.size () - 1 })
+			dates << all [idx].Date_;
+		CheckDatePositions (storage, entryId, dates);
+
+		Storage imported { Dir_.filePath ("positions.db") };
+		QVERIFY (imported.Initialize ().IsRight ());
+
+		const auto& now = QDateTime::currentDateTime ();
+
+		auto makeItems = [] (const QDateTime& from, int count, int step)
+		{
+			QList<LogItem> items;
+			for (int i = 0; i < count; ++i)
+				items << MakeItem (from.addSecs (i * step), QString { "message %1" }.arg (i));
+			return items;
+		};
+
+		// The imported messages are older than the ones already stored,
+		// but get greater rowids, and some of them share days with them.
+		imported.AddMessages (AccountId, entryId, {}, makeItems (now.addDays (-3), 100, 3600), false);
+		imported.AddMessagesBulk ({ { AccountId, entryId, {}, makeItems (now.addDays (-10), 100, 5000) } });
+		imported.AddMessages (AccountId, entryId, {}, makeItems (now.addSecs (-100), 10, 1), false);
+
+		dates = { now.addDays (-20), now.addDays (-10), now.addDays (-5).addSecs (1234),
+				now.addDays (-3), now.addDays (-2).addSecs (-1), now.addSecs (-95), now.addDays (1) };
+		for (const auto& item : imported.GetChatLogs (AccountId, entryId, 0, std::numeric_limits<int>::max ()).GetRight ())
+			if (item.Message_.endsWith ('7'))
+				dates << item.Date_;
+		CheckDatePositions (imported, entryId, dates);
+	}
+
+	void StorageBench::benchPositions_data ()
+	{
+		QTest::addColumn<bool> ("byDate");
+
+		QTest::newRow ("date") << true;
+		QTest::newRow ("last page") << false;
+	}
+
+	void StorageBench::benchPositions ()
+	{
+		QFETCH (bool, byDate);
+
+		Storage storage { GetDBPath () };
+		QVERIFY (storage.Initialize ().IsRight ());
+
+		const auto& entryId = GetEntryId (0);
+		const auto all = storage.GetChatLogs (AccountId, entryId, 0, std::numeric_limits<int>::max ()).GetRight ();
+		const auto& oldestDate = all.last ().Date_;
+		const int perPage = 100;
+
+		QBENCHMARK
+		{
+			if (byDate)
+				QVERIFY (storage.SearchDate (AccountId, entryId, oldestDate).IsRight ());
+			else
+				QVERIFY (!storage.GetChatLogs (AccountId, entryId, (all.size () - 1) / perPage, perPage).GetRight ().isEmpty ());
+		}
+	}
+
+	void StorageBench::testBulkDedup ()
+	{
+		Storage storage { Dir_.filePath ("dedup.db") };
+		QVERIFY (storage.Initialize ().IsRight ());
+
+		const auto& entryId = GetEntryId (0);
+		const auto& date = QDateTime::currentDateTime ();
+		storage.AddMessages (AccountId, entryId, {}, { MakeItem (date, "first") }, false);
+
+		storage.AddMessagesBulk ({
+				{
+					AccountId,
+					entryId,
+					{},
+					{
+						MakeItem (date, "first"),
+						MakeItem (date.addSecs (1), "second"),
+						MakeItem (date.addSecs (1), "second"),
+						MakeItem (date.addSecs (2), "third")
+					}
+				},
+				{ AccountId, GetEntryId (1), {}, { MakeItem (date, "first") } }
+			});
+
+		QCOMPARE (CountEntryMessages (storage, entryId), 3);
+		QCOMPARE (CountEntryMessages (storage, GetEntryId (1)), 1);
+
+		const auto logs = storage.GetChatLogs (AccountId, entryId, 0, 3).GetRight ();
+		QCOMPARE (logs.value (0).Message_, QString { "third" });
+		QCOMPARE (logs.value (2).Message_, QString { "first" });
+	}
+
+	void StorageBench::benchIngest_data ()
+	{
+		QTest::addColumn<bool> ("bulk");
+
+		QTest::newRow ("per entry") << false;
+		QTest::newRow ("bulk") << true;
+	}
+
+	/* Replays an archive sync over the history from initTestCase(): each
+	 * contact gets its already stored messages back along with a few new
+	 * ones, and most of the work is deduplicating them.
+	 */
+	void StorageBench::benchIngest ()
+	{
+		QFETCH (bool, bulk);
+
+		const auto& path = Dir_.filePath (bulk ? "ingest-bulk.db" : "ingest-entry.db");
+		QVERIFY (QFile::copy (GetDBPath (), path));
+
+		Storage storage { path };
+		QVERIFY (storage.Initialize ().IsRight ());
+
+		QList<LogItemsBatch> batches;
+		for (int i = 0; i < ContactsCount; ++i)
+		{
+			const auto& entryId = GetEntryId (i);
+			auto items = storage.GetChatLogs (AccountId, entryId, 0, std::numeric_limits<int>::max ()).GetRight ();
+			const auto& date = QDateTime::currentDateTime ();
+			for (int j = 0; j < 100; ++j)
+				items << MakeItem (date.addSecs (j), QString { "new message %1" }.arg (j));
+			batches.push_back ({ AccountId, entryId, {}, items });
+		}
+
+		const auto before = storage.GetAllHistoryCount ().value_or (0);
+
+		QBENCHMARK_ONCE
+		{
+			if (bulk)
+				storage.AddMessagesBulk (batches);
+			else
+				for (const auto& batch : batches)
+					storage.AddMessages (batch.AccountId_, batch.EntryId_, batch.VisibleName_, batch.Items_, true);
+		}
+
+		QCOMPARE (storage.GetAllHistoryCount ().value_or (0), before + ContactsCount * 100);
+	}
+}
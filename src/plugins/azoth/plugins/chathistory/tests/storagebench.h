@@ -0,0 +1,39 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QTemporaryDir>
+
+namespace LC::Azoth::ChatHistory
+{
+	class StorageBench : public QObject
+	{
+		Q_OBJECT
+
+		QTemporaryDir Dir_;
+	private:
+		QString GetDBPath () const;
+	private slots:
+		void initTestCase ();
+
+		void benchSearch_data ();
+		void benchSearch ();
+
+		void testPositions ();
+
+		void benchPositions_data ();
+		void benchPositions ();
+
+		void testBulkDedup ();
+
+		void benchIngest_data ();
+		void benchIngest ();
+	};
+}
@@ -17,8 +17,6 @@
 #include <util/sll/util.h>
 #include <interfaces/core/icoreproxy.h>
 #include <interfaces/core/iiconthememanager.h>
-#include <interfaces/core/ipluginsmanager.h>
-#include <interfaces/core/iloadprogressreporter.h>
 #include <interfaces/azoth/iclentry.h>
 #include "ondiskstorage.h"
 #include "entrystats.h"
@@ -42,7 +40,7 @@ namespace Azoth
 {
 namespace LastSeen
 {
-	void Plugin::Init (ICoreProxy_ptr proxy)
+	void Plugin::Init (ICoreProxy_ptr)
 	{
 		Util::InstallTranslator ("azoth_lastseen");
 
@@ -50,8 +48,6 @@ namespace LastSeen
 		qRegisterMetaTypeStreamOperators<LastHash_t> ("LC::Azoth::LastSeen::LastHash_t");
 
 		Storage_ = std::make_shared<OnDiskStorage> ();
-
-		Migrate (proxy->GetPluginsManager ());
 	}
 
 	void Plugin::SecondInit ()
@@ -89,6 +85,11 @@ namespace LastSeen
 		return result;
 	}
 
+	void Plugin::BackgroundInit ()
+	{
+		Migrate ();
+	}
+
 	namespace
 	{
 		bool IsGoodEntry (QObject *entryObj)
@@ -106,7 +107,7 @@ namespace LastSeen
 		}
 	}
 
-	void Plugin::Migrate (IPluginsManager *manager)
+	void Plugin::Migrate ()
 	{
 		QSettings settings
 		{
@@ -117,8 +118,6 @@ namespace LastSeen
 		if (settings.allKeys ().isEmpty ())
 			return;
 
-		const auto& reporter = manager->CreateLoadProgressReporter (this);
-
 		qDebug () << Q_FUNC_INFO
 				<< "gonna migrate";
 
@@ -129,36 +128,30 @@ namespace LastSeen
 
 		QHash<QString, EntryStats> stats;
 
-		{
-			const auto& proc = reporter->InitiateProcess (tr ("Uniting keys"), 0, 3);
-
-			for (const auto& pair : Util::Stlize (avail))
-				stats [pair.first].Available_ = pair.second;
-
-			++*proc;
-
-			for (const auto& pair : Util::Stlize (online))
-				stats [pair.first].Online_ = pair.second;
-
-			++*proc;
-
-			for (const auto& pair : Util::Stlize (status))
-				stats [pair.first].StatusChange_ = pair.second;
-
-			++*proc;
-		}
+		for (const auto& pair : Util::Stlize (avail))
+			stats [pair.first].Available_ = pair.second;
+		for (const auto& pair : Util::Stlize (online))
+			stats [pair.first].Online_ = pair.second;
+		for (const auto& pair : Util::Stlize (status))
+			stats [pair.first].StatusChange_ = pair.second;
 
 		qDebug () << "done uniting";
 
 		{
-			auto lock = Storage_->BeginTransaction ();
+			// Migrate() runs in a background thread, while Storage_ is
+			// used from the GUI one, so a separate connection is used.
+			// The GUI thread might have already recorded fresher stats
+			// by now, so the existing rows are kept as is.
+			//
+			// The database is in the WAL mode, so the GUI thread still
+			// reads while this transaction is open, but its writes wait
+			// for the commit (up to the QSQLITE busy timeout), so the
+			// migration is done in a single short transaction.
+			OnDiskStorage storage;
+			auto lock = storage.BeginTransaction ();
 
-			const auto& proc = reporter->InitiateProcess (tr ("Writing the database"), 0, stats.size ());
 			for (const auto& pair : Util::Stlize (stats))
-			{
-				Storage_->SetEntryStats (pair.first, pair.second);
-				++*proc;
-			}
+				storage.AddEntryStats (pair.first, pair.second);
 
 			qDebug () << "done writing";
 
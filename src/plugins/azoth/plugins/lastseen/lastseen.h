@@ -12,11 +12,10 @@
 #include <QDateTime>
 #include <interfaces/iinfo.h>
 #include <interfaces/iplugin2.h>
+#include <interfaces/ihavebackgroundinit.h>
 #include <interfaces/core/ihookproxy.h>
 #include <interfaces/azoth/azothcommon.h>
 
-class IPluginsManager;
-
 namespace LC
 {
 namespace Azoth
@@ -29,9 +28,10 @@ namespace LastSeen
 	class Plugin : public QObject
 				 , public IInfo
 				 , public IPlugin2
+				 , public IHaveBackgroundInit
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IPlugin2)
+		Q_INTERFACES (IInfo IPlugin2 IHaveBackgroundInit)
 
 		LC_PLUGIN_METADATA ("org.LeechCraft.Azoth.LastSeen")
 
@@ -48,8 +48,10 @@ namespace LastSeen
 		QIcon GetIcon () const;
 
 		QSet<QByteArray> GetPluginClasses () const;
+
+		void BackgroundInit ();
 	private:
-		void Migrate (IPluginsManager*);
+		void Migrate ();
 	public slots:
 		void hookEntryStatusChanged (LC::IHookProxy_ptr proxy,
 				QObject *entry,
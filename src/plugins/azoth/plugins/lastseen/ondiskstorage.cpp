@@ -98,6 +98,11 @@ namespace LastSeen
 		AdaptedRecord_->Insert ({ entryId, stats }, Util::oral::InsertAction::Replace::PKey);
 	}
 
+	void OnDiskStorage::AddEntryStats (const QString& entryId, const EntryStats& stats)
+	{
+		AdaptedRecord_->Insert ({ entryId, stats }, Util::oral::InsertAction::Ignore);
+	}
+
 	Util::DBLock OnDiskStorage::BeginTransaction ()
 	{
 		Util::DBLock lock { DB_ };
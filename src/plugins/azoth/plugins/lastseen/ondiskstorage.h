@@ -40,6 +40,7 @@ namespace LastSeen
 
 		std::optional<EntryStats> GetEntryStats (const QString&);
 		void SetEntryStats (const QString&, const EntryStats&);
+		void AddEntryStats (const QString&, const EntryStats&);
 
 		Util::DBLock BeginTransaction ();
 	};
@@ -113,6 +113,19 @@ namespace Tracolor
 		}
 	}
 
+	QList<EntityCapability> Plugin::GetEntityCapabilities () const
+	{
+		EntityCapability cap;
+		cap.Mimes_ = QStringList { "x-leechcraft/notification*" };
+		cap.RequiredFields_ = QStringList { "org.LC.Plugins.Azoth.SourceID" };
+		cap.Predicate_ = [] (const Entity& e)
+		{
+			return e.Additional_ [AN::EF::EventCategory].toString () != AN::CatEventCancel;
+		};
+		cap.Priority_ = EntityTestHandleResult::PIdeal;
+		return { cap };
+	}
+
 	void Plugin::initPlugin (QObject *proxyObj)
 	{
 		AzothProxy_ = qobject_cast<IProxyObject*> (proxyObj);
@@ -13,6 +13,7 @@
 #include <interfaces/iplugin2.h>
 #include <interfaces/ihavesettings.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/core/ihookproxy.h>
 
 namespace LC
@@ -31,12 +32,14 @@ namespace Tracolor
 				 , public IPlugin2
 				 , public IHaveSettings
 				 , public IEntityHandler
+				 , public IHaveEntityCapabilities
 	{
 		Q_OBJECT
 		Q_INTERFACES (IInfo
 				IPlugin2
 				IHaveSettings
-				IEntityHandler)
+				IEntityHandler
+				IHaveEntityCapabilities)
 
 		LC_PLUGIN_METADATA ("org.LeechCraft.Azoth.Tracolor")
 
@@ -61,6 +64,8 @@ namespace Tracolor
 
 		EntityTestHandleResult CouldHandle (const Entity&) const;
 		void Handle (Entity);
+
+		QList<EntityCapability> GetEntityCapabilities () const;
 	public slots:
 		void initPlugin (QObject*);
 		void hookCollectContactIcons (LC::IHookProxy_ptr, QObject*, QList<QIcon>&) const;
@@ -12,9 +12,9 @@ namespace LC::BitTorrent
 {
 	libtorrent::torrent_status CachedStatusKeeper::GetStatus (const libtorrent::torrent_handle& handle, FlagsType_t flags)
 	{
-		if (Handle2Status_.contains (handle))
+		if (const auto pos = Handle2Status_.find (handle); pos != Handle2Status_.end ())
 		{
-			const auto& item = Handle2Status_ [handle];
+			const auto& item = pos->second;
 			if ((item.ReqFlags_ & flags) == flags)
 				return item.Status_;
 
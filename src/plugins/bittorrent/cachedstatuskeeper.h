@@ -8,8 +8,8 @@
 
 #pragma once
 
+#include <unordered_map>
 #include <QObject>
-#include <QMap>
 #include <libtorrent/torrent_handle.hpp>
 #include <libtorrent/torrent_status.hpp>
 
@@ -27,7 +27,7 @@ namespace LC::BitTorrent
 			FlagsType_t ReqFlags_;
 		};
 
-		QMap<libtorrent::torrent_handle, CachedItem> Handle2Status_;
+		std::unordered_map<libtorrent::torrent_handle, CachedItem> Handle2Status_;
 	public:
 		using QObject::QObject;
 
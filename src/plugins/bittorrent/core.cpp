@@ -102,7 +102,6 @@ namespace BitTorrent
 	Core::Core ()
 	: StatusKeeper_ { new CachedStatusKeeper { this } }
 	, Session_ { CreateSession () }
-	, FinishedTimer_ { new QTimer }
 	, WarningWatchdog_ { new QTimer }
 	, Dispatcher_ { *Session_ }
 	{
@@ -161,14 +160,14 @@ namespace BitTorrent
 					UpdateStatus (a.status);
 					return false;
 				});
-		Dispatcher_.RegisterHandler ([this] (const torrent_paused_alert& a) { UpdateStatus ({ a.handle.status () }); });
-		Dispatcher_.RegisterHandler ([this] (const torrent_resumed_alert& a) { UpdateStatus ({ a.handle.status () }); });
-		Dispatcher_.RegisterHandler ([this] (const state_changed_alert& a) { UpdateStatus ({ a.handle.status () }); });
-		Dispatcher_.RegisterHandler ([this] (const torrent_error_alert& a) { UpdateStatus ({ a.handle.status () }); });
+		Dispatcher_.RegisterHandler ([this] (const torrent_paused_alert&) { RequestStatusUpdate (); });
+		Dispatcher_.RegisterHandler ([this] (const torrent_resumed_alert&) { RequestStatusUpdate (); });
+		Dispatcher_.RegisterHandler ([this] (const state_changed_alert&) { RequestStatusUpdate (); });
+		Dispatcher_.RegisterHandler ([this] (const torrent_error_alert&) { RequestStatusUpdate (); });
 		Dispatcher_.RegisterHandler ([this] (const torrent_checked_alert& a)
 				{
 					HandleTorrentChecked (a.handle);
-					UpdateStatus ({ a.handle.status () });
+					RequestStatusUpdate ();
 				});
 
 		Dispatcher_.Swallow (torrent_finished_alert::alert_type, false);
@@ -279,12 +278,6 @@ namespace BitTorrent
 			tr ("Ratio")
 		};
 
-		connect (FinishedTimer_.get (),
-				SIGNAL (timeout ()),
-				this,
-				SLOT (checkFinished ()));
-		FinishedTimer_->start (10000);
-
 		connect (WarningWatchdog_.get (),
 				SIGNAL (timeout ()),
 				this,
@@ -308,7 +301,6 @@ namespace BitTorrent
 		Session_->pause ();
 		writeSettings ();
 
-		FinishedTimer_.reset ();
 		WarningWatchdog_.reset ();
 
 		qDeleteAll (children ());
@@ -812,6 +804,7 @@ namespace BitTorrent
 
 		beginInsertRows ({}, Handles_.size (), Handles_.size ());
 		Handles_.append ({ handle, tags, params });
+		ReindexHandles (Handles_.size () - 1);
 		endInsertRows ();
 
 		return Handles_.back ().Promise_->future ();
@@ -910,6 +903,7 @@ namespace BitTorrent
 				autoManaged,
 				params
 			});
+		ReindexHandles (Handles_.size () - 1);
 		endInsertRows ();
 
 		if (tryLive)
@@ -934,7 +928,9 @@ namespace BitTorrent
 			options |= libtorrent::session_handle::delete_files;
 		Session_->remove_torrent (Handles_.at (pos).Handle_, options);
 
+		Handle2Row_.erase (Handles_.at (pos).Handle_);
 		Handles_.removeAt (pos);
+		ReindexHandles (pos);
 
 		endRemoveRows ();
 
@@ -948,7 +944,7 @@ namespace BitTorrent
 
 		Handles_.at (pos).Handle_.pause ();
 		ToggleFlag (Handles_ [pos].Handle_, libtorrent::torrent_flags::auto_managed, false);
-		checkFinished ();
+		RequestStatusUpdate ();
 	}
 
 	void Core::ResumeTorrent (int pos)
@@ -959,7 +955,7 @@ namespace BitTorrent
 		Handles_.at (pos).Handle_.resume ();
 		Handles_ [pos].State_ = TSIdle;
 		ToggleFlag (Handles_ [pos].Handle_, libtorrent::torrent_flags::auto_managed, Handles_.at (pos).AutoManaged_);
-		checkFinished ();
+		RequestStatusUpdate ();
 	}
 
 	void Core::ForceReannounce (int pos)
@@ -1040,7 +1036,7 @@ namespace BitTorrent
 			return;
 		}
 
-		const auto& status = a.handle.status ({});
+		const auto& status = StatusKeeper_->GetStatus (a.handle);
 		if (status.errc)
 		{
 			qWarning () << Q_FUNC_INFO
@@ -1125,12 +1121,68 @@ namespace BitTorrent
 			}
 
 			const auto row = std::distance (Handles_.begin (), pos);
+			UpdateTorrentState (row, status);
 			emit dataChanged (index (row, 0), index (row, columnCount () - 1));
 		}
 
 		emit torrentsStatusesUpdated ();
 	}
 
+	void Core::RequestStatusUpdate ()
+	{
+		// The alerts come in batches, so a single update is posted for
+		// all the torrents that changed during a batch.
+		if (StatusUpdateRequested_)
+			return;
+
+		StatusUpdateRequested_ = true;
+		QTimer::singleShot (0,
+				this,
+				[this]
+				{
+					StatusUpdateRequested_ = false;
+					if (Session_)
+						Session_->post_torrent_updates ();
+				});
+	}
+
+	void Core::UpdateTorrentState (int row, const libtorrent::torrent_status& status)
+	{
+		auto& torrent = Handles_ [row];
+		if (torrent.State_ == TSSeeding)
+			return;
+
+		if (IsAutoManaged (status))
+		{
+			torrent.State_ = TSIdle;
+			return;
+		}
+
+		switch (status.state)
+		{
+		case libtorrent::torrent_status::checking_files:
+		case libtorrent::torrent_status::checking_resume_data:
+		case libtorrent::torrent_status::downloading_metadata:
+			torrent.State_ = TSPreparing;
+			break;
+		case libtorrent::torrent_status::downloading:
+			torrent.State_ = TSDownloading;
+			break;
+		case libtorrent::torrent_status::finished:
+		case libtorrent::torrent_status::seeding:
+		{
+			const auto oldState = torrent.State_;
+			torrent.State_ = TSSeeding;
+			if (oldState == TSDownloading)
+			{
+				HandleSingleFinished (row);
+				ScheduleSave ();
+			}
+			break;
+		}
+		}
+	}
+
 	void Core::HandleTorrentChecked (const libtorrent::torrent_handle& h)
 	{
 		const auto pos = FindHandle (h);
@@ -1166,6 +1218,7 @@ namespace BitTorrent
 			Handles_.at (*i).Handle_.queue_position_up ();
 			std::swap (Handles_ [*i],
 					Handles_ [*i - 1]);
+			ReindexHandles (*i - 1);
 
 			emit dataChanged (index (*i - 1, 0),
 					index (*i, columnCount () - 1));
@@ -1188,6 +1241,7 @@ namespace BitTorrent
 			Handles_.at (*i).Handle_.queue_position_down ();
 			std::swap (Handles_ [*i],
 					Handles_ [*i + 1]);
+			ReindexHandles (*i);
 
 			emit dataChanged (index (*i, 0),
 					index (*i + 1, columnCount () - 1));
@@ -1226,14 +1280,24 @@ namespace BitTorrent
 
 	auto Core::FindHandle (const libtorrent::torrent_handle& h) -> HandleDict_t::iterator
 	{
-		return std::find_if (Handles_.begin (), Handles_.end (),
-				[&h] (const TorrentStruct& ts) { return ts.Handle_ == h; });
+		const auto pos = Handle2Row_.find (h);
+		return pos == Handle2Row_.end () ?
+				Handles_.end () :
+				Handles_.begin () + pos->second;
 	}
 
 	auto Core::FindHandle (const libtorrent::torrent_handle& h) const -> HandleDict_t::const_iterator
 	{
-		return std::find_if (Handles_.begin (), Handles_.end (),
-				[&h] (const TorrentStruct& ts) { return ts.Handle_ == h; });
+		const auto pos = Handle2Row_.find (h);
+		return pos == Handle2Row_.end () ?
+				Handles_.end () :
+				Handles_.begin () + pos->second;
+	}
+
+	void Core::ReindexHandles (int from)
+	{
+		for (int i = from; i < Handles_.size (); ++i)
+			Handle2Row_ [Handles_.at (i).Handle_] = i;
 	}
 
 	void Core::MoveToTop (int row)
@@ -1246,6 +1310,7 @@ namespace BitTorrent
 
 		beginInsertRows (QModelIndex (), 0, 0);
 		Handles_.push_front (tmp);
+		ReindexHandles (0);
 		endInsertRows ();
 	}
 
@@ -1259,6 +1324,7 @@ namespace BitTorrent
 
 		beginInsertRows (QModelIndex (), Handles_.size (), Handles_.size ());
 		Handles_.push_back (tmp);
+		ReindexHandles (row);
 		endInsertRows ();
 	}
 
@@ -1317,6 +1383,7 @@ namespace BitTorrent
 					taskParameters,
 					TorrentStruct::NoFuture {}
 				});
+			ReindexHandles (Handles_.size () - 1);
 			endInsertRows ();
 			qDebug () << "restored a torrent";
 		}
@@ -1531,46 +1598,6 @@ namespace BitTorrent
 		queryLibtorrent ();
 	}
 
-	void Core::checkFinished ()
-	{
-		for (int i = 0; i < Handles_.size (); ++i)
-		{
-			if (Handles_.at (i).State_ == TSSeeding)
-				continue;
-
-			const auto& status = Handles_.at (i).Handle_.status ({});
-			libtorrent::torrent_status::state_t state = status.state;
-
-			if (IsAutoManaged (status))
-			{
-				Handles_ [i].State_ = TSIdle;
-				continue;
-			}
-
-			switch (state)
-			{
-			case libtorrent::torrent_status::checking_files:
-			case libtorrent::torrent_status::checking_resume_data:
-			case libtorrent::torrent_status::downloading_metadata:
-				Handles_ [i].State_ = TSPreparing;
-				break;
-			case libtorrent::torrent_status::downloading:
-				Handles_ [i].State_ = TSDownloading;
-				break;
-			case libtorrent::torrent_status::finished:
-			case libtorrent::torrent_status::seeding:
-				TorrentState oldState = Handles_ [i].State_;
-				Handles_ [i].State_ = TSSeeding;
-				if (oldState == TSDownloading)
-				{
-					HandleSingleFinished (i);
-					ScheduleSave ();
-				}
-				break;
-			}
-		}
-	}
-
 	void Core::queryLibtorrent ()
 	{
 		Session_->post_torrent_updates ();
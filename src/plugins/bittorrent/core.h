@@ -10,6 +10,7 @@
 
 #include <memory>
 #include <optional>
+#include <unordered_map>
 #include <QAbstractItemModel>
 #include <QList>
 #include <QVector>
@@ -132,8 +133,16 @@ namespace BitTorrent
 
 		typedef QList<TorrentStruct> HandleDict_t;
 		HandleDict_t Handles_;
+
+		/* Maps the handles to their rows in Handles_, so that the alerts
+		 * and status updates for thousands of torrents don't have to scan
+		 * the whole list. Updated on every insertion, removal and move.
+		 */
+		std::unordered_map<libtorrent::torrent_handle, int> Handle2Row_;
+		bool StatusUpdateRequested_ = false;
+
 		QList<QString> Headers_;
-		std::shared_ptr<QTimer> FinishedTimer_, WarningWatchdog_;
+		std::shared_ptr<QTimer> WarningWatchdog_;
 		std::shared_ptr<LiveStreamManager> LiveStreamManager_;
 		bool SaveScheduled_ = false;
 		QToolBar *Toolbar_ = nullptr;
@@ -240,6 +249,10 @@ namespace BitTorrent
 	private:
 		HandleDict_t::iterator FindHandle (const libtorrent::torrent_handle&);
 		HandleDict_t::const_iterator FindHandle (const libtorrent::torrent_handle&) const;
+		void ReindexHandles (int from = 0);
+
+		void RequestStatusUpdate ();
+		void UpdateTorrentState (int, const libtorrent::torrent_status&);
 
 		void MoveToTop (int);
 		void MoveToBottom (int);
@@ -256,7 +269,6 @@ namespace BitTorrent
 		void ShowError (const QString&);
 	private slots:
 		void writeSettings ();
-		void checkFinished ();
 		void scrape ();
 		void queryLibtorrent ();
 	signals:
@@ -321,6 +321,30 @@ namespace LC::BitTorrent
 		return result;
 	}
 
+	QList<EntityCapability> TorrentPlugin::GetEntityCapabilities () const
+	{
+		const auto isMagnet = [] (const Entity& e)
+		{
+			return e.Entity_.canConvert<QUrl> () && e.Entity_.toUrl ().scheme () == "magnet"_ql;
+		};
+
+		EntityCapability magnet;
+		magnet.Kind_ = EntityCapability::Kind::Download;
+		magnet.Priority_ = EntityTestHandleResult::PIdeal;
+		magnet.Predicate_ = [isMagnet] (const Entity& e)
+		{
+			return isMagnet (e) && CouldDownloadUrl (e.Entity_.toUrl ()).HandlePriority_ > 0;
+		};
+
+		// The torrent files are read and checked against the settings.
+		EntityCapability torrents;
+		torrents.Kind_ = EntityCapability::Kind::Download;
+		torrents.NeedsQuery_ = true;
+		torrents.Predicate_ = [isMagnet] (const Entity& e) { return !isMagnet (e); };
+
+		return { magnet, torrents };
+	}
+
 	QAbstractItemModel* TorrentPlugin::GetRepresentation () const
 	{
 		return ReprProxy_;
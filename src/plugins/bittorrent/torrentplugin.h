@@ -11,6 +11,7 @@
 #include <memory>
 #include <interfaces/iinfo.h>
 #include <interfaces/idownload.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/ijobholder.h>
 #include <interfaces/itaggablejobs.h>
 #include <interfaces/ihavesettings.h>
@@ -39,6 +40,7 @@ namespace LC::BitTorrent
 	class TorrentPlugin : public QObject
 						, public IInfo
 						, public IDownload
+						, public IHaveEntityCapabilities
 						, public IJobHolder
 						, public ITaggableJobs
 						, public IHaveSettings
@@ -52,6 +54,7 @@ namespace LC::BitTorrent
 
 		Q_INTERFACES (IInfo
 				IDownload
+				IHaveEntityCapabilities
 				IJobHolder
 				ITaggableJobs
 				IHaveSettings
@@ -91,6 +94,8 @@ namespace LC::BitTorrent
 		EntityTestHandleResult CouldDownload (const LC::Entity&) const override;
 		QFuture<Result> AddJob (LC::Entity) override;
 
+		QList<EntityCapability> GetEntityCapabilities () const override;
+
 		// IJobHolder
 		QAbstractItemModel* GetRepresentation () const override;
 		IJobHolderRepresentationHandler_ptr CreateRepresentationHandler () override;
@@ -189,6 +189,24 @@ namespace Blasq
 		new DataFilterUploader (entity, AccountsMgr_);
 	}
 
+	QList<EntityCapability> Plugin::GetEntityCapabilities () const
+	{
+		const auto isImage = [] (const Entity& e) { return !e.Entity_.value<QImage> ().isNull (); };
+
+		EntityCapability images;
+		images.Mimes_ = QStringList { "x-leechcraft/data-filter-request" };
+		images.Priority_ = EntityTestHandleResult::PHigh;
+		images.Predicate_ = isImage;
+
+		// The MIME types of the files are detected by their contents.
+		EntityCapability files;
+		files.Mimes_ = QStringList { "x-leechcraft/data-filter-request" };
+		files.NeedsQuery_ = true;
+		files.Predicate_ = [isImage] (const Entity& e) { return !isImage (e); };
+
+		return { images, files };
+	}
+
 	QString Plugin::GetFilterVerb () const
 	{
 		return tr ("Upload image to cloud");
@@ -16,6 +16,7 @@
 #include <interfaces/ihavesettings.h>
 #include <interfaces/idatafilter.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/data/iimgsource.h>
 
 namespace LC
@@ -33,10 +34,11 @@ namespace Blasq
 				 , public IHaveSettings
 				 , public IImgSource
 				 , public IEntityHandler
+				 , public IHaveEntityCapabilities
 				 , public IDataFilter
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IHaveTabs IHaveRecoverableTabs IPluginReady IHaveSettings IImgSource IEntityHandler IDataFilter)
+		Q_INTERFACES (IInfo IHaveTabs IHaveRecoverableTabs IPluginReady IHaveSettings IImgSource IEntityHandler IHaveEntityCapabilities IDataFilter)
 
 		LC_PLUGIN_METADATA ("org.LeechCraft.Blasq")
 
@@ -74,6 +76,8 @@ namespace Blasq
 		EntityTestHandleResult CouldHandle (const Entity&) const;
 		void Handle (Entity);
 
+		QList<EntityCapability> GetEntityCapabilities () const;
+
 		QString GetFilterVerb () const;
 		QList<FilterVariant> GetFilterVariants (const QVariant&) const;
 	private:
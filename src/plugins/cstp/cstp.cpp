@@ -109,6 +109,23 @@ namespace CSTP
 		return Core::Instance ().AddTask (e);
 	}
 
+	QList<EntityCapability> CSTP::GetEntityCapabilities () const
+	{
+		QList<EntityCapability> result;
+		for (const auto priority : { EntityTestHandleResult::PIdeal, EntityTestHandleResult::PHigh })
+		{
+			EntityCapability cap;
+			cap.Kind_ = EntityCapability::Kind::Download;
+			cap.Priority_ = priority;
+			cap.Predicate_ = [priority] (const Entity& e)
+			{
+				return Core::Instance ().CouldDownload (e).HandlePriority_ == priority;
+			};
+			result << cap;
+		}
+		return result;
+	}
+
 	QAbstractItemModel* CSTP::GetRepresentation () const
 	{
 		return Core::Instance ().GetRepresentationModel ();
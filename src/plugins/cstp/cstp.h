@@ -12,6 +12,7 @@
 #include <QModelIndex>
 #include <interfaces/iinfo.h>
 #include <interfaces/idownload.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/ijobholder.h>
 #include <interfaces/ihavesettings.h>
 #include <interfaces/structures.h>
@@ -30,11 +31,12 @@ namespace CSTP
 	class CSTP : public QObject
 				, public IInfo
 				, public IDownload
+				, public IHaveEntityCapabilities
 				, public IJobHolder
 				, public IHaveSettings
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IDownload IJobHolder IHaveSettings)
+		Q_INTERFACES (IInfo IDownload IHaveEntityCapabilities IJobHolder IHaveSettings)
 
 		LC_PLUGIN_METADATA ("org.LeechCraft.CSTP")
 
@@ -57,6 +59,8 @@ namespace CSTP
 		EntityTestHandleResult CouldDownload (const LC::Entity&) const override;
 		QFuture<Result> AddJob (LC::Entity) override;
 
+		QList<EntityCapability> GetEntityCapabilities () const override;
+
 		QAbstractItemModel* GetRepresentation () const override;
 		IJobHolderRepresentationHandler_ptr CreateRepresentationHandler () override;
 
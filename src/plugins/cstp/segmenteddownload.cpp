@@ -0,0 +1,592 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "segmenteddownload.h"
+#include <algorithm>
+#include <QDataStream>
+#include <QFile>
+#include <QNetworkAccessManager>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QTimer>
+#include <QtDebug>
+
+namespace LC
+{
+namespace CSTP
+{
+	namespace
+	{
+		// Files smaller than this aren't worth the additional requests.
+		const qint64 MinSegmentedSize = 2 * 1024 * 1024;
+
+		// A running segment is only split if both halves would be at
+		// least this large.
+		const qint64 MinSegmentSize = 1024 * 1024;
+
+		const int MaxSegmentFailures = 3;
+		const int RetryDelay = 2000;
+		const int SaveInterval = 5000;
+
+		const quint32 StateMagic = 0x43535047;
+		const quint8 StateVersion = 1;
+
+		QString GetStatePath (const QString& path)
+		{
+			return path + ".cstp-segments";
+		}
+
+		QNetworkRequest MakeTemplate (QNetworkRequest req)
+		{
+			req.setRawHeader ("Range", {});
+			// The Host header would be wrong after a redirect, and
+			// QNetworkAccessManager sets the right one anyway.
+			req.setRawHeader ("Host", {});
+			req.setAttribute (QNetworkRequest::RedirectPolicyAttribute,
+					QNetworkRequest::NoLessSafeRedirectPolicy);
+			return req;
+		}
+	}
+
+	SegmentedDownload::SegmentedDownload (QNetworkAccessManager *nam, const QNetworkRequest& req,
+			const std::shared_ptr<QFile>& to, int maxConnections, QObject *parent)
+	: QObject { parent }
+	, NAM_ { nam }
+	, Request_ { MakeTemplate (req) }
+	, To_ { to }
+	, MaxConnections_ { std::max (maxConnections, 1) }
+	, SaveTimer_ { new QTimer { this } }
+	{
+		SaveTimer_->setInterval (SaveInterval);
+		connect (SaveTimer_,
+				&QTimer::timeout,
+				this,
+				&SegmentedDownload::SaveState);
+	}
+
+	SegmentedDownload::~SegmentedDownload ()
+	{
+		for (const auto& seg : Segments_)
+			DetachReply (*seg);
+	}
+
+	bool SegmentedDownload::CanSegment (QNetworkReply *reply)
+	{
+		if (reply->attribute (QNetworkRequest::HttpStatusCodeAttribute).toInt () != 200)
+			return false;
+
+		if (reply->rawHeader ("Accept-Ranges").trimmed ().toLower () != "bytes")
+			return false;
+
+		// Content-Length is the length of the encoded body otherwise.
+		const auto& encoding = reply->rawHeader ("Content-Encoding").trimmed ().toLower ();
+		if (!encoding.isEmpty () && encoding != "identity")
+			return false;
+
+		return reply->header (QNetworkRequest::ContentLengthHeader).toLongLong () >= MinSegmentedSize;
+	}
+
+	bool SegmentedDownload::HasState (const QString& path)
+	{
+		return QFile::exists (GetStatePath (path));
+	}
+
+	void SegmentedDownload::Adopt (QNetworkReply *reply)
+	{
+		Total_ = reply->header (QNetworkRequest::ContentLengthHeader).toLongLong ();
+		ETag_ = reply->rawHeader ("ETag");
+		LastModified_ = reply->rawHeader ("Last-Modified");
+
+		// Whatever the reply has delivered so far has been written
+		// sequentially from the start of the file.
+		const auto written = To_->size ();
+		Done_ = written;
+
+		if (!To_->resize (Total_))
+		{
+			reply->abort ();
+			reply->deleteLater ();
+			FailLocally (tr ("Unable to allocate %1 bytes for file %2: %3.")
+					.arg (Total_)
+					.arg (To_->fileName ())
+					.arg (To_->errorString ()));
+			return;
+		}
+
+		auto seg = std::make_unique<Segment> ();
+		seg->Pos_ = written;
+		seg->End_ = Total_;
+		seg->Reply_ = reply;
+		seg->IsChecked_ = true;
+		Segments_.push_back (std::move (seg));
+
+		const auto segPtr = Segments_.back ().get ();
+		connect (reply,
+				&QNetworkReply::readyRead,
+				this,
+				[this, segPtr] { HandleReadyRead (*segPtr); });
+		connect (reply,
+				&QNetworkReply::finished,
+				this,
+				[this, segPtr] { HandleReplyFinished (*segPtr); });
+
+		SaveTimer_->start ();
+		SaveState ();
+
+		Schedule ();
+
+		if (reply->bytesAvailable ())
+			HandleReadyRead (*segPtr);
+	}
+
+	bool SegmentedDownload::Resume ()
+	{
+		const auto& statePath = GetStatePath (To_->fileName ());
+
+		QFile file { statePath };
+		if (!file.open (QIODevice::ReadOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< statePath
+					<< file.errorString ();
+			return false;
+		}
+
+		QDataStream in { &file };
+		quint32 magic = 0;
+		quint8 version = 0;
+		in >> magic >> version;
+		if (magic != StateMagic || version != StateVersion)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unknown state format"
+					<< magic
+					<< version;
+			file.remove ();
+			return false;
+		}
+
+		QUrl url;
+		QList<QPair<qint64, qint64>> ranges;
+		in >> url
+			>> Total_
+			>> ETag_
+			>> LastModified_
+			>> ranges;
+
+		if (in.status () != QDataStream::Ok ||
+				url != Request_.url () ||
+				To_->size () != Total_)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "stale state for"
+					<< To_->fileName ()
+					<< url
+					<< Request_.url ()
+					<< Total_
+					<< To_->size ();
+			file.remove ();
+			return false;
+		}
+
+		Done_ = Total_;
+		for (const auto& range : ranges)
+		{
+			if (range.first < 0 || range.first >= range.second || range.second > Total_)
+				continue;
+
+			auto seg = std::make_unique<Segment> ();
+			seg->Pos_ = range.first;
+			seg->End_ = range.second;
+			Done_ -= seg->End_ - seg->Pos_;
+			Segments_.push_back (std::move (seg));
+		}
+
+		SaveTimer_->start ();
+
+		// Let the caller connect to our signals before possibly finishing.
+		QTimer::singleShot (0,
+				this,
+				[this]
+				{
+					emit progress (Done_, Total_);
+					Schedule ();
+				});
+		return true;
+	}
+
+	void SegmentedDownload::Stop ()
+	{
+		if (State_ != State::Running)
+			return;
+
+		State_ = State::Stopped;
+		SaveTimer_->stop ();
+
+		for (const auto& seg : Segments_)
+			DetachReply (*seg);
+
+		SaveState ();
+	}
+
+	bool SegmentedDownload::IsActive () const
+	{
+		return State_ == State::Running;
+	}
+
+	qint64 SegmentedDownload::GetDone () const
+	{
+		return Done_;
+	}
+
+	qint64 SegmentedDownload::GetTotal () const
+	{
+		return Total_;
+	}
+
+	QByteArray SegmentedDownload::GetETag () const
+	{
+		return ETag_;
+	}
+
+	QByteArray SegmentedDownload::GetLastModified () const
+	{
+		return LastModified_;
+	}
+
+	QString SegmentedDownload::GetErrorString () const
+	{
+		return ErrorString_;
+	}
+
+	void SegmentedDownload::Schedule ()
+	{
+		if (State_ != State::Running)
+			return;
+
+		auto running = std::count_if (Segments_.begin (), Segments_.end (),
+				[] (const auto& seg) { return seg->Reply_; });
+
+		for (const auto& seg : Segments_)
+		{
+			if (running >= MaxConnections_)
+				break;
+
+			if (seg->Reply_ || seg->IsWaitingRetry_ || seg->Pos_ >= seg->End_)
+				continue;
+
+			StartSegment (*seg);
+			++running;
+		}
+
+		// Rebalance: the idle connections take the second halves of the
+		// largest remaining ranges of the running segments.
+		while (running < MaxConnections_)
+		{
+			Segment *largest = nullptr;
+			for (const auto& seg : Segments_)
+				if (seg->Reply_ &&
+						(!largest || seg->End_ - seg->Pos_ > largest->End_ - largest->Pos_))
+					largest = seg.get ();
+
+			if (!largest || largest->End_ - largest->Pos_ < 2 * MinSegmentSize)
+				break;
+
+			auto seg = std::make_unique<Segment> ();
+			seg->Pos_ = largest->Pos_ + (largest->End_ - largest->Pos_) / 2;
+			seg->End_ = largest->End_;
+			largest->End_ = seg->Pos_;
+
+			StartSegment (*seg);
+			Segments_.push_back (std::move (seg));
+			++running;
+		}
+
+		CheckFinished ();
+	}
+
+	void SegmentedDownload::StartSegment (Segment& seg)
+	{
+		auto req = Request_;
+		req.setRawHeader ("Range", "bytes=" + QByteArray::number (seg.Pos_) + "-");
+
+		// Weak ETags can't be used for ranges.
+		if (!ETag_.isEmpty () && !ETag_.startsWith ("W/"))
+			req.setRawHeader ("If-Range", ETag_);
+		else if (!LastModified_.isEmpty ())
+			req.setRawHeader ("If-Range", LastModified_);
+
+		seg.Reply_ = NAM_->get (req);
+		seg.IsChecked_ = false;
+		seg.IsWaitingRetry_ = false;
+
+		const auto segPtr = &seg;
+		connect (seg.Reply_,
+				&QNetworkReply::readyRead,
+				this,
+				[this, segPtr] { HandleReadyRead (*segPtr); });
+		connect (seg.Reply_,
+				&QNetworkReply::finished,
+				this,
+				[this, segPtr] { HandleReplyFinished (*segPtr); });
+	}
+
+	bool SegmentedDownload::CheckResponse (Segment& seg)
+	{
+		if (seg.IsChecked_)
+			return true;
+
+		const auto reply = seg.Reply_;
+
+		// Errors are handled once the reply finishes.
+		const auto code = reply->attribute (QNetworkRequest::HttpStatusCodeAttribute).toInt ();
+		if (reply->error () != QNetworkReply::NoError || code >= 400)
+			return false;
+
+		static const QRegularExpression rx { "^bytes\\s+(\\d+)-(\\d+)/(\\d+)$" };
+		const auto& match = rx.match (QString::fromLatin1 (reply->rawHeader ("Content-Range").trimmed ()));
+		if (code != 206 ||
+				!match.hasMatch () ||
+				match.captured (1).toLongLong () != seg.Pos_ ||
+				match.captured (3).toLongLong () != Total_)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unexpected response for the segment at"
+					<< seg.Pos_
+					<< code
+					<< reply->rawHeader ("Content-Range");
+
+			// The file has changed or the server no longer supports
+			// ranges: the downloaded data can't be trusted anymore, so
+			// the next attempt starts from scratch.
+			for (const auto& other : Segments_)
+				DetachReply (*other);
+			To_->resize (0);
+			RemoveState ();
+			Fail (QNetworkReply::ContentConflictError,
+					tr ("The file has changed on the server, or the server "
+						"no longer supports partial downloads."));
+			return false;
+		}
+
+		seg.IsChecked_ = true;
+		seg.Failures_ = 0;
+		return true;
+	}
+
+	void SegmentedDownload::HandleReadyRead (Segment& seg)
+	{
+		if (!seg.Reply_ || !CheckResponse (seg))
+			return;
+
+		const auto& data = seg.Reply_->read (seg.End_ - seg.Pos_);
+		if (!data.isEmpty ())
+		{
+			if (!To_->seek (seg.Pos_) ||
+					To_->write (data) != data.size ())
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "error writing to file:"
+						<< To_->fileName ()
+						<< To_->errorString ();
+
+				FailLocally (tr ("Error writing to file %1: %2")
+						.arg (To_->fileName ())
+						.arg (To_->errorString ()));
+				return;
+			}
+
+			seg.Pos_ += data.size ();
+			Done_ += data.size ();
+			emit progress (Done_, Total_);
+		}
+
+		// The requests are open-ended, so a segment that has been shrunk
+		// by a split has to be cut off explicitly.
+		if (seg.Pos_ >= seg.End_)
+		{
+			DetachReply (seg);
+			Schedule ();
+		}
+	}
+
+	void SegmentedDownload::HandleReplyFinished (Segment& seg)
+	{
+		HandleReadyRead (seg);
+
+		// Either the segment is complete, or the whole download has
+		// failed while reading.
+		if (!seg.Reply_)
+			return;
+
+		const auto error = seg.Reply_->error ();
+		const auto& errorString = seg.Reply_->errorString ();
+		DetachReply (seg);
+
+		if (error != QNetworkReply::NoError)
+			HandleSegmentFailed (seg, error, errorString);
+		else if (seg.Pos_ < seg.End_)
+			HandleSegmentFailed (seg, QNetworkReply::RemoteHostClosedError,
+					tr ("The server closed the connection prematurely."));
+		else
+			Schedule ();
+	}
+
+	void SegmentedDownload::HandleSegmentFailed (Segment& seg,
+			QNetworkReply::NetworkError error, const QString& errorString)
+	{
+		if (State_ != State::Running)
+			return;
+
+		qWarning () << Q_FUNC_INFO
+				<< "segment at"
+				<< seg.Pos_
+				<< "failed:"
+				<< error
+				<< errorString;
+
+		if (++seg.Failures_ > MaxSegmentFailures)
+		{
+			for (const auto& other : Segments_)
+				DetachReply (*other);
+			SaveState ();
+			Fail (error, errorString);
+			return;
+		}
+
+		// The running segment right before this one just keeps reading
+		// into this one's range.
+		const auto pred = std::find_if (Segments_.begin (), Segments_.end (),
+				[&seg] (const auto& other) { return other->Reply_ && other->End_ == seg.Pos_; });
+		if (pred != Segments_.end ())
+		{
+			(*pred)->End_ = seg.End_;
+			seg.End_ = seg.Pos_;
+			Schedule ();
+			return;
+		}
+
+		seg.IsWaitingRetry_ = true;
+		const auto segPtr = &seg;
+		QTimer::singleShot (RetryDelay * seg.Failures_,
+				this,
+				[this, segPtr]
+				{
+					segPtr->IsWaitingRetry_ = false;
+					Schedule ();
+				});
+	}
+
+	void SegmentedDownload::DetachReply (Segment& seg)
+	{
+		const auto reply = seg.Reply_;
+		if (!reply)
+			return;
+
+		seg.Reply_ = nullptr;
+
+		disconnect (reply,
+				nullptr,
+				this,
+				nullptr);
+		reply->abort ();
+		reply->deleteLater ();
+	}
+
+	void SegmentedDownload::CheckFinished ()
+	{
+		if (State_ != State::Running)
+			return;
+
+		const auto isPending = [] (const auto& seg) { return seg->Reply_ || seg->Pos_ < seg->End_; };
+		if (std::any_of (Segments_.begin (), Segments_.end (), isPending))
+			return;
+
+		State_ = State::Finished;
+		SaveTimer_->stop ();
+		To_->flush ();
+		RemoveState ();
+
+		emit finished ();
+	}
+
+	void SegmentedDownload::Fail (QNetworkReply::NetworkError error, const QString& errorString)
+	{
+		if (State_ != State::Running)
+			return;
+
+		State_ = State::Failed;
+		SaveTimer_->stop ();
+		ErrorString_ = errorString;
+
+		emit failed (error, errorString);
+	}
+
+	void SegmentedDownload::FailLocally (const QString& errorString)
+	{
+		if (State_ != State::Running)
+			return;
+
+		for (const auto& seg : Segments_)
+			DetachReply (*seg);
+		SaveState ();
+
+		State_ = State::Failed;
+		SaveTimer_->stop ();
+		ErrorString_ = errorString;
+
+		emit localError (errorString);
+	}
+
+	void SegmentedDownload::SaveState ()
+	{
+		if (State_ == State::Finished || !Total_ || To_->size () != Total_)
+			return;
+
+		QList<QPair<qint64, qint64>> ranges;
+		for (const auto& seg : Segments_)
+			if (seg->Pos_ < seg->End_)
+				ranges.append ({ seg->Pos_, seg->End_ });
+
+		// The data has to reach the file before the state saying so.
+		To_->flush ();
+
+		const auto& statePath = GetStatePath (To_->fileName ());
+		QSaveFile file { statePath };
+		if (!file.open (QIODevice::WriteOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< statePath
+					<< file.errorString ();
+			return;
+		}
+
+		QDataStream out { &file };
+		out << StateMagic
+			<< StateVersion
+			<< Request_.url ()
+			<< Total_
+			<< ETag_
+			<< LastModified_
+			<< ranges;
+
+		if (!file.commit ())
+			qWarning () << Q_FUNC_INFO
+					<< "unable to save"
+					<< statePath
+					<< file.errorString ();
+	}
+
+	void SegmentedDownload::RemoveState ()
+	{
+		QFile::remove (GetStatePath (To_->fileName ()));
+	}
+}
+}
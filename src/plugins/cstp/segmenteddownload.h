@@ -0,0 +1,136 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <QObject>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+
+class QFile;
+class QTimer;
+
+namespace LC
+{
+namespace CSTP
+{
+	/** @brief Downloads a file over several parallel ranged requests.
+	 *
+	 * The file is preallocated to its full size, and split into segments
+	 * each downloaded by its own request and written at its own offset.
+	 * All the requests are open-ended, so that a segment can be shrunk
+	 * or extended while its request is running: once a request finishes
+	 * its segment, the largest remaining segment is split in two, and a
+	 * segment whose request has failed is taken over by the preceding
+	 * one if possible.
+	 *
+	 * The state of the segments is saved next to the file, so that the
+	 * download is resumed per segment after it is stopped or LeechCraft
+	 * is restarted.
+	 */
+	class SegmentedDownload : public QObject
+	{
+		Q_OBJECT
+
+		QNetworkAccessManager * const NAM_;
+		const QNetworkRequest Request_;
+		const std::shared_ptr<QFile> To_;
+		const int MaxConnections_;
+
+		qint64 Total_ = 0;
+		qint64 Done_ = 0;
+		QByteArray ETag_;
+		QByteArray LastModified_;
+
+		struct Segment
+		{
+			qint64 Pos_ = 0;
+			qint64 End_ = 0;
+			QNetworkReply *Reply_ = nullptr;
+			bool IsChecked_ = false;
+			bool IsWaitingRetry_ = false;
+			int Failures_ = 0;
+		};
+		std::vector<std::unique_ptr<Segment>> Segments_;
+
+		QTimer * const SaveTimer_;
+		QString ErrorString_;
+
+		enum class State
+		{
+			Running,
+			Stopped,
+			Finished,
+			Failed
+		} State_ = State::Running;
+	public:
+		SegmentedDownload (QNetworkAccessManager*, const QNetworkRequest&,
+				const std::shared_ptr<QFile>&, int maxConnections, QObject* = nullptr);
+		~SegmentedDownload () override;
+
+		/** Returns whether the \em reply to a plain GET request is
+		 * suitable to continue the download in segments.
+		 */
+		static bool CanSegment (QNetworkReply *reply);
+
+		/** Returns whether there is a saved segments state for the
+		 * file at the given \em path.
+		 */
+		static bool HasState (const QString& path);
+
+		/** Continues the download of the \em reply to a plain GET
+		 * request, whose body has been written to the file up to the
+		 * current size of the file, by splitting the rest of the file
+		 * into segments.
+		 */
+		void Adopt (QNetworkReply *reply);
+
+		/** Resumes the download from the saved state. Returns false if
+		 * there is no valid state for this file and URL, in which case
+		 * the state is removed.
+		 */
+		bool Resume ();
+
+		/** Stops all the requests and saves the state of the segments.
+		 */
+		void Stop ();
+
+		/** Returns whether the download is neither stopped, finished
+		 * nor failed.
+		 */
+		bool IsActive () const;
+
+		qint64 GetDone () const;
+		qint64 GetTotal () const;
+		QByteArray GetETag () const;
+		QByteArray GetLastModified () const;
+		QString GetErrorString () const;
+	private:
+		void Schedule ();
+		void StartSegment (Segment&);
+		bool CheckResponse (Segment&);
+		void HandleReadyRead (Segment&);
+		void HandleReplyFinished (Segment&);
+		void HandleSegmentFailed (Segment&, QNetworkReply::NetworkError, const QString&);
+		void DetachReply (Segment&);
+		void CheckFinished ();
+		void Fail (QNetworkReply::NetworkError, const QString&);
+		void FailLocally (const QString&);
+
+		void SaveState ();
+		void RemoveState ();
+	signals:
+		void progress (qint64 done, qint64 total);
+		void finished ();
+		void failed (QNetworkReply::NetworkError, const QString&);
+		void localError (const QString&);
+	};
+}
+}
@@ -24,6 +24,7 @@
 #include <interfaces/core/icoreproxy.h>
 #include <interfaces/core/ientitymanager.h>
 #include "core.h"
+#include "segmenteddownload.h"
 #include "xmlsettingsmanager.h"
 
 namespace LC
@@ -166,6 +167,8 @@ namespace CSTP
 
 	void Task::Start (const std::shared_ptr<QFile>& tof)
 	{
+		DropSegmented ();
+
 		FileSizeAtStart_ = tof->size ();
 		To_ = tof;
 
@@ -187,8 +190,6 @@ namespace CSTP
 				ua = "LeechCraft.CSTP/" + Core::Instance ().GetCoreProxy ()->GetVersion ();
 
 			QNetworkRequest req { URL_ };
-			if (tof->size ())
-				req.setRawHeader ("Range", QString ("bytes=%1-").arg (tof->size ()).toLatin1 ());
 			req.setRawHeader ("User-Agent", ua.toLatin1 ());
 
 			if (Referer_.isEmpty ())
@@ -205,6 +206,14 @@ namespace CSTP
 			for (const auto& pair : Util::Stlize (Headers_))
 				req.setRawHeader (pair.first.toLatin1 (), pair.second.toByteArray ());
 
+			if (Operation_ == QNetworkAccessManager::GetOperation &&
+					SegmentedDownload::HasState (tof->fileName ()) &&
+					TryResumeSegmented (req))
+				return;
+
+			if (tof->size ())
+				req.setRawHeader ("Range", QString ("bytes=%1-").arg (tof->size ()).toLatin1 ());
+
 			auto nam = Core::Instance ().GetNetworkAccessManager ();
 			switch (Operation_)
 			{
@@ -273,6 +282,8 @@ namespace CSTP
 
 	void Task::Stop ()
 	{
+		if (Segmented_)
+			Segmented_->Stop ();
 		if (Reply_)
 			Reply_->abort ();
 	}
@@ -333,6 +344,13 @@ namespace CSTP
 
 	QString Task::GetState () const
 	{
+		if (Segmented_)
+		{
+			if (Segmented_->IsActive ())
+				return tr ("Running");
+			return Done_ == Total_ ? tr ("Finished") : tr ("Stopped");
+		}
+
 		if (!Reply_)
 			return tr ("Stopped");
 		else if (Done_ == Total_)
@@ -353,11 +371,17 @@ namespace CSTP
 
 	bool Task::IsRunning () const
 	{
+		if (Segmented_)
+			return Segmented_->IsActive ();
+
 		return Reply_ && !URL_.isEmpty ();
 	}
 
 	QString Task::GetErrorString () const
 	{
+		if (Segmented_)
+			return Segmented_->GetErrorString ();
+
 		return Reply_ ? Reply_->errorString () : tr ("Task isn't initialized properly");
 	}
 
@@ -374,6 +398,7 @@ namespace CSTP
 		Speed_ = 0;
 		FileSizeAtStart_ = -1;
 		Reply_.reset ();
+		DropSegmented ();
 	}
 
 	void Task::RestartTime ()
@@ -504,6 +529,91 @@ namespace CSTP
 		}
 	}
 
+	SegmentedDownload* Task::CreateSegmented (const QNetworkRequest& req)
+	{
+		const auto count = XmlSettingsManager::Instance ().property ("SegmentsCount").toInt ();
+		Segmented_ = new SegmentedDownload { Core::Instance ().GetNetworkAccessManager (),
+				req, To_, count, this };
+
+		connect (Segmented_,
+				&SegmentedDownload::progress,
+				this,
+				[this] (qint64 done, qint64 total)
+				{
+					Done_ = done;
+					Total_ = total;
+					RecalculateSpeed ();
+				});
+		connect (Segmented_,
+				&SegmentedDownload::finished,
+				this,
+				&Task::handleFinished);
+		connect (Segmented_,
+				&SegmentedDownload::failed,
+				this,
+				[this] (QNetworkReply::NetworkError err, const QString& msg) { HandleError (MapError (err), msg); });
+		connect (Segmented_,
+				&SegmentedDownload::localError,
+				this,
+				[this] (const QString& msg) { HandleError (IDownload::Error::Type::LocalError, msg); });
+
+		if (!Timer_->isActive ())
+			Timer_->start (3000);
+
+		return Segmented_;
+	}
+
+	void Task::DropSegmented ()
+	{
+		if (!Segmented_)
+			return;
+
+		Segmented_->disconnect (this);
+		Segmented_->deleteLater ();
+		Segmented_ = nullptr;
+	}
+
+	bool Task::TryResumeSegmented (const QNetworkRequest& req)
+	{
+		RestartTime ();
+
+		if (CreateSegmented (req)->Resume ())
+			return true;
+
+		DropSegmented ();
+		return false;
+	}
+
+	void Task::TrySwitchToSegmented ()
+	{
+		if (Segmented_ ||
+				URL_.isEmpty () ||
+				Operation_ != QNetworkAccessManager::GetOperation ||
+				FileSizeAtStart_ != 0)
+			return;
+
+		const auto& scheme = Reply_->url ().scheme ();
+		if (scheme != "http" && scheme != "https")
+			return;
+
+		if (XmlSettingsManager::Instance ().property ("SegmentsCount").toInt () < 2 ||
+				!SegmentedDownload::CanSegment (Reply_.get ()))
+			return;
+
+		qDebug () << Q_FUNC_INFO
+				<< "downloading"
+				<< URL_
+				<< "in segments";
+
+		disconnect (Reply_.get (),
+				0,
+				this,
+				0);
+
+		const auto& req = Reply_->request ();
+		CreateSegmented (req)->Adopt (Reply_.release ());
+	}
+
 	void Task::HandleError (IDownload::Error::Type err, const QString& msg)
 	{
 		// TODO don't emit this when the file is already fully downloaded
@@ -598,6 +708,7 @@ namespace CSTP
 	{
 		HandleMetadataRedirection ();
 		HandleMetadataFilename ();
+		TrySwitchToSegmented ();
 	}
 
 	void Task::handleLocalTransfer ()
@@ -694,7 +805,20 @@ namespace CSTP
 
 	void Task::handleFinished ()
 	{
-		Util::ReportFutureResult (Promise_, IDownload::Result::Right ({}));
+		IDownload::Success success;
+		if (Segmented_)
+		{
+			success.HttpStatusCode_ = 200;
+			success.ETag_ = Segmented_->GetETag ();
+			success.LastModified_ = Segmented_->GetLastModified ();
+		}
+		else if (Reply_)
+		{
+			success.HttpStatusCode_ = Reply_->attribute (QNetworkRequest::HttpStatusCodeAttribute).toInt ();
+			success.ETag_ = Reply_->rawHeader ("ETag");
+			success.LastModified_ = Reply_->rawHeader ("Last-Modified");
+		}
+		Util::ReportFutureResult (Promise_, IDownload::Result::Right (success));
 
 		emit done (false);
 	}
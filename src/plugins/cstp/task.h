@@ -30,6 +30,8 @@ namespace LC
 {
 namespace CSTP
 {
+	class SegmentedDownload;
+
 	class Task : public QObject
 	{
 		Q_OBJECT
@@ -42,6 +44,7 @@ namespace CSTP
 		double Speed_ = 0;
 		QList<QUrl> RedirectHistory_;
 		std::shared_ptr<QFile> To_;
+		SegmentedDownload *Segmented_ = nullptr;
 		QTimer *Timer_;
 		bool CanChangeName_ = true;
 
@@ -82,6 +85,11 @@ namespace CSTP
 		void HandleMetadataRedirection ();
 		void HandleMetadataFilename ();
 
+		SegmentedDownload* CreateSegmented (const QNetworkRequest&);
+		void DropSegmented ();
+		bool TryResumeSegmented (const QNetworkRequest&);
+		void TrySwitchToSegmented ();
+
 		void HandleError (IDownload::Error::Type, const QString&);
 	private slots:
 		void handleDataTransferProgress (qint64, qint64);
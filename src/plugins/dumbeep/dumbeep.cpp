@@ -109,6 +109,15 @@ namespace Dumbeep
 
 		QProcess::startDetached (parts.at (0), parts.mid (1) << path);
 	}
+
+	QList<EntityCapability> Plugin::GetEntityCapabilities () const
+	{
+		EntityCapability cap;
+		cap.RequiredParameters_ = Internal;
+		cap.NeedsQuery_ = true;
+		cap.Predicate_ = [] (const Entity& e) { return !GetPath (e).isEmpty (); };
+		return { cap };
+	}
 }
 }
 
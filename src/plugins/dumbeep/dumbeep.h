@@ -12,6 +12,7 @@
 #include <interfaces/iinfo.h>
 #include <interfaces/ihavesettings.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 
 namespace LC
 {
@@ -21,9 +22,10 @@ namespace Dumbeep
 				 , public IInfo
 				 , public IHaveSettings
 				 , public IEntityHandler
+				 , public IHaveEntityCapabilities
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IHaveSettings IEntityHandler)
+		Q_INTERFACES (IInfo IHaveSettings IEntityHandler IHaveEntityCapabilities)
 
 		LC_PLUGIN_METADATA ("org.LeechCraft.Dumbeep")
 
@@ -41,6 +43,8 @@ namespace Dumbeep
 
 		EntityTestHandleResult CouldHandle (const Entity&) const;
 		void Handle (Entity);
+
+		QList<EntityCapability> GetEntityCapabilities () const;
 	};
 }
 }
@@ -97,6 +97,15 @@ namespace GActs
 		RegisterChildren (sh.get (), e);
 	}
 
+	QList<EntityCapability> Plugin::GetEntityCapabilities () const
+	{
+		EntityCapability cap;
+		cap.Mimes_ = QStringList { Mimes::GlobalActionRegister, Mimes::GlobalActionUnregister };
+		cap.RequiredFields_ = QStringList { EF::GlobalAction::ActionID };
+		cap.Priority_ = EntityTestHandleResult::PIdeal;
+		return { cap };
+	}
+
 	void Plugin::RegisterChildren (QxtGlobalShortcut *sh, const Entity& e)
 	{
 		for (const auto& seqVar : e.Additional_ [EF::GlobalAction::AltShortcuts].toList ())
@@ -12,6 +12,7 @@
 #include <QObject>
 #include <interfaces/iinfo.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 
 class QxtGlobalShortcut;
 
@@ -22,9 +23,10 @@ namespace GActs
 	class Plugin : public QObject
 				 , public IInfo
 				 , public IEntityHandler
+				 , public IHaveEntityCapabilities
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IEntityHandler)
+		Q_INTERFACES (IInfo IEntityHandler IHaveEntityCapabilities)
 
 		LC_PLUGIN_METADATA ("org.LeechCraft.GActs")
 
@@ -40,6 +42,8 @@ namespace GActs
 
 		EntityTestHandleResult CouldHandle (const Entity&) const;
 		void Handle (Entity);
+
+		QList<EntityCapability> GetEntityCapabilities () const;
 	private:
 		void RegisterChildren (QxtGlobalShortcut*, const Entity&);
 	private slots:
@@ -81,6 +81,16 @@ namespace HistoryHolder
 	void Plugin::Handle (LC::Entity)
 	{
 	}
+
+	QList<EntityCapability> Plugin::GetEntityCapabilities () const
+	{
+		// CouldHandle() records the downloaded entities in the history.
+		EntityCapability cap;
+		cap.RequiredParameters_ = IsDownloaded;
+		cap.ForbiddenParameters_ = Internal | DoNotSaveInHistory;
+		cap.NeedsQuery_ = true;
+		return { cap };
+	}
 }
 }
 
@@ -13,6 +13,7 @@
 #include <interfaces/iinfo.h>
 #include <interfaces/ifinder.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 
 class QModelIndex;
 
@@ -26,9 +27,10 @@ namespace HistoryHolder
 					, public IInfo
 					, public IFinder
 					, public IEntityHandler
+					, public IHaveEntityCapabilities
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IFinder IEntityHandler)
+		Q_INTERFACES (IInfo IFinder IEntityHandler IHaveEntityCapabilities)
 
 		LC_PLUGIN_METADATA ("org.LeechCraft.HistoryHolder")
 
@@ -48,6 +50,8 @@ namespace HistoryHolder
 
 		EntityTestHandleResult CouldHandle (const Entity&) const;
 		void Handle (Entity);
+
+		QList<EntityCapability> GetEntityCapabilities () const;
 	signals:
 		void categoriesChanged (const QStringList&, const QStringList&);
 	};
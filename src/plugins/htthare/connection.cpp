@@ -14,13 +14,21 @@ namespace LC
 {
 namespace HttHare
 {
+	namespace
+	{
+		const auto IdleTimeout = std::chrono::seconds { 15 };
+		const auto MaxRequestsPerConnection = 1000;
+	}
+
 	Connection::Connection (boost::asio::io_service& service,
-			const StorageManager& stMgr, IconResolver *resolver, TrManager *trMgr)
+			const StorageManager& stMgr, IconResolver *resolver, TrManager *trMgr, ListingCache& cache)
 	: Strand_ { service }
 	, Socket_ { service }
+	, IdleTimer_ { service }
 	, StorageMgr_ (stMgr)
 	, IconResolver_ { resolver }
 	, TrManager_ { trMgr }
+	, ListingCache_ (cache)
 	, Buf_ { 2 * 1024 }
 	{
 	}
@@ -45,6 +53,11 @@ namespace HttHare
 		return TrManager_;
 	}
 
+	ListingCache& Connection::GetListingCache () const
+	{
+		return ListingCache_;
+	}
+
 	const StorageManager& Connection::GetStorageManager () const
 	{
 		return StorageMgr_;
@@ -53,6 +66,18 @@ namespace HttHare
 	void Connection::Start ()
 	{
 		auto conn = shared_from_this ();
+
+		// The timer may have already fired when the request arrives, so
+		// it only closes the connection if it's still waiting for the
+		// same request.
+		const auto generation = ReadGeneration_;
+		IdleTimer_.expires_from_now (IdleTimeout);
+		IdleTimer_.async_wait (Strand_.wrap ([conn, generation] (const boost::system::error_code& ec)
+					{
+						if (!ec && conn->ReadGeneration_ == generation)
+							conn->Close ();
+					}));
+
 		boost::asio::async_read_until (Socket_,
 				Buf_,
 				std::string { "\r\n\r\n" },
@@ -60,8 +85,35 @@ namespace HttHare
 					{ conn->HandleHeader (ec, transferred); }));
 	}
 
-	void Connection::HandleHeader (const boost::system::error_code&, unsigned long transferred)
+	bool Connection::CanKeepAlive () const
+	{
+		return ServedRequests_ + 1 < MaxRequestsPerConnection;
+	}
+
+	void Connection::FinishResponse (bool keepAlive)
 	{
+		++ServedRequests_;
+
+		if (keepAlive && Socket_.is_open ())
+			Start ();
+		else
+			Close ();
+	}
+
+	void Connection::HandleHeader (const boost::system::error_code& ec, unsigned long transferred)
+	{
+		++ReadGeneration_;
+
+		boost::system::error_code iec;
+		IdleTimer_.cancel (iec);
+
+		// Too long headers are still answered with an error below.
+		if (ec && ec != boost::asio::error::not_found)
+		{
+			Close ();
+			return;
+		}
+
 		QByteArray data;
 		data.resize (transferred);
 
@@ -70,5 +122,13 @@ namespace HttHare
 
 		RequestHandler { shared_from_this () } (data);
 	}
+
+	void Connection::Close ()
+	{
+		boost::system::error_code ec;
+		IdleTimer_.cancel (ec);
+		Socket_.shutdown (boost::asio::socket_base::shutdown_both, ec);
+		Socket_.close (ec);
+	}
 }
 }
@@ -10,6 +10,7 @@
 
 #include <memory>
 #include <boost/asio.hpp>
+#include <QtGlobal>
 
 namespace LC
 {
@@ -18,19 +19,26 @@ namespace HttHare
 	class StorageManager;
 	class IconResolver;
 	class TrManager;
+	class ListingCache;
 
 	class Connection : public std::enable_shared_from_this<Connection>
 	{
 		boost::asio::io_service::strand Strand_;
 		boost::asio::ip::tcp::socket Socket_;
+		boost::asio::steady_timer IdleTimer_;
 
 		const StorageManager& StorageMgr_;
 		IconResolver * const IconResolver_;
 		TrManager * const TrManager_;
+		ListingCache& ListingCache_;
 
 		boost::asio::streambuf Buf_;
+
+		int ServedRequests_ = 0;
+		quint64 ReadGeneration_ = 0;
 	public:
-		Connection (boost::asio::io_service&, const StorageManager&, IconResolver*, TrManager*);
+		Connection (boost::asio::io_service&, const StorageManager&,
+				IconResolver*, TrManager*, ListingCache&);
 
 		Connection (const Connection&) = delete;
 		Connection& operator= (const Connection&) = delete;
@@ -39,12 +47,25 @@ namespace HttHare
 		boost::asio::io_service::strand& GetStrand ();
 		IconResolver* GetIconResolver () const;
 		TrManager* GetTrManager () const;
+		ListingCache& GetListingCache () const;
 
 		const StorageManager& GetStorageManager () const;
 
 		void Start ();
+
+		/** Returns whether the connection may be kept alive after the
+		 * response to the current request.
+		 */
+		bool CanKeepAlive () const;
+
+		/** Called once the response to the current request is written,
+		 * either to read the next (possibly already pipelined) request
+		 * or to close the connection.
+		 */
+		void FinishResponse (bool keepAlive);
 	private:
 		void HandleHeader (const boost::system::error_code&, unsigned long);
+		void Close ();
 	};
 
 	typedef std::shared_ptr<Connection> Connection_ptr;
@@ -21,6 +21,28 @@ namespace HttHare
 	{
 	}
 
+	QByteArray IconResolver::GetIconSource (const QString& mimetype, int dim)
+	{
+		const QPair<QString, int> key { mimetype, dim };
+		{
+			QMutexLocker locker { &CacheLock_ };
+			if (const auto pos = Cache_.find (key); pos != Cache_.end ())
+				return *pos;
+		}
+
+		QByteArray image;
+		QMetaObject::invokeMethod (this,
+				"resolveMime",
+				Qt::BlockingQueuedConnection,
+				Q_ARG (QString, mimetype),
+				Q_ARG (QByteArray&, image),
+				Q_ARG (int, dim));
+
+		QMutexLocker locker { &CacheLock_ };
+		Cache_ [key] = image;
+		return image;
+	}
+
 	void IconResolver::resolveMime (QString mimetype, QByteArray& image, int dim)
 	{
 		mimetype.replace ('/', '-');
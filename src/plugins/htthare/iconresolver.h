@@ -9,6 +9,8 @@
 #pragma once
 
 #include <QObject>
+#include <QHash>
+#include <QMutex>
 
 class QImage;
 
@@ -19,8 +21,17 @@ namespace HttHare
 	class IconResolver : public QObject
 	{
 		Q_OBJECT
+
+		QMutex CacheLock_;
+		QHash<QPair<QString, int>, QByteArray> Cache_;
 	public:
 		IconResolver (QObject* = 0);
+
+		/** Returns the icon for the \em mimetype as a data URI,
+		 * resolving it in the GUI thread only the first time it's
+		 * requested. Must not be called from the GUI thread.
+		 */
+		QByteArray GetIconSource (const QString& mimetype, int dim);
 	public slots:
 		void resolveMime (QString, QByteArray&, int);
 	};
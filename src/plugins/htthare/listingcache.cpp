@@ -0,0 +1,40 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "listingcache.h"
+#include <algorithm>
+
+namespace LC
+{
+namespace HttHare
+{
+	ListingCache::ListingCache ()
+	: Cache_ { 32 * 1024 * 1024 }
+	{
+	}
+
+	QByteArray ListingCache::GetListing (const QString& key, const QDateTime& modified, const Renderer_f& render)
+	{
+		{
+			QMutexLocker locker { &Lock_ };
+			if (const auto listing = Cache_.object (key);
+					listing && listing->Modified_ == modified)
+				return listing->Body_;
+		}
+
+		// Rendering is the slow part, so it's done without holding the
+		// lock, even if another thread might be rendering the same
+		// listing at the same time.
+		const auto& body = render ();
+
+		QMutexLocker locker { &Lock_ };
+		Cache_.insert (key, new Listing { modified, body }, std::max (body.size (), 1));
+		return body;
+	}
+}
+}
@@ -0,0 +1,54 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <QByteArray>
+#include <QCache>
+#include <QDateTime>
+#include <QMutex>
+#include <QString>
+
+namespace LC
+{
+namespace HttHare
+{
+	/** @brief Caches the rendered directory listings.
+	 *
+	 * A listing is identified by the path of the directory along with
+	 * everything else affecting its rendering, like the requested URL
+	 * and the languages accepted by the client. A cached listing is
+	 * only used while the modification time of the directory stays the
+	 * same.
+	 *
+	 * This class is thread-safe.
+	 */
+	class ListingCache
+	{
+		struct Listing
+		{
+			QDateTime Modified_;
+			QByteArray Body_;
+		};
+
+		QMutex Lock_;
+		QCache<QString, Listing> Cache_;
+	public:
+		ListingCache ();
+
+		using Renderer_f = std::function<QByteArray ()>;
+
+		/** Returns the cached listing for the given \em key if it has
+		 * been rendered for the same \em modified time, otherwise calls
+		 * \em render and caches its result.
+		 */
+		QByteArray GetListing (const QString& key, const QDateTime& modified, const Renderer_f& render);
+	};
+}
+}
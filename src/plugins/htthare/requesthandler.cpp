@@ -27,12 +27,13 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QDateTime>
+#include <QLocale>
 #include <util/util.h>
 #include <util/sys/mimedetector.h>
-#include <util/sll/util.h>
 #include "connection.h"
 #include "storagemanager.h"
 #include "iconresolver.h"
+#include "listingcache.h"
 #include "trmanager.h"
 
 namespace LC
@@ -72,6 +73,16 @@ namespace HttHare
 			Headers_ [line.left (colonPos)] = line.mid (colonPos + 1).trimmed ();
 		}
 
+		// The requests with bodies aren't supported, so the connection
+		// can't be reused after them.
+		const auto& connection = Headers_.value ("Connection").toLower ();
+		KeepAlive_ = Conn_->CanKeepAlive () &&
+				Headers_.value ("Content-Length").toLongLong () <= 0 &&
+				!Headers_.contains ("Transfer-Encoding") &&
+				(req.value (2).toUpper () == "HTTP/1.1" ?
+						!connection.contains ("close") :
+						connection.contains ("keep-alive"));
+
 #ifdef QT_DEBUG
 		qDebug () << Q_FUNC_INFO << "got request";
 		qDebug () << req << Url_;
@@ -109,6 +120,9 @@ namespace HttHare
 	void RequestHandler::ErrorResponse (int code,
 			const QByteArray& reason, const QByteArray& full)
 	{
+		// The rest of the request might still be in the stream.
+		KeepAlive_ = false;
+
 		ResponseLine_ = "HTTP/1.1 " + QByteArray::number (code) + " " + reason + "\r\n";
 
 		ResponseBody_ = QString (R"delim(<html>
@@ -157,16 +171,7 @@ namespace HttHare
 			const auto& type = detector (entry.filePath ());
 
 			if (!mimeCache.contains (type))
-			{
-				QByteArray image;
-				QMetaObject::invokeMethod (Conn_->GetIconResolver (),
-						"resolveMime",
-						Qt::BlockingQueuedConnection,
-						Q_ARG (QString, type),
-						Q_ARG (QByteArray&, image),
-						Q_ARG (int, IconSize));
-				mimeCache [type] = image;
-			}
+				mimeCache [type] = Conn_->GetIconResolver ()->GetIconSource (type, IconSize);
 
 			mimes.append ({ type });
 		}
@@ -205,6 +210,66 @@ namespace HttHare
 		return result.toUtf8 ();
 	}
 
+	namespace
+	{
+		const auto HttpDateFormat = "ddd, dd MMM yyyy hh:mm:ss 'GMT'";
+
+		QByteArray FormatHttpDate (const QDateTime& dt)
+		{
+			return QLocale::c ().toString (dt.toUTC (), HttpDateFormat).toLatin1 ();
+		}
+
+		QDateTime ParseHttpDate (const QString& str)
+		{
+			auto dt = QLocale::c ().toDateTime (str.trimmed (), HttpDateFormat);
+			dt.setTimeSpec (Qt::UTC);
+			return dt;
+		}
+
+		QByteArray StripWeak (QByteArray etag)
+		{
+			if (etag.startsWith ("W/"))
+				etag.remove (0, 2);
+			return etag;
+		}
+	}
+
+	bool RequestHandler::IsNotModified (const QByteArray& etag, const QDateTime& modified) const
+	{
+		// If-None-Match takes precedence over If-Modified-Since, and the
+		// weak comparison is fine for GET and HEAD.
+		const auto& ifNoneMatch = Headers_.value ("If-None-Match");
+		if (!ifNoneMatch.isEmpty ())
+		{
+			const auto& ours = StripWeak (etag);
+			for (const auto& tag : ifNoneMatch.split (','))
+			{
+				const auto& theirs = tag.trimmed ().toLatin1 ();
+				if (theirs == "*" || StripWeak (theirs) == ours)
+					return true;
+			}
+			return false;
+		}
+
+		const auto& ifModifiedSince = ParseHttpDate (Headers_.value ("If-Modified-Since"));
+		return ifModifiedSince.isValid () &&
+				modified.toSecsSinceEpoch () <= ifModifiedSince.toSecsSinceEpoch ();
+	}
+
+	void RequestHandler::AddValidators (const QByteArray& etag, const QDateTime& modified)
+	{
+		ResponseHeaders_.append ({ "ETag", etag });
+		ResponseHeaders_.append ({ "Last-Modified", FormatHttpDate (modified) });
+	}
+
+	void RequestHandler::NotModifiedResponse (Verb verb)
+	{
+		ResponseLine_ = "HTTP/1.1 304 Not Modified\r\n";
+		HasBody_ = false;
+
+		DefaultWrite (verb);
+	}
+
 	namespace
 	{
 		QList<QPair<qint64, qint64>> ParseRanges (QString str, qint64 fullSize)
@@ -425,10 +490,25 @@ namespace HttHare
 	{
 		if (Url_.path ().endsWith ('/'))
 		{
+			// The listing also depends on the URL it's requested by and
+			// on the languages it's translated to.
+			const auto& modified = fi.lastModified ();
+			const auto& key = path + '\n' + Url_.toString () + '\n' + Headers_.value ("Accept-Language");
+			const auto& etag = "W/\"" + QByteArray::number (modified.toMSecsSinceEpoch (), 16) +
+					'-' + QByteArray::number (qHash (key), 16) + '"';
+
+			// The listings change way more often than the files, so the
+			// clients should always revalidate them.
+			ResponseHeaders_.push_back ({ "Cache-Control", "no-cache" });
+			AddValidators (etag, modified);
+			if (IsNotModified (etag, modified))
+				return NotModifiedResponse (verb);
+
 			ResponseLine_ = "HTTP/1.1 200 OK\r\n";
 
 			ResponseHeaders_.push_back ({ "Content-Type", "text/html; charset=utf-8" });
-			ResponseBody_ = MakeDirResponse (fi, path, Url_);
+			ResponseBody_ = Conn_->GetListingCache ().GetListing (key, modified,
+					[&] { return MakeDirResponse (fi, path, Url_); });
 
 			DefaultWrite (verb);
 		}
@@ -447,6 +527,13 @@ namespace HttHare
 
 	void RequestHandler::WriteFile (const QString& path, const QFileInfo& fi, RequestHandler::Verb verb)
 	{
+		const auto& modified = fi.lastModified ();
+		const auto& etag = '"' + QByteArray::number (modified.toMSecsSinceEpoch (), 16) +
+				'-' + QByteArray::number (fi.size (), 16) + '"';
+		AddValidators (etag, modified);
+		if (IsNotModified (etag, modified))
+			return NotModifiedResponse (verb);
+
 		auto ranges = ParseRanges (Headers_.value ("Range"), fi.size ());
 
 		const auto& mime = Util::MimeDetector {} (path);
@@ -468,22 +555,30 @@ namespace HttHare
 			ResponseHeaders_.append ({ "Content-Length", QByteArray::number (totalSize) });
 		}
 
+		const auto& buffers = ToBuffers (verb);
+
+		// The buffers point to the data of these copies, which outlive
+		// this handler.
 		auto c = Conn_;
 		boost::asio::async_write (c->GetSocket (),
-				ToBuffers (verb),
-				c->GetStrand ().wrap ([c, path, verb, ranges] (boost::system::error_code ec, ulong) mutable -> void
+				buffers,
+				c->GetStrand ().wrap ([c, path, verb, ranges, keepAlive = KeepAlive_,
+							line = ResponseLine_, headers = CookedRH_]
+						(boost::system::error_code ec, ulong) mutable -> void
 					{
 						if (ec)
+						{
 							qWarning () << Q_FUNC_INFO
 									<< ec.message ().c_str ();
-
-						auto& s = c->GetSocket ();
-
-						auto shutdownGuard = Util::MakeScopeGuard ([&s, &ec]
-								{ s.shutdown (boost::asio::socket_base::shutdown_both, ec); }).Shared ();
+							c->FinishResponse (false);
+							return;
+						}
 
 						if (verb != Verb::Get)
+						{
+							c->FinishResponse (keepAlive);
 							return;
+						}
 
 						auto file = std::make_shared<QFile> (path);
 						if (!file->open (QIODevice::ReadOnly))
@@ -492,12 +587,14 @@ namespace HttHare
 									<< "cannot open file"
 									<< path
 									<< file->errorString ();
+							c->FinishResponse (false);
 							return;
 						}
 
 						if (ranges.isEmpty ())
 							ranges.append ({ 0, file->size () - 1 });
 
+						auto& s = c->GetSocket ();
 						if (!s.native_non_blocking ())
 							s.native_non_blocking (true, ec);
 
@@ -509,24 +606,30 @@ namespace HttHare
 							0,
 							headRange,
 							ranges,
-							[c, shutdownGuard] (boost::system::error_code, ulong) {}
+							[c, keepAlive] (boost::system::error_code sendEc, ulong)
+								{ c->FinishResponse (keepAlive && !sendEc); }
 						} (ec, 0);
 					}));
 	}
 
 	void RequestHandler::DefaultWrite (Verb verb)
 	{
+		const auto& buffers = ToBuffers (verb);
+
+		// The buffers point to the data of these copies, which outlive
+		// this handler.
 		auto c = Conn_;
 		boost::asio::async_write (c->GetSocket (),
-				ToBuffers (verb),
-				c->GetStrand ().wrap ([c] (const boost::system::error_code& ec, ulong)
+				buffers,
+				c->GetStrand ().wrap ([c, keepAlive = KeepAlive_,
+							line = ResponseLine_, headers = CookedRH_, body = ResponseBody_]
+						(const boost::system::error_code& ec, ulong)
 					{
 						if (ec)
 							qWarning () << Q_FUNC_INFO
 									<< ec.message ().c_str ();
 
-						boost::system::error_code iec;
-						c->GetSocket ().shutdown (boost::asio::socket_base::shutdown_both, iec);
+						c->FinishResponse (keepAlive && !ec);
 					}));
 	}
 
@@ -564,7 +667,9 @@ namespace HttHare
 			ResponseBody_.remove (0, 4);
 		}
 
-		if (!hasContentLength)
+		ResponseHeaders_.append ({ "Connection", KeepAlive_ ? "keep-alive" : "close" });
+
+		if (!hasContentLength && HasBody_)
 			ResponseHeaders_.append ({ "Content-Length", QByteArray::number (ResponseBody_.size ()) });
 
 		CookedRH_.clear ();
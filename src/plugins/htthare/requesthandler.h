@@ -16,6 +16,7 @@
 #include <QCoreApplication>
 
 class QFileInfo;
+class QDateTime;
 
 namespace LC
 {
@@ -37,6 +38,9 @@ namespace HttHare
 		QList<QPair<QByteArray, QByteArray>> ResponseHeaders_;
 		QByteArray CookedRH_;
 		QByteArray ResponseBody_;
+		bool HasBody_ = true;
+
+		bool KeepAlive_ = false;
 
 		enum class Verb
 		{
@@ -53,6 +57,10 @@ namespace HttHare
 		void ErrorResponse (int, const QByteArray&, const QByteArray& = QByteArray ());
 		QByteArray MakeDirResponse (const QFileInfo&, const QString&, const QUrl&);
 
+		bool IsNotModified (const QByteArray& etag, const QDateTime& modified) const;
+		void AddValidators (const QByteArray& etag, const QDateTime& modified);
+		void NotModifiedResponse (Verb);
+
 		void HandleRequest (Verb);
 		void WriteDir (const QString&, const QFileInfo&, Verb);
 		void WriteFile (const QString&, const QFileInfo&, Verb);
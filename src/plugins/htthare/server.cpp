@@ -76,7 +76,7 @@ namespace HttHare
 
 	void Server::StartAccept ()
 	{
-		Connection_ptr connection { new Connection { IoService_, StorageMgr_, IconResolver_, TrManager_ } };
+		Connection_ptr connection { new Connection { IoService_, StorageMgr_, IconResolver_, TrManager_, ListingCache_ } };
 
 		for (auto& acceptor : Acceptors_)
 			acceptor->async_accept (connection->GetSocket (),
@@ -11,6 +11,7 @@
 #include <thread>
 #include <boost/asio.hpp>
 #include "storagemanager.h"
+#include "listingcache.h"
 
 template<typename T>
 class QSet;
@@ -30,6 +31,7 @@ namespace HttHare
 		std::vector<std::unique_ptr<boost::asio::ip::tcp::acceptor>> Acceptors_;
 
 		StorageManager StorageMgr_;
+		ListingCache ListingCache_;
 
 		std::vector<std::thread> Threads_;
 
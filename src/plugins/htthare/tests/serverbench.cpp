@@ -0,0 +1,328 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "serverbench.h"
+#include <atomic>
+#include <thread>
+#include <boost/asio.hpp>
+#include <QtTest>
+#include <QTcpServer>
+#include "server.h"
+
+QTEST_MAIN (LC::HttHare::ServerBench)
+
+namespace LC::HttHare
+{
+	namespace
+	{
+		const int ClientsCount = 8;
+
+		int GetEntriesCount ()
+		{
+			bool ok = false;
+			const auto count = qEnvironmentVariableIntValue ("LC_HTTHARE_BENCH_ENTRIES", &ok);
+			return ok ? count : 2000;
+		}
+
+		int GetRequestsPerClient ()
+		{
+			bool ok = false;
+			const auto count = qEnvironmentVariableIntValue ("LC_HTTHARE_BENCH_REQUESTS", &ok);
+			return ok ? count : 200;
+		}
+
+		struct Response
+		{
+			int Code_ = 0;
+			QMap<QByteArray, QByteArray> Headers_;
+			QByteArray Body_;
+		};
+
+		Response ReadResponse (boost::asio::ip::tcp::socket& sock, boost::asio::streambuf& buf)
+		{
+			const auto headerSize = boost::asio::read_until (sock, buf, std::string { "\r\n\r\n" });
+
+			QByteArray header;
+			header.resize (headerSize);
+			std::istream { &buf }.read (header.data (), headerSize);
+
+			auto lines = header.split ('\n');
+			for (auto& line : lines)
+				line = line.trimmed ();
+			lines.removeAll ({});
+
+			Response result;
+			result.Code_ = lines.takeFirst ().split (' ').value (1).toInt ();
+			for (const auto& line : lines)
+			{
+				const auto colonPos = line.indexOf (':');
+				result.Headers_ [line.left (colonPos).toLower ()] = line.mid (colonPos + 1).trimmed ();
+			}
+
+			const auto length = result.Headers_.value ("content-length").toLongLong ();
+			if (static_cast<qint64> (buf.size ()) < length)
+				boost::asio::read (sock, buf, boost::asio::transfer_exactly (length - buf.size ()));
+
+			result.Body_.resize (length);
+			std::istream { &buf }.read (result.Body_.data (), length);
+			return result;
+		}
+
+		QByteArray MakeRequest (const QByteArray& path, bool keepAlive, const QByteArray& etag = {})
+		{
+			QByteArray result = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n";
+			if (!keepAlive)
+				result += "Connection: close\r\n";
+			if (!etag.isEmpty ())
+				result += "If-None-Match: " + etag + "\r\n";
+			return result + "\r\n";
+		}
+
+		struct LoadParams
+		{
+			QByteArray Request_;
+			bool KeepAlive_;
+			int PipelineDepth_;
+		};
+
+		struct ClientResult
+		{
+			QMap<int, int> Codes_;
+			QByteArray LastETag_;
+			QString Error_;
+		};
+
+		ClientResult RunClient (quint16 port, const LoadParams& params, int requests)
+		{
+			ClientResult result;
+
+			boost::asio::io_service io;
+			const boost::asio::ip::tcp::endpoint endpoint { boost::asio::ip::address_v4::loopback (), port };
+			boost::asio::ip::tcp::socket sock { io };
+			boost::asio::streambuf buf;
+
+			const auto handle = [&result] (const Response& resp)
+			{
+				++result.Codes_ [resp.Code_];
+				result.LastETag_ = resp.Headers_.value ("etag");
+			};
+
+			try
+			{
+				if (!params.KeepAlive_)
+					for (int i = 0; i < requests; ++i)
+					{
+						sock.connect (endpoint);
+						boost::asio::write (sock, boost::asio::buffer (params.Request_.constData (), params.Request_.size ()));
+						handle (ReadResponse (sock, buf));
+						sock.close ();
+						buf.consume (buf.size ());
+					}
+				else
+				{
+					sock.connect (endpoint);
+					for (int sent = 0; sent < requests; )
+					{
+						// The requests of a batch are sent at once, without
+						// waiting for the responses to the previous ones.
+						const auto batch = std::min (params.PipelineDepth_, requests - sent);
+						const auto& data = params.Request_.repeated (batch);
+						boost::asio::write (sock, boost::asio::buffer (data.constData (), data.size ()));
+						for (int i = 0; i < batch; ++i)
+							handle (ReadResponse (sock, buf));
+						sent += batch;
+					}
+				}
+			}
+			catch (const std::exception& e)
+			{
+				result.Error_ = QString::fromUtf8 (e.what ());
+			}
+
+			return result;
+		}
+
+		/* The server resolves the icons in the GUI thread, so the clients
+		 * run in their own threads while this one keeps processing events.
+		 */
+		QList<ClientResult> RunLoad (quint16 port, const LoadParams& params, int clients, int requests)
+		{
+			QVector<ClientResult> results (clients);
+			std::atomic<int> finished { 0 };
+
+			std::vector<std::thread> threads;
+			for (int i = 0; i < clients; ++i)
+				threads.emplace_back ([&, i]
+						{
+							results [i] = RunClient (port, params, requests);
+							++finished;
+						});
+
+			while (finished < clients)
+				QCoreApplication::processEvents (QEventLoop::AllEvents, 5);
+
+			for (auto& thread : threads)
+				thread.join ();
+
+			return results.toList ();
+		}
+
+		void CheckResults (const QList<ClientResult>& results, int code, int requests)
+		{
+			for (const auto& result : results)
+			{
+				QVERIFY2 (result.Error_.isEmpty (), qPrintable (result.Error_));
+				QCOMPARE (result.Codes_.value (code), requests);
+			}
+		}
+	}
+
+	ServerBench::ServerBench () = default;
+	ServerBench::~ServerBench () = default;
+
+	/* The server is started on a temporary home directory with a single
+	 * directory of GetEntriesCount () files of several types, listed by
+	 * the clients like a media player paging through a collection would
+	 * do. Set LC_HTTHARE_BENCH_ENTRIES and LC_HTTHARE_BENCH_REQUESTS to
+	 * change the size of the directory and the number of requests per
+	 * each of the ClientsCount clients.
+	 */
+	void ServerBench::initTestCase ()
+	{
+		QVERIFY (Home_.isValid ());
+
+		const QDir home { Home_.path () };
+		QVERIFY (home.mkpath ("media"));
+
+		const QStringList extensions { "txt", "mp3", "flac", "jpg", "png", "mkv", "pdf", "html" };
+		for (int i = 0, count = GetEntriesCount (); i < count; ++i)
+		{
+			QFile file { home.filePath (QString { "media/entry%1.%2" }.arg (i).arg (extensions.at (i % extensions.size ()))) };
+			QVERIFY (file.open (QIODevice::WriteOnly));
+			file.write (QByteArray::number (i));
+		}
+
+		QFile file { home.filePath ("media/small.bin") };
+		QVERIFY (file.open (QIODevice::WriteOnly));
+		file.write (QByteArray { 16 * 1024, 'x' });
+		file.close ();
+
+		OrigHome_ = qgetenv ("HOME");
+		qputenv ("HOME", QFile::encodeName (Home_.path ()));
+
+		QTcpServer probe;
+		QVERIFY (probe.listen (QHostAddress::LocalHost));
+		Port_ = probe.serverPort ();
+		probe.close ();
+
+		Server_ = std::make_unique<Server> (QList<QPair<QString, QString>> { { "127.0.0.1", QString::number (Port_) } });
+		Server_->Start ();
+	}
+
+	void ServerBench::cleanupTestCase ()
+	{
+		Server_.reset ();
+		qputenv ("HOME", OrigHome_);
+	}
+
+	void ServerBench::testKeepAlive ()
+	{
+		const auto& results = RunLoad (Port_, { MakeRequest ("/media/small.bin", true), true, 4 }, 1, 10);
+		CheckResults (results, 200, 10);
+	}
+
+	void ServerBench::testConditional ()
+	{
+		const auto& first = RunLoad (Port_, { MakeRequest ("/media/", true), true, 1 }, 1, 1);
+		CheckResults (first, 200, 1);
+
+		const auto& etag = first.value (0).LastETag_;
+		QVERIFY (!etag.isEmpty ());
+
+		const auto& results = RunLoad (Port_, { MakeRequest ("/media/", true, etag), true, 4 }, 1, 8);
+		CheckResults (results, 304, 8);
+
+		QFile file { QDir { Home_.path () }.filePath ("media/new.txt") };
+		QVERIFY (file.open (QIODevice::WriteOnly));
+		file.close ();
+
+		// Some filesystems only keep the modification times in seconds.
+		QTest::qWait (1100);
+		QVERIFY (QFile::remove (file.fileName ()));
+
+		const auto& changed = RunLoad (Port_, { MakeRequest ("/media/", true, etag), true, 1 }, 1, 1);
+		CheckResults (changed, 200, 1);
+	}
+
+	namespace
+	{
+		void AddLoadRows ()
+		{
+			QTest::addColumn<bool> ("keepAlive");
+			QTest::addColumn<int> ("pipelineDepth");
+			QTest::addColumn<bool> ("conditional");
+
+			QTest::newRow ("connection per request") << false << 1 << false;
+			QTest::newRow ("keep-alive") << true << 1 << false;
+			QTest::newRow ("keep-alive, pipelined") << true << 8 << false;
+			QTest::newRow ("keep-alive, pipelined, conditional") << true << 8 << true;
+		}
+	}
+
+	void ServerBench::benchListing_data ()
+	{
+		AddLoadRows ();
+	}
+
+	void ServerBench::benchListing ()
+	{
+		QFETCH (bool, keepAlive);
+		QFETCH (int, pipelineDepth);
+		QFETCH (bool, conditional);
+
+		QByteArray etag;
+		if (conditional)
+			etag = RunLoad (Port_, { MakeRequest ("/media/", true), true, 1 }, 1, 1).value (0).LastETag_;
+
+		const auto requests = GetRequestsPerClient ();
+		const LoadParams params { MakeRequest ("/media/", keepAlive, etag), keepAlive, pipelineDepth };
+
+		QList<ClientResult> results;
+		QBENCHMARK_ONCE
+		{
+			results = RunLoad (Port_, params, ClientsCount, requests);
+		}
+		CheckResults (results, conditional ? 304 : 200, requests);
+	}
+
+	void ServerBench::benchFile_data ()
+	{
+		AddLoadRows ();
+	}
+
+	void ServerBench::benchFile ()
+	{
+		QFETCH (bool, keepAlive);
+		QFETCH (int, pipelineDepth);
+		QFETCH (bool, conditional);
+
+		QByteArray etag;
+		if (conditional)
+			etag = RunLoad (Port_, { MakeRequest ("/media/small.bin", true), true, 1 }, 1, 1).value (0).LastETag_;
+
+		const auto requests = GetRequestsPerClient ();
+		const LoadParams params { MakeRequest ("/media/small.bin", keepAlive, etag), keepAlive, pipelineDepth };
+
+		QList<ClientResult> results;
+		QBENCHMARK_ONCE
+		{
+			results = RunLoad (Port_, params, ClientsCount, requests);
+		}
+		CheckResults (results, conditional ? 304 : 200, requests);
+	}
+}
@@ -0,0 +1,43 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <QObject>
+#include <QTemporaryDir>
+
+namespace LC::HttHare
+{
+	class Server;
+
+	class ServerBench : public QObject
+	{
+		Q_OBJECT
+
+		QTemporaryDir Home_;
+		QByteArray OrigHome_;
+		std::unique_ptr<Server> Server_;
+		quint16 Port_ = 0;
+	public:
+		ServerBench ();
+		~ServerBench () override;
+	private slots:
+		void initTestCase ();
+		void cleanupTestCase ();
+
+		void testKeepAlive ();
+		void testConditional ();
+
+		void benchListing_data ();
+		void benchListing ();
+
+		void benchFile_data ();
+		void benchFile ();
+	};
+}
@@ -11,6 +11,7 @@
 #include <QObject>
 #include <interfaces/iinfo.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/idatafilter.h>
 #include <interfaces/ijobholder.h>
 
@@ -24,11 +25,12 @@ namespace LC::Imgaste
 	class Plugin : public QObject
 				 , public IInfo
 				 , public IEntityHandler
+				 , public IHaveEntityCapabilities
 				 , public IDataFilter
 				 , public IJobHolder
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IEntityHandler IDataFilter IJobHolder)
+		Q_INTERFACES (IInfo IEntityHandler IHaveEntityCapabilities IDataFilter IJobHolder)
 
 		LC_PLUGIN_METADATA ("org.LeechCraft.Imgaste")
 
@@ -45,6 +47,8 @@ namespace LC::Imgaste
 		EntityTestHandleResult CouldHandle (const Entity&) const override;
 		void Handle (Entity) override;
 
+		QList<EntityCapability> GetEntityCapabilities () const override;
+
 		QString GetFilterVerb () const override;
 		QList<FilterVariant> GetFilterVariants (const QVariant&) const override;
 
@@ -79,6 +79,15 @@ namespace LC::Kinotify
 				EntityTestHandleResult ();
 	}
 
+	QList<EntityCapability> Plugin::GetEntityCapabilities () const
+	{
+		EntityCapability cap;
+		cap.Mimes_ = QStringList { LC::Mimes::Notification };
+		cap.Priority_ = EntityTestHandleResult::PHigh;
+		cap.Predicate_ = [] (const Entity& e) { return !e.Additional_ [LC::EF::Text].toString ().isEmpty (); };
+		return { cap };
+	}
+
 	namespace
 	{
 		QString GetPriorityIconName (Priority prio)
@@ -11,6 +11,7 @@
 #include <QObject>
 #include <interfaces/iinfo.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/ihavesettings.h>
 #include <xmlsettingsdialog/xmlsettingsdialog.h>
 
@@ -21,10 +22,11 @@ namespace LC::Kinotify
 	class Plugin : public QObject
 					, public IInfo
 					, public IEntityHandler
+					, public IHaveEntityCapabilities
 					, public IHaveSettings
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IEntityHandler IHaveSettings)
+		Q_INTERFACES (IInfo IEntityHandler IHaveEntityCapabilities IHaveSettings)
 
 		LC_PLUGIN_METADATA ("org.LeechCraft.Kinotify")
 
@@ -42,6 +44,8 @@ namespace LC::Kinotify
 		EntityTestHandleResult CouldHandle (const Entity&) const override;
 		void Handle (Entity) override;
 
+		QList<EntityCapability> GetEntityCapabilities () const override;
+
 		Util::XmlSettingsDialog_ptr GetSettingsDialog () const override;
 	private:
 		void TestNotification ();
@@ -144,6 +144,14 @@ namespace LackMan
 		}
 	}
 
+	QList<EntityCapability> Plugin::GetEntityCapabilities () const
+	{
+		EntityCapability cap;
+		cap.Mimes_ = QStringList { "x-leechcraft/package-manager-action" };
+		cap.Priority_ = EntityTestHandleResult::PIdeal;
+		return { cap };
+	}
+
 	void Plugin::SetShortcut (const QByteArray& id, const QKeySequences_t& seqs)
 	{
 		ShortcutMgr_->SetShortcut (id, seqs);
@@ -16,6 +16,7 @@
 #include <interfaces/ihavetabs.h>
 #include <interfaces/ihavesettings.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/ihaveshortcuts.h>
 #include <interfaces/ihaverecoverabletabs.h>
 
@@ -37,6 +38,7 @@ namespace LackMan
 				 , public IHaveTabs
 				 , public IHaveSettings
 				 , public IEntityHandler
+				 , public IHaveEntityCapabilities
 				 , public IHaveShortcuts
 				 , public IHaveRecoverableTabs
 	{
@@ -45,6 +47,7 @@ namespace LackMan
 				IHaveTabs
 				IHaveSettings
 				IEntityHandler
+				IHaveEntityCapabilities
 				IHaveShortcuts
 				IHaveRecoverableTabs)
 
@@ -75,6 +78,8 @@ namespace LackMan
 		EntityTestHandleResult CouldHandle (const Entity&) const;
 		void Handle (Entity);
 
+		QList<EntityCapability> GetEntityCapabilities () const;
+
 		void SetShortcut (const QByteArray&, const QKeySequences_t&);
 		QMap<QByteArray, ActionInfo> GetActionInfo () const;
 
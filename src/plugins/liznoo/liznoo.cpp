@@ -143,6 +143,14 @@ namespace Liznoo
 					entity.Additional_ ["ContextID"].toString ());
 	}
 
+	QList<EntityCapability> Plugin::GetEntityCapabilities () const
+	{
+		EntityCapability cap;
+		cap.Mimes_ = QStringList { "x-leechcraft/power-management" };
+		cap.Priority_ = EntityTestHandleResult::PIdeal;
+		return { cap };
+	}
+
 	QList<QAction*> Plugin::GetActions (ActionsEmbedPlace) const
 	{
 		return {};
@@ -12,6 +12,7 @@
 #include <interfaces/iinfo.h>
 #include <interfaces/ihavesettings.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/iactionsexporter.h>
 #include <interfaces/iquarkcomponentprovider.h>
 #include "batteryhistory.h"
@@ -28,11 +29,12 @@ namespace Liznoo
 				 , public IInfo
 				 , public IHaveSettings
 				 , public IEntityHandler
+				 , public IHaveEntityCapabilities
 				 , public IActionsExporter
 				 , public IQuarkComponentProvider
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IHaveSettings IEntityHandler IActionsExporter IQuarkComponentProvider)
+		Q_INTERFACES (IInfo IHaveSettings IEntityHandler IHaveEntityCapabilities IActionsExporter IQuarkComponentProvider)
 
 		LC_PLUGIN_METADATA ("org.LeechCraft.Liznoo")
 
@@ -64,6 +66,8 @@ namespace Liznoo
 		EntityTestHandleResult CouldHandle (const Entity& entity) const;
 		void Handle (Entity entity);
 
+		QList<EntityCapability> GetEntityCapabilities () const;
+
 		QList<QAction*> GetActions (ActionsEmbedPlace) const;
 		QMap<QString, QList<QAction*>> GetMenuActions () const;
 
@@ -13,7 +13,7 @@
 #include <QStandardItemModel>
 #include <QMessageBox>
 #include <QClipboard>
-#include <QMutexLocker>
+#include <QReadLocker>
 #include <QFileInfo>
 #include <QAction>
 #include <QtDebug>
@@ -265,7 +265,7 @@ namespace LC::LMP
 		{
 			const auto resolver = Core::Instance ().GetLocalFileResolver ();
 
-			QMutexLocker tlLocker { &resolver->GetMutex () };
+			QReadLocker tlLocker { &resolver->GetTagLibLock () };
 			const auto r = resolver->GetFileRef (path);
 			const auto tag = r.tag ();
 			if (!tag)
@@ -7,6 +7,7 @@
  **********************************************************************/
 
 #include "collectionwidget.h"
+#include <algorithm>
 #include <QSortFilterProxyModel>
 #include <QMessageBox>
 #include <QMenu>
@@ -80,10 +81,6 @@ namespace LC::LMP
 		new Util::ClearLineEditAddon (GetProxyHolder (), Ui_.CollectionFilter_);
 		new PaletteFixerFilter (Ui_.CollectionTree_);
 
-		connect (Core::Instance ().GetLocalCollection (),
-				&LocalCollection::scanStarted,
-				Ui_.ScanProgress_,
-				&QProgressBar::setMaximum);
 		connect (Core::Instance ().GetLocalCollection (),
 				&LocalCollection::scanProgressChanged,
 				this,
@@ -296,16 +293,18 @@ namespace LC::LMP
 		menu.exec (Ui_.CollectionTree_->viewport ()->mapToGlobal (point));
 	}
 
-	void CollectionWidget::HandleScanProgress (int progress)
+	void CollectionWidget::HandleScanProgress (const LocalCollectionScanner::Progress& progress)
 	{
-		if (progress >= Ui_.ScanProgress_->maximum ())
-		{
-			Ui_.ScanProgress_->hide ();
-			return;
-		}
+		// The number of the changed files isn't known until the walk finishes.
+		Ui_.ScanProgress_->setMaximum (progress.IsWalkFinished_ ? std::max (progress.Changed_, 1) : 0);
+		Ui_.ScanProgress_->setValue (progress.Delivered_);
+		Ui_.ScanProgress_->setFormat (tr ("%1 files found, %2 changed, %3 read, %4 stored")
+				.arg (progress.Found_)
+				.arg (progress.Changed_)
+				.arg (progress.Read_)
+				.arg (progress.Delivered_));
 
 		if (!Ui_.ScanProgress_->isVisible ())
 			Ui_.ScanProgress_->show ();
-		Ui_.ScanProgress_->setValue (progress);
 	}
 }
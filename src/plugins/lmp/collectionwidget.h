@@ -11,6 +11,7 @@
 #include <QWidget>
 #include <interfaces/core/ihookproxy.h>
 #include "ui_collectionwidget.h"
+#include "localcollectionscanner.h"
 
 class QSortFilterProxyModel;
 
@@ -38,7 +39,7 @@ namespace LC::LMP
 		void HandleCollectionRemove ();
 		void HandleCollectionDelete ();
 		void LoadFromCollection ();
-		void HandleScanProgress (int);
+		void HandleScanProgress (const LocalCollectionScanner::Progress&);
 
 		void ShowContextMenu (QPoint);
 	signals:
@@ -55,7 +55,7 @@ namespace LMP
 
 		LMPProxy LmpProxy_ { &Collection_, &Resolver_ };
 
-		RgAnalysisManager RgMgr_ { &Collection_ };
+		RgAnalysisManager RgMgr_ { &Collection_, &Player_ };
 
 		Members () = default;
 	};
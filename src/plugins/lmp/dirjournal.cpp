@@ -0,0 +1,261 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "dirjournal.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QtDebug>
+
+namespace LC::LMP
+{
+	namespace
+	{
+		constexpr quint32 JournalMagic = 0x4c4d504a;
+		constexpr quint32 JournalVersion = 1;
+
+		bool IsUnder (const QString& path, const QString& root)
+		{
+			return path.startsWith (root) &&
+					(path.size () == root.size () ||
+						root.endsWith ('/') ||
+						path.at (root.size ()) == '/');
+		}
+	}
+
+	DirJournal::DirJournal (const QString& path)
+	: Path_ { path }
+	{
+		Load ();
+		LoadDirtyLog ();
+	}
+
+	DirJournal::~DirJournal ()
+	{
+		Save ();
+	}
+
+	void DirJournal::Save ()
+	{
+		if (!IsModified_)
+			return;
+
+		QSaveFile file { Path_ };
+		if (!file.open (QIODevice::WriteOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< file.fileName ()
+					<< file.errorString ();
+			return;
+		}
+
+		QDataStream ostr { &file };
+		ostr << JournalMagic << JournalVersion << static_cast<qint32> (DirMTimes_.size ());
+		for (auto i = DirMTimes_.begin (), end = DirMTimes_.end (); i != end; ++i)
+			ostr << i.key () << i.value ();
+
+		if (!file.commit ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to save"
+					<< file.fileName ()
+					<< file.errorString ();
+			return;
+		}
+
+		QSaveFile dirtyLog { GetDirtyLogPath () };
+		if (!dirtyLog.open (QIODevice::WriteOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< dirtyLog.fileName ()
+					<< dirtyLog.errorString ();
+			return;
+		}
+
+		QTextStream dirtyStr { &dirtyLog };
+		dirtyStr.setCodec ("UTF-8");
+		for (const auto& dir : DirtyDirs_)
+			dirtyStr << dir << '\n';
+		dirtyStr.flush ();
+
+		if (!dirtyLog.commit ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to save"
+					<< dirtyLog.fileName ()
+					<< dirtyLog.errorString ();
+			return;
+		}
+
+		IsModified_ = false;
+	}
+
+	bool DirJournal::IsKnown (const QString& root) const
+	{
+		return DirMTimes_.contains (root);
+	}
+
+	auto DirJournal::GetSnapshot (const QString& root) const -> Snapshot
+	{
+		Snapshot result;
+		for (auto i = DirMTimes_.begin (), end = DirMTimes_.end (); i != end; ++i)
+			if (IsUnder (i.key (), root))
+				result.DirMTimes_ [i.key ()] = i.value ();
+		for (const auto& dir : DirtyDirs_)
+			if (IsUnder (dir, root))
+				result.DirtyDirs_ << dir;
+		return result;
+	}
+
+	auto DirJournal::CollectChanges (const Snapshot& snapshot) -> Changes
+	{
+		Changes result;
+		for (auto i = snapshot.DirMTimes_.begin (), end = snapshot.DirMTimes_.end (); i != end; ++i)
+		{
+			const QFileInfo fi { i.key () };
+			if (!fi.isDir ())
+				result.RemovedDirs_ << i.key ();
+			else if (fi.lastModified ().toMSecsSinceEpoch () != i.value () ||
+					snapshot.DirtyDirs_.contains (i.key ()))
+				result.ChangedDirs_ << i.key ();
+		}
+
+		// The dirty directories unknown to the journal have appeared
+		// after the last scan and are thus under some changed directory.
+
+		return result;
+	}
+
+	void DirJournal::MarkDirty (const QString& dir)
+	{
+		if (DirtyDirs_.contains (dir))
+			return;
+
+		DirtyDirs_ << dir;
+		AppendDirtyLog (dir);
+	}
+
+	void DirJournal::Record (const QHash<QString, qint64>& dirMTimes)
+	{
+		if (dirMTimes.isEmpty ())
+			return;
+
+		for (auto i = dirMTimes.begin (), end = dirMTimes.end (); i != end; ++i)
+		{
+			DirMTimes_ [i.key ()] = i.value ();
+			DirtyDirs_.remove (i.key ());
+		}
+
+		IsModified_ = true;
+	}
+
+	void DirJournal::Forget (const QString& root)
+	{
+		for (auto i = DirMTimes_.begin (); i != DirMTimes_.end (); )
+		{
+			if (IsUnder (i.key (), root))
+			{
+				i = DirMTimes_.erase (i);
+				IsModified_ = true;
+			}
+			else
+				++i;
+		}
+
+		for (auto i = DirtyDirs_.begin (); i != DirtyDirs_.end (); )
+		{
+			if (IsUnder (*i, root))
+			{
+				i = DirtyDirs_.erase (i);
+				IsModified_ = true;
+			}
+			else
+				++i;
+		}
+	}
+
+	QString DirJournal::GetDirtyLogPath () const
+	{
+		return Path_ + ".dirty";
+	}
+
+	void DirJournal::Load ()
+	{
+		QFile file { Path_ };
+		if (!file.open (QIODevice::ReadOnly))
+			return;
+
+		QDataStream istr { &file };
+
+		quint32 magic = 0;
+		quint32 version = 0;
+		qint32 count = 0;
+		istr >> magic >> version >> count;
+		if (magic != JournalMagic || version != JournalVersion || count < 0)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unknown journal format in"
+					<< file.fileName ();
+			return;
+		}
+
+		QHash<QString, qint64> dirMTimes;
+		dirMTimes.reserve (count);
+		for (qint32 i = 0; i < count; ++i)
+		{
+			QString dir;
+			qint64 mtime = 0;
+			istr >> dir >> mtime;
+			dirMTimes [dir] = mtime;
+		}
+
+		if (istr.status () != QDataStream::Ok)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "corrupted journal"
+					<< file.fileName ();
+			return;
+		}
+
+		DirMTimes_ = std::move (dirMTimes);
+	}
+
+	void DirJournal::LoadDirtyLog ()
+	{
+		QFile file { GetDirtyLogPath () };
+		if (!file.open (QIODevice::ReadOnly))
+			return;
+
+		QTextStream istr { &file };
+		istr.setCodec ("UTF-8");
+		QString dir;
+		while (istr.readLineInto (&dir))
+			if (!dir.isEmpty ())
+				DirtyDirs_ << dir;
+	}
+
+	void DirJournal::AppendDirtyLog (const QString& dir)
+	{
+		QFile file { GetDirtyLogPath () };
+		if (!file.open (QIODevice::WriteOnly | QIODevice::Append))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< file.fileName ()
+					<< file.errorString ();
+			return;
+		}
+
+		file.write (dir.toUtf8 () + '\n');
+	}
+}
@@ -0,0 +1,106 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+
+namespace LC::LMP
+{
+	/** @brief Persistent journal of the collection directories state.
+	 *
+	 * The journal records the modification time of each directory as of
+	 * the last completed scan, as well as the directories reported as
+	 * changed by the file system watcher since then (the dirty ones).
+	 *
+	 * This allows re-examining only the directories that have changed
+	 * since the last run instead of walking the whole collection: adding,
+	 * removing or renaming a file in a directory changes its modification
+	 * time, while the in-place changes noticed by the watcher are kept in
+	 * the dirty list until the corresponding directory is rescanned.
+	 *
+	 * The dirty directories are appended to a separate log file as soon
+	 * as they are reported, so they survive a crash, while the (much
+	 * larger) modification times table is only written by Save().
+	 */
+	class Q_DECL_EXPORT DirJournal
+	{
+		const QString Path_;
+
+		QHash<QString, qint64> DirMTimes_;
+		QSet<QString> DirtyDirs_;
+
+		bool IsModified_ = false;
+	public:
+		struct Snapshot
+		{
+			QHash<QString, qint64> DirMTimes_;
+			QSet<QString> DirtyDirs_;
+		};
+
+		struct Changes
+		{
+			QStringList ChangedDirs_;
+			QStringList RemovedDirs_;
+		};
+
+		/** Loads the journal from the file at \em path, if any.
+		 */
+		explicit DirJournal (const QString& path);
+
+		/** Saves the journal if it has been modified.
+		 */
+		~DirJournal ();
+
+		DirJournal (const DirJournal&) = delete;
+		DirJournal& operator= (const DirJournal&) = delete;
+
+		void Save ();
+
+		/** Returns whether the \em root has been recorded by a completed
+		 * scan, that is, whether it's possible to rely on the journal
+		 * instead of walking the \em root from scratch.
+		 */
+		bool IsKnown (const QString& root) const;
+
+		/** Returns the recorded state of the \em root and the directories
+		 * under it.
+		 */
+		Snapshot GetSnapshot (const QString& root) const;
+
+		/** Compares the \em snapshot with the current state of the file
+		 * system.
+		 *
+		 * This function only stats the directories in the snapshot and
+		 * doesn't touch the journal, so it's intended to be run in a
+		 * background thread.
+		 */
+		static Changes CollectChanges (const Snapshot& snapshot);
+
+		/** Marks the \em dir as changed and in need of a rescan.
+		 */
+		void MarkDirty (const QString& dir);
+
+		/** Records the directories visited by a completed scan, clearing
+		 * their dirty marks.
+		 */
+		void Record (const QHash<QString, qint64>& dirMTimes);
+
+		/** Forgets the \em root and the directories under it.
+		 */
+		void Forget (const QString& root);
+	private:
+		QString GetDirtyLogPath () const;
+
+		void Load ();
+		void LoadDirtyLog ();
+		void AppendDirtyLog (const QString&);
+	};
+}
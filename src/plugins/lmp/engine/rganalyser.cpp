@@ -9,6 +9,7 @@
 #include "rganalyser.h"
 #include <functional>
 #include <atomic>
+#include <memory>
 #include <QStringList>
 #include <QThread>
 #include <QMetaType>
@@ -18,6 +19,13 @@
 #include "../gstfix.h"
 #include "../xmlsettingsmanager.h"
 
+#ifdef Q_OS_LINUX
+#include <cstring>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace LC
 {
 namespace LMP
@@ -85,6 +93,86 @@ namespace LMP
 		}
 	}
 
+	namespace
+	{
+		/* A task pool running each streaming task in a thread of its own,
+		 * which exits as soon as the task is stopped. The default pool
+		 * reuses its threads for other pipelines (including the playback
+		 * one), so the idle priority set for the analysis would leak there,
+		 * and it can't be reliably restored without CAP_SYS_NICE.
+		 */
+		struct RgTaskPool
+		{
+			GstTaskPool Parent_;
+		};
+
+		struct RgTaskPoolClass
+		{
+			GstTaskPoolClass Parent_;
+		};
+
+		G_DEFINE_TYPE (RgTaskPool, rg_task_pool, GST_TYPE_TASK_POOL)
+
+		struct PooledTask
+		{
+			GstTaskPoolFunction Func_;
+			gpointer Data_;
+		};
+
+		gpointer RunPooledTask (gpointer data)
+		{
+			const std::unique_ptr<PooledTask> task { static_cast<PooledTask*> (data) };
+			task->Func_ (task->Data_);
+			return nullptr;
+		}
+
+		void rg_task_pool_init (RgTaskPool*)
+		{
+		}
+
+		void rg_task_pool_class_init (RgTaskPoolClass *klass)
+		{
+			const auto poolClass = GST_TASK_POOL_CLASS (klass);
+			poolClass->prepare = [] (GstTaskPool*, GError**) {};
+			poolClass->cleanup = [] (GstTaskPool*) {};
+			poolClass->push = [] (GstTaskPool*, GstTaskPoolFunction func, gpointer data, GError **error)
+			{
+				const auto task = new PooledTask { func, data };
+				const auto thread = g_thread_try_new ("lmp-rganalyser", &RunPooledTask, task, error);
+				if (!thread)
+					delete task;
+				return static_cast<gpointer> (thread);
+			};
+			poolClass->join = [] (GstTaskPool*, gpointer id)
+			{
+				g_thread_join (static_cast<GThread*> (id));
+			};
+		}
+
+		qint64 GetCurrentThreadId ()
+		{
+#ifdef Q_OS_LINUX
+			return syscall (SYS_gettid);
+#else
+			return 0;
+#endif
+		}
+
+		void SetThreadIdlePriority (qint64 tid)
+		{
+#ifdef Q_OS_LINUX
+			sched_param param {};
+			if (sched_setscheduler (static_cast<pid_t> (tid), SCHED_IDLE, &param))
+				qWarning () << Q_FUNC_INFO
+						<< "unable to change the priority of"
+						<< tid
+						<< std::strerror (errno);
+#else
+			Q_UNUSED (tid)
+#endif
+		}
+	}
+
 	RgAnalyser::RgAnalyser (const QStringList& paths, QObject *parent)
 	: QObject { parent }
 	, Paths_ { paths }
@@ -95,6 +183,7 @@ namespace LMP
 	, RGAnalysis_ { gst_element_factory_make ("rganalysis", nullptr) }
 	, Fakesink_ { gst_element_factory_make ("fakesink", nullptr) }
 	, PopThread_ { new LightPopThread { gst_pipeline_get_bus (GST_PIPELINE (Pipeline_)), this } }
+	, TaskPool_ { static_cast<GstTaskPool*> (gst_object_ref_sink (g_object_new (rg_task_pool_get_type (), nullptr))) }
 	{
 		qRegisterMetaType<GstMessage_ptr> ("GstMessage_ptr");
 
@@ -111,6 +200,17 @@ namespace LMP
 		g_object_set (GST_OBJECT (RGAnalysis_), "num-tracks", paths.size (), nullptr);
 		g_object_set (GST_OBJECT (Pipeline_), "audio-sink", SinkBin_, nullptr);
 
+		const auto bus = gst_pipeline_get_bus (GST_PIPELINE (Pipeline_));
+		gst_bus_set_sync_handler (bus,
+				[] (GstBus *bus, GstMessage *msg, gpointer udata)
+				{
+					return static_cast<GstBusSyncReply> (static_cast<RgAnalyser*> (udata)->
+								HandleSyncMessage (bus, msg));
+				},
+				this,
+				nullptr);
+		gst_object_unref (bus);
+
 		CheckFinish ();
 
 		PopThread_->start ();
@@ -124,6 +224,7 @@ namespace LMP
 		gst_element_set_state (Pipeline_, GST_STATE_NULL);
 
 		gst_object_unref (Pipeline_);
+		gst_object_unref (TaskPool_);
 	}
 
 	const AlbumRgResult& RgAnalyser::GetResult () const
@@ -131,6 +232,60 @@ namespace LMP
 		return Result_;
 	}
 
+	void RgAnalyser::SetIdlePriority (bool idle)
+	{
+		if (IsIdlePriority_.exchange (idle) == idle || !idle)
+			return;
+
+		// The threads that are already idle keep being so until the
+		// current track is analysed, and then they exit.
+		QMutexLocker locker { &StreamingThreadsMutex_ };
+		for (const auto tid : StreamingThreads_)
+			SetThreadIdlePriority (tid);
+	}
+
+	int RgAnalyser::HandleSyncMessage (GstBus*, GstMessage *msg)
+	{
+		if (GST_MESSAGE_TYPE (msg) != GST_MESSAGE_STREAM_STATUS)
+			return GST_BUS_PASS;
+
+		// The stream status messages are posted from the streaming threads
+		// themselves as they enter and leave their loops.
+		GstStreamStatusType type;
+		GstElement *owner = nullptr;
+		gst_message_parse_stream_status (msg, &type, &owner);
+
+		switch (type)
+		{
+		case GST_STREAM_STATUS_TYPE_CREATE:
+		{
+			const auto value = gst_message_get_stream_status_object (msg);
+			if (value && G_VALUE_TYPE (value) == GST_TYPE_TASK)
+				gst_task_set_pool (GST_TASK (g_value_get_object (value)), TaskPool_);
+			break;
+		}
+		case GST_STREAM_STATUS_TYPE_ENTER:
+		{
+			const auto tid = GetCurrentThreadId ();
+			QMutexLocker locker { &StreamingThreadsMutex_ };
+			StreamingThreads_ << tid;
+			if (IsIdlePriority_)
+				SetThreadIdlePriority (tid);
+			break;
+		}
+		case GST_STREAM_STATUS_TYPE_LEAVE:
+		{
+			QMutexLocker locker { &StreamingThreadsMutex_ };
+			StreamingThreads_.remove (GetCurrentThreadId ());
+			break;
+		}
+		default:
+			break;
+		}
+
+		return GST_BUS_PASS;
+	}
+
 	void RgAnalyser::CheckFinish ()
 	{
 		gst_element_set_state (Pipeline_, GST_STATE_NULL);
@@ -8,13 +8,18 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <QObject>
 #include <QMap>
+#include <QMutex>
+#include <QSet>
 #include <QStringList>
 
+typedef struct _GstBus GstBus;
 typedef struct _GstMessage GstMessage;
 typedef struct _GstElement GstElement;
+typedef struct _GstTaskPool GstTaskPool;
 typedef std::shared_ptr<GstMessage> GstMessage_ptr;
 
 namespace LC
@@ -57,15 +62,36 @@ namespace LMP
 
 		LightPopThread * const PopThread_;
 
+		GstTaskPool * const TaskPool_;
+
 		bool IsDraining_ = false;
+
+		std::atomic_bool IsIdlePriority_ { false };
+
+		QMutex StreamingThreadsMutex_;
+		QSet<qint64> StreamingThreads_;
 	public:
 		RgAnalyser (const QStringList&, QObject* = nullptr);
 		~RgAnalyser ();
 
 		const AlbumRgResult& GetResult () const;
+
+		/** Switches the GStreamer streaming threads of this analyser to
+		 * (or from) the idle scheduling priority, so that the analysis
+		 * only gets the CPU time nobody else needs.
+		 *
+		 * The streaming threads are dedicated to this analyser and live
+		 * for a single track, so switching back only takes effect for
+		 * the next track.
+		 *
+		 * This is only supported on Linux.
+		 */
+		void SetIdlePriority (bool);
 	private:
 		void CheckFinish ();
 
+		int HandleSyncMessage (GstBus*, GstMessage*);
+
 		void HandleTagMsg (GstMessage*);
 		void HandleErrorMsg (GstMessage*);
 		void HandleEosMsg (GstMessage*);
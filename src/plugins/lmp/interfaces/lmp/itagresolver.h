@@ -10,7 +10,7 @@
 
 #include <QtPlugin>
 
-class QMutex;
+class QReadWriteLock;
 
 namespace TagLib
 {
@@ -45,9 +45,14 @@ namespace LMP
 
 		virtual TagLib::FileRef GetFileRef (const QString&) const = 0;
 		virtual ResolveResult_t ResolveInfo (const QString&) = 0;
-		virtual QMutex& GetMutex () = 0;
+		/** Returns the lock guarding TagLib file accesses.
+		 *
+		 * Reading tags only requires the lock to be held for reading,
+		 * while writing them requires it to be held for writing.
+		 */
+		virtual QReadWriteLock& GetTagLibLock () = 0;
 	};
 }
 }
 
-Q_DECLARE_INTERFACE (LC::LMP::ITagResolver, "org.LeechCraft.LMP.ITagResolver/1.0")
+Q_DECLARE_INTERFACE (LC::LMP::ITagResolver, "org.LeechCraft.LMP.ITagResolver/2.0")
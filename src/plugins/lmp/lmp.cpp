@@ -255,6 +255,20 @@ namespace LMP
 		return XSD_;
 	}
 
+	namespace
+	{
+		QString GetEntityPath (const Entity& e)
+		{
+			QString path = e.Entity_.toString ();
+			const QUrl& url = e.Entity_.toUrl ();
+			if (path.isEmpty () &&
+					url.isValid () &&
+					url.scheme () == "file")
+				path = url.toLocalFile ();
+			return path;
+		}
+	}
+
 	EntityTestHandleResult Plugin::CouldHandle (const Entity& e) const
 	{
 		if (e.Mime_ == Mimes::PowerStateChanged)
@@ -274,12 +288,7 @@ namespace LMP
 			return EntityTestHandleResult { EntityTestHandleResult::PHigh };
 		}
 
-		QString path = e.Entity_.toString ();
-		const QUrl& url = e.Entity_.toUrl ();
-		if (path.isEmpty () &&
-				url.isValid () &&
-				url.scheme () == "file")
-			path = url.toLocalFile ();
+		const auto& path = GetEntityPath (e);
 
 		const auto& goodExt = XmlSettingsManager::Instance ()
 				.property ("TestExtensions").toString ()
@@ -340,6 +349,48 @@ namespace LMP
 			player->AddToOneShotQueue (url);
 	}
 
+	QList<EntityCapability> Plugin::GetEntityCapabilities () const
+	{
+		EntityCapability powerState;
+		powerState.Mimes_ = QStringList { Mimes::PowerStateChanged };
+		powerState.Priority_ = EntityTestHandleResult::PHigh;
+
+		EntityCapability filter;
+		filter.Mimes_ = QStringList { Mimes::DataFilterRequest };
+		filter.RequiredFields_ = QStringList { "DataFilter" };
+		filter.Priority_ = EntityTestHandleResult::PHigh;
+		filter.Predicate_ = [id = GetUniqueID ()] (const Entity& e)
+		{
+			return e.Additional_ ["DataFilter"].toString ().startsWith (id) &&
+					e.Entity_.type () == QVariant::String &&
+					e.Entity_.toString ().size () < 80;
+		};
+
+		const auto isMedia = [] (const Entity& e)
+		{
+			return e.Mime_ != Mimes::PowerStateChanged && e.Mime_ != Mimes::DataFilterRequest;
+		};
+
+		EntityCapability enqueue;
+		enqueue.RequiredFields_ = QStringList { "Action" };
+		enqueue.Priority_ = EntityTestHandleResult::PHigh;
+		enqueue.Predicate_ = [isMedia] (const Entity& e)
+		{
+			const auto& action = e.Additional_ ["Action"].toString ();
+			return isMedia (e) && (action == "AudioEnqueuePlay" || action == "AudioEnqueue");
+		};
+
+		// The files are checked against the extensions from the settings.
+		EntityCapability files;
+		files.NeedsQuery_ = true;
+		files.Predicate_ = [isMedia] (const Entity& e)
+		{
+			return isMedia (e) && !QFileInfo { GetEntityPath (e) }.suffix ().isEmpty ();
+		};
+
+		return { powerState, filter, enqueue, files };
+	}
+
 	QList<QAction*> Plugin::GetActions (ActionsEmbedPlace) const
 	{
 		return {};
@@ -13,6 +13,7 @@
 #include <interfaces/ihavetabs.h>
 #include <interfaces/ihavesettings.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/iactionsexporter.h>
 #include <interfaces/ihaverecoverabletabs.h>
 #include <interfaces/ipluginready.h>
@@ -33,6 +34,7 @@ namespace LMP
 				 , public IHaveTabs
 				 , public IHaveSettings
 				 , public IEntityHandler
+				 , public IHaveEntityCapabilities
 				 , public IActionsExporter
 				 , public IHaveRecoverableTabs
 				 , public IHaveShortcuts
@@ -46,6 +48,7 @@ namespace LMP
 				IHaveTabs
 				IHaveSettings
 				IEntityHandler
+				IHaveEntityCapabilities
 				IActionsExporter
 				IHaveRecoverableTabs
 				IHaveShortcuts
@@ -88,6 +91,8 @@ namespace LMP
 		EntityTestHandleResult CouldHandle (const Entity&) const override;
 		void Handle (Entity) override;
 
+		QList<EntityCapability> GetEntityCapabilities () const override;
+
 		QList<QAction*> GetActions (ActionsEmbedPlace area) const override;
 		QMap<QString, QList<QAction*>> GetMenuActions () const override;
 
@@ -9,9 +9,10 @@
 #include "localcollection.h"
 #include <functional>
 #include <algorithm>
+#include <utility>
+#include <QFileInfo>
 #include <QStandardItemModel>
 #include <QRandomGenerator>
-#include <QtConcurrentMap>
 #include <QtConcurrentRun>
 #include <QTimer>
 #include <QtDebug>
@@ -21,6 +22,7 @@
 #include <util/sll/unreachable.h>
 #include <util/xpc/util.h>
 #include <util/sll/prelude.h>
+#include <util/sys/paths.h>
 #include <util/threads/futures.h>
 #include "localcollectionstorage.h"
 #include "core.h"
@@ -32,6 +34,7 @@
 #include "localcollectionwatcher.h"
 #include "localcollectionmodel.h"
 #include "collectionnormalizer.h"
+#include "dirjournal.h"
 
 namespace LC::LMP
 {
@@ -39,19 +42,10 @@ namespace LC::LMP
 	: QObject (parent)
 	, Storage_ (new LocalCollectionStorage (this))
 	, CollectionModel_ (new LocalCollectionModel (Artists_, *Storage_, *this))
-	, FilesWatcher_ (new LocalCollectionWatcher (this))
+	, Journal_ (std::make_unique<DirJournal> (Util::CreateIfNotExists ("lmp").filePath ("dirjournal")))
+	, FilesWatcher_ (new LocalCollectionWatcher (*Journal_, this))
 	, AlbumArtMgr_ (new AlbumArtManager (*this, this)) // TODO it needn't be owned by the collection
-	, Watcher_ (new QFutureWatcher<MediaInfo> (this))
 	{
-		connect (Watcher_,
-				SIGNAL (finished ()),
-				this,
-				SLOT (handleScanFinished ()));
-		connect (Watcher_,
-				SIGNAL (progressValueChanged (int)),
-				this,
-				SIGNAL (scanProgressChanged (int)));
-
 		Util::Sequence (this, QtConcurrent::run ([] { return LocalCollectionStorage ().Load (); })) >>
 				[this] (const LocalCollectionStorage::LoadResult& result)
 				{
@@ -76,6 +70,8 @@ namespace LC::LMP
 				SLOT (saveRootPaths ()));
 	}
 
+	LocalCollection::~LocalCollection () = default;
+
 	bool LocalCollection::IsReady () const
 	{
 		return IsReady_;
@@ -98,6 +94,8 @@ namespace LC::LMP
 
 	void LocalCollection::Clear ()
 	{
+		StopScans ({});
+
 		Storage_->Clear ();
 
 		{
@@ -114,84 +112,12 @@ namespace LC::LMP
 		RemoveRootPaths (RootPaths_);
 	}
 
-	namespace
-	{
-		struct IterateResult
-		{
-			QSet<QString> UnchangedFiles_;
-			QSet<QString> ChangedFiles_;
-		};
-	}
-
 	void LocalCollection::Scan (const QString& path, bool root)
 	{
 		if (root)
 			AddRootPaths ({ path });
 
-		const auto datetimeTolerance = 1500;
-
-		const bool symLinks = XmlSettingsManager::Instance ()
-				.property ("FollowSymLinks").toBool ();
-		auto worker = [path, symLinks]
-		{
-			IterateResult result;
-
-			LocalCollectionStorage storage;
-
-			const auto& paths = storage.GetTracksPaths ();
-
-			const auto& allInfos = RecIterateInfo (path, symLinks);
-			for (const auto& info : allInfos)
-			{
-				const auto& trackPath = info.absoluteFilePath ();
-				const auto& mtime = info.lastModified ();
-				try
-				{
-					const auto& storedDt = storage.GetMTime (trackPath);
-					if (storedDt.isValid () &&
-							std::abs (storedDt.msecsTo (mtime)) < datetimeTolerance)
-					{
-						result.UnchangedFiles_ << trackPath;
-						continue;
-					}
-				}
-				catch (const std::exception& e)
-				{
-					qWarning () << Q_FUNC_INFO
-							<< "error getting mtime"
-							<< trackPath
-							<< e.what ();
-				}
-
-				if (paths.contains (trackPath))
-				{
-					try
-					{
-						storage.SetMTime (trackPath, mtime);
-					}
-					catch (const std::exception& e)
-					{
-						qWarning () << Q_FUNC_INFO
-								<< "error setting mtime"
-								<< trackPath
-								<< e.what ();
-					}
-				}
-				result.ChangedFiles_ << trackPath;
-			}
-
-			return result;
-		};
-		Util::Sequence (this, QtConcurrent::run (worker)) >>
-				[this, path] (const IterateResult& result)
-				{
-					CheckRemovedFiles (result.ChangedFiles_ + result.UnchangedFiles_, path);
-
-					if (Watcher_->isRunning ())
-						NewPathsQueue_ << result.ChangedFiles_;
-					else
-						InitiateScan (result.ChangedFiles_);
-				};
+		EnqueueScan ({ { path }, {} });
 	}
 
 	void LocalCollection::Unscan (const QString& path)
@@ -199,6 +125,8 @@ namespace LC::LMP
 		if (!RootPaths_.contains (path))
 			return;
 
+		StopScans (path);
+
 		QStringList toRemove;
 		for (const auto& subPath : Util::StlizeKeys (Path2Track_))
 			if (subPath.startsWith (path))
@@ -457,7 +385,20 @@ namespace LC::LMP
 					track.Number_ == info.TrackNumber_ &&
 					track.Name_ == info.Title_ &&
 					track.Genres_ == info.Genres_)
+			{
+				try
+				{
+					Storage_->SetMTime (path, QFileInfo { path }.lastModified ());
+				}
+				catch (const std::exception& e)
+				{
+					qWarning () << Q_FUNC_INFO
+							<< "error setting mtime"
+							<< path
+							<< e.what ();
+				}
 				continue;
+			}
 
 			const auto& stats = GetTrackStats (path);
 			RemoveTrack (path);
@@ -709,48 +650,159 @@ namespace LC::LMP
 		{
 			removed += RootPaths_.removeAll (str);
 			FilesWatcher_->RemovePath (str);
+			Journal_->Forget (str);
 		}
 
 		if (removed)
 			emit rootPathsChanged (RootPaths_);
 	}
 
-	void LocalCollection::CheckRemovedFiles (const QSet<QString>& scanned, const QString& rootPath)
+	namespace
 	{
-		QSet<QString> toRemove { Path2Track_.keyBegin (), Path2Track_.keyEnd () };
-		toRemove.subtract (scanned);
-
-		for (auto pos = toRemove.begin (); pos != toRemove.end (); )
+		bool IsUnder (const QString& path, const QString& dir)
 		{
-			if (pos->startsWith (rootPath))
-				++pos;
-			else
-				pos = toRemove.erase (pos);
+			return path.startsWith (dir) &&
+					(path.size () == dir.size () || path.at (dir.size ()) == '/');
 		}
+	}
+
+	void LocalCollection::CheckRemovedFiles (const QSet<QString>& scanned,
+			const QHash<QString, qint64>& scannedDirs, const ScanRequest& request)
+	{
+		// A full scan covers everything under the scanned paths, while an
+		// incremental one only covers the files directly in the visited
+		// directories.
+		const auto isCovered = [&] (const QString& path)
+		{
+			if (request.SkippedDirs_.isEmpty ())
+				return std::any_of (request.Paths_.begin (), request.Paths_.end (),
+						[&path] (const QString& root) { return path.startsWith (root); });
+
+			return scannedDirs.contains (path.left (path.lastIndexOf ('/')));
+		};
+
+		QStringList toRemove;
+		for (const auto& path : Util::StlizeKeys (Path2Track_))
+			if (!scanned.contains (path) && isCovered (path))
+				toRemove << path;
 
 		for (const auto& path : toRemove)
 			RemoveTrack (path);
 	}
 
-	void LocalCollection::InitiateScan (const QSet<QString>& newPaths)
+	void LocalCollection::RemoveTracksUnder (const QString& dir)
 	{
-		auto resolver = Core::Instance ().GetLocalFileResolver ();
+		QStringList toRemove;
+		for (const auto& path : Util::StlizeKeys (Path2Track_))
+			if (IsUnder (path, dir))
+				toRemove << path;
+
+		for (const auto& path : toRemove)
+			RemoveTrack (path);
+	}
 
-		emit scanStarted (newPaths.size ());
-		auto worker = [resolver] (const QString& path)
+	void LocalCollection::EnqueueScan (const ScanRequest& request)
+	{
+		if (!Scanner_)
 		{
-			return resolver->ResolveInfo (path).ToRight ([] (const ResolveError& error)
-					{
-						qWarning () << Q_FUNC_INFO
-								<< "error resolving media info for"
-								<< error.FilePath_
-								<< error.ReasonString_;
-						return MediaInfo {};
-					});
+			StartScan (request);
+			return;
+		}
+
+		const auto isSame = [&request] (const ScanRequest& other)
+		{
+			return other.Paths_ == request.Paths_ && other.SkippedDirs_ == request.SkippedDirs_;
 		};
-		const auto& future = QtConcurrent::mapped (newPaths,
-				std::function<MediaInfo (QString)> (worker));
-		Watcher_->setFuture (future);
+		if (std::none_of (PendingScans_.begin (), PendingScans_.end (), isSame))
+			PendingScans_ << request;
+	}
+
+	void LocalCollection::StartScan (const ScanRequest& request)
+	{
+		const bool symLinks = XmlSettingsManager::Instance ()
+				.property ("FollowSymLinks").toBool ();
+
+		CurrentScan_ = request;
+		CurrentScanDirs_.clear ();
+
+		Scanner_ = new LocalCollectionScanner
+		{
+			request.Paths_,
+			request.SkippedDirs_,
+			symLinks,
+			Core::Instance ().GetLocalFileResolver (),
+			this
+		};
+		connect (Scanner_,
+				&LocalCollectionScanner::gotInfos,
+				this,
+				&LocalCollection::HandleScannedInfos);
+		connect (Scanner_,
+				&LocalCollectionScanner::walkFinished,
+				this,
+				[this] (const QSet<QString>& files, const QHash<QString, qint64>& dirs)
+				{
+					CheckRemovedFiles (files, dirs, CurrentScan_);
+					CurrentScanDirs_ = dirs;
+				});
+		connect (Scanner_,
+				&LocalCollectionScanner::progressChanged,
+				this,
+				&LocalCollection::scanProgressChanged);
+		connect (Scanner_,
+				&LocalCollectionScanner::finished,
+				this,
+				&LocalCollection::HandleScanFinished);
+		Scanner_->Start ();
+	}
+
+	void LocalCollection::StopScans (const QString& under)
+	{
+		const auto isUnder = [&under] (const ScanRequest& request)
+		{
+			return std::any_of (request.Paths_.begin (), request.Paths_.end (),
+					[&under] (const QString& path) { return path.startsWith (under); });
+		};
+
+		PendingScans_.erase (std::remove_if (PendingScans_.begin (), PendingScans_.end (), isUnder),
+				PendingScans_.end ());
+
+		if (!Scanner_ || !isUnder (CurrentScan_))
+			return;
+
+		Scanner_->Stop ();
+		Scanner_->deleteLater ();
+		Scanner_ = nullptr;
+
+		emit scanFinished ();
+
+		if (!PendingScans_.isEmpty ())
+			StartScan (PendingScans_.takeFirst ());
+	}
+
+	void LocalCollection::HandleScannedInfos (const QList<MediaInfo>& infos)
+	{
+		QList<MediaInfo> newInfos;
+		QList<MediaInfo> existingInfos;
+		for (const auto& info : infos)
+		{
+			if (Path2Track_.contains (info.LocalPath_))
+				existingInfos << info;
+			else
+				newInfos << info;
+		}
+
+		try
+		{
+			HandleNewArtists (Storage_->AddToCollection (newInfos));
+			HandleExistingInfos (existingInfos);
+		}
+		catch (const std::exception& e)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "error storing scanned files"
+					<< e.what ();
+		}
 	}
 
 	void LocalCollection::RecordPlayedTrack (const QString& path)
@@ -782,34 +834,84 @@ namespace LC::LMP
 
 	void LocalCollection::RescanOnLoad ()
 	{
+		QList<std::pair<QString, DirJournal::Snapshot>> snapshots;
 		for (const auto& rootPath : RootPaths_)
-			Scan (rootPath, true);
+		{
+			if (Journal_->IsKnown (rootPath))
+				snapshots.push_back ({ rootPath, Journal_->GetSnapshot (rootPath) });
+			else
+				Scan (rootPath, true);
+		}
+
+		if (snapshots.isEmpty ())
+			return;
+
+		auto worker = [snapshots]
+		{
+			return Util::Map (snapshots,
+					[] (const auto& pair) { return DirJournal::CollectChanges (pair.second); });
+		};
+		Util::Sequence (this, QtConcurrent::run (worker)) >>
+				[this, snapshots] (const QList<DirJournal::Changes>& allChanges)
+				{
+					for (int i = 0; i < snapshots.size (); ++i)
+					{
+						const auto& [rootPath, snapshot] = snapshots.at (i);
+						const auto& changes = allChanges.at (i);
+						if (!RootPaths_.contains (rootPath))
+							continue;
+
+						for (const auto& dir : changes.RemovedDirs_)
+						{
+							try
+							{
+								RemoveTracksUnder (dir);
+							}
+							catch (const std::exception& e)
+							{
+								qWarning () << Q_FUNC_INFO
+										<< "error removing tracks under"
+										<< dir
+										<< e.what ();
+								continue;
+							}
+							Journal_->Forget (dir);
+						}
+
+						if (!changes.ChangedDirs_.isEmpty ())
+							EnqueueScan ({
+									changes.ChangedDirs_,
+									{ snapshot.DirMTimes_.keyBegin (), snapshot.DirMTimes_.keyEnd () }
+								});
+					}
+
+					Journal_->Save ();
+
+					// Nothing has changed since the last run, but the listeners
+					// might still be interested in the collection being checked.
+					if (!Scanner_)
+						emit scanFinished ();
+				};
 	}
 
-	void LocalCollection::handleScanFinished ()
+	void LocalCollection::HandleScanFinished ()
 	{
-		auto future = Watcher_->future ();
-		QList<MediaInfo> newInfos;
-		QList<MediaInfo> existingInfos;
-		for (const auto& info : future)
-		{
-			const auto& path = info.LocalPath_;
-			if (path.isEmpty ())
-				continue;
+		Scanner_->deleteLater ();
+		Scanner_ = nullptr;
 
-			if (Path2Track_.contains (path))
-				existingInfos << info;
-			else
-				newInfos << info;
-		}
+		// Only now everything the scan has found is stored, so only now
+		// the journal can consider these directories up to date.
+		if (CurrentScan_.SkippedDirs_.isEmpty ())
+			for (const auto& path : CurrentScan_.Paths_)
+				if (CurrentScanDirs_.contains (path))
+					Journal_->Forget (path);
+		Journal_->Record (std::exchange (CurrentScanDirs_, {}));
+		Journal_->Save ();
 
 		emit scanFinished ();
 
-		auto newArts = Storage_->AddToCollection (newInfos);
-		HandleNewArtists (newArts);
-
-		if (!NewPathsQueue_.isEmpty ())
-			InitiateScan (NewPathsQueue_.takeFirst ());
+		if (!PendingScans_.isEmpty ())
+			StartScan (PendingScans_.takeFirst ());
 		else if (UpdateNewTracks_)
 		{
 			const auto& artistsMsg = tr ("%n new artist(s)", nullptr, UpdateNewArtists_);
@@ -823,8 +925,6 @@ namespace LC::LMP
 
 			UpdateNewArtists_ = UpdateNewAlbums_ = UpdateNewTracks_ = 0;
 		}
-
-		HandleExistingInfos (existingInfos);
 	}
 
 	void LocalCollection::saveRootPaths ()
@@ -8,16 +8,17 @@
 
 #pragma once
 
+#include <memory>
 #include <optional>
 #include <QObject>
 #include <QHash>
 #include <QSet>
-#include <QFutureWatcher>
 #include <QIcon>
 #include "interfaces/lmp/collectiontypes.h"
 #include "interfaces/lmp/ilocalcollection.h"
 #include "mediainfo.h"
 #include "localcollectionmodel.h"
+#include "localcollectionscanner.h"
 
 class QModelIndex;
 class QSortFilterProxyModel;
@@ -25,6 +26,7 @@ class QSortFilterProxyModel;
 namespace LC::LMP
 {
 	class AlbumArtManager;
+	class DirJournal;
 	class LocalCollectionStorage;
 	class LocalCollectionWatcher;
 	class Player;
@@ -41,6 +43,7 @@ namespace LC::LMP
 
 		LocalCollectionStorage * const Storage_;
 		LocalCollectionModel * const CollectionModel_;
+		const std::unique_ptr<DirJournal> Journal_;
 		LocalCollectionWatcher * const FilesWatcher_;
 
 		AlbumArtManager * const AlbumArtMgr_;
@@ -53,8 +56,19 @@ namespace LC::LMP
 		QHash<int, Collection::Album_ptr> AlbumID2Album_;
 		QHash<int, int> AlbumID2ArtistID_;
 
-		QFutureWatcher<MediaInfo> *Watcher_;
-		QList<QSet<QString>> NewPathsQueue_;
+		struct ScanRequest
+		{
+			QStringList Paths_;
+
+			// Empty for full scans, the already known directories for
+			// incremental ones.
+			QSet<QString> SkippedDirs_;
+		};
+
+		LocalCollectionScanner *Scanner_ = nullptr;
+		ScanRequest CurrentScan_;
+		QHash<QString, qint64> CurrentScanDirs_;
+		QList<ScanRequest> PendingScans_;
 
 		int UpdateNewArtists_ = 0;
 		int UpdateNewAlbums_ = 0;
@@ -81,6 +95,7 @@ namespace LC::LMP
 		};
 
 		explicit LocalCollection (QObject* = nullptr);
+		~LocalCollection () override;
 
 		bool IsReady () const;
 
@@ -132,16 +147,20 @@ namespace LC::LMP
 		void AddRootPaths (QStringList);
 		void RemoveRootPaths (const QStringList&);
 
-		void CheckRemovedFiles (const QSet<QString>& scanned, const QString& root);
+		void CheckRemovedFiles (const QSet<QString>& scanned,
+				const QHash<QString, qint64>& scannedDirs, const ScanRequest&);
+		void RemoveTracksUnder (const QString&);
 
-		void InitiateScan (const QSet<QString>&);
+		void EnqueueScan (const ScanRequest&);
+		void StartScan (const ScanRequest&);
+		void StopScans (const QString& under);
+		void HandleScannedInfos (const QList<MediaInfo>&);
+		void HandleScanFinished ();
 		void RescanOnLoad ();
 	private slots:
-		void handleScanFinished ();
 		void saveRootPaths ();
 	signals:
-		void scanStarted (int);
-		void scanProgressChanged (int);
+		void scanProgressChanged (const LocalCollectionScanner::Progress&);
 		void scanFinished ();
 
 		void collectionReady ();
@@ -0,0 +1,226 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "localcollectionscanner.h"
+#include <cstdlib>
+#include <QThread>
+#include <QTimer>
+#include <QtDebug>
+#include <util/sll/either.h>
+#include "localcollectionstorage.h"
+#include "localfileresolver.h"
+#include "util.h"
+
+namespace LC::LMP
+{
+	namespace
+	{
+		const int QueueCapacity = 512;
+
+		// Each batch is stored in a single transaction, so the larger
+		// the batch, the faster the scan, but the longer the GUI thread
+		// is busy storing it.
+		const int BatchSize = 250;
+		const int FlushInterval = 100;
+
+		const int DateTimeTolerance = 1500;
+	}
+
+	LocalCollectionScanner::LocalCollectionScanner (const QStringList& paths, const QSet<QString>& skippedDirs,
+			bool followSymlinks, LocalFileResolver *resolver, QObject *parent)
+	: QObject { parent }
+	, Paths_ { paths }
+	, SkippedDirs_ { skippedDirs }
+	, FollowSymlinks_ { followSymlinks }
+	, Resolver_ { resolver }
+	, ChangedPaths_ { QueueCapacity }
+	, Infos_ { QueueCapacity }
+	, FlushTimer_ { new QTimer { this } }
+	{
+		FlushTimer_->setInterval (FlushInterval);
+		connect (FlushTimer_,
+				&QTimer::timeout,
+				this,
+				&LocalCollectionScanner::Flush);
+	}
+
+	LocalCollectionScanner::~LocalCollectionScanner ()
+	{
+		Stop ();
+		Pool_.waitForDone ();
+	}
+
+	const QStringList& LocalCollectionScanner::GetPaths () const
+	{
+		return Paths_;
+	}
+
+	auto LocalCollectionScanner::GetProgress () const -> Progress
+	{
+		return
+		{
+			.Found_ = FoundCount_.load (std::memory_order_relaxed),
+			.Changed_ = ChangedCount_.load (std::memory_order_relaxed),
+			.Read_ = ReadCount_.load (std::memory_order_relaxed),
+			.Delivered_ = DeliveredCount_,
+			.IsWalkFinished_ = IsWalkReported_
+		};
+	}
+
+	void LocalCollectionScanner::Start ()
+	{
+		const auto readersCount = std::max (QThread::idealThreadCount (), 1);
+		Pool_.setMaxThreadCount (readersCount + 1);
+
+		ActiveReaders_ = readersCount;
+
+		Pool_.start ([this] { Walk (); });
+		for (int i = 0; i < readersCount; ++i)
+			Pool_.start ([this] { Read (); });
+
+		FlushTimer_->start ();
+	}
+
+	void LocalCollectionScanner::Stop ()
+	{
+		IsStopped_ = true;
+		FlushTimer_->stop ();
+
+		ChangedPaths_.Cancel ();
+		Infos_.Cancel ();
+	}
+
+	void LocalCollectionScanner::Walk ()
+	{
+		const auto handleDir = [this] (const QFileInfo& info)
+		{
+			const auto& dir = info.absoluteFilePath ();
+			if (SkippedDirs_.contains (dir))
+				return false;
+
+			// The modification time is taken before listing the directory,
+			// so that the changes done meanwhile are caught by the next scan.
+			VisitedDirs_ [dir] = info.lastModified ().toMSecsSinceEpoch ();
+			return true;
+		};
+
+		try
+		{
+			LocalCollectionStorage storage;
+
+			const auto handleFile = [&] (const QFileInfo& info)
+			{
+				if (IsStopped_.load (std::memory_order_relaxed))
+					return false;
+
+				const auto& trackPath = info.absoluteFilePath ();
+				FoundPaths_ << trackPath;
+				FoundCount_.fetch_add (1, std::memory_order_relaxed);
+
+				try
+				{
+					const auto& storedDt = storage.GetMTime (trackPath);
+					if (storedDt.isValid () &&
+							std::abs (storedDt.msecsTo (info.lastModified ())) < DateTimeTolerance)
+						return true;
+				}
+				catch (const std::exception& e)
+				{
+					qWarning () << Q_FUNC_INFO
+							<< "error getting mtime"
+							<< trackPath
+							<< e.what ();
+				}
+
+				ChangedCount_.fetch_add (1, std::memory_order_relaxed);
+				return ChangedPaths_.Push (trackPath);
+			};
+
+			for (const auto& path : Paths_)
+			{
+				if (const QFileInfo pathInfo { path }; pathInfo.isDir ())
+					VisitedDirs_ [pathInfo.absoluteFilePath ()] = pathInfo.lastModified ().toMSecsSinceEpoch ();
+
+				if (!IterateMediaFiles (path, FollowSymlinks_, handleFile, handleDir))
+					break;
+			}
+		}
+		catch (const std::exception& e)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "error scanning"
+					<< Paths_
+					<< e.what ();
+			ChangedPaths_.Close ();
+			return;
+		}
+
+		IsWalkFinished_.store (!IsStopped_, std::memory_order_release);
+		ChangedPaths_.Close ();
+	}
+
+	void LocalCollectionScanner::Read ()
+	{
+		while (const auto path = ChangedPaths_.Pop ())
+		{
+			auto info = Resolver_->ResolveInfo (*path).ToRight ([] (const ResolveError& error)
+					{
+						qWarning () << Q_FUNC_INFO
+								<< "error resolving media info for"
+								<< error.FilePath_
+								<< error.ReasonString_;
+						return MediaInfo {};
+					});
+			ReadCount_.fetch_add (1, std::memory_order_relaxed);
+
+			if (info.LocalPath_.isEmpty ())
+				continue;
+
+			if (!Infos_.Push (std::move (info)))
+				break;
+		}
+
+		if (ActiveReaders_.fetch_sub (1) == 1)
+			Infos_.Close ();
+	}
+
+	void LocalCollectionScanner::Flush ()
+	{
+		if (IsStopped_)
+			return;
+
+		const auto& infos = Infos_.TryPopMany (BatchSize);
+		DeliveredCount_ += infos.size ();
+		if (!infos.isEmpty ())
+			emit gotInfos (infos);
+
+		// The receivers might have stopped us.
+		if (IsStopped_)
+			return;
+
+		// The walk finishes before the readers drain, so this has to be
+		// checked before the walk state to not miss the latter.
+		const bool isDrained = Infos_.IsDrained ();
+
+		if (!IsWalkReported_ && IsWalkFinished_.load (std::memory_order_acquire))
+		{
+			IsWalkReported_ = true;
+			emit walkFinished (FoundPaths_, VisitedDirs_);
+			FoundPaths_.clear ();
+			VisitedDirs_.clear ();
+		}
+
+		emit progressChanged (GetProgress ());
+
+		if (isDrained)
+		{
+			FlushTimer_->stop ();
+			emit finished ();
+		}
+	}
+}
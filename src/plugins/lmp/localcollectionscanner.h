@@ -0,0 +1,126 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QThreadPool>
+#include <util/threads/boundedqueue.h>
+#include "mediainfo.h"
+
+class QTimer;
+
+namespace LC::LMP
+{
+	class LocalFileResolver;
+
+	/** @brief Scans directories for new or changed media files.
+	 *
+	 * The scan is a pipeline of stages running concurrently:
+	 * - a single thread walks the directory tree and compares the
+	 *   modification times of the files with the ones recorded in the
+	 *   collection, passing the changed files further,
+	 * - a pool of threads reads the tags of the changed files,
+	 * - the resulting infos are delivered in batches in the thread the
+	 *   scanner lives in via the gotInfos() signal.
+	 *
+	 * The stages are connected by bounded queues, so the faster stages
+	 * wait for the slower ones instead of accumulating the whole
+	 * directory in memory.
+	 *
+	 * The scanner doesn't record anything by itself, so a file is
+	 * considered unchanged only after the receiver of gotInfos() has
+	 * stored it into the collection. Thus a scan interrupted at any
+	 * point is resumed by the next one.
+	 *
+	 * The scanner descends into all the subdirectories of the scanned
+	 * directories except the skipped ones, which allows rescanning just
+	 * the changed directories of an already known tree, along with the
+	 * subdirectories that have appeared in them.
+	 */
+	class LocalCollectionScanner : public QObject
+	{
+		Q_OBJECT
+	public:
+		struct Progress
+		{
+			int Found_ = 0;
+			int Changed_ = 0;
+			int Read_ = 0;
+			int Delivered_ = 0;
+
+			bool IsWalkFinished_ = false;
+		};
+	private:
+		const QStringList Paths_;
+		const QSet<QString> SkippedDirs_;
+		const bool FollowSymlinks_;
+		LocalFileResolver * const Resolver_;
+
+		Util::BoundedQueue<QString> ChangedPaths_;
+		Util::BoundedQueue<MediaInfo> Infos_;
+
+		std::atomic<bool> IsStopped_ { false };
+		std::atomic<bool> IsWalkFinished_ { false };
+		std::atomic<int> ActiveReaders_ { 0 };
+
+		std::atomic<int> FoundCount_ { 0 };
+		std::atomic<int> ChangedCount_ { 0 };
+		std::atomic<int> ReadCount_ { 0 };
+		int DeliveredCount_ = 0;
+
+		// Only touched by the walker thread until IsWalkFinished_ is set.
+		QSet<QString> FoundPaths_;
+		QHash<QString, qint64> VisitedDirs_;
+		bool IsWalkReported_ = false;
+
+		QTimer * const FlushTimer_;
+		QThreadPool Pool_;
+	public:
+		LocalCollectionScanner (const QStringList& paths, const QSet<QString>& skippedDirs,
+				bool followSymlinks, LocalFileResolver*, QObject* = nullptr);
+
+		/** Stops the scan and waits for the worker threads to finish.
+		 */
+		~LocalCollectionScanner () override;
+
+		const QStringList& GetPaths () const;
+		Progress GetProgress () const;
+
+		void Start ();
+
+		/** Stops the scan as soon as possible, dropping the files that
+		 * have been read but not delivered yet. No signals are emitted
+		 * after this.
+		 */
+		void Stop ();
+	private:
+		void Walk ();
+		void Read ();
+
+		void Flush ();
+	signals:
+		/** Emitted for each batch of read files.
+		 */
+		void gotInfos (const QList<MediaInfo>&);
+
+		/** Emitted once the directories have been walked with all the
+		 * media files found in them, changed or not, and the modification
+		 * times of the visited directories.
+		 */
+		void walkFinished (const QSet<QString>& files, const QHash<QString, qint64>& dirs);
+
+		void progressChanged (const LocalCollectionScanner::Progress&);
+
+		void finished ();
+	};
+}
@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <QTimer>
 #include "core.h"
+#include "dirjournal.h"
 #include "localcollection.h"
 #include "recursivedirwatcher.h"
 
@@ -17,8 +18,9 @@ namespace LC
 {
 namespace LMP
 {
-	LocalCollectionWatcher::LocalCollectionWatcher (QObject *parent)
+	LocalCollectionWatcher::LocalCollectionWatcher (DirJournal& journal, QObject *parent)
 	: QObject (parent)
+	, Journal_ (journal)
 	, Watcher_ (new RecursiveDirWatcher (this))
 	, ScanTimer_ (new QTimer (this))
 	{
@@ -63,6 +65,9 @@ namespace LMP
 
 	void LocalCollectionWatcher::handleDirectoryChanged (const QString& path)
 	{
+		// If we are closed before the rescan, the next start will still
+		// know this directory needs to be rescanned.
+		Journal_.MarkDirty (path);
 		ScheduleDir (path);
 	}
 
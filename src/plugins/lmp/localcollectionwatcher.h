@@ -20,18 +20,20 @@ namespace LC
 {
 namespace LMP
 {
+	class DirJournal;
 	class RecursiveDirWatcher;
 
 	class LocalCollectionWatcher : public QObject
 	{
 		Q_OBJECT
 
+		DirJournal& Journal_;
 		RecursiveDirWatcher * const Watcher_;
 
 		QList<QString> ScheduledDirs_;
 		QTimer * const ScanTimer_;
 	public:
-		LocalCollectionWatcher (QObject* = nullptr);
+		LocalCollectionWatcher (DirJournal&, QObject* = nullptr);
 
 		void AddPath (const QString&);
 		void RemovePath (const QString&);
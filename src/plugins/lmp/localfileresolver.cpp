@@ -43,7 +43,7 @@ namespace LMP
 			}
 		}
 
-		QMutexLocker tlLocker (&TaglibMutex_);
+		QReadLocker tlLocker (&TaglibLock_);
 
 		auto r = GetFileRef (file);
 		auto tag = r.tag ();
@@ -83,9 +83,9 @@ namespace LMP
 		return ResolveResult_t::Right (info);
 	}
 
-	QMutex& LocalFileResolver::GetMutex ()
+	QReadWriteLock& LocalFileResolver::GetTagLibLock ()
 	{
-		return TaglibMutex_;
+		return TaglibLock_;
 	}
 
 	void LocalFileResolver::flushCache ()
@@ -12,7 +12,6 @@
 #include <QObject>
 #include <QHash>
 #include <QReadWriteLock>
-#include <QMutex>
 #include <QDateTime>
 #include <taglib/fileref.h>
 #include "interfaces/lmp/itagresolver.h"
@@ -28,7 +27,7 @@ namespace LMP
 		Q_OBJECT
 		Q_INTERFACES (LC::LMP::ITagResolver)
 
-		QMutex TaglibMutex_;
+		QReadWriteLock TaglibLock_;
 		QReadWriteLock CacheLock_;
 		QHash<QString, QPair<QDateTime, MediaInfo>> Cache_;
 	public:
@@ -36,7 +35,7 @@ namespace LMP
 
 		TagLib::FileRef GetFileRef (const QString&) const;
 		ResolveResult_t ResolveInfo (const QString&);
-		QMutex& GetMutex ();
+		QReadWriteLock& GetTagLibLock ();
 	private slots:
 		void flushCache ();
 	};
@@ -16,6 +16,7 @@
 #include <QtConcurrentRun>
 #include <QtDebug>
 #include <QSettings>
+#include <QWriteLocker>
 #include <taglib/fileref.h>
 #include <taglib/tag.h>
 #include <util/tags/tagscompletionmodel.h>
@@ -424,7 +425,7 @@ namespace LC::LMP::Graffiti
 		{
 			const auto& newInfo = pair.first;
 
-			QMutexLocker locker (&resolver->GetMutex ());
+			QWriteLocker locker (&resolver->GetTagLibLock ());
 			auto file = resolver->GetFileRef (newInfo.LocalPath_);
 			auto tag = file.tag ();
 
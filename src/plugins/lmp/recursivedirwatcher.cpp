@@ -8,8 +8,10 @@
 
 #include "recursivedirwatcher.h"
 
-#ifdef Q_OS_MAC
+#if defined (Q_OS_MAC)
 #include "recursivedirwatcher_mac.h"
+#elif defined (Q_OS_LINUX)
+#include "recursivedirwatcher_inotify.h"
 #else
 #include "recursivedirwatcher_generic.h"
 #endif
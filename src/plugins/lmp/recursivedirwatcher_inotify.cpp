@@ -0,0 +1,250 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "recursivedirwatcher_inotify.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <QDir>
+#include <QFile>
+#include <QSocketNotifier>
+#include <QtConcurrentRun>
+#include <QtDebug>
+#include <util/threads/futures.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace LC
+{
+namespace LMP
+{
+	/* The watches are added in a worker thread, which might still be
+	 * running when the watcher is destroyed, so the descriptor is only
+	 * closed once the worker is done with it.
+	 */
+	struct InotifyFd
+	{
+		const int Fd_ = inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+		std::atomic_bool IsClosing_ { false };
+
+		~InotifyFd ()
+		{
+			if (Fd_ >= 0)
+				close (Fd_);
+		}
+	};
+
+	namespace
+	{
+		// Directory-level events only: changes to the files are caught by
+		// IN_CLOSE_WRITE on their parent directory instead of the much more
+		// frequent IN_MODIFY.
+		const uint32_t WatchMask = IN_CREATE | IN_DELETE |
+				IN_MOVED_FROM | IN_MOVED_TO |
+				IN_CLOSE_WRITE |
+				IN_ONLYDIR | IN_DONT_FOLLOW;
+
+		InotifyWatches AddWatches (const std::shared_ptr<InotifyFd>& inotify, const QString& root)
+		{
+			InotifyWatches result;
+
+			const auto fd = inotify->Fd_;
+			QStringList queue { root };
+			while (!queue.isEmpty () && !inotify->IsClosing_)
+			{
+				const auto dir = queue.takeLast ();
+				const auto wd = inotify_add_watch (fd, QFile::encodeName (dir).constData (), WatchMask);
+				if (wd < 0)
+				{
+					if (errno == ENOSPC)
+					{
+						result.HitLimit_ = true;
+						break;
+					}
+
+					qWarning () << Q_FUNC_INFO
+							<< "unable to watch"
+							<< dir
+							<< std::strerror (errno);
+					continue;
+				}
+
+				result.Watches_.append ({ wd, dir });
+
+				for (const auto& subdir : QDir { dir }.entryList (QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks))
+					queue << dir + '/' + subdir;
+			}
+
+			return result;
+		}
+
+		bool IsUnder (const QString& path, const QString& dir)
+		{
+			return path.startsWith (dir) &&
+					(path.size () == dir.size () || path.at (dir.size ()) == '/');
+		}
+	}
+
+	RecursiveDirWatcherImpl::RecursiveDirWatcherImpl (QObject *parent)
+	: QObject { parent }
+	, Inotify_ { std::make_shared<InotifyFd> () }
+	, Fd_ { Inotify_->Fd_ }
+	{
+		if (Fd_ < 0)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to initialize inotify:"
+					<< std::strerror (errno);
+			return;
+		}
+
+		Notifier_ = new QSocketNotifier { Fd_, QSocketNotifier::Read, this };
+		connect (Notifier_,
+				&QSocketNotifier::activated,
+				this,
+				&RecursiveDirWatcherImpl::ReadEvents);
+	}
+
+	RecursiveDirWatcherImpl::~RecursiveDirWatcherImpl ()
+	{
+		if (Fd_ < 0)
+			return;
+
+		Notifier_->setEnabled (false);
+		Inotify_->IsClosing_ = true;
+	}
+
+	void RecursiveDirWatcherImpl::AddRoot (const QString& root)
+	{
+		if (Fd_ < 0 || Roots_.contains (root))
+			return;
+
+		Roots_ << root;
+		WatchTree (root);
+	}
+
+	void RecursiveDirWatcherImpl::RemoveRoot (const QString& root)
+	{
+		if (!Roots_.removeAll (root))
+			return;
+
+		UnwatchTree (root);
+	}
+
+	void RecursiveDirWatcherImpl::WatchTree (const QString& dir)
+	{
+		Util::Sequence (this, QtConcurrent::run (AddWatches, Inotify_, dir)) >>
+				[this] (const InotifyWatches& watches) { HandleWatches (watches); };
+	}
+
+	void RecursiveDirWatcherImpl::UnwatchTree (const QString& dir)
+	{
+		for (auto i = Dir2Wd_.begin (); i != Dir2Wd_.end (); )
+		{
+			if (!IsUnder (i.key (), dir))
+			{
+				++i;
+				continue;
+			}
+
+			inotify_rm_watch (Fd_, i.value ());
+			Wd2Dir_.remove (i.value ());
+			i = Dir2Wd_.erase (i);
+		}
+	}
+
+	void RecursiveDirWatcherImpl::HandleWatches (const InotifyWatches& watches)
+	{
+		for (const auto& [wd, dir] : watches.Watches_)
+		{
+			// The root might have been removed while we've been busy adding
+			// the watches.
+			const auto isWatched = std::any_of (Roots_.begin (), Roots_.end (),
+					[&dir] (const QString& root) { return IsUnder (dir, root); });
+			if (!isWatched)
+			{
+				inotify_rm_watch (Fd_, wd);
+				continue;
+			}
+
+			Wd2Dir_ [wd] = dir;
+			Dir2Wd_ [dir] = wd;
+		}
+
+		if (watches.HitLimit_ && !IsLimitReported_)
+		{
+			IsLimitReported_ = true;
+
+			QFile limitFile { "/proc/sys/fs/inotify/max_user_watches" };
+			const auto& limit = limitFile.open (QIODevice::ReadOnly) ?
+					limitFile.readAll ().trimmed () :
+					QByteArray {};
+			qWarning () << Q_FUNC_INFO
+					<< "inotify watches limit of"
+					<< limit
+					<< "is reached after"
+					<< Wd2Dir_.size ()
+					<< "directories; the changes in the rest of the collection will only be noticed on next start";
+		}
+	}
+
+	void RecursiveDirWatcherImpl::ReadEvents ()
+	{
+		alignas (inotify_event) char buffer [64 * 1024];
+
+		QStringList changedDirs;
+		while (true)
+		{
+			const auto length = read (Fd_, buffer, sizeof (buffer));
+			if (length <= 0)
+				break;
+
+			for (auto ptr = buffer; ptr < buffer + length; )
+			{
+				const auto event = reinterpret_cast<const inotify_event*> (ptr);
+				ptr += sizeof (inotify_event) + event->len;
+
+				if (event->mask & IN_Q_OVERFLOW)
+				{
+					qWarning () << Q_FUNC_INFO
+							<< "inotify queue overflow, rescanning all the roots";
+					changedDirs << Roots_;
+					continue;
+				}
+
+				const auto& dir = Wd2Dir_.value (event->wd);
+				if (dir.isEmpty ())
+					continue;
+
+				if (event->mask & IN_IGNORED)
+				{
+					Wd2Dir_.remove (event->wd);
+					Dir2Wd_.remove (dir);
+					continue;
+				}
+
+				if (event->mask & IN_ISDIR)
+				{
+					const auto& subdir = dir + '/' + QFile::decodeName (event->name);
+					if (event->mask & (IN_CREATE | IN_MOVED_TO))
+						WatchTree (subdir);
+					else if (event->mask & IN_MOVED_FROM)
+						UnwatchTree (subdir);
+				}
+
+				if (!changedDirs.contains (dir))
+					changedDirs << dir;
+			}
+		}
+
+		for (const auto& dir : changedDirs)
+			emit directoryChanged (dir);
+	}
+}
+}
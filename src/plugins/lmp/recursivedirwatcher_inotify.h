@@ -0,0 +1,59 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <QObject>
+#include <QHash>
+#include <QStringList>
+
+class QSocketNotifier;
+
+namespace LC
+{
+namespace LMP
+{
+	struct InotifyFd;
+
+	struct InotifyWatches
+	{
+		QList<QPair<int, QString>> Watches_;
+		bool HitLimit_ = false;
+	};
+
+	class RecursiveDirWatcherImpl : public QObject
+	{
+		Q_OBJECT
+
+		const std::shared_ptr<InotifyFd> Inotify_;
+		const int Fd_;
+		QSocketNotifier *Notifier_ = nullptr;
+
+		QStringList Roots_;
+		QHash<int, QString> Wd2Dir_;
+		QHash<QString, int> Dir2Wd_;
+
+		bool IsLimitReported_ = false;
+	public:
+		RecursiveDirWatcherImpl (QObject*);
+		~RecursiveDirWatcherImpl ();
+
+		void AddRoot (const QString&);
+		void RemoveRoot (const QString&);
+	private:
+		void WatchTree (const QString&);
+		void UnwatchTree (const QString&);
+		void HandleWatches (const InotifyWatches&);
+
+		void ReadEvents ();
+	signals:
+		void directoryChanged (const QString&);
+	};
+}
+}
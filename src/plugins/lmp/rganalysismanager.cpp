@@ -7,17 +7,21 @@
  **********************************************************************/
 
 #include "rganalysismanager.h"
+#include <algorithm>
+#include <QThread>
 #include "localcollection.h"
 #include "localcollectionstorage.h"
 #include "engine/rganalyser.h"
 #include "engine/rgfilter.h"
+#include "engine/sourceobject.h"
+#include "player.h"
 #include "xmlsettingsmanager.h"
 
 namespace LC
 {
 namespace LMP
 {
-	RgAnalysisManager::RgAnalysisManager (LocalCollection *coll, QObject *parent)
+	RgAnalysisManager::RgAnalysisManager (LocalCollection *coll, Player *player, QObject *parent)
 	: QObject { parent }
 	, Coll_ { coll }
 	{
@@ -26,8 +30,17 @@ namespace LMP
 				this,
 				SLOT (handleScanFinished ()));
 
+		const auto source = player->GetSourceObject ();
+		connect (source,
+				&SourceObject::stateChanged,
+				this,
+				[this] (SourceState state) { HandlePlayerState (state == SourceState::Playing); });
+		IsPlaying_ = source->GetState () == SourceState::Playing;
+
 		XmlSettingsManager::Instance ().RegisterObject ("AutobuildRG",
 				this, "handleScanFinished");
+		XmlSettingsManager::Instance ().RegisterObject ("RgAnalysersCount",
+				this, "rotateQueue");
 	}
 
 	namespace
@@ -38,10 +51,44 @@ namespace LMP
 		}
 	}
 
-	void RgAnalysisManager::handleAnalysed ()
+	int RgAnalysisManager::GetMaxAnalysers () const
+	{
+		if (IsPlaying_)
+			return 1;
+
+		const auto count = XmlSettingsManager::Instance ().property ("RgAnalysersCount").toInt ();
+		return count > 0 ?
+				count :
+				std::max (QThread::idealThreadCount (), 1);
+	}
+
+	void RgAnalysisManager::StartAnalyser (const Collection::Album_ptr& album)
 	{
-		const auto& result = CurrentAnalyser_->GetResult ();
+		QStringList paths;
+		for (const auto& track : album->Tracks_)
+			paths << track.FilePath_;
+
+		const auto analyser = new RgAnalyser { paths, this };
+		analyser->SetIdlePriority (IsPlaying_);
+		Analysers_ << analyser;
+
+		const auto albumId = album->ID_;
+		connect (analyser,
+				&RgAnalyser::finished,
+				this,
+				[this, analyser, albumId] { HandleAnalysed (analyser, albumId); },
+				Qt::QueuedConnection);
+	}
 
+	void RgAnalysisManager::HandleAnalysed (RgAnalyser *analyser, int albumId)
+	{
+		Analysers_.removeOne (analyser);
+		analyser->deleteLater ();
+		PendingAlbums_.remove (albumId);
+
+		const auto& result = analyser->GetResult ();
+
+		const auto storage = Coll_->GetStorage ();
 		for (const auto& track : result.Tracks_)
 		{
 			const auto id = Coll_->FindTrack (track.TrackPath_);
@@ -53,19 +100,44 @@ namespace LMP
 				continue;
 			}
 
-			Coll_->GetStorage ()->SetRgTrackInfo (id,
-					{
-						track.TrackGain_,
-						track.TrackPeak_,
-						result.AlbumGain_,
-						result.AlbumPeak_
-					});
+			try
+			{
+				storage->SetRgTrackInfo (id,
+						{
+							track.TrackGain_,
+							track.TrackPeak_,
+							result.AlbumGain_,
+							result.AlbumPeak_
+						});
+			}
+			catch (const std::exception& e)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to store ReplayGain data for"
+						<< track.TrackPath_
+						<< e.what ();
+			}
 		}
 
-		CurrentAnalyser_.reset ();
 		rotateQueue ();
 	}
 
+	void RgAnalysisManager::HandlePlayerState (bool isPlaying)
+	{
+		if (isPlaying == IsPlaying_)
+			return;
+
+		IsPlaying_ = isPlaying;
+
+		// The analysers exceeding the limit aren't killed: they just run
+		// with the idle priority until they finish.
+		for (const auto analyser : Analysers_)
+			analyser->SetIdlePriority (IsPlaying_);
+
+		if (!IsPlaying_)
+			rotateQueue ();
+	}
+
 	void RgAnalysisManager::rotateQueue ()
 	{
 		if (AlbumsQueue_.isEmpty ())
@@ -73,19 +145,24 @@ namespace LMP
 
 		if (!IsScanAllowed ())
 		{
+			for (const auto& album : AlbumsQueue_)
+				PendingAlbums_.remove (album->ID_);
 			AlbumsQueue_.clear ();
 			return;
 		}
 
-		QStringList paths;
-		for (const auto& track : AlbumsQueue_.takeFirst ()->Tracks_)
-			paths << track.FilePath_;
+		const auto maxAnalysers = GetMaxAnalysers ();
+		while (Analysers_.size () < maxAnalysers && !AlbumsQueue_.isEmpty ())
+		{
+			const auto& album = AlbumsQueue_.takeFirst ();
+			if (album->Tracks_.isEmpty ())
+			{
+				PendingAlbums_.remove (album->ID_);
+				continue;
+			}
 
-		CurrentAnalyser_ = std::make_shared<RgAnalyser> (paths);
-		connect (CurrentAnalyser_.get (),
-				SIGNAL (finished ()),
-				this,
-				SLOT (handleAnalysed ()));
+			StartAnalyser (album);
+		}
 	}
 
 	void RgAnalysisManager::handleScanFinished ()
@@ -94,16 +171,21 @@ namespace LMP
 		if (!IsScanAllowed ())
 			return;
 
-		const bool wasEmpty = AlbumsQueue_.isEmpty ();
-
 		for (auto albumId : Coll_->GetStorage ()->GetOutdatedRgAlbums ())
+		{
+			if (PendingAlbums_.contains (albumId))
+				continue;
+
 			if (const auto& album = Coll_->GetAlbum (albumId))
+			{
 				AlbumsQueue_ << album;
+				PendingAlbums_ << albumId;
+			}
+		}
 
 		qDebug () << AlbumsQueue_.size ()
 				<< "albums to rescan";
-		if (wasEmpty)
-			rotateQueue ();
+		rotateQueue ();
 	}
 }
 }
@@ -18,20 +18,37 @@ namespace LMP
 {
 	class RgAnalyser;
 	class LocalCollection;
+	class Player;
 
+	/** @brief Calculates the missing ReplayGain data for the collection.
+	 *
+	 * Several albums are analysed in parallel, up to the number of
+	 * analysers set by the user (one per CPU core by default). While
+	 * something is being played, the pool shrinks to a single analyser,
+	 * and the streaming threads of the running analysers are switched
+	 * to the idle scheduling priority, so that the analysis doesn't
+	 * cause any playback glitches.
+	 */
 	class RgAnalysisManager : public QObject
 	{
 		Q_OBJECT
 
 		LocalCollection * const Coll_;
 
-		std::shared_ptr<RgAnalyser> CurrentAnalyser_;
+		QList<RgAnalyser*> Analysers_;
 
 		QList<Collection::Album_ptr> AlbumsQueue_;
+		QSet<int> PendingAlbums_;
+
+		bool IsPlaying_ = false;
 	public:
-		RgAnalysisManager (LocalCollection *coll, QObject* = nullptr);
+		RgAnalysisManager (LocalCollection *coll, Player *player, QObject* = nullptr);
+	private:
+		int GetMaxAnalysers () const;
+		void StartAnalyser (const Collection::Album_ptr&);
+		void HandleAnalysed (RgAnalyser*, int albumId);
+		void HandlePlayerState (bool isPlaying);
 	private slots:
-		void handleAnalysed ();
 		void rotateQueue ();
 	public slots:
 		void handleScanFinished ();
@@ -12,6 +12,7 @@
 #include <QMap>
 #include <QDir>
 #include <QUuid>
+#include <QWriteLocker>
 #include <QtDebug>
 #include <taglib/tag.h>
 #include "transcodingparams.h"
@@ -131,7 +132,7 @@ namespace LMP
 		{
 			const auto resolver = Core::Instance ().GetLocalFileResolver ();
 
-			QMutexLocker locker (&resolver->GetMutex ());
+			QWriteLocker locker (&resolver->GetTagLibLock ());
 
 			auto fromRef = resolver->GetFileRef (from);
 			auto toRef = resolver->GetFileRef (to);
@@ -0,0 +1,114 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "dirjournalbench.h"
+#include <QtTest>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QTemporaryDir>
+#include <dirjournal.h>
+#include <util.h>
+
+namespace LC::LMP
+{
+	namespace
+	{
+		// 500k files in the usual artist/album/track layout.
+		constexpr int ArtistsCount = 2000;
+		constexpr int AlbumsPerArtist = 25;
+		constexpr int TracksPerAlbum = 10;
+	}
+
+	DirJournalBench::DirJournalBench () = default;
+	DirJournalBench::~DirJournalBench () = default;
+
+	void DirJournalBench::initTestCase ()
+	{
+		Dir_ = std::make_unique<QTemporaryDir> ();
+		QVERIFY (Dir_->isValid ());
+
+		const QDir root { Dir_->filePath ("music") };
+		for (int artist = 0; artist < ArtistsCount; ++artist)
+			for (int album = 0; album < AlbumsPerArtist; ++album)
+			{
+				const auto& albumPath = QStringLiteral ("artist%1/album%2").arg (artist).arg (album);
+				QVERIFY (root.mkpath (albumPath));
+
+				const QDir albumDir { root.filePath (albumPath) };
+				for (int track = 0; track < TracksPerAlbum; ++track)
+				{
+					QFile file { albumDir.filePath (QStringLiteral ("%1.mp3").arg (track)) };
+					QVERIFY (file.open (QIODevice::WriteOnly));
+				}
+			}
+
+		QHash<QString, qint64> mtimes;
+		mtimes [GetRoot ()] = QFileInfo { GetRoot () }.lastModified ().toMSecsSinceEpoch ();
+		QDirIterator it { GetRoot (), QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories };
+		while (it.hasNext ())
+		{
+			it.next ();
+			mtimes [it.filePath ()] = it.fileInfo ().lastModified ().toMSecsSinceEpoch ();
+		}
+
+		DirJournal journal { GetJournalPath () };
+		journal.Record (mtimes);
+	}
+
+	void DirJournalBench::benchFullWalk ()
+	{
+		// This is what each start used to do before looking up the files
+		// in the collection database.
+		int count = 0;
+		QBENCHMARK_ONCE
+		{
+			count = 0;
+			IterateMediaFiles (GetRoot (), false,
+					[&count] (const QFileInfo& info)
+					{
+						count += info.lastModified ().isValid ();
+						return true;
+					});
+		}
+		QCOMPARE (count, ArtistsCount * AlbumsPerArtist * TracksPerAlbum);
+	}
+
+	void DirJournalBench::benchJournalLoad ()
+	{
+		QBENCHMARK
+		{
+			DirJournal journal { GetJournalPath () };
+			QVERIFY (journal.IsKnown (GetRoot ()));
+		}
+	}
+
+	void DirJournalBench::benchJournalCheck ()
+	{
+		const auto& snapshot = DirJournal { GetJournalPath () }.GetSnapshot (GetRoot ());
+		QCOMPARE (snapshot.DirMTimes_.size (), 1 + ArtistsCount * (1 + AlbumsPerArtist));
+
+		DirJournal::Changes changes;
+		QBENCHMARK_ONCE
+		{
+			changes = DirJournal::CollectChanges (snapshot);
+		}
+		QVERIFY (changes.ChangedDirs_.isEmpty ());
+		QVERIFY (changes.RemovedDirs_.isEmpty ());
+	}
+
+	QString DirJournalBench::GetRoot () const
+	{
+		return Dir_->filePath ("music");
+	}
+
+	QString DirJournalBench::GetJournalPath () const
+	{
+		return Dir_->filePath ("journal");
+	}
+}
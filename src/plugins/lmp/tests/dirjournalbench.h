@@ -0,0 +1,38 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <QObject>
+
+class QTemporaryDir;
+
+namespace LC::LMP
+{
+	class Q_DECL_EXPORT DirJournalBench : public QObject
+	{
+		Q_OBJECT
+
+		std::unique_ptr<QTemporaryDir> Dir_;
+	public:
+		DirJournalBench ();
+		~DirJournalBench () override;
+	private slots:
+		void initTestCase ();
+
+		void benchFullWalk ();
+		void benchJournalLoad ();
+		void benchJournalCheck ();
+	private:
+		QString GetRoot () const;
+		QString GetJournalPath () const;
+	};
+}
+
+using TheTestObject = LC::LMP::DirJournalBench;
@@ -0,0 +1,187 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "dirjournaltest.h"
+#include <QtTest>
+#include <QDateTime>
+#include <QDir>
+#include <QTemporaryDir>
+#include <dirjournal.h>
+
+namespace LC::LMP
+{
+	namespace
+	{
+		qint64 GetMTime (const QString& dir)
+		{
+			return QFileInfo { dir }.lastModified ().toMSecsSinceEpoch ();
+		}
+
+		struct Tree
+		{
+			QTemporaryDir Dir_;
+
+			QString Root_;
+			QString Artist_;
+			QString Album1_;
+			QString Album2_;
+
+			Tree ()
+			{
+				QDir root { Dir_.path () };
+				root.mkpath ("music/artist/album1");
+				root.mkpath ("music/artist/album2");
+
+				Root_ = root.filePath ("music");
+				Artist_ = root.filePath ("music/artist");
+				Album1_ = root.filePath ("music/artist/album1");
+				Album2_ = root.filePath ("music/artist/album2");
+			}
+
+			QString GetJournalPath () const
+			{
+				return QDir { Dir_.path () }.filePath ("journal");
+			}
+
+			QHash<QString, qint64> GetMTimes () const
+			{
+				QHash<QString, qint64> result;
+				for (const auto& dir : { Root_, Artist_, Album1_, Album2_ })
+					result [dir] = GetMTime (dir);
+				return result;
+			}
+		};
+
+		QStringList Sorted (QStringList list)
+		{
+			list.sort ();
+			return list;
+		}
+	}
+
+	void DirJournalTest::testUnknown ()
+	{
+		Tree tree;
+		DirJournal journal { tree.GetJournalPath () };
+
+		QVERIFY (!journal.IsKnown (tree.Root_));
+		QVERIFY (journal.GetSnapshot (tree.Root_).DirMTimes_.isEmpty ());
+	}
+
+	void DirJournalTest::testUnchanged ()
+	{
+		Tree tree;
+		DirJournal journal { tree.GetJournalPath () };
+		journal.Record (tree.GetMTimes ());
+
+		QVERIFY (journal.IsKnown (tree.Root_));
+
+		const auto& changes = DirJournal::CollectChanges (journal.GetSnapshot (tree.Root_));
+		QCOMPARE (changes.ChangedDirs_, QStringList {});
+		QCOMPARE (changes.RemovedDirs_, QStringList {});
+	}
+
+	void DirJournalTest::testChanged ()
+	{
+		Tree tree;
+		DirJournal journal { tree.GetJournalPath () };
+
+		auto mtimes = tree.GetMTimes ();
+		mtimes [tree.Album1_] -= 10000;
+		journal.Record (mtimes);
+
+		const auto& changes = DirJournal::CollectChanges (journal.GetSnapshot (tree.Root_));
+		QCOMPARE (changes.ChangedDirs_, QStringList { tree.Album1_ });
+		QCOMPARE (changes.RemovedDirs_, QStringList {});
+	}
+
+	void DirJournalTest::testRemoved ()
+	{
+		Tree tree;
+		DirJournal journal { tree.GetJournalPath () };
+		journal.Record (tree.GetMTimes ());
+
+		QVERIFY (QDir { tree.Album2_ }.removeRecursively ());
+
+		const auto& changes = DirJournal::CollectChanges (journal.GetSnapshot (tree.Root_));
+		QCOMPARE (changes.RemovedDirs_, QStringList { tree.Album2_ });
+	}
+
+	void DirJournalTest::testDirty ()
+	{
+		Tree tree;
+		DirJournal journal { tree.GetJournalPath () };
+		journal.Record (tree.GetMTimes ());
+		journal.MarkDirty (tree.Album1_);
+		journal.MarkDirty (tree.Album2_);
+
+		const auto& changes = DirJournal::CollectChanges (journal.GetSnapshot (tree.Root_));
+		QCOMPARE (Sorted (changes.ChangedDirs_), Sorted ({ tree.Album1_, tree.Album2_ }));
+	}
+
+	void DirJournalTest::testDirtyPersisted ()
+	{
+		Tree tree;
+
+		DirJournal journal { tree.GetJournalPath () };
+		journal.Record (tree.GetMTimes ());
+		journal.Save ();
+		journal.MarkDirty (tree.Album1_);
+
+		// The journal isn't saved after the dirty mark, as if we crashed.
+		DirJournal reloaded { tree.GetJournalPath () };
+		const auto& changes = DirJournal::CollectChanges (reloaded.GetSnapshot (tree.Root_));
+		QCOMPARE (changes.ChangedDirs_, QStringList { tree.Album1_ });
+	}
+
+	void DirJournalTest::testRecordClearsDirty ()
+	{
+		Tree tree;
+		DirJournal journal { tree.GetJournalPath () };
+		journal.Record (tree.GetMTimes ());
+		journal.MarkDirty (tree.Album1_);
+		journal.Record ({ { tree.Album1_, GetMTime (tree.Album1_) } });
+
+		const auto& changes = DirJournal::CollectChanges (journal.GetSnapshot (tree.Root_));
+		QCOMPARE (changes.ChangedDirs_, QStringList {});
+	}
+
+	void DirJournalTest::testPersisted ()
+	{
+		Tree tree;
+
+		auto mtimes = tree.GetMTimes ();
+		mtimes [tree.Artist_] -= 10000;
+
+		{
+			DirJournal journal { tree.GetJournalPath () };
+			journal.Record (mtimes);
+		}
+
+		DirJournal journal { tree.GetJournalPath () };
+		QVERIFY (journal.IsKnown (tree.Root_));
+		QCOMPARE (journal.GetSnapshot (tree.Root_).DirMTimes_, mtimes);
+
+		const auto& changes = DirJournal::CollectChanges (journal.GetSnapshot (tree.Root_));
+		QCOMPARE (changes.ChangedDirs_, QStringList { tree.Artist_ });
+	}
+
+	void DirJournalTest::testForget ()
+	{
+		Tree tree;
+		DirJournal journal { tree.GetJournalPath () };
+		journal.Record (tree.GetMTimes ());
+		journal.MarkDirty (tree.Album1_);
+
+		journal.Forget (tree.Artist_);
+
+		const auto& snapshot = journal.GetSnapshot (tree.Root_);
+		QCOMPARE (snapshot.DirMTimes_.keys (), QStringList { tree.Root_ });
+		QVERIFY (snapshot.DirtyDirs_.isEmpty ());
+	}
+}
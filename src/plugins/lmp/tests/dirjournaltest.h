@@ -0,0 +1,31 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <QObject>
+
+namespace LC::LMP
+{
+	class Q_DECL_EXPORT DirJournalTest : public QObject
+	{
+		Q_OBJECT
+	private slots:
+		void testUnknown ();
+		void testUnchanged ();
+		void testChanged ();
+		void testRemoved ();
+		void testDirty ();
+		void testDirtyPersisted ();
+		void testRecordClearsDirty ();
+		void testPersisted ();
+		void testForget ();
+	};
+}
+
+using TheTestObject = LC::LMP::DirJournalTest;
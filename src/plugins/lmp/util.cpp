@@ -9,6 +9,7 @@
 #include "util.h"
 #include <algorithm>
 #include <atomic>
+#include <functional>
 #include <QDirIterator>
 #include <QPixmap>
 #include <QApplication>
@@ -28,7 +29,9 @@
 
 namespace LC::LMP
 {
-	QList<QFileInfo> RecIterateInfo (const QString& dirPath, bool followSymlinks, std::atomic<bool> *stopFlag)
+	bool IterateMediaFiles (const QString& dirPath, bool followSymlinks,
+			const std::function<bool (const QFileInfo&)>& handler,
+			const std::function<bool (const QFileInfo&)>& dirFilter)
 	{
 		static const QStringList nameFilters
 		{
@@ -55,33 +58,53 @@ namespace LC::LMP
 		{
 			for (const auto& filter : nameFilters)
 				if (dirPath.endsWith (filter.mid (1), Qt::CaseInsensitive))
-					return { dirInfo };
+					return handler (dirInfo);
 
-			return {};
+			return true;
 		}
 
 		auto filters = QDir::AllDirs | QDir::Files | QDir::NoDotAndDotDot;
 		if (!followSymlinks)
 			filters |= QDir::NoSymLinks;
 
-		QList<QFileInfo> result;
 		const auto& list = QDir (dirPath).entryInfoList (nameFilters, filters);
 		for (const auto& entryInfo : list)
 		{
-			if (stopFlag && stopFlag->load (std::memory_order_relaxed))
-				return result;
-
 			const auto& path = entryInfo.absoluteFilePath ();
 			if (entryInfo.isSymLink () &&
 					entryInfo.symLinkTarget () == path)
 				continue;
 
 			if (entryInfo.isDir ())
-				result += RecIterateInfo (path, followSymlinks, stopFlag);
+			{
+				if (dirFilter && !dirFilter (entryInfo))
+					continue;
+
+				if (!IterateMediaFiles (path, followSymlinks, handler, dirFilter))
+					return false;
+			}
 			else if (entryInfo.isFile ())
-				result += entryInfo;
+			{
+				if (!handler (entryInfo))
+					return false;
+			}
 		}
 
+		return true;
+	}
+
+	QList<QFileInfo> RecIterateInfo (const QString& dirPath, bool followSymlinks, std::atomic<bool> *stopFlag)
+	{
+		QList<QFileInfo> result;
+		IterateMediaFiles (dirPath, followSymlinks,
+				[&] (const QFileInfo& info)
+				{
+					if (stopFlag && stopFlag->load (std::memory_order_relaxed))
+						return false;
+
+					result << info;
+					return true;
+				});
 		return result;
 	}
 
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
 #include <QStringList>
 #include <QFileInfo>
 #include <interfaces/media/idiscographyprovider.h>
@@ -27,6 +28,19 @@ namespace LMP
 {
 	struct MediaInfo;
 
+	/** Calls the \em handler for each media file in \em dirPath (or for
+	 * the \em dirPath itself if it's a media file) as soon as the file is
+	 * found, descending into those subdirectories the \em dirFilter (if
+	 * any) accepts.
+	 *
+	 * The iteration stops as soon as the \em handler returns false.
+	 *
+	 * @return Whether the whole tree has been visited.
+	 */
+	Q_DECL_EXPORT bool IterateMediaFiles (const QString& dirPath, bool followSymlinks,
+			const std::function<bool (const QFileInfo&)>& handler,
+			const std::function<bool (const QFileInfo&)>& dirFilter = {});
+
 	QList<QFileInfo> RecIterateInfo (const QString& dirPath,
 			bool followSymlinks = false, std::atomic<bool> *stopFlag = nullptr);
 	QStringList RecIterate (const QString& dirPath, bool followSymlinks = false);
@@ -7,15 +7,80 @@
  **********************************************************************/
 
 #include "pixmapcachemanager.h"
-#include <numeric>
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <QThread>
 #include <QtDebug>
+#include <util/threads/futures.h>
+#include "interfaces/monocle/idocument.h"
+#include "interfaces/monocle/isupportregionrendering.h"
 #include "components/viewitems/pagegraphicsitem.h"
 #include "xmlsettingsmanager.h"
 
 namespace LC::Monocle
 {
+	uint qHash (const TileKey& key, uint seed)
+	{
+		return ::qHash (key.Doc_, seed) ^
+				::qHash (key.Page_, seed) ^
+				::qHash (key.ScaleBucket_ << 20 | key.Row_ << 10 | key.Column_, seed);
+	}
+
+	namespace
+	{
+		// Eight buckets per doubling of the scale, so that the scale
+		// of a bucket differs from the requested one by 5% at most.
+		constexpr auto BucketsPerOctave = 8;
+	}
+
+	int GetScaleBucket (double scale)
+	{
+		return static_cast<int> (std::lround (std::log2 (scale) * BucketsPerOctave));
+	}
+
+	double GetBucketScale (int bucket)
+	{
+		return std::exp2 (static_cast<double> (bucket) / BucketsPerOctave);
+	}
+
+	namespace
+	{
+		QSize GetScaledPageSize (IDocument& doc, int page, int bucket)
+		{
+			const auto scale = GetBucketScale (bucket);
+			const auto& size = doc.GetPageSize (page);
+			return
+			{
+				static_cast<int> (std::ceil (size.width () * scale)),
+				static_cast<int> (std::ceil (size.height () * scale))
+			};
+		}
+	}
+
+	QRect GetTileRect (IDocument& doc, const TileKey& key)
+	{
+		const QRect pageRect { { 0, 0 }, GetScaledPageSize (doc, key.Page_, key.ScaleBucket_) };
+		return QRect { key.Column_ * TileSize, key.Row_ * TileSize, TileSize, TileSize }.intersected (pageRect);
+	}
+
+	QList<TileKey> GetPageTiles (IDocument& doc, int page, int bucket, const QRect& rect)
+	{
+		const QRect pageRect { { 0, 0 }, GetScaledPageSize (doc, page, bucket) };
+		const auto& area = rect.isNull () ? pageRect : rect.intersected (pageRect);
+		if (area.isEmpty ())
+			return {};
+
+		QList<TileKey> result;
+		for (int row = area.top () / TileSize; row <= area.bottom () / TileSize; ++row)
+			for (int col = area.left () / TileSize; col <= area.right () / TileSize; ++col)
+				result.append ({ &doc, page, bucket, row, col });
+		return result;
+	}
+
 	PixmapCacheManager::PixmapCacheManager (QObject *parent)
 	: QObject { parent }
+	, MaxRunningJobs_ { std::max (QThread::idealThreadCount () / 2, 2) }
 	{
 		constexpr auto megabytes = 1024 * 1024;
 
@@ -28,58 +93,287 @@ namespace LC::Monocle
 				});
 	}
 
-	void PixmapCacheManager::RegisterPage (PageGraphicsItem& page)
+	QImage PixmapCacheManager::GetTile (const TileKey& key)
 	{
-		connect (&page,
-				&PageGraphicsItem::itemPainted,
-				this,
-				[&] { BumpPage (page); });
-		connect (&page,
-				&PageGraphicsItem::itemPixmapChanged,
-				this,
-				[&]
+		const auto pos = Tiles_.find (key);
+		if (pos == Tiles_.end ())
+			return {};
+
+		RecentlyUsed_.splice (RecentlyUsed_.end (), RecentlyUsed_, pos->LRUPos_);
+		return pos->Image_;
+	}
+
+	void PixmapCacheManager::RequestTile (PageGraphicsItem& page, const TileKey& key, Priority priority)
+	{
+		if (Tiles_.contains (key))
+			return;
+
+		TrackDocument (*key.Doc_);
+
+		const auto& jobKey = GetJobKey (key);
+		auto pos = Jobs_.find (jobKey);
+		const auto isNew = pos == Jobs_.end ();
+		if (isNew)
+			pos = Jobs_.insert (jobKey, { {}, priority, ++LastJobId_ });
+
+		auto& job = *pos;
+		job.IsCancelled_ = false;
+		if (!job.Waiters_.contains (&page))
+			job.Waiters_ << &page;
+
+		if (job.IsRunning_)
+			return;
+
+		if (isNew)
+			(priority == Priority::Visible ? VisibleQueue_ : PrefetchQueue_) << jobKey;
+		else if (job.Priority_ == Priority::Prefetch && priority == Priority::Visible)
+		{
+			job.Priority_ = Priority::Visible;
+			VisibleQueue_ << jobKey;
+		}
+		else
+			return;
+
+		RunJobs ();
+	}
+
+	void PixmapCacheManager::Prefetch (IDocument& doc, const QList<PageGraphicsItem*>& pages)
+	{
+		CancelJobs ([&doc] (const TileKey& key, const RenderJob& job)
 				{
-					BumpPage (page);
+					return key.Doc_ == &doc && job.Priority_ == Priority::Prefetch;
+				});
 
-					CurrentSize_ -= ItemsSizes_ [&page];
-					CurrentSize_ += page.GetMemorySize ();
-					ItemsSizes_ [&page] = page.GetMemorySize ();
+		// Prefetching into a full cache would only evict the recently
+		// seen tiles in favour of the ones that might never be seen.
+		constexpr qint64 tileBytes = TileSize * TileSize * 4;
+		auto budget = MaxSize_ - CurrentSize_;
 
-					CheckCache ();
+		for (const auto page : pages)
+			for (const auto& key : GetPageTiles (doc, page->GetPageNum (), page->GetScaleBucket ()))
+			{
+				if (Tiles_.contains (key))
+					continue;
+
+				budget -= tileBytes;
+				if (budget < 0)
+					return;
+
+				RequestTile (*page, key, Priority::Prefetch);
+			}
+	}
+
+	void PixmapCacheManager::CancelStale (IDocument& doc, int page, int currentBucket)
+	{
+		CancelJobs ([&] (const TileKey& key, const RenderJob&)
+				{
+					return key.Doc_ == &doc &&
+							key.Page_ == page &&
+							key.ScaleBucket_ != currentBucket;
 				});
-		connect (&page,
+	}
+
+	void PixmapCacheManager::InvalidatePage (IDocument& doc, int page)
+	{
+		CancelJobs ([&] (const TileKey& key, const RenderJob&) { return key.Doc_ == &doc && key.Page_ == page; });
+
+		for (auto i = Tiles_.begin (); i != Tiles_.end (); )
+			if (i.key ().Doc_ == &doc && i.key ().Page_ == page)
+				RemoveTile (i++);
+			else
+				++i;
+	}
+
+	void PixmapCacheManager::TrackDocument (IDocument& doc)
+	{
+		if (Docs_.contains (&doc))
+			return;
+
+		Docs_ [&doc] = qobject_cast<ISupportRegionRendering*> (doc.GetQObject ());
+		connect (doc.GetQObject (),
 				&QObject::destroyed,
 				this,
-				[&]
+				[this, docPtr = &doc] { ForgetDocument (docPtr); });
+	}
+
+	void PixmapCacheManager::ForgetDocument (IDocument *doc)
+	{
+		Docs_.remove (doc);
+
+		CancelJobs ([doc] (const TileKey& key, const RenderJob&) { return key.Doc_ == doc; });
+
+		for (auto i = Tiles_.begin (); i != Tiles_.end (); )
+			if (i.key ().Doc_ == doc)
+				RemoveTile (i++);
+			else
+				++i;
+	}
+
+	TileKey PixmapCacheManager::GetJobKey (const TileKey& key) const
+	{
+		if (Docs_.value (key.Doc_))
+			return key;
+
+		return { key.Doc_, key.Page_, key.ScaleBucket_, 0, 0 };
+	}
+
+	void PixmapCacheManager::RunJobs ()
+	{
+		auto takeNext = [this] (QList<TileKey>& queue, Priority priority) -> std::optional<TileKey>
+		{
+			while (!queue.isEmpty ())
+			{
+				const auto& key = queue.takeFirst ();
+				const auto pos = Jobs_.find (key);
+				if (pos == Jobs_.end () || pos->IsRunning_ || pos->Priority_ != priority)
+					continue;
+
+				// The visible tiles might have been scrolled away since
+				// they have been requested: they will be requested again
+				// if they become visible again.
+				const auto isWholePage = !Docs_.value (key.Doc_);
+				const auto isDisplayed = [&key, isWholePage] (const auto& page)
 				{
-					CurrentSize_ -= ItemsSizes_.take (&page);
-					RecentlyUsed_.removeOne (&page);
-				});
+					return page && (isWholePage ? page->IsDisplayed () : page->IsTileDisplayed (key));
+				};
+				if (priority == Priority::Visible &&
+						std::none_of (pos->Waiters_.begin (), pos->Waiters_.end (), isDisplayed))
+				{
+					Jobs_.erase (pos);
+					continue;
+				}
+
+				return key;
+			}
+			return {};
+		};
+
+		while (RunningJobs_ < MaxRunningJobs_)
+		{
+			auto next = takeNext (VisibleQueue_, Priority::Visible);
+			if (!next)
+				next = takeNext (PrefetchQueue_, Priority::Prefetch);
+			if (!next)
+				break;
+
+			RunJob (*next);
+		}
+	}
+
+	void PixmapCacheManager::RunJob (const TileKey& jobKey)
+	{
+		auto& job = Jobs_ [jobKey];
+		job.IsRunning_ = true;
+		++RunningJobs_;
+
+		auto& doc = *jobKey.Doc_;
+		const auto scale = GetBucketScale (jobKey.ScaleBucket_);
+		const auto future = Docs_.value (&doc) ?
+				Docs_.value (&doc)->RenderPageRegion (jobKey.Page_, scale, scale, GetTileRect (doc, jobKey)) :
+				doc.RenderPage (jobKey.Page_, scale, scale);
+		Util::Sequence (this, future) >>
+				[this, jobKey, jobId = job.Id_] (const QImage& image) { HandleRendered (jobKey, jobId, image); };
 	}
 
-	void PixmapCacheManager::BumpPage (PageGraphicsItem& page)
+	void PixmapCacheManager::HandleRendered (const TileKey& jobKey, quint64 jobId, const QImage& image)
 	{
-		if (!RecentlyUsed_.isEmpty () && RecentlyUsed_.last () == &page)
+		--RunningJobs_;
+
+		const auto pos = Jobs_.find (jobKey);
+		if (pos == Jobs_.end () || pos->Id_ != jobId)
+		{
+			RunJobs ();
 			return;
+		}
 
-		RecentlyUsed_.removeOne (&page);
-		RecentlyUsed_ << &page;
+		const auto job = *pos;
+		Jobs_.erase (pos);
+
+		if (job.IsCancelled_ || image.isNull ())
+		{
+			RunJobs ();
+			return;
+		}
+
+		const auto firstWaiter = std::find_if (job.Waiters_.begin (), job.Waiters_.end (),
+				[] (const auto& page) { return page; });
+		const auto owner = firstWaiter == job.Waiters_.end () ? nullptr : firstWaiter->data ();
+
+		auto& doc = *jobKey.Doc_;
+		QRect updatedRect;
+		if (Docs_.value (&doc))
+		{
+			InsertTile (jobKey, image, owner);
+			updatedRect = GetTileRect (doc, jobKey);
+		}
+		else
+		{
+			for (const auto& key : GetPageTiles (doc, jobKey.Page_, jobKey.ScaleBucket_))
+			{
+				const auto& tileRect = GetTileRect (doc, key);
+				InsertTile (key, image.copy (tileRect), owner);
+				updatedRect |= tileRect;
+			}
+		}
+
+		for (const auto& page : job.Waiters_)
+			if (page)
+				page->HandleTileRendered (jobKey.ScaleBucket_, updatedRect);
+
+		CheckCache ();
+		RunJobs ();
+	}
+
+	void PixmapCacheManager::InsertTile (const TileKey& key, const QImage& image, PageGraphicsItem *page)
+	{
+		if (const auto pos = Tiles_.find (key); pos != Tiles_.end ())
+			RemoveTile (pos);
+
+		RecentlyUsed_.push_back (key);
+		Tiles_ [key] = { image, page, std::prev (RecentlyUsed_.end ()) };
+		CurrentSize_ += image.sizeInBytes ();
+	}
+
+	void PixmapCacheManager::RemoveTile (QHash<TileKey, CacheEntry>::iterator pos)
+	{
+		CurrentSize_ -= pos->Image_.sizeInBytes ();
+		RecentlyUsed_.erase (pos->LRUPos_);
+		Tiles_.erase (pos);
 	}
 
 	void PixmapCacheManager::CheckCache ()
 	{
 		for (auto i = RecentlyUsed_.begin (); i != RecentlyUsed_.end () && MaxSize_ < CurrentSize_; )
 		{
-			const auto page = *i;
-			if (page->IsDisplayed ())
+			const auto pos = Tiles_.find (*i++);
+			if (const auto& page = pos->Page_;
+					page && page->IsTileDisplayed (pos.key ()))
+				continue;
+
+			RemoveTile (pos);
+		}
+	}
+
+	template<typename F>
+	void PixmapCacheManager::CancelJobs (F&& pred)
+	{
+		for (auto i = Jobs_.begin (); i != Jobs_.end (); )
+		{
+			if (!pred (i.key (), *i))
 			{
 				++i;
 				continue;
 			}
 
-			CurrentSize_ -= ItemsSizes_.take (page);
-			page->ClearPixmap ();
-			i = RecentlyUsed_.erase (i);
+			// The running renders can't be interrupted, but their results
+			// are dropped once they are ready.
+			if (i->IsRunning_)
+			{
+				i->IsCancelled_ = true;
+				++i;
+			}
+			else
+				i = Jobs_.erase (i);
 		}
 	}
 }
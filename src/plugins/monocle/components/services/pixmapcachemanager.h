@@ -8,26 +8,147 @@
 
 #pragma once
 
+#include <list>
 #include <QObject>
 #include <QHash>
+#include <QImage>
+#include <QPointer>
 
 namespace LC::Monocle
 {
+	class IDocument;
+	class ISupportRegionRendering;
 	class PageGraphicsItem;
 
+	/** @brief Identifies a single rendered tile of a page.
+	 *
+	 * The pages are rendered at a discrete set of scales (the scale
+	 * buckets), so that slightly different zoom levels share the already
+	 * rendered tiles, and the rendered page is split into square tiles of
+	 * TileSize pixels.
+	 */
+	struct TileKey
+	{
+		IDocument *Doc_ = nullptr;
+		int Page_ = 0;
+		int ScaleBucket_ = 0;
+		int Row_ = 0;
+		int Column_ = 0;
+
+		bool operator== (const TileKey&) const = default;
+	};
+
+	uint qHash (const TileKey&, uint = 0);
+
+	constexpr int TileSize = 512;
+
+	int GetScaleBucket (double scale);
+	double GetBucketScale (int bucket);
+
+	/** Returns the rect of the given \em key in the coordinates of the
+	 * page rendered at the scale of the key's bucket.
+	 */
+	QRect GetTileRect (IDocument&, const TileKey& key);
+
+	/** Returns the keys of all the tiles of the \em page at the given
+	 * scale \em bucket intersecting the \em rect (or all the tiles if
+	 * the \em rect is null).
+	 */
+	QList<TileKey> GetPageTiles (IDocument&, int page, int bucket, const QRect& rect = {});
+
+	/** @brief Renders and caches the tiles of the pages.
+	 *
+	 * The manager is shared by all the documents, and the total size of
+	 * the cached tiles is limited by the PixmapCacheSize setting. The
+	 * least recently used tiles that aren't visible are evicted first.
+	 *
+	 * At most a few tiles are rendered at once. The tiles requested for
+	 * the visible parts of the pages are rendered before the prefetched
+	 * ones, and the pending renders for a page are dropped once the page
+	 * scale changes.
+	 */
 	class PixmapCacheManager : public QObject
 	{
+	public:
+		enum class Priority
+		{
+			Visible,
+			Prefetch
+		};
+	private:
 		qint64 CurrentSize_ = 0;
 		qint64 MaxSize_ = 0;
 
-		QVector<PageGraphicsItem*> RecentlyUsed_;
-		QHash<PageGraphicsItem*, int> ItemsSizes_;
+		struct CacheEntry
+		{
+			QImage Image_;
+			QPointer<PageGraphicsItem> Page_;
+			std::list<TileKey>::iterator LRUPos_;
+		};
+		QHash<TileKey, CacheEntry> Tiles_;
+		std::list<TileKey> RecentlyUsed_;
+
+		/* A render job produces a single tile for the documents
+		 * supporting region rendering, or all the tiles of the page
+		 * otherwise, in which case the job is keyed by the (0, 0) tile.
+		 */
+		struct RenderJob
+		{
+			QList<QPointer<PageGraphicsItem>> Waiters_;
+			Priority Priority_;
+			quint64 Id_;
+			bool IsRunning_ = false;
+			bool IsCancelled_ = false;
+		};
+		QHash<TileKey, RenderJob> Jobs_;
+		QList<TileKey> VisibleQueue_;
+		QList<TileKey> PrefetchQueue_;
+		quint64 LastJobId_ = 0;
+		int RunningJobs_ = 0;
+		const int MaxRunningJobs_;
+
+		QHash<IDocument*, ISupportRegionRendering*> Docs_;
 	public:
 		explicit PixmapCacheManager (QObject* = nullptr);
 
-		void RegisterPage (PageGraphicsItem&);
+		/** Returns the cached tile for the \em key, if any, marking it
+		 * as recently used.
+		 */
+		QImage GetTile (const TileKey& key);
+
+		/** Schedules rendering of the tile for the \em key unless it is
+		 * already cached or scheduled. The \em page is notified via
+		 * PageGraphicsItem::HandleTileRendered() once the tile is ready.
+		 */
+		void RequestTile (PageGraphicsItem& page, const TileKey& key, Priority);
+
+		/** Replaces the prefetch requests for the \em doc with the
+		 * tiles of the given \em pages at their current scales.
+		 */
+		void Prefetch (IDocument& doc, const QList<PageGraphicsItem*>& pages);
+
+		/** Drops the pending renders of the \em page of the \em doc for
+		 * all the scale buckets except the \em currentBucket.
+		 */
+		void CancelStale (IDocument& doc, int page, int currentBucket);
+
+		/** Drops all the cached and pending tiles of the \em page of the
+		 * \em doc, for example, when its contents have changed.
+		 */
+		void InvalidatePage (IDocument& doc, int page);
 	private:
-		void BumpPage (PageGraphicsItem&);
+		void TrackDocument (IDocument&);
+		void ForgetDocument (IDocument*);
+		TileKey GetJobKey (const TileKey&) const;
+		void RunJobs ();
+		void RunJob (const TileKey& jobKey);
+		void HandleRendered (const TileKey& jobKey, quint64 jobId, const QImage&);
+
+		void InsertTile (const TileKey&, const QImage&, PageGraphicsItem*);
+		void RemoveTile (QHash<TileKey, CacheEntry>::iterator);
 		void CheckCache ();
+
+		template<typename F>
+		void CancelJobs (F&& pred);
 	};
 }
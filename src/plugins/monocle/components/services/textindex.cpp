@@ -0,0 +1,345 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "textindex.h"
+#include <algorithm>
+#include <cmath>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include <QUrl>
+#include <QtConcurrentRun>
+#include <QtDebug>
+#include <util/sys/paths.h>
+#include <util/threads/futures.h>
+#include "interfaces/monocle/idocument.h"
+#include "interfaces/monocle/ihavetextlayout.h"
+
+namespace LC::Monocle
+{
+	namespace
+	{
+		constexpr quint32 IndexMagic = 0x4d545849;
+		constexpr quint32 IndexVersion = 1;
+
+		/* Hashing the whole file might take quite some time for large
+		 * scanned documents, while the size along with the beginning and
+		 * the end of the file identify it well enough: the incremental
+		 * updates are appended to the end of the file.
+		 */
+		QString ComputeDocHash (const QString& path)
+		{
+			QFile file { path };
+			if (!file.open (QIODevice::ReadOnly))
+				return {};
+
+			constexpr qint64 chunkSize = 4 * 1024 * 1024;
+
+			QCryptographicHash hash { QCryptographicHash::Sha1 };
+			hash.addData (QByteArray::number (file.size ()));
+			hash.addData (file.read (chunkSize));
+			if (file.size () > chunkSize)
+			{
+				file.seek (std::max (chunkSize, file.size () - chunkSize));
+				hash.addData (file.read (chunkSize));
+			}
+			return hash.result ().toHex ();
+		}
+
+		QString GetCachePath (const QString& docPath)
+		{
+			const auto& hash = ComputeDocHash (docPath);
+			if (hash.isEmpty ())
+				return {};
+
+			try
+			{
+				return Util::CreateIfNotExists ("monocle/textindex").filePath (hash);
+			}
+			catch (const std::exception& e)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< e.what ();
+				return {};
+			}
+		}
+
+		QVector<TextIndex::Page> LoadIndex (const QString& path, int pagesCount)
+		{
+			QFile file { path };
+			if (!file.open (QIODevice::ReadOnly))
+				return {};
+
+			QDataStream fileStr { &file };
+			quint32 magic = 0;
+			quint32 version = 0;
+			QByteArray data;
+			fileStr >> magic >> version >> data;
+			if (magic != IndexMagic || version != IndexVersion)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unknown index format in"
+						<< path;
+				return {};
+			}
+
+			QDataStream istr { qUncompress (data) };
+			istr.setFloatingPointPrecision (QDataStream::SinglePrecision);
+			qint32 count = 0;
+			istr >> count;
+			if (count != pagesCount)
+				return {};
+
+			QVector<TextIndex::Page> pages;
+			pages.reserve (count);
+			for (int i = 0; i < count; ++i)
+			{
+				TextIndex::Page page;
+				qint32 wordsCount = 0;
+				istr >> page.Text_ >> page.CharEdges_ >> wordsCount;
+				if (istr.status () != QDataStream::Ok || wordsCount < 0)
+					break;
+
+				page.Words_.reserve (wordsCount);
+				for (int j = 0; j < wordsCount; ++j)
+				{
+					qint32 start = 0;
+					qint32 length = 0;
+					float x = 0, y = 0, w = 0, h = 0;
+					istr >> start >> length >> x >> y >> w >> h;
+					page.Words_.append ({ start, length, { x, y, w, h } });
+				}
+				pages << page;
+			}
+
+			if (istr.status () != QDataStream::Ok)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "corrupted index"
+						<< path;
+				return {};
+			}
+
+			return pages;
+		}
+
+		void SaveIndex (const QString& path, const QVector<TextIndex::Page>& pages)
+		{
+			QByteArray data;
+			{
+				QDataStream ostr { &data, QIODevice::WriteOnly };
+				ostr.setFloatingPointPrecision (QDataStream::SinglePrecision);
+				ostr << static_cast<qint32> (pages.size ());
+				for (const auto& page : pages)
+				{
+					ostr << page.Text_ << page.CharEdges_ << static_cast<qint32> (page.Words_.size ());
+					for (const auto& word : page.Words_)
+						ostr << static_cast<qint32> (word.Start_)
+								<< static_cast<qint32> (word.Length_)
+								<< static_cast<float> (word.Rect_.x ())
+								<< static_cast<float> (word.Rect_.y ())
+								<< static_cast<float> (word.Rect_.width ())
+								<< static_cast<float> (word.Rect_.height ());
+				}
+			}
+
+			QSaveFile file { path };
+			if (!file.open (QIODevice::WriteOnly))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to open"
+						<< path
+						<< file.errorString ();
+				return;
+			}
+
+			QDataStream fileStr { &file };
+			fileStr << IndexMagic << IndexVersion << qCompress (data);
+			if (!file.commit ())
+				qWarning () << Q_FUNC_INFO
+						<< "unable to save"
+						<< path
+						<< file.errorString ();
+		}
+
+		bool IsSeparator (const PageRelativeRectBase& box)
+		{
+			return box.ToRectF ().isNull ();
+		}
+
+		bool IsSameWord (const QRectF& word, const QRectF& ch)
+		{
+			return ch.top () < word.bottom () &&
+					ch.bottom () > word.top () &&
+					ch.left () >= word.left ();
+		}
+
+		TextIndex::Page BuildPage (const PageTextLayout& layout)
+		{
+			TextIndex::Page page;
+			page.Text_ = layout.Text_;
+			page.CharEdges_.fill (0, layout.Text_.size ());
+
+			const auto& boxes = layout.CharBoxes_;
+			const auto size = std::min<int> (layout.Text_.size (), boxes.size ());
+			for (int i = 0; i < size; )
+			{
+				if (IsSeparator (boxes [i]))
+				{
+					++i;
+					continue;
+				}
+
+				const auto start = i;
+				auto rect = boxes [i++].ToRectF ();
+				while (i < size && !IsSeparator (boxes [i]) && IsSameWord (rect, boxes [i].ToRectF ()))
+					rect |= boxes [i++].ToRectF ();
+
+				page.Words_.append ({ start, i - start, rect });
+
+				if (rect.width () <= 0)
+					continue;
+
+				for (int j = start; j < i; ++j)
+				{
+					const auto edge = (boxes [j].ToRectF ().left () - rect.left ()) / rect.width ();
+					page.CharEdges_ [j] = static_cast<char> (std::clamp<int> (std::lround (edge * 255), 0, 255));
+				}
+			}
+
+			return page;
+		}
+	}
+
+	TextIndex::TextIndex (IDocument& doc, IHaveTextLayout& layout, QObject *parent)
+	: QObject { parent }
+	, Doc_ { doc }
+	, Layout_ { layout }
+	{
+		const auto& url = Doc_.GetDocURL ();
+		if (!url.isLocalFile ())
+		{
+			IndexNextPage ();
+			return;
+		}
+
+		const auto pagesCount = Doc_.GetNumPages ();
+		Util::Sequence (this,
+				QtConcurrent::run ([path = url.toLocalFile (), pagesCount]
+					{
+						const auto& cachePath = GetCachePath (path);
+						return std::pair { cachePath, LoadIndex (cachePath, pagesCount) };
+					})) >>
+				[this] (const std::pair<QString, QVector<Page>>& result)
+				{
+					CachePath_ = result.first;
+					HandleCacheLoaded (result.second);
+				};
+	}
+
+	int TextIndex::GetIndexedPagesCount () const
+	{
+		return Pages_.size ();
+	}
+
+	bool TextIndex::IsComplete () const
+	{
+		return Pages_.size () == Doc_.GetNumPages ();
+	}
+
+	namespace
+	{
+		QRectF GetFragmentRect (const TextIndex::Page& page, const TextIndex::Word& word, int from, int to)
+		{
+			const auto& rect = word.Rect_;
+			auto edgeX = [&] (int pos)
+			{
+				return rect.left () + rect.width () * static_cast<uchar> (page.CharEdges_.at (pos)) / 255.;
+			};
+
+			const auto left = from == word.Start_ ? rect.left () : edgeX (from);
+			const auto right = to == word.Start_ + word.Length_ ? rect.right () : edgeX (to);
+			return { QPointF { left, rect.top () }, QPointF { right, rect.bottom () } };
+		}
+	}
+
+	QList<PageRelativeRectBase> TextIndex::Search (int pageNum, const QString& text, Qt::CaseSensitivity cs) const
+	{
+		QList<PageRelativeRectBase> result;
+		if (text.isEmpty () || pageNum < 0 || pageNum >= Pages_.size ())
+			return result;
+
+		const auto& page = Pages_.at (pageNum);
+		for (auto pos = page.Text_.indexOf (text, 0, cs); pos >= 0; pos = page.Text_.indexOf (text, pos + text.size (), cs))
+		{
+			const auto end = pos + text.size ();
+
+			auto word = std::lower_bound (page.Words_.begin (), page.Words_.end (), pos,
+					[] (const Word& word, int pos) { return word.Start_ + word.Length_ <= pos; });
+
+			// An occurrence spanning several lines results in a rect per line.
+			QRectF current;
+			for (; word != page.Words_.end () && word->Start_ < end; ++word)
+			{
+				const auto& fragment = GetFragmentRect (page,
+						*word,
+						std::max (pos, word->Start_),
+						std::min (end, word->Start_ + word->Length_));
+				if (current.isNull ())
+					current = fragment;
+				else if (IsSameWord (current, fragment))
+					current |= fragment;
+				else
+				{
+					result << PageRelativeRectBase { current };
+					current = fragment;
+				}
+			}
+
+			if (!current.isNull ())
+				result << PageRelativeRectBase { current };
+		}
+
+		return result;
+	}
+
+	void TextIndex::HandleCacheLoaded (const QVector<Page>& pages)
+	{
+		if (pages.isEmpty ())
+		{
+			IndexNextPage ();
+			return;
+		}
+
+		qDebug () << Q_FUNC_INFO
+				<< "loaded the cached index of"
+				<< pages.size ()
+				<< "pages";
+		Pages_ = pages;
+		emit pagesIndexed (0, Pages_.size ());
+	}
+
+	void TextIndex::IndexNextPage ()
+	{
+		if (IsComplete ())
+		{
+			if (!CachePath_.isEmpty ())
+				QtConcurrent::run (SaveIndex, CachePath_, Pages_);
+			return;
+		}
+
+		Util::Sequence (this, Layout_.GetTextLayout (Pages_.size ())) >>
+				[this] (const PageTextLayout& layout)
+				{
+					Pages_ << BuildPage (layout);
+					emit pagesIndexed (Pages_.size () - 1, Pages_.size ());
+					IndexNextPage ();
+				};
+	}
+}
@@ -0,0 +1,79 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QVector>
+#include "interfaces/monocle/coords.h"
+
+namespace LC::Monocle
+{
+	class IDocument;
+	class IHaveTextLayout;
+	struct PageTextLayout;
+
+	/** @brief Full text index of a document.
+	 *
+	 * The index keeps the text of each page along with the positions of
+	 * its words and glyphs, so that searching for text is a matter of
+	 * scanning the in-memory text instead of extracting it from the
+	 * document for each query.
+	 *
+	 * The index is built page by page in the background once it is
+	 * created, and is saved to the disk when complete, keyed by the
+	 * hash of the document file, so that it is loaded at once the next
+	 * time the same document is opened.
+	 */
+	class TextIndex : public QObject
+	{
+		Q_OBJECT
+	public:
+		struct Word
+		{
+			int Start_;
+			int Length_;
+			QRectF Rect_;
+		};
+
+		struct Page
+		{
+			QString Text_;
+			QVector<Word> Words_;
+
+			/* The left edge of each character relative to its word, as a
+			 * fraction of the word width scaled to 0..255.
+			 */
+			QByteArray CharEdges_;
+		};
+	private:
+		IDocument& Doc_;
+		IHaveTextLayout& Layout_;
+
+		QVector<Page> Pages_;
+		QString CachePath_;
+	public:
+		TextIndex (IDocument&, IHaveTextLayout&, QObject* = nullptr);
+
+		int GetIndexedPagesCount () const;
+		bool IsComplete () const;
+
+		/** Returns the rects of the occurrences of the \em text on the
+		 * already indexed \em page.
+		 */
+		QList<PageRelativeRectBase> Search (int page, const QString& text, Qt::CaseSensitivity) const;
+	private:
+		void HandleCacheLoaded (const QVector<Page>&);
+		void IndexNextPage ();
+	signals:
+		/** Emitted when the pages from \em from to \em to (exclusive)
+		 * have been indexed.
+		 */
+		void pagesIndexed (int from, int to);
+	};
+}
@@ -7,14 +7,15 @@
  **********************************************************************/
 
 #include "pagegraphicsitem.h"
+#include <algorithm>
 #include <limits>
 #include <cmath>
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsScene>
 #include <QGraphicsView>
 #include <QStyleOptionGraphicsItem>
-#include <util/threads/futures.h>
 #include "components/layout/positions.h"
+#include "components/services/pixmapcachemanager.h"
 
 namespace LC::Monocle
 {
@@ -24,14 +25,14 @@ namespace LC::Monocle
 		RectSetter_f Setter_;
 	};
 
-	PageGraphicsItem::PageGraphicsItem (IDocument& doc, int page, QGraphicsItem *parent)
+	PageGraphicsItem::PageGraphicsItem (IDocument& doc, int page, PixmapCacheManager& cache, QGraphicsItem *parent)
 	: QGraphicsItem { parent }
 	, Doc_ { doc }
+	, Cache_ { cache }
 	, PageNum_ { page }
 	{
 		setAcceptHoverEvents (true);
-
-		ClearPixmap ();
+		setFlag (ItemUsesExtendedStyleOption);
 	}
 
 	PageGraphicsItem::~PageGraphicsItem () = default;
@@ -52,7 +53,9 @@ namespace LC::Monocle
 		XScale_ = xs;
 		YScale_ = ys;
 
-		UpdatePixmap ();
+		Cache_.CancelStale (Doc_, PageNum_, GetScaleBucket ());
+		if (ShouldRender ())
+			update ();
 
 		for (const auto& info : Item2RectInfo_)
 			info.Setter_ (info.Rect_.ToPageAbsolute (*this));
@@ -63,6 +66,11 @@ namespace LC::Monocle
 		return PageNum_;
 	}
 
+	int PageGraphicsItem::GetScaleBucket () const
+	{
+		return Monocle::GetScaleBucket (std::max (XScale_, YScale_));
+	}
+
 	void PageGraphicsItem::setPos (const SceneAbsolutePos& pos)
 	{
 		QGraphicsItem::setPos (pos.ToPointF ());
@@ -79,57 +87,46 @@ namespace LC::Monocle
 		Item2RectInfo_.remove (item);
 	}
 
-	void PageGraphicsItem::ClearPixmap ()
-	{
-		Image_ = QImage {};
-	}
-
 	void PageGraphicsItem::UpdatePixmap ()
 	{
-		ClearPixmap ();
+		Cache_.InvalidatePage (Doc_, PageNum_);
 		if (ShouldRender ())
 			update ();
 	}
 
-	namespace
+	void PageGraphicsItem::HandleTileRendered (int bucket, const QRect& rect)
 	{
-		void DrawEmptyPixmap (QPainter& painter, const QStyleOptionGraphicsItem& option)
-		{
-			painter.fillRect (option.rect, QBrush { Qt::white });
-		}
+		if (bucket == GetScaleBucket ())
+			update (MapFromBucket (rect, bucket));
 	}
 
 	void PageGraphicsItem::paint (QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget*)
 	{
-		emit itemPainted ();
-
-		if (!Image_.isNull ())
+		const auto bucket = GetScaleBucket ();
+		const auto bucketScale = GetBucketScale (bucket);
+		const auto& exposed = option->exposedRect;
+		const auto& exposedInBucket = QRectF
 		{
-			painter->drawImage (option->rect, Image_);
-			return;
-		}
-
-		if (!IsDisplayed ())
-			return;
-
-		DrawEmptyPixmap (*painter, *option);
+			exposed.x () * bucketScale / XScale_,
+			exposed.y () * bucketScale / YScale_,
+			exposed.width () * bucketScale / XScale_,
+			exposed.height () * bucketScale / YScale_
+		}.toAlignedRect ();
 
-		if (IsRenderingEnabled_ && !IsRenderingScheduled_)
+		for (const auto& key : GetPageTiles (Doc_, PageNum_, bucket, exposedInBucket))
 		{
-			IsRenderingScheduled_ = true;
-			Util::Sequence (this, Doc_.RenderPage (PageNum_, XScale_, YScale_)) >>
-					[&, prevXScale = XScale_, prevYScale = YScale_] (QImage img)
-					{
-						IsRenderingScheduled_ = false;
-						Image_ = std::move (img);
-						update ();
-
-						emit itemPixmapChanged ();
-
-						if (std::abs (prevXScale - XScale_) > std::numeric_limits<double>::epsilon () * XScale_ ||
-							std::abs (prevYScale - YScale_) > std::numeric_limits<double>::epsilon () * YScale_)
-							UpdatePixmap ();
-					};
+			const auto& target = MapFromBucket (GetTileRect (Doc_, key), bucket);
+
+			const auto& tile = Cache_.GetTile (key);
+			if (!tile.isNull ())
+			{
+				painter->drawImage (target, tile);
+				continue;
+			}
+
+			painter->fillRect (target, QBrush { Qt::white });
+			if (IsRenderingEnabled_)
+				Cache_.RequestTile (*this, key, PixmapCacheManager::Priority::Visible);
 		}
 	}
 
@@ -147,17 +144,23 @@ namespace LC::Monocle
 			QGraphicsItem::mouseReleaseEvent (event);
 	}
 
-	int PageGraphicsItem::GetMemorySize () const
+	bool PageGraphicsItem::IsDisplayed () const
 	{
-		if (Image_.isNull ())
-			return 0;
+		return IsRectDisplayed (boundingRect ());
+	}
 
-		return Image_.width () * Image_.height () * Image_.depth () / 8;
+	bool PageGraphicsItem::IsTileDisplayed (const TileKey& key) const
+	{
+		return key.ScaleBucket_ == GetScaleBucket () &&
+				IsRectDisplayed (MapFromBucket (GetTileRect (Doc_, key), key.ScaleBucket_));
 	}
 
-	bool PageGraphicsItem::IsDisplayed () const
+	bool PageGraphicsItem::IsRectDisplayed (const QRectF& rect) const
 	{
-		const auto& thisMapped = mapToScene (boundingRect ()).boundingRect ();
+		if (!scene ())
+			return false;
+
+		const auto& thisMapped = mapToScene (rect).boundingRect ();
 		return std::ranges::any_of (scene ()->views (),
 				[&thisMapped] (auto view)
 				{
@@ -181,6 +184,18 @@ namespace LC::Monocle
 		return IsRenderingEnabled_ && IsDisplayed ();
 	}
 
+	QRectF PageGraphicsItem::MapFromBucket (const QRect& rect, int bucket) const
+	{
+		const auto bucketScale = GetBucketScale (bucket);
+		const auto xRatio = XScale_ / bucketScale;
+		const auto yRatio = YScale_ / bucketScale;
+		return QRectF
+		{
+			QPointF { rect.left () * xRatio, rect.top () * yRatio },
+			QPointF { (rect.right () + 1) * xRatio, (rect.bottom () + 1) * yRatio }
+		}.intersected (boundingRect ());
+	}
+
 	QRectF PageGraphicsItem::boundingRect () const
 	{
 		QSizeF size { Doc_.GetPageSize (PageNum_) };
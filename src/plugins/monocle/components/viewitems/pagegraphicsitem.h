@@ -19,6 +19,9 @@ namespace LC::Monocle
 	struct PageAbsoluteRect;
 	struct PageRelativeRect;
 	struct SceneAbsolutePos;
+	struct TileKey;
+
+	class PixmapCacheManager;
 
 	class PageGraphicsItem : public QObject
 						   , public QGraphicsItem
@@ -27,7 +30,7 @@ namespace LC::Monocle
 		Q_INTERFACES (QGraphicsItem)
 
 		IDocument& Doc_;
-		QImage Image_;
+		PixmapCacheManager& Cache_;
 
 		qreal XScale_ = 1;
 		qreal YScale_ = 1;
@@ -35,7 +38,6 @@ namespace LC::Monocle
 		const int PageNum_;
 
 		bool IsRenderingEnabled_ = true;
-		bool IsRenderingScheduled_ = false;
 	public:
 		using RectSetter_f = std::function<void (PageAbsoluteRect)>;
 		using ReleaseHandler_f = std::function<void (int, PageAbsolutePos)>;
@@ -45,7 +47,7 @@ namespace LC::Monocle
 		struct RectInfo;
 		QMap<QGraphicsItem*, RectInfo> Item2RectInfo_;
 	public:
-		PageGraphicsItem (IDocument&, int, QGraphicsItem* = nullptr);
+		PageGraphicsItem (IDocument&, int, PixmapCacheManager&, QGraphicsItem* = nullptr);
 		~PageGraphicsItem () override;
 
 		void SetReleaseHandler (ReleaseHandler_f);
@@ -53,17 +55,26 @@ namespace LC::Monocle
 		void SetScale (double, double);
 		int GetPageNum () const;
 
+		/** Returns the scale bucket the page is currently rendered at.
+		 */
+		int GetScaleBucket () const;
+
 		void setPos (const SceneAbsolutePos&);
 
 		void RegisterChildRect (QGraphicsItem*, const PageRelativeRect&, RectSetter_f);
 		void UnregisterChildRect (QGraphicsItem*);
 
-		void ClearPixmap ();
+		/** Drops the rendered tiles of the page and renders it anew.
+		 */
 		void UpdatePixmap ();
 
-		int GetMemorySize () const;
+		/** Called by the PixmapCacheManager once the \em rect of the
+		 * page rendered at the scale \em bucket is ready.
+		 */
+		void HandleTileRendered (int bucket, const QRect& rect);
 
 		bool IsDisplayed () const;
+		bool IsTileDisplayed (const TileKey&) const;
 
 		void SetRenderingEnabled (bool);
 
@@ -75,8 +86,7 @@ namespace LC::Monocle
 		void mouseReleaseEvent (QGraphicsSceneMouseEvent*) override;
 	private:
 		bool ShouldRender () const;
-	signals:
-		void itemPainted ();
-		void itemPixmapChanged ();
+		bool IsRectDisplayed (const QRectF&) const;
+		QRectF MapFromBucket (const QRect&, int bucket) const;
 	};
 }
@@ -163,6 +163,25 @@ namespace Monocle
 						page->SetRenderingEnabled (!isScrolling);
 				});
 
+		connect (Ui_.PagesView_->verticalScrollBar (),
+				&QScrollBar::valueChanged,
+				this,
+				&DocumentTab::HandleScrolled);
+		connect (&C_->LayoutManager_,
+				&PagesLayoutManager::layoutFinished,
+				this,
+				[this]
+				{
+					LastPrefetch_.reset ();
+					PrefetchPages ();
+				});
+		XmlSettingsManager::Instance ().RegisterObject ("PrefetchPagesCount", this,
+				[this]
+				{
+					LastPrefetch_.reset ();
+					PrefetchPages ();
+				});
+
 		connect (&C_->LayoutManager_,
 				&PagesLayoutManager::layoutModeChanged,
 				this,
@@ -634,6 +653,7 @@ namespace Monocle
 
 		Scene_.clear ();
 		Pages_.clear ();
+		LastPrefetch_.reset ();
 
 		CurrentDoc_ = document;
 		CurrentDocPath_ = path;
@@ -642,8 +662,7 @@ namespace Monocle
 
 		for (int i = 0, size = CurrentDoc_->GetNumPages (); i < size; ++i)
 		{
-			auto item = new PageGraphicsItem { *CurrentDoc_, i };
-			PixmapCacheManager_.RegisterPage (*item);
+			auto item = new PageGraphicsItem { *CurrentDoc_, i, PixmapCacheManager_ };
 			Scene_.addItem (item);
 			Pages_ << item;
 		}
@@ -673,7 +692,11 @@ namespace Monocle
 			connect (docSignals,
 					&DocumentSignals::pageContentsChanged,
 					this,
-					[this] (int idx) { Pages_ [idx]->UpdatePixmap (); });
+					[this] (int idx)
+					{
+						Pages_ [idx]->UpdatePixmap ();
+						LastPrefetch_.reset ();
+					});
 		}
 
 		emit tabRecoverDataChanged ();
@@ -686,6 +709,40 @@ namespace Monocle
 		ExportPDFAction_->setEnabled (qobject_cast<ISupportPainting*> (docObj));
 	}
 
+	void DocumentTab::HandleScrolled (int value)
+	{
+		if (value != PrevScrollValue_)
+			IsScrollingBackwards_ = value < PrevScrollValue_;
+		PrevScrollValue_ = value;
+
+		PrefetchPages ();
+	}
+
+	void DocumentTab::PrefetchPages ()
+	{
+		if (!CurrentDoc_ || Pages_.isEmpty ())
+			return;
+
+		const auto current = C_->LayoutManager_.GetCurrentPage ();
+		const std::pair prefetch { current, IsScrollingBackwards_ };
+		if (LastPrefetch_ == prefetch)
+			return;
+		LastPrefetch_ = prefetch;
+
+		const auto count = XmlSettingsManager::Instance ().property ("PrefetchPagesCount").toInt ();
+		const auto step = IsScrollingBackwards_ ? -1 : 1;
+
+		// The page next to the current one is most probably visible
+		// already, so it doesn't count.
+		QList<PageGraphicsItem*> pages;
+		for (int i = 1; i <= count + 1; ++i)
+			if (const auto page = current + i * step;
+					page >= 0 && page < Pages_.size ())
+				pages << Pages_ [page];
+
+		PixmapCacheManager_.Prefetch (*CurrentDoc_, pages);
+	}
+
 	void DocumentTab::saveState ()
 	{
 		if (!SaveStateScheduled_)
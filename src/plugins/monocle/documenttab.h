@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <optional>
+#include <utility>
 #include <QWidget>
 #include <interfaces/ihavetabs.h>
 #include <interfaces/ihaverecoverabletabs.h>
@@ -77,6 +79,10 @@ namespace Monocle
 
 		bool SaveStateScheduled_ = false;
 
+		int PrevScrollValue_ = 0;
+		bool IsScrollingBackwards_ = false;
+		std::optional<std::pair<int, bool>> LastPrefetch_;
+
 		Util::ScreensaverProhibitor ScreensaverProhibitor_;
 	public:
 		struct Deps
@@ -125,6 +131,9 @@ namespace Monocle
 
 		void HandleDocumentLoaded (const IDocument_ptr&, const QString&);
 
+		void HandleScrolled (int);
+		void PrefetchPages ();
+
 		void AddBookmark ();
 	private slots:
 		void scheduleSaveState ();
@@ -0,0 +1,71 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <QFuture>
+#include <QString>
+#include <QVector>
+#include <QtPlugin>
+#include "coords.h"
+
+namespace LC
+{
+namespace Monocle
+{
+	/** @brief The text of a page along with the positions of its glyphs.
+	 */
+	struct PageTextLayout
+	{
+		/** @brief The text of the page in the reading order.
+		 *
+		 * The words should be separated by spaces.
+		 */
+		QString Text_;
+
+		/** @brief The bounding boxes of the characters of the Text_.
+		 *
+		 * This vector should contain exactly one element for each
+		 * character of the Text_. The characters not corresponding to any
+		 * glyph on the page, like the spaces between the words, should
+		 * have null boxes.
+		 */
+		QVector<PageRelativeRectBase> CharBoxes_;
+	};
+
+	/** @brief Interface for documents providing their text layout.
+	 *
+	 * This interface should be implemented by the documents that can
+	 * return the text of a page along with the positions of each glyph.
+	 * Monocle uses this to build a full text index of the document in
+	 * the background, so that searching for text doesn't require
+	 * extracting the text anew for each query.
+	 *
+	 * @sa ISearchableDocument
+	 */
+	class IHaveTextLayout
+	{
+	public:
+		virtual ~IHaveTextLayout () {}
+
+		/** @brief Returns the text layout of the given \em page.
+		 *
+		 * The text should be extracted asynchronously, preferably
+		 * without blocking the rendering of the document. The returned
+		 * future may outlive the document.
+		 *
+		 * @param[in] page The index of the page to query.
+		 * @return The future with the layout of the \em page.
+		 */
+		virtual QFuture<PageTextLayout> GetTextLayout (int page) = 0;
+	};
+}
+}
+
+Q_DECLARE_INTERFACE (LC::Monocle::IHaveTextLayout,
+		"org.LeechCraft.Monocle.IHaveTextLayout/1.0")
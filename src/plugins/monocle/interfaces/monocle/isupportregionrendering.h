@@ -0,0 +1,64 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <QFuture>
+#include <QImage>
+#include <QtPlugin>
+
+class QRect;
+
+namespace LC
+{
+namespace Monocle
+{
+	/** @brief Interface for documents able to render parts of pages.
+	 *
+	 * This interface should be implemented by IDocument objects that can
+	 * render an arbitrary rectangle of a page without rendering the whole
+	 * page. This allows Monocle to render only the visible parts of the
+	 * pages at high zoom levels.
+	 *
+	 * The documents not implementing this interface are rendered as a
+	 * whole via IDocument::RenderPage().
+	 *
+	 * @sa IDocument
+	 */
+	class ISupportRegionRendering
+	{
+	public:
+		virtual ~ISupportRegionRendering () {}
+
+		/** @brief Renders the given \em region of the given \em page.
+		 *
+		 * The \em region is in the coordinates of the page rendered at
+		 * the given scale, that is, rendering the full region of
+		 * \code
+			QRect { { 0, 0 }, GetPageSize (page) * scale }
+		   \endcode
+		 * should give the same image as IDocument::RenderPage().
+		 *
+		 * The returned image should be of the size of the \em region.
+		 *
+		 * This function should be thread-safe.
+		 *
+		 * @param[in] page The index of the page to render.
+		 * @param[in] xScale The scale of the <em>x</em> axis.
+		 * @param[in] yScale The scale of the <em>y</em> axis.
+		 * @param[in] region The region of the scaled page to render.
+		 * @return The rendering of the \em region.
+		 */
+		virtual QFuture<QImage> RenderPageRegion (int page,
+				double xScale, double yScale, const QRect& region) = 0;
+	};
+}
+}
+
+Q_DECLARE_INTERFACE (LC::Monocle::ISupportRegionRendering,
+		"org.LeechCraft.Monocle.ISupportRegionRendering/1.0")
@@ -139,6 +139,18 @@ namespace LC::Monocle
 		tab->SetDoc (e.Entity_.toUrl ().toLocalFile ());
 	}
 
+	QList<EntityCapability> Plugin::GetEntityCapabilities () const
+	{
+		EntityCapability cap;
+		cap.RequiredParameters_ = FromUserInitiated;
+		cap.NeedsQuery_ = true;
+		cap.Predicate_ = [] (const Entity& e)
+		{
+			return e.Entity_.canConvert<QUrl> () && e.Entity_.toUrl ().scheme () == "file"_qs;
+		};
+		return { cap };
+	}
+
 	Util::XmlSettingsDialog_ptr Plugin::GetSettingsDialog () const
 	{
 		return XSD_;
@@ -14,6 +14,7 @@
 #include <interfaces/ipluginready.h>
 #include <interfaces/ihaverecoverabletabs.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/ihavesettings.h>
 #include <interfaces/ihaveshortcuts.h>
 
@@ -29,6 +30,7 @@ namespace LC::Monocle
 	class Plugin : public QObject
 					, public IInfo
 					, public IEntityHandler
+					, public IHaveEntityCapabilities
 					, public IHaveSettings
 					, public IHaveTabs
 					, public IPluginReady
@@ -38,6 +40,7 @@ namespace LC::Monocle
 		Q_OBJECT
 		Q_INTERFACES (IInfo
 				IEntityHandler
+				IHaveEntityCapabilities
 				IHaveSettings
 				IHaveTabs
 				IPluginReady
@@ -67,6 +70,8 @@ namespace LC::Monocle
 		EntityTestHandleResult CouldHandle (const Entity&) const override;
 		void Handle (Entity) override;
 
+		QList<EntityCapability> GetEntityCapabilities () const override;
+
 		Util::XmlSettingsDialog_ptr GetSettingsDialog () const override;
 
 		TabClasses_t GetTabClasses () const override;
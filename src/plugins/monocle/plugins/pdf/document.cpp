@@ -33,6 +33,7 @@ namespace LC::Monocle::PDF
 	: PDocument_ (Poppler::Document::load (path))
 	, DocURL_ (QUrl::fromLocalFile (path))
 	, Plugin_ (plugin)
+	, TextDocument_ (new TextDocument { path })
 	{
 		if (!PDocument_)
 			return;
@@ -112,6 +113,19 @@ namespace LC::Monocle::PDF
 		return QtConcurrent::run ([=] { return page->renderToImage (DPI * xScale, DPI * yScale); });
 	}
 
+	QFuture<QImage> Document::RenderPageRegion (int num, double xScale, double yScale, const QRect& region)
+	{
+		const std::shared_ptr<Poppler::Page> page (PDocument_->page (num));
+		if (!page)
+			return Util::MakeReadyFuture (QImage {});
+
+		return QtConcurrent::run ([=]
+				{
+					return page->renderToImage (DPI * xScale, DPI * yScale,
+							region.x (), region.y (), region.width (), region.height ());
+				});
+	}
+
 	QList<ILink_ptr> Document::GetPageLinks (int num)
 	{
 		QList<ILink_ptr> result;
@@ -153,6 +167,52 @@ namespace LC::Monocle::PDF
 		return page->text ({ r.x () * w, r.y () * h, r.width () * w, r.height () * h });
 	}
 
+	QFuture<PageTextLayout> Document::GetTextLayout (int num)
+	{
+		return QtConcurrent::run ([textDoc = TextDocument_, num]
+				{
+					QMutexLocker locker { &textDoc->Mutex_ };
+
+					if (!textDoc->IsLoaded_)
+					{
+						textDoc->Doc_.reset (Poppler::Document::load (textDoc->Path_));
+						textDoc->IsLoaded_ = true;
+					}
+
+					const auto& doc = textDoc->Doc_;
+					if (!doc)
+						return PageTextLayout {};
+
+					std::unique_ptr<Poppler::Page> page { doc->page (num) };
+					if (!page)
+						return PageTextLayout {};
+
+					const auto& size = page->pageSizeF ();
+					const auto scaleMat = QMatrix {}.scale (1 / size.width (), 1 / size.height ());
+
+					PageTextLayout result;
+					const auto& boxes = page->textList ();
+					for (const auto box : boxes)
+					{
+						const auto& text = box->text ();
+						for (int i = 0; i < text.size (); ++i)
+						{
+							result.Text_ += text [i];
+							result.CharBoxes_ << PageRelativeRectBase { scaleMat.mapRect (box->charBoundingBox (i)) };
+						}
+
+						if (box->hasSpaceAfter () || !box->nextWord ())
+						{
+							result.Text_ += ' ';
+							result.CharBoxes_ << PageRelativeRectBase {};
+						}
+					}
+					qDeleteAll (boxes);
+
+					return result;
+				});
+	}
+
 	QAbstractItemModel* Document::GetOptContentModel ()
 	{
 		return PDocument_->hasOptionalContent () ?
@@ -11,15 +11,18 @@
 #include <memory>
 #include <QObject>
 #include <QUrl>
+#include <QMutex>
 #include <interfaces/monocle/idocument.h>
 #include <interfaces/monocle/ihavetoc.h>
 #include <interfaces/monocle/ihavetextcontent.h>
+#include <interfaces/monocle/ihavetextlayout.h>
 #include <interfaces/monocle/ihavefontinfo.h>
 #include <interfaces/monocle/isupportannotations.h>
 #include <interfaces/monocle/isupportforms.h>
 #include <interfaces/monocle/isearchabledocument.h>
 #include <interfaces/monocle/isaveabledocument.h>
 #include <interfaces/monocle/isupportpainting.h>
+#include <interfaces/monocle/isupportregionrendering.h>
 #include <interfaces/monocle/ihaveoptionalcontent.h>
 #include <util/monocle/documentsignals.h>
 
@@ -36,11 +39,13 @@ namespace LC::Monocle::PDF
 				   , public IDocument
 				   , public IHaveTOC
 				   , public IHaveTextContent
+				   , public IHaveTextLayout
 				   , public IHaveOptionalContent
 				   , public IHaveFontInfo
 				   , public ISupportAnnotations
 				   , public ISupportForms
 				   , public ISupportPainting
+				   , public ISupportRegionRendering
 				   , public ISearchableDocument
 				   , public ISaveableDocument
 	{
@@ -48,11 +53,13 @@ namespace LC::Monocle::PDF
 		Q_INTERFACES (LC::Monocle::IDocument
 				LC::Monocle::IHaveTOC
 				LC::Monocle::IHaveTextContent
+				LC::Monocle::IHaveTextLayout
 				LC::Monocle::IHaveOptionalContent
 				LC::Monocle::IHaveFontInfo
 				LC::Monocle::ISupportAnnotations
 				LC::Monocle::ISupportForms
 				LC::Monocle::ISupportPainting
+				LC::Monocle::ISupportRegionRendering
 				LC::Monocle::ISearchableDocument
 				LC::Monocle::ISaveableDocument)
 
@@ -62,6 +69,18 @@ namespace LC::Monocle::PDF
 
 		QObject *Plugin_;
 
+		// A separate document instance for extracting the text in the
+		// background, since Poppler documents aren't thread-safe. It is
+		// loaded by the first background request, not in the GUI thread.
+		struct TextDocument
+		{
+			const QString Path_;
+			QMutex Mutex_ {};
+			PDocument_ptr Doc_ {};
+			bool IsLoaded_ = false;
+		};
+		const std::shared_ptr<TextDocument> TextDocument_;
+
 		DocumentSignals Signals_;
 	public:
 		Document (const QString&, QObject*);
@@ -81,6 +100,8 @@ namespace LC::Monocle::PDF
 
 		QString GetTextContent (int, const PageRelativeRectBase&) override;
 
+		QFuture<PageTextLayout> GetTextLayout (int) override;
+
 		QAbstractItemModel* GetOptContentModel () override;
 
 		IPendingFontInfoRequest* RequestFontInfos () const override;
@@ -91,6 +112,8 @@ namespace LC::Monocle::PDF
 
 		void PaintPage (QPainter*, int, double, double) override;
 
+		QFuture<QImage> RenderPageRegion (int, double, double, const QRect&) override;
+
 		QMap<int, QList<PageRelativeRectBase>> GetTextPositions (const QString&, Qt::CaseSensitivity) override;
 
 		SaveQueryResult CanSave () const override;
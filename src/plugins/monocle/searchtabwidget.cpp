@@ -31,6 +31,10 @@ namespace LC::Monocle
 		Ui_.setupUi (this);
 		Ui_.ResultsTree_->setModel (&Model_);
 
+		connect (&handler,
+				&TextSearchHandler::searchStarted,
+				this,
+				&SearchTabWidget::HandleSearchStarted);
 		connect (&handler,
 				&TextSearchHandler::gotSearchResults,
 				this,
@@ -45,6 +49,12 @@ namespace LC::Monocle
 	{
 		Model_.clear ();
 		Root2Results_.clear ();
+		CurrentRoot_ = nullptr;
+	}
+
+	void SearchTabWidget::HandleSearchStarted ()
+	{
+		CurrentRoot_ = nullptr;
 	}
 
 	void SearchTabWidget::AddSearchResults (const TextSearchHandlerResults& results)
@@ -53,8 +63,14 @@ namespace LC::Monocle
 				[] (const auto& list) { return list.isEmpty (); }))
 			return;
 
-		QList<QStandardItem*> pageItems;
+		// The results of a search arrive in the order of the pages, so the
+		// results of each part just continue the ones already shown.
 		int globalPosIdx = 0;
+		if (CurrentRoot_)
+			for (const auto& list : Root2Results_ [CurrentRoot_].Positions_)
+				globalPosIdx += list.size ();
+
+		QList<QStandardItem*> pageItems;
 		for (const auto& [pageNum, posList] : Util::Stlize (results.Positions_))
 		{
 			if (posList.isEmpty ())
@@ -77,14 +93,21 @@ namespace LC::Monocle
 		if (pageItems.isEmpty ())
 			return;
 
-		const auto searchItem = new QStandardItem { results.Text_ };
-		searchItem->appendRows (pageItems);
-		searchItem->setEditable (false);
+		if (!CurrentRoot_)
+		{
+			CurrentRoot_ = new QStandardItem { results.Text_ };
+			CurrentRoot_->setEditable (false);
+			Root2Results_ [CurrentRoot_] = { results.Text_, results.FindFlags_, {} };
+			Model_.insertRow (0, CurrentRoot_);
+		}
+
+		CurrentRoot_->appendRows (pageItems);
 
-		Root2Results_ [searchItem] = results;
+		auto& positions = Root2Results_ [CurrentRoot_].Positions_;
+		for (const auto& [pageNum, posList] : Util::Stlize (results.Positions_))
+			positions [pageNum] += posList;
 
-		Model_.insertRow (0, searchItem);
-		Ui_.ResultsTree_->expand (searchItem->index ());
+		Ui_.ResultsTree_->expand (CurrentRoot_->index ());
 	}
 
 	namespace
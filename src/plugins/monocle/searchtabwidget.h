@@ -30,11 +30,15 @@ namespace LC::Monocle
 		TextSearchHandler& SearchHandler_;
 
 		QMap<QStandardItem*, TextSearchHandlerResults> Root2Results_;
+
+		// The root item of the search whose results are still arriving.
+		QStandardItem *CurrentRoot_ = nullptr;
 	public:
 		explicit SearchTabWidget (TextSearchHandler&, QWidget* = nullptr);
 
 		void Reset ();
 	private:
+		void HandleSearchStarted ();
 		void AddSearchResults (const TextSearchHandlerResults&);
 		void SetResultsFromHistory (const QModelIndex&);
 	};
@@ -11,20 +11,35 @@
 #include <QPen>
 #include <QtDebug>
 #include <util/sll/qtutil.h>
+#include "interfaces/monocle/ihavetextlayout.h"
 #include "interfaces/monocle/isearchabledocument.h"
 #include "components/layout/positions.h"
+#include "components/services/textindex.h"
 #include "components/viewitems/pagegraphicsitem.h"
 
 namespace LC::Monocle
 {
+	TextSearchHandler::~TextSearchHandler () = default;
+
 	void TextSearchHandler::HandleDoc (IDocument& doc, const QVector<PageGraphicsItem*>& pages)
 	{
 		CurrentHighlights_.clear ();
 		CurrentRectIndex_ = -1;
 		CurrentSearchString_.clear ();
+		SearchedPages_ = -1;
 		Pages_ = pages;
 
 		SearchableDoc_ = qobject_cast<ISearchableDocument*> (doc.GetQObject ());
+
+		Index_.reset ();
+		if (const auto layout = qobject_cast<IHaveTextLayout*> (doc.GetQObject ()))
+		{
+			Index_ = std::make_unique<TextIndex> (doc, *layout);
+			connect (Index_.get (),
+					&TextIndex::pagesIndexed,
+					this,
+					&TextSearchHandler::ContinueSearch);
+		}
 	}
 
 	bool TextSearchHandler::Search (const QString& text, Util::FindNotification::FindFlags flags)
@@ -72,6 +87,8 @@ namespace LC::Monocle
 		{
 			ClearHighlights ();
 			CurrentSearchString_ = results.Text_;
+			CurrentFindFlags_ = results.FindFlags_;
+			SearchedPages_ = -1;
 			BuildHighlights (results.Positions_);
 		}
 
@@ -86,6 +103,19 @@ namespace LC::Monocle
 			return false;
 
 		CurrentSearchString_ = text;
+		CurrentFindFlags_ = flags;
+		CurrentRectIndex_ = -1;
+		emit searchStarted (text, flags);
+
+		if (Index_)
+		{
+			SearchedPages_ = 0;
+			ContinueSearch ();
+
+			// There still might be something on the pages not indexed yet.
+			return !CurrentHighlights_.isEmpty () || !Index_->IsComplete ();
+		}
+
 		const auto cs = flags & Util::FindNotification::FindCaseSensitively ?
 				Qt::CaseSensitive :
 				Qt::CaseInsensitive;
@@ -100,6 +130,32 @@ namespace LC::Monocle
 		return !CurrentHighlights_.isEmpty ();
 	}
 
+	void TextSearchHandler::ContinueSearch ()
+	{
+		if (SearchedPages_ < 0 || !Index_)
+			return;
+
+		const auto cs = CurrentFindFlags_ & Util::FindNotification::FindCaseSensitively ?
+				Qt::CaseSensitive :
+				Qt::CaseInsensitive;
+
+		QMap<int, QList<PageRelativeRectBase>> map;
+		for (const auto indexed = Index_->GetIndexedPagesCount (); SearchedPages_ < indexed; ++SearchedPages_)
+			if (const auto& rects = Index_->Search (SearchedPages_, CurrentSearchString_, cs);
+					!rects.isEmpty ())
+				map [SearchedPages_] = rects;
+
+		if (map.isEmpty ())
+			return;
+
+		emit gotSearchResults ({ CurrentSearchString_, CurrentFindFlags_, map });
+
+		BuildHighlights (map);
+
+		if (CurrentRectIndex_ < 0)
+			SelectItem (0);
+	}
+
 	namespace
 	{
 		constexpr double InactiveOpacity = 0.2;
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <memory>
 #include <QObject>
 #include <QMap>
 #include <util/gui/findnotification.h>
@@ -19,6 +20,7 @@ namespace LC::Monocle
 {
 	class ISearchableDocument;
 	class PageGraphicsItem;
+	class TextIndex;
 
 	struct TextSearchHandlerResults
 	{
@@ -31,10 +33,17 @@ namespace LC::Monocle
 	{
 		Q_OBJECT
 
-		ISearchableDocument *SearchableDoc_;
+		ISearchableDocument *SearchableDoc_ = nullptr;
 		QVector<PageGraphicsItem*> Pages_;
 
+		std::unique_ptr<TextIndex> Index_;
+
 		QString CurrentSearchString_;
+		Util::FindNotification::FindFlags CurrentFindFlags_;
+
+		// The number of the indexed pages the current search has been
+		// run over, or -1 if there is no search in progress.
+		int SearchedPages_ = -1;
 
 		struct Highlight
 		{
@@ -47,6 +56,7 @@ namespace LC::Monocle
 		int CurrentRectIndex_ = -1;
 	public:
 		using QObject::QObject;
+		~TextSearchHandler () override;
 
 		void HandleDoc (IDocument&, const QVector<PageGraphicsItem*>&);
 
@@ -54,6 +64,7 @@ namespace LC::Monocle
 		void SetPreparedResults (const TextSearchHandlerResults&, int selectedItem);
 	private:
 		bool RequestSearch (const QString&, Util::FindNotification::FindFlags);
+		void ContinueSearch ();
 
 		void BuildHighlights (const QMap<int, QList<PageRelativeRectBase>>&);
 		void ClearHighlights ();
@@ -62,6 +73,14 @@ namespace LC::Monocle
 	signals:
 		void navigateRequested (const NavigationAction&);
 
+		/** Emitted when a new search for \em text has been started.
+		 */
+		void searchStarted (const QString& text, Util::FindNotification::FindFlags);
+
+		/** Emitted with the results for some more pages of the current
+		 * search. The results for a search might be delivered in several
+		 * parts as the text index of the document is being built.
+		 */
 		void gotSearchResults (const TextSearchHandlerResults&);
 	};
 }
@@ -45,8 +45,7 @@ namespace LC::Monocle
 		Pages_.reserve (numPages);
 		for (int i = 0; i < numPages; ++i)
 		{
-			auto item = new PageGraphicsItem { doc, i };
-			PxCache_.RegisterPage (*item);
+			auto item = new PageGraphicsItem { doc, i, PxCache_ };
 			Scene_.addItem (item);
 			item->SetReleaseHandler ([this] (int page, auto&&) { emit pageClicked (page); });
 			Pages_ << item;
@@ -17,6 +17,7 @@
 #endif
 
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/ihavesettings.h>
 
 namespace LC
@@ -30,12 +31,13 @@ namespace Otlozhu
 					, public IHaveTabs
 					, public IHaveSettings
 					, public IEntityHandler
+					, public IHaveEntityCapabilities
 #ifdef ENABLE_SYNC
 					, public ISyncable
 #endif
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IHaveTabs IEntityHandler IHaveSettings)
+		Q_INTERFACES (IInfo IHaveTabs IEntityHandler IHaveEntityCapabilities IHaveSettings)
 #ifdef ENABLE_SYNC
 		Q_INTERFACES (ISyncable)
 #endif
@@ -64,6 +66,8 @@ namespace Otlozhu
 		EntityTestHandleResult CouldHandle (const Entity&) const;
 		void Handle (Entity);
 
+		QList<EntityCapability> GetEntityCapabilities () const;
+
 		Util::XmlSettingsDialog_ptr GetSettingsDialog () const;
 
 #ifdef ENABLE_SYNC
@@ -102,6 +102,16 @@ namespace Otzerkalu
 		dl->Begin ();
 	}
 
+	QList<EntityCapability> Plugin::GetEntityCapabilities () const
+	{
+		EntityCapability cap;
+		cap.RequiredFields_ = QStringList { "AllowedSemantics" };
+		cap.RequiredParameters_ = FromUserInitiated;
+		cap.Priority_ = EntityTestHandleResult::PHigh;
+		cap.Predicate_ = [this] (const Entity& e) { return CouldHandle (e).HandlePriority_ > 0; };
+		return { cap };
+	}
+
 	QAbstractItemModel* Plugin::GetRepresentation () const
 	{
 		return RepresentationModel_;
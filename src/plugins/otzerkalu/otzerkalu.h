@@ -14,6 +14,7 @@
 #include <QStandardItemModel>
 #include <interfaces/iinfo.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/structures.h>
 #include <interfaces/ijobholder.h>
 #include "otzerkaludownloader.h"
@@ -25,10 +26,11 @@ namespace Otzerkalu
 	class Plugin : public QObject
 				 , public IInfo
 				 , public IEntityHandler
+				 , public IHaveEntityCapabilities
 				 , public IJobHolder
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IEntityHandler IJobHolder)
+		Q_INTERFACES (IInfo IEntityHandler IHaveEntityCapabilities IJobHolder)
 
 		LC_PLUGIN_METADATA ("org.LeechCraft.Otzerkalu")
 
@@ -44,6 +46,8 @@ namespace Otzerkalu
 		QIcon GetIcon () const override;
 		EntityTestHandleResult CouldHandle (const Entity& entity) const override;
 		void Handle (Entity entity) override;
+
+		QList<EntityCapability> GetEntityCapabilities () const override;
 		QAbstractItemModel* GetRepresentation () const override;
 	};
 }
@@ -85,6 +85,15 @@ namespace Pogooglue
 		GoogleIt (str);
 	}
 
+	QList<EntityCapability> Plugin::GetEntityCapabilities () const
+	{
+		EntityCapability cap;
+		cap.Mimes_ = QStringList { "x-leechcraft/data-filter-request" };
+		cap.Priority_ = EntityTestHandleResult::PIdeal;
+		cap.Predicate_ = [this] (const Entity& e) { return CouldHandle (e).HandlePriority_ > 0; };
+		return { cap };
+	}
+
 	QString Plugin::GetFilterVerb () const
 	{
 		return tr ("Google it!");
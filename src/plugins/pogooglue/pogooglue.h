@@ -12,6 +12,7 @@
 #include <QObject>
 #include <interfaces/iinfo.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/idatafilter.h>
 
 namespace LC
@@ -21,10 +22,11 @@ namespace Pogooglue
 	class Plugin : public QObject
 				 , public IInfo
 				 , public IEntityHandler
+				 , public IHaveEntityCapabilities
 				 , public IDataFilter
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IEntityHandler IDataFilter)
+		Q_INTERFACES (IInfo IEntityHandler IHaveEntityCapabilities IDataFilter)
 
 		LC_PLUGIN_METADATA ("org.LeechCraft.Pogooglue")
 
@@ -41,6 +43,8 @@ namespace Pogooglue
 		EntityTestHandleResult CouldHandle (const Entity& entity) const;
 		void Handle (Entity entity);
 
+		QList<EntityCapability> GetEntityCapabilities () const;
+
 		QString GetFilterVerb () const;
 		QList<FilterVariant> GetFilterVariants (const QVariant&) const;
 	private:
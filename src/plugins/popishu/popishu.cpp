@@ -106,6 +106,15 @@ namespace Popishu
 		AnnouncePage (page);
 	}
 
+	QList<EntityCapability> Plugin::GetEntityCapabilities () const
+	{
+		EntityCapability cap;
+		cap.Mimes_ = QStringList { "x-leechcraft/plain-text-document" };
+		cap.Predicate_ = [] (const Entity& e) { return e.Entity_.canConvert<QString> (); };
+		cap.Priority_ = EntityTestHandleResult::PIdeal;
+		return { cap };
+	}
+
 	std::shared_ptr<Util::XmlSettingsDialog> Plugin::GetSettingsDialog () const
 	{
 		return XmlSettingsDialog_;
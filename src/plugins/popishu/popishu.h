@@ -12,6 +12,7 @@
 #include <interfaces/iinfo.h>
 #include <interfaces/ihavetabs.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/ihavesettings.h>
 #include <interfaces/ihaverecoverabletabs.h>
 
@@ -27,11 +28,12 @@ namespace Popishu
 				 , public IInfo
 				 , public IHaveTabs
 				 , public IEntityHandler
+				 , public IHaveEntityCapabilities
 				 , public IHaveSettings
 				 , public IHaveRecoverableTabs
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IHaveTabs IEntityHandler IHaveSettings IHaveRecoverableTabs)
+		Q_INTERFACES (IInfo IHaveTabs IEntityHandler IHaveEntityCapabilities IHaveSettings IHaveRecoverableTabs)
 
 		LC_PLUGIN_METADATA ("org.LeechCraft.Popishu")
 
@@ -53,6 +55,8 @@ namespace Popishu
 		EntityTestHandleResult CouldHandle (const Entity&) const override;
 		void Handle (Entity) override;
 
+		QList<EntityCapability> GetEntityCapabilities () const override;
+
 		std::shared_ptr<Util::XmlSettingsDialog> GetSettingsDialog () const override;
 
 		void RecoverTabs (const QList<TabRecoverInfo>&) override;
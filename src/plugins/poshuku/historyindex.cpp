@@ -0,0 +1,352 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "historyindex.h"
+#include <algorithm>
+#include <cmath>
+#include <QStringList>
+
+namespace LC
+{
+namespace Poshuku
+{
+	namespace
+	{
+		// Longer words are mostly hashes and IDs, not worth indexing fully.
+		constexpr int MaxTokenLength = 64;
+
+		// 2020-01-01, the point in time the logarithmic scores are relative to.
+		constexpr qint64 ScoreEpoch = 1577836800;
+
+		QStringList Tokenize (const QString& text)
+		{
+			QStringList result;
+
+			const auto size = text.size ();
+			for (int pos = 0; pos < size; )
+			{
+				if (!text.at (pos).isLetterOrNumber ())
+				{
+					++pos;
+					continue;
+				}
+
+				const auto start = pos;
+				while (pos < size && text.at (pos).isLetterOrNumber ())
+					++pos;
+				result << text.mid (start, std::min (pos - start, MaxTokenLength)).toLower ();
+			}
+
+			return result;
+		}
+
+		quint64 GetTrigram (const QString& text, int pos)
+		{
+			return (static_cast<quint64> (text.at (pos).unicode ()) << 32) |
+					(static_cast<quint64> (text.at (pos + 1).unicode ()) << 16) |
+					text.at (pos + 2).unicode ();
+		}
+
+		double GetVisitScore (qint64 visit)
+		{
+			return (visit - ScoreEpoch) / 86400.;
+		}
+
+		// log (exp (left) + exp (right)) without overflowing.
+		double AddScores (double left, double right)
+		{
+			if (left < right)
+				std::swap (left, right);
+			if (std::isinf (right))
+				return left;
+			return left + std::log1p (std::exp (right - left));
+		}
+
+		double GetScore (const QVector<qint64>& visits)
+		{
+			auto result = -std::numeric_limits<double>::infinity ();
+			for (const auto visit : visits)
+				result = AddScores (result, GetVisitScore (visit));
+			return result;
+		}
+	}
+
+	void HistoryIndex::Add (const HistoryItem& item)
+	{
+		QWriteLocker locker { &Lock_ };
+		AddLocked (item);
+	}
+
+	void HistoryIndex::Add (const history_items_t& items)
+	{
+		QWriteLocker locker { &Lock_ };
+		for (const auto& item : items)
+			AddLocked (item);
+	}
+
+	void HistoryIndex::RemoveOlderThan (const QDateTime& threshold)
+	{
+		const auto minVisit = threshold.toSecsSinceEpoch ();
+
+		QWriteLocker locker { &Lock_ };
+		MinVisit_ = std::max (MinVisit_, minVisit);
+
+		for (auto& entry : Entries_)
+		{
+			if (entry.IsRemoved_ || entry.Visits_.front () >= minVisit)
+				continue;
+
+			auto& visits = entry.Visits_;
+			visits.erase (visits.begin (), std::lower_bound (visits.begin (), visits.end (), minVisit));
+			if (!visits.isEmpty ())
+			{
+				entry.LogScore_ = GetScore (visits);
+				continue;
+			}
+
+			URL2Entry_.remove (entry.URL_);
+			entry = Entry { {}, {}, {}, 0, true };
+			++RemovedCount_;
+		}
+
+		if (RemovedCount_ > 1024 && RemovedCount_ > static_cast<int> (Entries_.size ()) / 4)
+			Compact ();
+	}
+
+	void HistoryIndex::SetReady ()
+	{
+		QWriteLocker locker { &Lock_ };
+		IsReady_ = true;
+	}
+
+	bool HistoryIndex::IsReady () const
+	{
+		QReadLocker locker { &Lock_ };
+		return IsReady_;
+	}
+
+	int HistoryIndex::GetURLsCount () const
+	{
+		QReadLocker locker { &Lock_ };
+		return URL2Entry_.size ();
+	}
+
+	history_items_t HistoryIndex::Find (const QString& base, int limit, const std::atomic_bool *cancelled) const
+	{
+		const auto isCancelled = [cancelled] { return cancelled && *cancelled; };
+
+		const auto& words = Tokenize (base);
+
+		QReadLocker locker { &Lock_ };
+
+		/* An entry is a candidate if each word of the base string is found
+		 * among the tokens of the entry. The candidates are collected on
+		 * the first word and then counted on the following ones.
+		 */
+		std::vector<int> candidates;
+		std::vector<quint8> matchedWords;
+		int filteringWords = 0;
+		for (int i = 0; i < words.size () && filteringWords < std::numeric_limits<quint8>::max (); ++i)
+		{
+			const auto& word = words.at (i);
+			// The tokens are truncated, so these are left to the final check.
+			if (word.size () > MaxTokenLength)
+				continue;
+
+			if (matchedWords.empty ())
+				matchedWords.resize (Entries_.size ());
+
+			const auto& tokens = i || word.size () < 3 ?
+					GetPrefixedTokens (word) :
+					GetContainingTokens (word);
+			for (const auto tokenId : tokens)
+				for (const auto entryId : Tokens_ [tokenId].Entries_)
+					if (matchedWords [entryId] == filteringWords)
+					{
+						if (!filteringWords)
+							candidates.push_back (entryId);
+						++matchedWords [entryId];
+					}
+
+			if (candidates.empty () || isCancelled ())
+				return {};
+
+			++filteringWords;
+		}
+
+		if (filteringWords)
+			candidates.erase (std::remove_if (candidates.begin (), candidates.end (),
+						[&] (int entryId) { return matchedWords [entryId] != filteringWords; }),
+					candidates.end ());
+		else
+			for (int i = 0, size = Entries_.size (); i < size; ++i)
+				if (!Entries_ [i].IsRemoved_)
+					candidates.push_back (i);
+
+		if (isCancelled ())
+			return {};
+
+		/* Only the best candidates are checked against the whole base
+		 * string, so the heap is cheaper than sorting them all.
+		 */
+		const auto byScore = [this] (int left, int right)
+		{
+			return Entries_ [left].LogScore_ < Entries_ [right].LogScore_;
+		};
+		std::make_heap (candidates.begin (), candidates.end (), byScore);
+
+		history_items_t result;
+		int checked = 0;
+		for (auto end = candidates.end ();
+				end != candidates.begin () && (limit < 0 || result.size () < limit);
+				--end)
+		{
+			if (!(++checked % 1024) && isCancelled ())
+				return {};
+
+			std::pop_heap (candidates.begin (), end, byScore);
+
+			const auto& entry = Entries_ [*(end - 1)];
+			if (entry.IsRemoved_ ||
+					!(entry.URL_.contains (base, Qt::CaseInsensitive) ||
+						entry.Title_.contains (base, Qt::CaseInsensitive)))
+				continue;
+
+			result.push_back ({ entry.Title_, {}, entry.URL_ });
+		}
+		return result;
+	}
+
+	void HistoryIndex::AddLocked (const HistoryItem& item)
+	{
+		if (item.URL_.startsWith ("data:"))
+			return;
+
+		const auto visit = item.DateTime_.toSecsSinceEpoch ();
+		if (visit < MinVisit_)
+			return;
+
+		const auto pos = URL2Entry_.find (item.URL_);
+		if (pos == URL2Entry_.end ())
+		{
+			const int entryId = Entries_.size ();
+			Entries_.push_back ({ item.URL_, item.Title_, { visit }, GetVisitScore (visit) });
+			URL2Entry_ [item.URL_] = entryId;
+			IndexText (entryId, item.URL_);
+			IndexText (entryId, item.Title_);
+			return;
+		}
+
+		const auto entryId = *pos;
+		auto& entry = Entries_ [entryId];
+		auto& visits = entry.Visits_;
+
+		// The history is keyed by the time of the visit.
+		const auto visitPos = std::lower_bound (visits.begin (), visits.end (), visit);
+		if (visitPos != visits.end () && *visitPos == visit)
+			return;
+
+		const bool isLatest = visitPos == visits.end ();
+		visits.insert (visitPos, visit);
+		entry.LogScore_ = AddScores (entry.LogScore_, GetVisitScore (visit));
+
+		// The tokens of the previous title are filtered out by Find() later.
+		if (isLatest && entry.Title_ != item.Title_)
+		{
+			entry.Title_ = item.Title_;
+			IndexText (entryId, item.Title_);
+		}
+	}
+
+	void HistoryIndex::IndexText (int entryId, const QString& text)
+	{
+		for (const auto& token : Tokenize (text))
+		{
+			const auto tokenId = GetTokenId (token);
+			auto& entries = Tokens_ [tokenId].Entries_;
+			if (entries.empty () || entries.back () != entryId)
+				entries.push_back (entryId);
+		}
+	}
+
+	int HistoryIndex::GetTokenId (const QString& text)
+	{
+		if (const auto pos = Text2Token_.find (text); pos != Text2Token_.end ())
+			return *pos;
+
+		const int tokenId = Tokens_.size ();
+		Tokens_.push_back ({ text, {} });
+		Text2Token_ [text] = tokenId;
+		SortedTokens_ [text] = tokenId;
+
+		for (int i = 0; i + 3 <= text.size (); ++i)
+		{
+			auto& tokens = Trigram2Tokens_ [GetTrigram (text, i)];
+			if (tokens.empty () || tokens.back () != tokenId)
+				tokens.push_back (tokenId);
+		}
+
+		return tokenId;
+	}
+
+	std::vector<int> HistoryIndex::GetContainingTokens (const QString& word) const
+	{
+		const std::vector<int> *rarest = nullptr;
+		for (int i = 0; i + 3 <= word.size (); ++i)
+		{
+			const auto pos = Trigram2Tokens_.find (GetTrigram (word, i));
+			if (pos == Trigram2Tokens_.end ())
+				return {};
+
+			if (!rarest || pos->size () < rarest->size ())
+				rarest = &*pos;
+		}
+
+		std::vector<int> result;
+		for (const auto tokenId : *rarest)
+			if (Tokens_ [tokenId].Text_.contains (word))
+				result.push_back (tokenId);
+		return result;
+	}
+
+	std::vector<int> HistoryIndex::GetPrefixedTokens (const QString& word) const
+	{
+		std::vector<int> result;
+		for (auto it = SortedTokens_.lowerBound (word);
+				it != SortedTokens_.end () && it.key ().startsWith (word);
+				++it)
+			result.push_back (*it);
+		return result;
+	}
+
+	void HistoryIndex::Compact ()
+	{
+		auto entries = std::move (Entries_);
+
+		Entries_.clear ();
+		URL2Entry_.clear ();
+		RemovedCount_ = 0;
+		Tokens_.clear ();
+		Text2Token_.clear ();
+		SortedTokens_.clear ();
+		Trigram2Tokens_.clear ();
+
+		for (auto& entry : entries)
+		{
+			if (entry.IsRemoved_)
+				continue;
+
+			const int entryId = Entries_.size ();
+			URL2Entry_ [entry.URL_] = entryId;
+			Entries_.push_back (std::move (entry));
+			IndexText (entryId, Entries_.back ().URL_);
+			IndexText (entryId, Entries_.back ().Title_);
+		}
+	}
+}
+}
@@ -0,0 +1,119 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <limits>
+#include <vector>
+#include <QHash>
+#include <QMap>
+#include <QReadWriteLock>
+#include <QVector>
+#include "interfaces/poshuku/poshukutypes.h"
+
+namespace LC
+{
+namespace Poshuku
+{
+	/** @brief In-memory index of the history for the URL completion.
+	 *
+	 * The index keeps a single entry per URL along with the times of all
+	 * its visits. The URLs and the titles are split into lowercase words,
+	 * and the words are indexed by their trigrams, so that the entries
+	 * resembling a string are found without looking at all the others.
+	 *
+	 * The entries are ranked by their frecency: each visit contributes
+	 * exp (-age / 1 day) to the score of its entry. The logarithm of the
+	 * score relative to a fixed point in time is kept instead, so that
+	 * the scores don't need to be updated as the time goes on.
+	 *
+	 * All the methods are thread-safe.
+	 */
+	class Q_DECL_EXPORT HistoryIndex
+	{
+		struct Entry
+		{
+			QString URL_;
+			QString Title_;
+			QVector<qint64> Visits_;
+			double LogScore_;
+			bool IsRemoved_ = false;
+		};
+		std::vector<Entry> Entries_;
+		QHash<QString, int> URL2Entry_;
+		int RemovedCount_ = 0;
+
+		struct Token
+		{
+			QString Text_;
+			std::vector<int> Entries_;
+		};
+		std::vector<Token> Tokens_;
+		QHash<QString, int> Text2Token_;
+		QMap<QString, int> SortedTokens_;
+		QHash<quint64, std::vector<int>> Trigram2Tokens_;
+
+		qint64 MinVisit_ = std::numeric_limits<qint64>::min ();
+		bool IsReady_ = false;
+
+		mutable QReadWriteLock Lock_;
+	public:
+		/** Adds a visit of the \em item URL, keeping the title of the
+		 * latest visit. The URLs of the data: scheme are ignored, as
+		 * well as the visits already known to the index.
+		 */
+		void Add (const HistoryItem& item);
+
+		/** Adds all the visits in the \em items at once.
+		 */
+		void Add (const history_items_t& items);
+
+		/** Removes the visits older than the \em threshold along with
+		 * the URLs that have no visits left. The visits older than the
+		 * \em threshold that are added later are ignored as well.
+		 */
+		void RemoveOlderThan (const QDateTime& threshold);
+
+		/** Marks the index as containing the whole history.
+		 */
+		void SetReady ();
+
+		/** Returns whether the index contains the whole history.
+		 */
+		bool IsReady () const;
+
+		/** Returns the number of distinct URLs in the index.
+		 */
+		int GetURLsCount () const;
+
+		/** Returns up to \em limit URLs whose title or URL contains the
+		 * \em base string, case-insensitively, sorted by frecency in
+		 * descending order. All such URLs are returned if the \em limit
+		 * is negative.
+		 *
+		 * If the \em base string consists of several words, each of
+		 * the following words has to start a word in the title or the
+		 * URL, as well as the first one if it is shorter than three
+		 * characters.
+		 *
+		 * The search is aborted with an empty result as soon as the
+		 * \em cancelled flag is set.
+		 */
+		history_items_t Find (const QString& base, int limit,
+				const std::atomic_bool *cancelled = nullptr) const;
+	private:
+		void AddLocked (const HistoryItem&);
+		void IndexText (int, const QString&);
+		int GetTokenId (const QString&);
+		std::vector<int> GetContainingTokens (const QString&) const;
+		std::vector<int> GetPrefixedTokens (const QString&) const;
+		void Compact ();
+	};
+}
+}
@@ -97,6 +97,15 @@ namespace CleanWeb
 		Core_->Handle (e);
 	}
 
+	QList<EntityCapability> CleanWeb::GetEntityCapabilities () const
+	{
+		EntityCapability cap;
+		cap.Schemes_ = QStringList { "abp" };
+		cap.Priority_ = EntityTestHandleResult::PIdeal;
+		cap.Predicate_ = [] (const Entity& e) { return e.Entity_.toUrl ().path () == "subscribe"; };
+		return { cap };
+	}
+
 	QList<QWizardPage*> CleanWeb::GetWizardPages () const
 	{
 		return WizardGenerator::GetPages (Core_.get ());
@@ -16,6 +16,7 @@
 #include <interfaces/iplugin2.h>
 #include <interfaces/ihavesettings.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/istartupwizard.h>
 #include <interfaces/poshuku/poshukutypes.h>
 #include <interfaces/core/ihookproxy.h>
@@ -37,11 +38,12 @@ namespace CleanWeb
 					, public IInfo
 					, public IHaveSettings
 					, public IEntityHandler
+					, public IHaveEntityCapabilities
 					, public IStartupWizard
 					, public IPlugin2
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IHaveSettings IEntityHandler IStartupWizard IPlugin2)
+		Q_INTERFACES (IInfo IHaveSettings IEntityHandler IHaveEntityCapabilities IStartupWizard IPlugin2)
 
 		LC_PLUGIN_METADATA ("org.LeechCraft.Poshuku.CleanWeb")
 
@@ -65,6 +67,8 @@ namespace CleanWeb
 		EntityTestHandleResult CouldHandle (const Entity&) const;
 		void Handle (Entity);
 
+		QList<EntityCapability> GetEntityCapabilities () const;
+
 		QList<QWizardPage*> GetWizardPages () const;
 
 		QSet<QByteArray> GetPluginClasses () const;
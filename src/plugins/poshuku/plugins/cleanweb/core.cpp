@@ -18,7 +18,6 @@
 #include <QDir>
 #include <QCoreApplication>
 #include <QtConcurrentRun>
-#include <QtConcurrentMap>
 #include <QMenu>
 #include <QElapsedTimer>
 #include <util/xpc/util.h>
@@ -40,6 +39,7 @@
 #include "lineparser.h"
 #include "subscriptionsmodel.h"
 #include "pslhandler.h"
+#include "filterscache.h"
 
 Q_DECLARE_METATYPE (QNetworkReply*);
 
@@ -82,6 +82,30 @@ namespace CleanWeb
 			}
 			return result;
 		}
+
+		QList<Filter> LoadFilters (const QStringList& paths)
+		{
+			auto cached = LoadFiltersCache ();
+			bool changed = cached.size () != paths.size ();
+
+			QList<Filter> result;
+			for (const auto& path : paths)
+			{
+				const auto& filename = QFileInfo (path).fileName ();
+				if (cached.contains (filename))
+					result << cached.take (filename);
+				else
+				{
+					result << ParseToFilters ({ path });
+					changed = true;
+				}
+			}
+
+			if (changed)
+				SaveFiltersCache (result);
+
+			return result;
+		}
 	}
 
 	Core::Core (SubscriptionsModel *model, UserFiltersModel *ufm, const ICoreProxy_ptr& proxy)
@@ -103,7 +127,7 @@ namespace CleanWeb
 		const auto& infos = path.entryInfoList (QDir::Files | QDir::Readable);
 		const auto& paths = Util::Map (infos, &QFileInfo::absoluteFilePath);
 
-		Util::Sequence (nullptr, QtConcurrent::run (ParseToFilters, paths)) >>
+		Util::Sequence (nullptr, QtConcurrent::run (LoadFilters, paths)) >>
 				[this] (const QList<Filter>& filters)
 				{
 					SubsModel_->SetInitialFilters (filters);
@@ -163,111 +187,6 @@ namespace CleanWeb
 		}
 	}
 
-	namespace
-	{
-#if defined (Q_OS_WIN32) || defined (Q_OS_MAC)
-		// Thanks for this goes to http://www.codeproject.com/KB/string/patmatch.aspx
-		bool WildcardMatches (const char *pattern, const char *str)
-		{
-			enum State {
-				Exact,        // exact match
-				Any,        // ?
-				AnyRepeat    // *
-			};
-
-			const char *s = str;
-			const char *p = pattern;
-			const char *q = 0;
-			int state = 0;
-
-			bool match = true;
-			while (match && *p) {
-				if (*p == '*') {
-					state = AnyRepeat;
-					q = p+1;
-				} else if (*p == '?') state = Any;
-				else state = Exact;
-
-				if (*s == 0) break;
-
-				switch (state) {
-					case Exact:
-						match = *s == *p;
-						s++;
-						p++;
-						break;
-
-					case Any:
-						match = true;
-						s++;
-						p++;
-						break;
-
-					case AnyRepeat:
-						match = true;
-						s++;
-
-						if (*s == *q) p++;
-						break;
-				}
-			}
-
-			if (state == AnyRepeat) return (*s == *q);
-			else if (state == Any) return (*s == *p);
-			else return match && (*s == *p);
-		}
-#else
-#include <fnmatch.h>
-
-		bool WildcardMatches (const char *pat, const char *str)
-		{
-			return !fnmatch (pat, str, 0);
-		}
-#endif
-
-		bool Matches (const FilterItem_ptr& item,
-				const QByteArray& urlUtf8, const QString& domain)
-		{
-			const auto& opt = item->Option_;
-			if (opt.MatchObjects_ != FilterOption::MatchObject::All)
-			{
-				if (!(opt.MatchObjects_ & FilterOption::MatchObject::CSS) &&
-						!(opt.MatchObjects_ & FilterOption::MatchObject::Image) &&
-						!(opt.MatchObjects_ & FilterOption::MatchObject::Script) &&
-						!(opt.MatchObjects_ & FilterOption::MatchObject::Object) &&
-						!(opt.MatchObjects_ & FilterOption::MatchObject::ObjSubrequest))
-					return false;
-			}
-
-			if (std::any_of (opt.NotDomains_.begin (), opt.NotDomains_.end (),
-						[&domain, &opt] (const QString& notDomain)
-							{ return domain.endsWith (notDomain, opt.Case_); }))
-				return false;
-
-			if (!opt.Domains_.isEmpty () &&
-					std::none_of (opt.Domains_.begin (), opt.Domains_.end (),
-							[&domain, &opt] (const QString& doDomain)
-								{ return domain.endsWith (doDomain, opt.Case_); }))
-				return false;
-
-			switch (opt.MatchType_)
-			{
-			case FilterOption::MatchType::Regexp:
-				return item->RegExp_.Matches (urlUtf8);
-			case FilterOption::MatchType::Wildcard:
-				return WildcardMatches (item->PlainMatcher_.constData (), urlUtf8.constData ());
-			case FilterOption::MatchType::Plain:
-				return urlUtf8.indexOf (item->PlainMatcher_) >= 0;
-			case FilterOption::MatchType::Begin:
-				return urlUtf8.startsWith (item->PlainMatcher_);
-			case FilterOption::MatchType::End:
-				return urlUtf8.endsWith (item->PlainMatcher_);
-			}
-
-			return false;
-		}
-	}
-
 	namespace
 	{
 		FilterOption::MatchObjects ResourceType2Objs (IInterceptableRequests::ResourceType type)
@@ -305,8 +224,8 @@ namespace CleanWeb
 
 		struct RejectInfo
 		{
-			const QList<QList<FilterItem_ptr>>& Exceptions_;
-			const QList<QList<FilterItem_ptr>>& Filters_;
+			const RuleIndex& Exceptions_;
+			const RuleIndex& Filters_;
 
 			const PslHandler& Psl_;
 		};
@@ -332,44 +251,33 @@ namespace CleanWeb
 			const QString& domain = req.PageUrl_.host ();
 			const bool isThirdParty = !IsSameDomain (req.PageUrl_, url, info.Psl_);
 
-			auto matches = [=] (const QList<QList<FilterItem_ptr>>& chunks)
+			const auto& keys = RuleIndex::MakeKeys (urlUtf8, cinUrlUtf8, domain);
+
+			auto matches = [&] (const FilterItem& item)
 			{
-				return QtConcurrent::blockingMappedReduced (chunks.begin (), chunks.end (),
-						std::function<bool (const QList<FilterItem_ptr>&)>
-						{
-							[=] (const QList<FilterItem_ptr>& items)
-							{
-								for (const auto& item : items)
-								{
-									const auto& opt = item->Option_;
-									if (opt.ThirdParty_ != FilterOption::ThirdParty::Unspecified)
-										if ((opt.ThirdParty_ == FilterOption::ThirdParty::Yes) != isThirdParty)
-											continue;
-
-									if (opt.MatchObjects_ != FilterOption::MatchObject::All &&
-											!(objs & opt.MatchObjects_))
-										continue;
-
-									const auto& utf8 = item->Option_.Case_ == Qt::CaseSensitive ? urlUtf8 : cinUrlUtf8;
-									if (Matches (item, utf8, domain))
-									{
-										if (shouldDebug)
-											qDebug () << Q_FUNC_INFO
-													<< utf8
-													<< "matches"
-													<< *item;
-										return true;
-									}
-								}
-
-								return false;
-							}
-						},
-						+[] (bool& res, bool value) { res = res || value; });
+				const auto& opt = item.Option_;
+				if (opt.ThirdParty_ != FilterOption::ThirdParty::Unspecified)
+					if ((opt.ThirdParty_ == FilterOption::ThirdParty::Yes) != isThirdParty)
+						return false;
+
+				if (opt.MatchObjects_ != FilterOption::MatchObject::All &&
+						!(objs & opt.MatchObjects_))
+					return false;
+
+				const auto& utf8 = opt.Case_ == Qt::CaseSensitive ? urlUtf8 : cinUrlUtf8;
+				if (!Matches (item, utf8, domain))
+					return false;
+
+				if (shouldDebug)
+					qDebug () << Q_FUNC_INFO
+							<< utf8
+							<< "matches"
+							<< item;
+				return true;
 			};
-			if (matches (info.Exceptions_))
+			if (info.Exceptions_.AnyOf (keys, matches))
 				return false;
-			if (matches (info.Filters_))
+			if (info.Filters_.AnyOf (keys, matches))
 				return true;
 
 			return false;
@@ -384,7 +292,7 @@ namespace CleanWeb
 			if (info.RequestUrl_.scheme () == "data")
 				return IInterceptableRequests::Allow {};
 
-			if (!ShouldReject (info, { .Exceptions_ = ExceptionsCache_, .Filters_ = FilterItemsCache_, .Psl_ = PslFetcher_.GetPsl () }))
+			if (!ShouldReject (info, { .Exceptions_ = ExceptionsIndex_, .Filters_ = FiltersIndex_, .Psl_ = PslFetcher_.GetPsl () }))
 				return IInterceptableRequests::Allow {};
 
 			if (info.View_)
@@ -405,9 +313,16 @@ namespace CleanWeb
 			interceptable->AddInterceptor (interceptor);
 	}
 
-	void Core::Parse (const QString& filePath)
+	void Core::Parse (const QString& filePath, const SubscriptionData& sd)
 	{
-		SubsModel_->AddFilter (ParseToFilters ({ filePath }).first ());
+		Util::Sequence (this, QtConcurrent::run (ParseToFilters, QStringList { filePath })) >>
+				[=, this] (const QList<Filter>& filters)
+				{
+					SubsModel_->AddFilter (filters.first ());
+					SubsModel_->SetSubData (sd);
+
+					QtConcurrent::run (SaveFiltersCache, SubsModel_->GetAllFilters ());
+				};
 	}
 
 	bool Core::Add (const QUrl& subscrUrl)
@@ -472,8 +387,8 @@ namespace CleanWeb
 					[] (const IDownload::Error&) {},
 					[=, this] (IDownload::Success)
 					{
-						Parse (path);
-						SubsModel_->SetSubData ({
+						Parse (path,
+								{
 									url,
 									subscrName,
 									filename,
@@ -533,7 +448,7 @@ namespace CleanWeb
 
 							const auto& opt = item->Option_;
 							const auto& utf8 = opt.Case_ == Qt::CaseSensitive ? urlUtf8 : cinUrlUtf8;
-							if (!Matches (item, utf8, domain))
+							if (!Matches (*item, utf8, domain))
 								continue;
 
 							sels << item->Option_.HideSelector_;
@@ -675,63 +590,24 @@ namespace CleanWeb
 
 	void Core::regenFilterCaches ()
 	{
-		ExceptionsCache_.clear ();
-		FilterItemsCache_.clear ();
-
 		auto allFilters = SubsModel_->GetAllFilters ();
 		allFilters << UserFilters_->GetFilter ();
 
-		int exceptionsCount = 0;
-		int filtersCount = 0;
-		for (const Filter& filter : allFilters)
-		{
-			exceptionsCount += filter.Exceptions_.size ();
-			filtersCount += filter.Filters_.size ();
-		}
-
-		auto idealThreads = std::max (QThread::idealThreadCount (), 2);
-
-		const int exChunkSize = std::max (exceptionsCount / idealThreads / 4, 200);
-		const int fChunkSize = std::max (filtersCount / idealThreads / 4, 200);
-		qDebug () << Q_FUNC_INFO << exceptionsCount << filtersCount << exChunkSize << fChunkSize;
-
-		QList<FilterItem_ptr> lastItemsChunk, lastExceptionsChunk;
-		lastItemsChunk.reserve (fChunkSize);
-		lastExceptionsChunk.reserve (exChunkSize);
-
+		QList<FilterItem_ptr> exceptions;
+		QList<FilterItem_ptr> filters;
 		for (const Filter& filter : allFilters)
 		{
 			for (const auto& item : filter.Exceptions_)
-			{
-				if (!item->Option_.HideSelector_.isEmpty ())
-					continue;
-
-				lastExceptionsChunk << item;
-				if (lastExceptionsChunk.size () >= exChunkSize)
-				{
-					ExceptionsCache_ << lastExceptionsChunk;
-					lastExceptionsChunk.clear ();
-				}
-			}
+				if (item->Option_.HideSelector_.isEmpty ())
+					exceptions << item;
 
 			for (const auto& item : filter.Filters_)
-			{
-				if (!item->Option_.HideSelector_.isEmpty ())
-					continue;
-
-				lastItemsChunk << item;
-				if (lastItemsChunk.size () >= fChunkSize)
-				{
-					FilterItemsCache_ << lastItemsChunk;
-					lastItemsChunk.clear ();
-				}
-			}
+				if (item->Option_.HideSelector_.isEmpty ())
+					filters << item;
 		}
 
-		if (!lastItemsChunk.isEmpty ())
-			FilterItemsCache_ << lastItemsChunk;
-		if (!lastExceptionsChunk.isEmpty ())
-			ExceptionsCache_ << lastExceptionsChunk;
+		ExceptionsIndex_ = RuleIndex { exceptions };
+		FiltersIndex_ = RuleIndex { filters };
 	}
 }
 }
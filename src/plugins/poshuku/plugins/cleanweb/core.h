@@ -17,6 +17,7 @@
 #include <interfaces/poshuku/poshukutypes.h>
 #include "filter.h"
 #include "pslfetcher.h"
+#include "ruleindex.h"
 
 class QNetworkRequest;
 
@@ -45,8 +46,8 @@ namespace CleanWeb
 		UserFiltersModel * const UserFilters_;
 		SubscriptionsModel * const SubsModel_;
 
-		QList<QList<FilterItem_ptr>> ExceptionsCache_;
-		QList<QList<FilterItem_ptr>> FilterItemsCache_;
+		RuleIndex ExceptionsIndex_;
+		RuleIndex FiltersIndex_;
 
 		QHash<QObject*, QSet<QUrl>> MoreDelayedURLs_;
 
@@ -102,7 +103,7 @@ namespace CleanWeb
 		 */
 		bool Load (const QUrl& url, const QString& subscrName);
 	private:
-		void Parse (const QString&);
+		void Parse (const QString&, const SubscriptionData&);
 
 		void HideElementsChunk (HidingWorkerResult);
 		void DelayedRemoveElements (IWebView*, const QUrl&);
@@ -7,10 +7,15 @@
  **********************************************************************/
 
 #include "filter.h"
+#include <algorithm>
 #include <QDataStream>
 #include <QtDebug>
 #include <util/sll/unreachable.h>
 
+#if !defined (Q_OS_WIN32) && !defined (Q_OS_MAC)
+#include <fnmatch.h>
+#endif
+
 namespace LC
 {
 namespace Poshuku
@@ -19,13 +24,15 @@ namespace CleanWeb
 {
 	QDataStream& operator<< (QDataStream& out, const FilterOption& opt)
 	{
-		qint8 version = 3;
+		qint8 version = 4;
 		out << version
 			<< static_cast<qint8> (opt.Case_)
 			<< static_cast<qint8> (opt.MatchType_)
 			<< opt.Domains_
 			<< opt.NotDomains_
-			<< static_cast<qint8> (opt.ThirdParty_);
+			<< static_cast<qint8> (opt.ThirdParty_)
+			<< static_cast<qint32> (opt.MatchObjects_)
+			<< opt.HideSelector_;
 		return out;
 	}
 
@@ -34,7 +41,7 @@ namespace CleanWeb
 		qint8 version = 0;
 		in >> version;
 
-		if (version < 1 || version > 3)
+		if (version < 1 || version > 4)
 		{
 			qWarning () << Q_FUNC_INFO
 				<< "unknown version"
@@ -67,6 +74,13 @@ namespace CleanWeb
 			in >> tpVal;
 			opt.ThirdParty_ = static_cast<FilterOption::ThirdParty> (tpVal);
 		}
+		if (version >= 4)
+		{
+			qint32 objs;
+			in >> objs
+				>> opt.HideSelector_;
+			opt.MatchObjects_ = FilterOption::MatchObjects { QFlag { objs } };
+		}
 
 		return in;
 	}
@@ -76,8 +90,10 @@ namespace CleanWeb
 		return f1.ThirdParty_ == f2.ThirdParty_ &&
 				f1.Case_ == f2.Case_ &&
 				f1.MatchType_ == f2.MatchType_ &&
+				f1.MatchObjects_ == f2.MatchObjects_ &&
 				f1.Domains_ == f2.Domains_ &&
-				f1.NotDomains_ == f2.NotDomains_;
+				f1.NotDomains_ == f2.NotDomains_ &&
+				f1.HideSelector_ == f2.HideSelector_;
 	}
 
 	bool operator!= (const FilterOption& f1, const FilterOption& f2)
@@ -170,6 +186,109 @@ namespace CleanWeb
 		return in;
 	}
 
+	namespace
+	{
+#if defined (Q_OS_WIN32) || defined (Q_OS_MAC)
+		// Thanks for this goes to http://www.codeproject.com/KB/string/patmatch.aspx
+		bool WildcardMatches (const char *pattern, const char *str)
+		{
+			enum State {
+				Exact,        // exact match
+				Any,        // ?
+				AnyRepeat    // *
+			};
+
+			const char *s = str;
+			const char *p = pattern;
+			const char *q = 0;
+			int state = 0;
+
+			bool match = true;
+			while (match && *p) {
+				if (*p == '*') {
+					state = AnyRepeat;
+					q = p+1;
+				} else if (*p == '?') state = Any;
+				else state = Exact;
+
+				if (*s == 0) break;
+
+				switch (state) {
+					case Exact:
+						match = *s == *p;
+						s++;
+						p++;
+						break;
+
+					case Any:
+						match = true;
+						s++;
+						p++;
+						break;
+
+					case AnyRepeat:
+						match = true;
+						s++;
+
+						if (*s == *q) p++;
+						break;
+				}
+			}
+
+			if (state == AnyRepeat) return (*s == *q);
+			else if (state == Any) return (*s == *p);
+			else return match && (*s == *p);
+		}
+#else
+		bool WildcardMatches (const char *pat, const char *str)
+		{
+			return !fnmatch (pat, str, 0);
+		}
+#endif
+	}
+
+	bool Matches (const FilterItem& item,
+			const QByteArray& urlUtf8, const QString& domain)
+	{
+		const auto& opt = item.Option_;
+		if (opt.MatchObjects_ != FilterOption::MatchObject::All)
+		{
+			if (!(opt.MatchObjects_ & FilterOption::MatchObject::CSS) &&
+					!(opt.MatchObjects_ & FilterOption::MatchObject::Image) &&
+					!(opt.MatchObjects_ & FilterOption::MatchObject::Script) &&
+					!(opt.MatchObjects_ & FilterOption::MatchObject::Object) &&
+					!(opt.MatchObjects_ & FilterOption::MatchObject::ObjSubrequest))
+				return false;
+		}
+
+		if (std::any_of (opt.NotDomains_.begin (), opt.NotDomains_.end (),
+					[&domain, &opt] (const QString& notDomain)
+						{ return domain.endsWith (notDomain, opt.Case_); }))
+			return false;
+
+		if (!opt.Domains_.isEmpty () &&
+				std::none_of (opt.Domains_.begin (), opt.Domains_.end (),
+						[&domain, &opt] (const QString& doDomain)
+							{ return domain.endsWith (doDomain, opt.Case_); }))
+			return false;
+
+		switch (opt.MatchType_)
+		{
+		case FilterOption::MatchType::Regexp:
+			return item.RegExp_.Matches (urlUtf8);
+		case FilterOption::MatchType::Wildcard:
+			return WildcardMatches (item.PlainMatcher_.constData (), urlUtf8.constData ());
+		case FilterOption::MatchType::Plain:
+			return urlUtf8.indexOf (item.PlainMatcher_) >= 0;
+		case FilterOption::MatchType::Begin:
+			return urlUtf8.startsWith (item.PlainMatcher_);
+		case FilterOption::MatchType::End:
+			return urlUtf8.endsWith (item.PlainMatcher_);
+		}
+
+		return false;
+	}
+
 	Filter& Filter::operator+= (const Filter& f)
 	{
 		Filters_ << f.Filters_;
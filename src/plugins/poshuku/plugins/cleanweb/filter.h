@@ -100,6 +100,12 @@ namespace CleanWeb
 
 	typedef std::shared_ptr<FilterItem> FilterItem_ptr;
 
+	/** Checks whether the item matches the given URL (which is
+	 * expected to be lowercased for case-insensitive items) requested
+	 * from a page on the given domain.
+	 */
+	bool Matches (const FilterItem&, const QByteArray& urlUtf8, const QString& domain);
+
 	QDataStream& operator<< (QDataStream&, const FilterItem&);
 	QDataStream& operator>> (QDataStream&, FilterItem&);
 
@@ -0,0 +1,231 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "filterscache.h"
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QSaveFile>
+#include <QtDebug>
+#include <util/sys/paths.h>
+
+namespace LC::Poshuku::CleanWeb
+{
+	namespace
+	{
+		const quint32 Magic = 0x4c434357;
+
+		/* Bump this whenever the layout of the snapshot or the way
+		 * subscriptions are parsed into filter items changes.
+		 */
+		const quint32 FormatVersion = 1;
+
+		const auto StreamVersion = QDataStream::Qt_5_15;
+
+		std::optional<QString> GetCachePath ()
+		{
+			try
+			{
+				return Util::CreateIfNotExists ("cleanweb/cache").filePath ("filters.bin");
+			}
+			catch (const std::exception& e)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< e.what ();
+				return {};
+			}
+		}
+
+		struct FileStamp
+		{
+			qint64 Size_ = 0;
+			qint64 MTime_ = 0;
+
+			bool operator== (const FileStamp& other) const
+			{
+				return Size_ == other.Size_ && MTime_ == other.MTime_;
+			}
+		};
+
+		std::optional<FileStamp> GetStamp (const QDir& dir, const QString& filename)
+		{
+			const QFileInfo fi { dir.filePath (filename) };
+			if (!fi.exists ())
+				return {};
+
+			return FileStamp { fi.size (), fi.lastModified ().toMSecsSinceEpoch () };
+		}
+
+		void WriteItems (QDataStream& out, const QList<FilterItem_ptr>& items)
+		{
+			out << static_cast<quint32> (items.size ());
+			for (const auto& item : items)
+				out << *item;
+		}
+
+		QList<FilterItem_ptr> ReadItems (QDataStream& in)
+		{
+			quint32 count = 0;
+			in >> count;
+
+			QList<FilterItem_ptr> items;
+			for (quint32 i = 0; i < count && in.status () == QDataStream::Ok; ++i)
+			{
+				auto item = std::make_shared<FilterItem> ();
+				in >> *item;
+				items << std::move (item);
+			}
+			return items;
+		}
+	}
+
+	QHash<QString, Filter> LoadFiltersCache ()
+	{
+		const auto& path = GetCachePath ();
+		if (!path)
+			return {};
+
+		QFile file { *path };
+		if (!file.exists ())
+			return {};
+
+		if (!file.open (QIODevice::ReadOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< *path
+					<< file.errorString ();
+			return {};
+		}
+
+		const auto size = file.size ();
+		const auto mapped = file.map (0, size);
+		if (!mapped)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to map"
+					<< *path
+					<< file.errorString ();
+			return {};
+		}
+
+		const auto& data = QByteArray::fromRawData (reinterpret_cast<const char*> (mapped), size);
+		QDataStream in { data };
+		in.setVersion (StreamVersion);
+
+		quint32 magic = 0;
+		quint32 version = 0;
+		bool isFastRx = false;
+		in >> magic >> version >> isFastRx;
+		if (magic != Magic || version != FormatVersion)
+		{
+			qDebug () << Q_FUNC_INFO
+					<< "ignoring snapshot of an unknown version"
+					<< version;
+			return {};
+		}
+
+		// the parser drops some kinds of rules if there is no fast regexp engine
+		if (isFastRx != Util::RegExp::IsFast ())
+			return {};
+
+		const auto& subsDir = Util::CreateIfNotExists ("cleanweb");
+
+		quint32 count = 0;
+		in >> count;
+
+		QHash<QString, Filter> result;
+		for (quint32 i = 0; i < count && in.status () == QDataStream::Ok; ++i)
+		{
+			QString filename;
+			FileStamp stamp;
+			in >> filename >> stamp.Size_ >> stamp.MTime_;
+
+			Filter filter;
+			filter.Filters_ = ReadItems (in);
+			filter.Exceptions_ = ReadItems (in);
+			filter.SD_.Filename_ = filename;
+
+			if (GetStamp (subsDir, filename) == stamp)
+				result [filename] = filter;
+		}
+
+		if (in.status () != QDataStream::Ok)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "corrupted snapshot"
+					<< *path;
+			return {};
+		}
+
+		qDebug () << Q_FUNC_INFO
+				<< "loaded"
+				<< result.size ()
+				<< "of"
+				<< count
+				<< "subscriptions";
+		return result;
+	}
+
+	void SaveFiltersCache (const QList<Filter>& filters)
+	{
+		static QMutex mutex;
+		QMutexLocker locker { &mutex };
+
+		const auto& path = GetCachePath ();
+		if (!path)
+			return;
+
+		const auto& subsDir = Util::CreateIfNotExists ("cleanweb");
+
+		std::vector<std::pair<const Filter*, FileStamp>> stamped;
+		for (const auto& filter : filters)
+			if (!filter.SD_.Filename_.isEmpty ())
+				if (const auto stamp = GetStamp (subsDir, filter.SD_.Filename_))
+					stamped.push_back ({ &filter, *stamp });
+
+		QSaveFile file { *path };
+		if (!file.open (QIODevice::WriteOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< *path
+					<< file.errorString ();
+			return;
+		}
+
+		QDataStream out { &file };
+		out.setVersion (StreamVersion);
+		out << Magic
+				<< FormatVersion
+				<< Util::RegExp::IsFast ()
+				<< static_cast<quint32> (stamped.size ());
+
+		for (const auto& [filter, stamp] : stamped)
+		{
+			out << filter->SD_.Filename_
+					<< stamp.Size_
+					<< stamp.MTime_;
+			WriteItems (out, filter->Filters_);
+			WriteItems (out, filter->Exceptions_);
+		}
+
+		if (!file.commit ())
+			qWarning () << Q_FUNC_INFO
+					<< "unable to commit"
+					<< *path
+					<< file.errorString ();
+	}
+}
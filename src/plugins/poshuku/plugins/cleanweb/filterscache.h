@@ -0,0 +1,36 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <QHash>
+#include "filter.h"
+
+namespace LC::Poshuku::CleanWeb
+{
+	/** @brief Loads the snapshot of the parsed subscriptions.
+	 *
+	 * Only the filters whose subscription files haven't changed (by
+	 * size and modification time) since the snapshot has been written
+	 * are returned, keyed by their file names.
+	 *
+	 * The snapshot is memory-mapped while being read.
+	 *
+	 * @return The still valid filters from the snapshot.
+	 */
+	QHash<QString, Filter> LoadFiltersCache ();
+
+	/** @brief Writes the snapshot of the given parsed subscriptions.
+	 *
+	 * This function is thread-safe and is intended to be run in a
+	 * worker thread.
+	 *
+	 * @param[in] filters The parsed subscriptions.
+	 */
+	void SaveFiltersCache (const QList<Filter>& filters);
+}
@@ -0,0 +1,501 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "ruleindex.h"
+#include <algorithm>
+#include <optional>
+#include <vector>
+#include <QtDebug>
+
+namespace LC::Poshuku::CleanWeb
+{
+	namespace
+	{
+		bool IsTokenChar (char c)
+		{
+			return (c >= 'a' && c <= 'z') ||
+					(c >= 'A' && c <= 'Z') ||
+					(c >= '0' && c <= '9') ||
+					static_cast<unsigned char> (c) >= 0x80;
+		}
+
+		bool IsAscii (char c)
+		{
+			return static_cast<unsigned char> (c) < 0x80;
+		}
+
+		char FoldCase (char c)
+		{
+			return c >= 'A' && c <= 'Z' ?
+					static_cast<char> (c - 'A' + 'a') :
+					c;
+		}
+
+		constexpr quint64 FnvOffset = 14695981039346656037ULL;
+		constexpr quint64 FnvPrime = 1099511628211ULL;
+
+		quint64 HashStep (quint64 hash, quint16 c)
+		{
+			return (hash ^ c) * FnvPrime;
+		}
+
+		quint64 HashToken (const QByteArray& token)
+		{
+			auto hash = FnvOffset;
+			for (const auto c : token)
+				hash = HashStep (hash, static_cast<unsigned char> (FoldCase (c)));
+			return hash;
+		}
+
+		/* An atom is a single-character piece of a pattern: either a
+		 * literal token character, something that always matches exactly
+		 * one non-token character (so it delimits URL tokens), or anything
+		 * else we can't reason about.
+		 */
+		enum class AtomKind
+		{
+			TokenChar,
+			Separator,
+			Unknown
+		};
+
+		struct Atom
+		{
+			AtomKind Kind_;
+			char Char_ = 0;
+		};
+
+		using Atoms_t = std::vector<Atom>;
+
+		Atom LiteralAtom (char c)
+		{
+			return { IsTokenChar (c) ? AtomKind::TokenChar : AtomKind::Separator, c };
+		}
+
+		Atoms_t AtomizePlain (const QByteArray& pattern, bool anchoredBegin, bool anchoredEnd)
+		{
+			Atoms_t atoms;
+			atoms.reserve (pattern.size () + 2);
+			atoms.push_back ({ anchoredBegin ? AtomKind::Separator : AtomKind::Unknown });
+			for (const auto c : pattern)
+				atoms.push_back (LiteralAtom (c));
+			atoms.push_back ({ anchoredEnd ? AtomKind::Separator : AtomKind::Unknown });
+			return atoms;
+		}
+
+		std::optional<Atoms_t> AtomizeWildcard (const QByteArray& pattern)
+		{
+			// the wildcard is matched against the whole URL, so both ends are anchored
+			Atoms_t atoms;
+			atoms.reserve (pattern.size () + 2);
+			atoms.push_back ({ AtomKind::Separator });
+			for (int i = 0; i < pattern.size (); ++i)
+				switch (const auto c = pattern.at (i))
+				{
+				case '[':
+					return {};
+				case '*':
+				case '?':
+					atoms.push_back ({ AtomKind::Unknown });
+					break;
+				case '\\':
+					// escapes are handled differently by fnmatch and our own matcher
+					atoms.push_back ({ AtomKind::Unknown });
+					if (i + 1 < pattern.size ())
+					{
+						atoms.push_back ({ AtomKind::Unknown });
+						++i;
+					}
+					break;
+				default:
+					atoms.push_back (LiteralAtom (c));
+					break;
+				}
+			atoms.push_back ({ AtomKind::Separator });
+			return atoms;
+		}
+
+		bool IsClassEscape (char c)
+		{
+			switch (c)
+			{
+			case 'd':
+			case 'D':
+			case 'w':
+			case 'W':
+			case 's':
+			case 'S':
+			case 'b':
+			case 'B':
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		std::optional<Atom> ParseCharClass (const QByteArray& pattern, int& pos)
+		{
+			const auto size = pattern.size ();
+
+			auto i = pos + 1;
+			const bool negated = i < size && pattern.at (i) == '^';
+			if (negated)
+				++i;
+
+			bool onlySeparators = !negated;
+			for (bool first = true; i < size; ++i, first = false)
+			{
+				const auto c = pattern.at (i);
+				if (c == ']' && !first)
+				{
+					pos = i;
+					return Atom { onlySeparators ? AtomKind::Separator : AtomKind::Unknown };
+				}
+
+				if (c == '\\')
+				{
+					if (++i >= size)
+						return {};
+					if (IsTokenChar (pattern.at (i)))
+						onlySeparators = false;
+					continue;
+				}
+
+				// POSIX classes like [:alpha:] nest brackets, just don't bother
+				if (c == '[' && i + 1 < size && pattern.at (i + 1) == ':')
+					return {};
+
+				// a range may span token characters even if its ends don't
+				if (c == '-' && !first && i + 1 < size && pattern.at (i + 1) != ']')
+					onlySeparators = false;
+
+				if (IsTokenChar (c))
+					onlySeparators = false;
+			}
+
+			return {};
+		}
+
+		std::optional<Atoms_t> AtomizeRegexp (const QByteArray& pattern)
+		{
+			const auto size = pattern.size ();
+
+			Atoms_t atoms;
+			atoms.reserve (size + 2);
+
+			// PCRE looks for the pattern anywhere in the URL unless it is anchored explicitly
+			if (!pattern.startsWith ('^'))
+				atoms.push_back ({ AtomKind::Unknown });
+
+			auto markLastUnknown = [&atoms]
+			{
+				if (!atoms.empty ())
+					atoms.back ().Kind_ = AtomKind::Unknown;
+			};
+
+			bool anchoredEnd = false;
+			for (int i = 0; i < size; ++i)
+			{
+				const auto c = pattern.at (i);
+				switch (c)
+				{
+				// alternations and groups may make any part of the pattern optional
+				case '|':
+				case '(':
+				case ')':
+					return {};
+				case '^':
+					atoms.push_back ({ i ? AtomKind::Unknown : AtomKind::Separator });
+					break;
+				case '$':
+					anchoredEnd = i == size - 1;
+					atoms.push_back ({ anchoredEnd ? AtomKind::Separator : AtomKind::Unknown });
+					break;
+				case '.':
+					atoms.push_back ({ AtomKind::Unknown });
+					break;
+				case '*':
+				case '+':
+				case '?':
+					markLastUnknown ();
+					break;
+				case '{':
+				{
+					const auto end = pattern.indexOf ('}', i);
+					if (end < 0)
+						return {};
+					markLastUnknown ();
+					i = end;
+					break;
+				}
+				case '[':
+				{
+					const auto atom = ParseCharClass (pattern, i);
+					if (!atom)
+						return {};
+					atoms.push_back (*atom);
+					break;
+				}
+				case '\\':
+				{
+					if (++i >= size)
+						return {};
+
+					const auto next = pattern.at (i);
+					if (IsClassEscape (next))
+						atoms.push_back ({ AtomKind::Unknown });
+					else if (IsTokenChar (next))
+						return {};
+					else
+						atoms.push_back ({ AtomKind::Separator, next });
+					break;
+				}
+				default:
+					atoms.push_back (LiteralAtom (c));
+					break;
+				}
+			}
+
+			if (!anchoredEnd)
+				atoms.push_back ({ AtomKind::Unknown });
+
+			return atoms;
+		}
+
+		std::optional<Atoms_t> Atomize (const FilterItem& item)
+		{
+			switch (item.Option_.MatchType_)
+			{
+			case FilterOption::MatchType::Regexp:
+				return AtomizeRegexp (item.RegExp_.GetPattern ().toUtf8 ());
+			case FilterOption::MatchType::Wildcard:
+				return AtomizeWildcard (item.PlainMatcher_);
+			case FilterOption::MatchType::Plain:
+				return AtomizePlain (item.PlainMatcher_, false, false);
+			case FilterOption::MatchType::Begin:
+				return AtomizePlain (item.PlainMatcher_, true, false);
+			case FilterOption::MatchType::End:
+				return AtomizePlain (item.PlainMatcher_, false, true);
+			}
+
+			return {};
+		}
+
+		/* Returns the literal tokens of the item's pattern that are
+		 * delimited by separators on both sides, and thus are bound to
+		 * appear as whole tokens in any URL the item matches.
+		 */
+		QList<QByteArray> GetSafeTokens (const FilterItem& item)
+		{
+			const auto& atoms = Atomize (item);
+			if (!atoms)
+				return {};
+
+			QList<QByteArray> result;
+
+			const auto size = static_cast<int> (atoms->size ());
+			for (int i = 0; i < size; )
+			{
+				if ((*atoms) [i].Kind_ != AtomKind::TokenChar)
+				{
+					++i;
+					continue;
+				}
+
+				const auto start = i;
+				QByteArray token;
+				bool ascii = true;
+				for (; i < size && (*atoms) [i].Kind_ == AtomKind::TokenChar; ++i)
+				{
+					const auto c = (*atoms) [i].Char_;
+					token += FoldCase (c);
+					ascii = ascii && IsAscii (c);
+				}
+
+				// case folding of non-ASCII characters differs between the URL and the patterns
+				if (!ascii)
+					continue;
+
+				if (start == 0 || i == size)
+					continue;
+				if ((*atoms) [start - 1].Kind_ != AtomKind::Separator ||
+						(*atoms) [i].Kind_ != AtomKind::Separator)
+					continue;
+
+				result << token;
+			}
+
+			return result;
+		}
+
+		quint64 HashReversed (QStringView str)
+		{
+			auto hash = FnvOffset;
+			for (auto i = str.size () - 1; i >= 0; --i)
+				hash = HashStep (hash, str [i].unicode ());
+			return hash;
+		}
+
+		QVector<quint64> GetDomainKeys (const FilterItem& item)
+		{
+			const auto& domains = item.Option_.Domains_;
+
+			QVector<quint64> result;
+			result.reserve (domains.size ());
+			for (const auto& domain : domains)
+			{
+				// an empty domain matches any page, so the item can't be keyed by the domains
+				if (domain.isEmpty ())
+					return {};
+
+				result << HashReversed (domain.toLower ());
+			}
+			return result;
+		}
+	}
+
+	RuleIndex::RuleIndex (const QList<FilterItem_ptr>& items)
+	{
+		QList<QList<QByteArray>> itemsTokens;
+		itemsTokens.reserve (items.size ());
+
+		QHash<QByteArray, int> frequencies;
+		for (const auto& item : items)
+		{
+			const auto& tokens = GetSafeTokens (*item);
+			for (const auto& token : tokens)
+				++frequencies [token];
+			itemsTokens << tokens;
+		}
+
+		for (int i = 0; i < items.size (); ++i)
+		{
+			const auto& item = items [i];
+			const auto& tokens = itemsTokens [i];
+
+			// prefer the rarest token to keep the buckets small, then the longest one
+			const auto best = std::min_element (tokens.begin (), tokens.end (),
+					[&frequencies] (const QByteArray& left, const QByteArray& right)
+					{
+						const auto leftFreq = frequencies.value (left);
+						const auto rightFreq = frequencies.value (right);
+						if (leftFreq != rightFreq)
+							return leftFreq < rightFreq;
+						return left.size () > right.size ();
+					});
+			if (best != tokens.end ())
+			{
+				TokenIndex_ [HashToken (*best)] << item;
+				continue;
+			}
+
+			const auto& domainKeys = GetDomainKeys (*item);
+			if (!domainKeys.isEmpty ())
+			{
+				for (const auto key : domainKeys)
+					DomainIndex_ [key] << item;
+				continue;
+			}
+
+			Unindexed_ << item;
+		}
+
+		qDebug () << Q_FUNC_INFO
+				<< items.size ()
+				<< "items;"
+				<< TokenIndex_.size ()
+				<< "tokens,"
+				<< DomainIndex_.size ()
+				<< "domains,"
+				<< Unindexed_.size ()
+				<< "unindexed";
+	}
+
+	RuleIndex::RequestKeys RuleIndex::MakeKeys (const QByteArray& urlUtf8,
+			const QByteArray& cinUrlUtf8, const QString& domain)
+	{
+		RequestKeys keys;
+
+		auto tokenize = [&tokens = keys.UrlTokens_] (const QByteArray& url)
+		{
+			auto hash = FnvOffset;
+			int length = 0;
+			bool ascii = true;
+			auto flush = [&]
+			{
+				if (length && ascii)
+					tokens << hash;
+				hash = FnvOffset;
+				length = 0;
+				ascii = true;
+			};
+
+			for (const auto c : url)
+				if (IsTokenChar (c))
+				{
+					hash = HashStep (hash, static_cast<unsigned char> (FoldCase (c)));
+					++length;
+					ascii = ascii && IsAscii (c);
+				}
+				else
+					flush ();
+			flush ();
+		};
+
+		// case-sensitive items are matched against the original URL, case-insensitive ones against the lowercased
+		tokenize (urlUtf8);
+		if (cinUrlUtf8 != urlUtf8)
+			tokenize (cinUrlUtf8);
+
+		std::sort (keys.UrlTokens_.begin (), keys.UrlTokens_.end ());
+		keys.UrlTokens_.erase (std::unique (keys.UrlTokens_.begin (), keys.UrlTokens_.end ()), keys.UrlTokens_.end ());
+
+		const auto& lowerDomain = domain.toLower ();
+		keys.DomainSuffixes_.reserve (lowerDomain.size ());
+		auto hash = FnvOffset;
+		for (auto i = lowerDomain.size () - 1; i >= 0; --i)
+		{
+			hash = HashStep (hash, lowerDomain [i].unicode ());
+			keys.DomainSuffixes_ << hash;
+		}
+
+		return keys;
+	}
+
+	bool RuleIndex::AnyOf (const RequestKeys& keys, const std::function<bool (const FilterItem&)>& pred) const
+	{
+		auto anyOf = [&pred] (const QList<FilterItem_ptr>& items)
+		{
+			return std::any_of (items.begin (), items.end (),
+					[&pred] (const FilterItem_ptr& item) { return pred (*item); });
+		};
+
+		auto anyOfIndexed = [&anyOf] (const QHash<quint64, QList<FilterItem_ptr>>& index, const QVector<quint64>& keys)
+		{
+			if (index.isEmpty ())
+				return false;
+
+			for (const auto key : keys)
+			{
+				const auto pos = index.constFind (key);
+				if (pos != index.constEnd () && anyOf (*pos))
+					return true;
+			}
+			return false;
+		};
+
+		return anyOfIndexed (TokenIndex_, keys.UrlTokens_) ||
+				anyOfIndexed (DomainIndex_, keys.DomainSuffixes_) ||
+				anyOf (Unindexed_);
+	}
+
+	int RuleIndex::GetUnindexedCount () const
+	{
+		return Unindexed_.size ();
+	}
+}
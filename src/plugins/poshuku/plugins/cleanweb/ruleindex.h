@@ -0,0 +1,62 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include "filter.h"
+
+namespace LC::Poshuku::CleanWeb
+{
+	/** @brief Precompiled lookup structure over a set of filter items.
+	 *
+	 * Each item is keyed by a literal token of its pattern that is
+	 * guaranteed to appear as a whole token in any matching URL, the
+	 * rarest among the rule set and then the longest one. Items
+	 * without such a token but with a <code>domain=</code> option are
+	 * keyed by those domains instead, and the rest are kept in a small
+	 * list that is always checked.
+	 *
+	 * A lookup thus only visits the items sharing a token with the
+	 * request URL or a domain suffix with the page host, instead of
+	 * the whole rule set.
+	 */
+	class RuleIndex
+	{
+		QHash<quint64, QList<FilterItem_ptr>> TokenIndex_;
+		QHash<quint64, QList<FilterItem_ptr>> DomainIndex_;
+		QList<FilterItem_ptr> Unindexed_;
+	public:
+		/** @brief Per-request lookup keys shared by several indexes.
+		 */
+		struct RequestKeys
+		{
+			QVector<quint64> UrlTokens_;
+			QVector<quint64> DomainSuffixes_;
+		};
+
+		RuleIndex () = default;
+		explicit RuleIndex (const QList<FilterItem_ptr>&);
+
+		static RequestKeys MakeKeys (const QByteArray& urlUtf8,
+				const QByteArray& cinUrlUtf8, const QString& domain);
+
+		/** @brief Checks whether any candidate item satisfies the pred.
+		 *
+		 * The pred is expected to do the actual matching against the
+		 * URL, the index only narrows the set of items it is called on.
+		 * The pred may be invoked several times for the same item.
+		 */
+		bool AnyOf (const RequestKeys&, const std::function<bool (const FilterItem&)>& pred) const;
+
+		int GetUnindexedCount () const;
+	};
+}
@@ -0,0 +1,189 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "ruleindextest.h"
+#include <QtTest>
+#include "filter.cpp"
+#include "lineparser.cpp"
+#include "ruleindex.cpp"
+
+QTEST_APPLESS_MAIN (LC::Poshuku::CleanWeb::RuleIndexTest)
+
+namespace LC::Poshuku::CleanWeb
+{
+	namespace
+	{
+		Filter ParseFilter (const QStringList& lines)
+		{
+			Filter filter;
+			LineParser parser { &filter };
+			for (const auto& line : lines)
+				if (!line.isEmpty () && !line.startsWith ('['))
+					parser (line.trimmed ());
+			return filter;
+		}
+
+		struct Request
+		{
+			QByteArray Url_;
+			QByteArray CinUrl_;
+			QString Domain_;
+		};
+
+		Request MakeRequest (const QString& url, const QString& domain)
+		{
+			return { url.toUtf8 (), url.toLower ().toUtf8 (), domain };
+		}
+
+		auto MakeMatcher (const Request& req)
+		{
+			return [&req] (const FilterItem& item)
+			{
+				const auto& utf8 = item.Option_.Case_ == Qt::CaseSensitive ? req.Url_ : req.CinUrl_;
+				return Matches (item, utf8, req.Domain_);
+			};
+		}
+
+		bool ScanRejects (const Filter& filter, const Request& req)
+		{
+			const auto matcher = MakeMatcher (req);
+			auto anyOf = [&matcher] (const QList<FilterItem_ptr>& items)
+			{
+				return std::any_of (items.begin (), items.end (),
+						[&matcher] (const FilterItem_ptr& item) { return matcher (*item); });
+			};
+			return !anyOf (filter.Exceptions_) && anyOf (filter.Filters_);
+		}
+
+		struct Indexes
+		{
+			RuleIndex Exceptions_;
+			RuleIndex Filters_;
+		};
+
+		bool IndexRejects (const Indexes& indexes, const Request& req)
+		{
+			const auto& keys = RuleIndex::MakeKeys (req.Url_, req.CinUrl_, req.Domain_);
+			const auto matcher = MakeMatcher (req);
+			return !indexes.Exceptions_.AnyOf (keys, matcher) && indexes.Filters_.AnyOf (keys, matcher);
+		}
+
+		const QStringList TestRules
+		{
+			"||tracker.net/pixel",
+			"@@||tracker.net/pixel/allowed",
+			"/banner/*/img.",
+			"|http://evil.org/",
+			".swf|",
+			"-ad-300x250.",
+			"/.*adserver[0-9]+\\..*/",
+			"ad_banner$domain=foo.com",
+			"*$script,domain=news.com",
+			"/ads/",
+			"/Track.JS$match-case",
+		};
+	}
+
+	void RuleIndexTest::testSameAsScan_data ()
+	{
+		QTest::addColumn<QString> ("url");
+		QTest::addColumn<QString> ("domain");
+		QTest::addColumn<bool> ("rejected");
+
+		QTest::newRow ("double pipe") << "http://cdn.tracker.net/pixel?id=1" << "site.com" << true;
+		QTest::newRow ("exception") << "http://tracker.net/pixel/allowed" << "site.com" << false;
+		QTest::newRow ("wildcard") << "http://example.com/banner/x/img.png" << "site.com" << true;
+		QTest::newRow ("begin") << "http://evil.org/index.html" << "site.com" << true;
+		QTest::newRow ("begin mismatch") << "https://evil.org/" << "site.com" << false;
+		QTest::newRow ("end") << "http://media.com/movie.swf" << "site.com" << true;
+		QTest::newRow ("end mismatch") << "http://media.com/movie.swf?x" << "site.com" << false;
+		QTest::newRow ("plain") << "http://img.com/b-ad-300x250.png" << "site.com" << true;
+		QTest::newRow ("regexp") << "http://adserver12.com/x.js" << "site.com" << true;
+		QTest::newRow ("regexp inside token") << "http://myadserver12.com/" << "site.com" << true;
+		QTest::newRow ("domain") << "http://foo.com/ad_banner.png" << "www.foo.com" << true;
+		QTest::newRow ("other domain") << "http://foo.com/ad_banner.png" << "bar.com" << false;
+		QTest::newRow ("domain only") << "http://anything.org/script.js" << "news.com" << true;
+		QTest::newRow ("token") << "http://site.com/ads/1.png" << "a.com" << true;
+		QTest::newRow ("partial token") << "http://site.com/loads/1.png" << "a.com" << false;
+		QTest::newRow ("match case") << "http://x.com/Track.JS" << "a.com" << true;
+		QTest::newRow ("match case mismatch") << "http://x.com/track.js" << "a.com" << false;
+	}
+
+	void RuleIndexTest::testSameAsScan ()
+	{
+		QFETCH (QString, url);
+		QFETCH (QString, domain);
+		QFETCH (bool, rejected);
+
+		const auto& filter = ParseFilter (TestRules);
+		const Indexes indexes { RuleIndex { filter.Exceptions_ }, RuleIndex { filter.Filters_ } };
+
+		const auto& req = MakeRequest (url, domain);
+		QCOMPARE (ScanRejects (filter, req), rejected);
+		QCOMPARE (IndexRejects (indexes, req), rejected);
+	}
+
+	void RuleIndexTest::benchReplay_data ()
+	{
+		QTest::addColumn<bool> ("useIndex");
+
+		QTest::newRow ("scan") << false;
+		QTest::newRow ("index") << true;
+	}
+
+	/* The filters file is a usual AdBlock Plus subscription, and the log
+	 * has one request per line: the page URL and the request URL
+	 * separated by whitespace.
+	 */
+	void RuleIndexTest::benchReplay ()
+	{
+		QFETCH (bool, useIndex);
+
+		const auto& filtersPath = qEnvironmentVariable ("LC_POSHUKU_CLEANWEB_BENCH_FILTERS");
+		const auto& logPath = qEnvironmentVariable ("LC_POSHUKU_CLEANWEB_BENCH_LOG");
+		if (filtersPath.isEmpty () || logPath.isEmpty ())
+			QSKIP ("LC_POSHUKU_CLEANWEB_BENCH_FILTERS and LC_POSHUKU_CLEANWEB_BENCH_LOG are not set");
+
+		auto readLines = [] (const QString& path)
+		{
+			QFile file { path };
+			if (!file.open (QIODevice::ReadOnly))
+				return QStringList {};
+			return QString::fromUtf8 (file.readAll ()).split ('\n', Qt::SkipEmptyParts);
+		};
+
+		const auto& filter = ParseFilter (readLines (filtersPath));
+
+		QList<Request> requests;
+		for (const auto& line : readLines (logPath))
+		{
+			const auto& parts = line.split (' ', Qt::SkipEmptyParts);
+			if (parts.size () == 2)
+				requests << MakeRequest (parts [1], QUrl { parts [0] }.host ());
+		}
+		QVERIFY (!requests.isEmpty ());
+
+		qDebug () << filter.Filters_.size () << "filters," << filter.Exceptions_.size () << "exceptions," << requests.size () << "requests";
+
+		if (useIndex)
+		{
+			const Indexes indexes { RuleIndex { filter.Exceptions_ }, RuleIndex { filter.Filters_ } };
+			QBENCHMARK
+			{
+				for (const auto& req : requests)
+					IndexRejects (indexes, req);
+			}
+		}
+		else
+			QBENCHMARK
+			{
+				for (const auto& req : requests)
+					ScanRejects (filter, req);
+			}
+	}
+}
@@ -0,0 +1,25 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <QObject>
+
+namespace LC::Poshuku::CleanWeb
+{
+	class RuleIndexTest : public QObject
+	{
+		Q_OBJECT
+	private slots:
+		void testSameAsScan_data ();
+		void testSameAsScan ();
+
+		void benchReplay_data ();
+		void benchReplay ();
+	};
+}
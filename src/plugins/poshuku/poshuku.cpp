@@ -207,6 +207,38 @@ namespace Poshuku
 		Core::Instance ().Handle (e);
 	}
 
+	QList<EntityCapability> Poshuku::GetEntityCapabilities () const
+	{
+		EntityCapability urls;
+		urls.Schemes_ = QStringList { "http", "https" };
+		urls.RequiredParameters_ = FromUserInitiated;
+		urls.ForbiddenParameters_ = Internal;
+		urls.Priority_ = EntityTestHandleResult::PIdeal;
+		urls.Predicate_ = [] (const Entity& e) { return e.Entity_.toUrl ().isValid (); };
+
+		// The URLs typed by the user might come as strings.
+		EntityCapability strings;
+		strings.RequiredParameters_ = FromUserInitiated;
+		strings.ForbiddenParameters_ = Internal;
+		strings.Priority_ = EntityTestHandleResult::PIdeal;
+		strings.Predicate_ = [] (const Entity& e)
+		{
+			if (e.Entity_.userType () != QMetaType::QString)
+				return false;
+
+			const auto& url = e.Entity_.toUrl ();
+			return url.isValid () && (url.scheme () == "http" || url.scheme () == "https");
+		};
+
+		EntityCapability imports;
+		imports.Mimes_ = QStringList { "x-leechcraft/browser-import-data" };
+		imports.RequiredParameters_ = FromUserInitiated;
+		imports.ForbiddenParameters_ = Internal;
+		imports.Priority_ = EntityTestHandleResult::PIdeal;
+
+		return { urls, strings, imports };
+	}
+
 	std::unique_ptr<IWebWidget> Poshuku::CreateWidget () const
 	{
 		return Core::Instance ().CreateWidget ();
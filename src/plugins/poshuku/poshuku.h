@@ -19,6 +19,7 @@
 #include <interfaces/iactionsexporter.h>
 #include <interfaces/ihavesettings.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/ihaveshortcuts.h>
 #include <interfaces/ihaverecoverabletabs.h>
 #include <xmlsettingsdialog/xmlsettingsdialog.h>
@@ -40,6 +41,7 @@ namespace Poshuku
 					, public IPluginReady
 					, public IHaveSettings
 					, public IEntityHandler
+					, public IHaveEntityCapabilities
 					, public IHaveShortcuts
 					, public IWebBrowser
 					, public IActionsExporter
@@ -50,6 +52,7 @@ namespace Poshuku
 				IHaveTabs
 				IHaveSettings
 				IEntityHandler
+				IHaveEntityCapabilities
 				IPluginReady
 				IWebBrowser
 				IHaveShortcuts
@@ -90,6 +93,8 @@ namespace Poshuku
 		EntityTestHandleResult CouldHandle (const LC::Entity&) const;
 		void Handle (LC::Entity);
 
+		QList<EntityCapability> GetEntityCapabilities () const;
+
 		std::unique_ptr<IWebWidget> CreateWidget () const;
 
 		void SetShortcut (const QByteArray&, const QKeySequences_t&);
@@ -13,6 +13,7 @@
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QThread>
+#include <QtConcurrentRun>
 #include <QtDebug>
 #include <util/db/dblock.h>
 #include <util/db/util.h>
@@ -20,7 +21,9 @@
 #include <util/db/oral/pgimpl.h>
 #include <util/sll/util.h>
 #include <util/sll/qtutil.h>
+#include <util/threads/futures.h>
 #include <util/util.h>
+#include "historyindex.h"
 #include "xmlsettingsmanager.h"
 
 namespace LC
@@ -111,9 +114,62 @@ namespace LC
 {
 namespace Poshuku
 {
+	namespace
+	{
+		/* Reads the whole history over its own connection, so that the
+		 * GUI thread could keep using the main one meanwhile.
+		 */
+		void LoadHistoryIndex (const QString& sourceConnName, const std::shared_ptr<HistoryIndex>& index)
+		{
+			const auto& connName = Util::GenConnectionName ("org.LeechCraft.Poshuku.HistoryIndex");
+
+			{
+				auto db = QSqlDatabase::cloneDatabase (sourceConnName, connName);
+				if (!db.open ())
+					Util::DBLock::DumpError (db.lastError ());
+				else
+				{
+					QSqlQuery query { db };
+					query.setForwardOnly (true);
+					if (!query.exec ("SELECT Date, Title, URL FROM History;"))
+						Util::DBLock::DumpError (query);
+					else
+					{
+						const auto batchSize = 10000;
+
+						history_items_t batch;
+						while (query.next ())
+						{
+							batch.push_back ({
+									query.value (1).toString (),
+									query.value (0).toDateTime (),
+									query.value (2).toString ()
+								});
+							if (batch.size () < batchSize)
+								continue;
+
+							index->Add (batch);
+							batch.clear ();
+						}
+						index->Add (batch);
+						index->SetReady ();
+
+						qDebug () << Q_FUNC_INFO
+								<< "indexed"
+								<< index->GetURLsCount ()
+								<< "URLs";
+					}
+				}
+			}
+
+			QSqlDatabase::removeDatabase (connName);
+		}
+	}
+
 	SQLStorageBackend::SQLStorageBackend (StorageBackend::Type type)
 	: Type_ { type }
 	, DBGuard_ { Util::MakeScopeGuard ([this] { DB_.close (); }) }
+	, HistoryIndex_ { std::make_shared<HistoryIndex> () }
 	{
 		QString strType;
 		switch (type)
@@ -161,6 +217,8 @@ namespace Poshuku
 		type == SBSQLite ?
 				oral::AdaptPtrs<oral::SQLiteImplFactory> (DB_, History_, Favorites_, FormsNever_) :
 				oral::AdaptPtrs<oral::PostgreSQLImplFactory> (DB_, History_, Favorites_, FormsNever_);
+
+		QtConcurrent::run (LoadHistoryIndex, DB_.connectionName (), HistoryIndex_);
 	}
 
 	SQLStorageBackend::~SQLStorageBackend () = default;
@@ -186,6 +244,9 @@ namespace Poshuku
 
 	history_items_t SQLStorageBackend::LoadResemblingHistory (const QString& base) const
 	{
+		if (HistoryIndex_->IsReady ())
+			return HistoryIndex_->Find (base, -1);
+
 		using namespace oral::infix;
 
 		const auto& pat = "%" + base + "%";
@@ -222,12 +283,26 @@ namespace Poshuku
 				});
 	}
 
+	QFuture<history_items_t> SQLStorageBackend::LoadResemblingHistoryAsync (const QString& base,
+			int limit, const std::shared_ptr<std::atomic_bool>& cancelled) const
+	{
+		// The index is still being loaded, so only the database can be used.
+		if (!HistoryIndex_->IsReady ())
+			return Util::MakeReadyFuture (LoadResemblingHistory (base).mid (0, limit));
+
+		return QtConcurrent::run ([index = HistoryIndex_, base, limit, cancelled]
+				{
+					return index->Find (base, limit, cancelled.get ());
+				});
+	}
+
 	void SQLStorageBackend::AddToHistory (const HistoryItem& item)
 	{
 		const auto& record = History::FromHistoryItem (item);
 		Type_ == SBSQLite ?
 				History_->Insert (oral::SQLiteImplFactory {}, record, oral::InsertAction::Replace::PKey) :
 				History_->Insert (oral::PostgreSQLImplFactory {}, record, oral::InsertAction::Replace::PKey);
+		HistoryIndex_->Add (item);
 		emit added (item);
 	}
 
@@ -247,6 +322,7 @@ namespace Poshuku
 				std::min (*countDateThreshold, ageDateThreshold) :
 				ageDateThreshold;
 		History_->DeleteBy (sph::f<&History::Date_> < threshold);
+		HistoryIndex_->RemoveOlderThan (threshold);
 	}
 
 	void SQLStorageBackend::LoadFavorites (FavoritesModel::items_t& items) const
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "storagebackend.h"
+#include <memory>
 #include <QSqlDatabase>
 #include <util/sll/util.h>
 #include <util/db/oral/oralfwd.h>
@@ -17,6 +18,8 @@ namespace LC
 {
 namespace Poshuku
 {
+	class HistoryIndex;
+
 	class SQLStorageBackend : public StorageBackend
 	{
 		const Type Type_;
@@ -30,12 +33,16 @@ namespace Poshuku
 		Util::oral::ObjectInfo_ptr<History> History_;
 		Util::oral::ObjectInfo_ptr<Favorites> Favorites_;
 		Util::oral::ObjectInfo_ptr<FormsNever> FormsNever_;
+
+		const std::shared_ptr<HistoryIndex> HistoryIndex_;
 	public:
 		SQLStorageBackend (Type);
 		~SQLStorageBackend ();
 
 		void LoadHistory (history_items_t&) const override;
 		history_items_t LoadResemblingHistory (const QString&) const override;
+		QFuture<history_items_t> LoadResemblingHistoryAsync (const QString&, int,
+				const std::shared_ptr<std::atomic_bool>&) const override;
 		void AddToHistory (const HistoryItem&) override;
 		void ClearOldHistory (int, int) override;
 		void LoadFavorites (FavoritesModel::items_t&) const override;
@@ -8,7 +8,9 @@
 
 #ifndef PLUGINS_POSHUKU_STORAGEBACKEND_H
 #define PLUGINS_POSHUKU_STORAGEBACKEND_H
+#include <atomic>
 #include <memory>
+#include <QFuture>
 #include <QObject>
 #include "interfaces/poshuku/poshukutypes.h"
 #include "interfaces/poshuku/istoragebackend.h"
@@ -54,6 +56,21 @@ namespace Poshuku
 			*/
 		virtual history_items_t LoadResemblingHistory (const QString& base) const = 0;
 
+		/** @brief Get resembling history items asynchronously.
+			*
+			* Like LoadResemblingHistory(), but returns at most limit URLs
+			* ranked by the frequency and recency of their visits, and may
+			* run the search in another thread. The search stops early with
+			* an empty result once the cancelled flag is set.
+			*
+			* @param[in] base The base string.
+			* @param[in] limit Maximum number of the returned items.
+			* @param[in] cancelled The flag for cancelling the search.
+			* @return The future with the similar history items.
+			*/
+		virtual QFuture<history_items_t> LoadResemblingHistoryAsync (const QString& base,
+				int limit, const std::shared_ptr<std::atomic_bool>& cancelled) const = 0;
+
 		/** @brief Add an item to history.
 			*
 			* Adds the passed item to the storage and emits the added() signal
@@ -0,0 +1,281 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "historyindexbench.h"
+#include <algorithm>
+#include <cmath>
+#include <QtTest>
+#include <QRandomGenerator>
+#include <historyindex.h>
+
+namespace LC::Poshuku
+{
+	namespace
+	{
+		int GetHistorySize ()
+		{
+			bool ok = false;
+			const auto count = qEnvironmentVariableIntValue ("LC_POSHUKU_BENCH_HISTORY", &ok);
+			return ok ? count : 1000000;
+		}
+
+		const QStringList Syllables
+		{
+			"ka", "ro", "mi", "te", "su", "na", "lo", "ve",
+			"di", "qu", "ba", "ze", "po", "fi", "gu", "ny"
+		};
+
+		const QList<QPair<QString, QString>> KnownHosts
+		{
+			{ "github.com", "GitHub" },
+			{ "en.wikipedia.org", "Wikipedia" },
+			{ "leechcraft.org", "LeechCraft" },
+			{ "news.ycombinator.com", "Hacker News" },
+			{ "doc.qt.io", "Qt Documentation" },
+			{ "www.boost.org", "Boost C++ Libraries" },
+		};
+
+		/* Each URL has its own title, so that the title of the latest
+		 * visit kept by the index is the title of any of the visits.
+		 */
+		HistoryItem MakeURL (int urlId)
+		{
+			QRandomGenerator gen { static_cast<quint32> (urlId) };
+			const auto word = [&gen]
+			{
+				QString result;
+				for (int i = 0, count = gen.bounded (2, 5); i < count; ++i)
+					result += Syllables.at (gen.bounded (Syllables.size ()));
+				return result;
+			};
+
+			QString host;
+			QString hostTitle;
+			if (urlId % 4)
+			{
+				host = word () + ".example.net";
+				hostTitle = host;
+			}
+			else
+			{
+				const auto& known = KnownHosts.at (gen.bounded (KnownHosts.size ()));
+				host = known.first;
+				hostTitle = known.second;
+			}
+
+			return
+			{
+				word () + " " + word () + " " + word () + " - " + hostTitle,
+				{},
+				"https://" + host + "/" + word () + "/" + word () + "/" + QString::number (urlId)
+			};
+		}
+
+		// Mirrors what the storage backend did before the index.
+		history_items_t LinearScan (const history_items_t& items, const QString& base)
+		{
+			const auto& now = QDateTime::currentDateTime ();
+
+			QHash<QString, QString> url2title;
+			QHash<QString, double> url2score;
+			for (const auto& item : items)
+			{
+				if (!item.Title_.contains (base, Qt::CaseInsensitive) &&
+						!item.URL_.contains (base, Qt::CaseInsensitive))
+					continue;
+
+				url2title [item.URL_] = item.Title_;
+				url2score [item.URL_] += std::exp (-item.DateTime_.secsTo (now) / 86400.);
+			}
+
+			QList<QPair<QString, double>> scored;
+			for (auto i = url2score.begin (), end = url2score.end (); i != end; ++i)
+				scored.push_back ({ i.key (), i.value () });
+			std::sort (scored.begin (), scored.end (),
+					[] (const auto& left, const auto& right) { return left.second > right.second; });
+
+			history_items_t result;
+			for (const auto& pair : scored)
+				result.push_back ({ url2title [pair.first], {}, pair.first });
+			return result;
+		}
+
+		QStringList GetURLs (const history_items_t& items)
+		{
+			QStringList result;
+			for (const auto& item : items)
+				result << item.URL_;
+			return result;
+		}
+	}
+
+	HistoryIndexBench::HistoryIndexBench () = default;
+	HistoryIndexBench::~HistoryIndexBench () = default;
+
+	/* The history consists of GetHistorySize () visits of a quarter as
+	 * many URLs, some of them much more popular than the others, spread
+	 * over the last three years. Set LC_POSHUKU_BENCH_HISTORY to change
+	 * the number of the visits.
+	 */
+	void HistoryIndexBench::initTestCase ()
+	{
+		const auto size = GetHistorySize ();
+		const auto urlsCount = std::max (size / 4, 1);
+
+		QVector<HistoryItem> urls;
+		urls.reserve (urlsCount);
+		for (int i = 0; i < urlsCount; ++i)
+			urls << MakeURL (i);
+
+		const auto& now = QDateTime::currentDateTime ();
+		const auto period = 3 * 365 * 86400;
+
+		QRandomGenerator gen { 42 };
+		Items_.reserve (size);
+		for (int i = 0; i < size; ++i)
+		{
+			const auto popularity = gen.generateDouble ();
+			const auto& url = urls.at (static_cast<int> (popularity * popularity * urlsCount));
+			Items_.push_back ({ url.Title_, now.addSecs (-gen.bounded (period)), url.URL_ });
+		}
+
+		Index_ = std::make_unique<HistoryIndex> ();
+		Index_->Add (Items_);
+		Index_->SetReady ();
+	}
+
+	void HistoryIndexBench::testFind ()
+	{
+		const auto& now = QDateTime::currentDateTime ();
+
+		HistoryIndex index;
+		index.Add (HistoryItem { "LeechCraft", now.addDays (-10), "https://leechcraft.org/" });
+		index.Add (HistoryItem { "LeechCraft", now.addDays (-9), "https://leechcraft.org/" });
+		index.Add (HistoryItem { "LeechCraft plugins", now.addDays (-1), "https://leechcraft.org/plugins" });
+		index.Add (HistoryItem { "Image", now, "data:image/png;base64,leechcraft" });
+		index.Add (HistoryItem { "Qt docs", now.addDays (-2), "https://doc.qt.io/" });
+
+		QCOMPARE (index.GetURLsCount (), 3);
+
+		const QStringList leechcraft { "https://leechcraft.org/plugins", "https://leechcraft.org/" };
+		QCOMPARE (GetURLs (index.Find ("craft", -1)), leechcraft);
+		QCOMPARE (GetURLs (index.Find ("CRAFT.org/PL", -1)), QStringList { "https://leechcraft.org/plugins" });
+		QCOMPARE (GetURLs (index.Find ("craft", 1)), QStringList { "https://leechcraft.org/plugins" });
+		QCOMPARE (index.Find ({}, -1).size (), 3);
+		QVERIFY (index.Find ("nothing", -1).isEmpty ());
+
+		QCOMPARE (GetURLs (index.Find ("docs", -1)), QStringList { "https://doc.qt.io/" });
+		index.Add (HistoryItem { "Qt documentation", now, "https://doc.qt.io/" });
+		QVERIFY (index.Find ("docs", -1).isEmpty ());
+		QCOMPARE (index.Find ("documentation", -1).value (0).Title_, QString { "Qt documentation" });
+
+		std::atomic_bool cancelled { true };
+		QVERIFY (index.Find ("craft", -1, &cancelled).isEmpty ());
+	}
+
+	void HistoryIndexBench::testRemoveOlderThan ()
+	{
+		const auto& now = QDateTime::currentDateTime ();
+
+		HistoryIndex index;
+		index.Add (HistoryItem { "LeechCraft", now.addDays (-10), "https://leechcraft.org/" });
+		index.Add (HistoryItem { "LeechCraft plugins", now.addDays (-1), "https://leechcraft.org/plugins" });
+		for (int i = 0; i < 3000; ++i)
+			index.Add (HistoryItem { "Old page", now.addDays (-20), QString { "https://example.net/%1" }.arg (i) });
+
+		index.RemoveOlderThan (now.addDays (-5));
+		QCOMPARE (index.GetURLsCount (), 1);
+		QCOMPARE (GetURLs (index.Find ("craft", -1)), QStringList { "https://leechcraft.org/plugins" });
+		QVERIFY (index.Find ("old", -1).isEmpty ());
+
+		index.Add (HistoryItem { "LeechCraft", now.addDays (-8), "https://leechcraft.org/" });
+		QCOMPARE (index.GetURLsCount (), 1);
+
+		index.Add (HistoryItem { "LeechCraft", now, "https://leechcraft.org/" });
+		QCOMPARE (GetURLs (index.Find ("craft", -1)).size (), 2);
+	}
+
+	namespace
+	{
+		void AddQueryRows ()
+		{
+			QTest::addColumn<QString> ("query");
+
+			QTest::newRow ("one letter") << QString { "g" };
+			QTest::newRow ("two letters") << QString { "qt" };
+			QTest::newRow ("host part") << QString { "git" };
+			QTest::newRow ("title word") << QString { "wiki" };
+			QTest::newRow ("generated word") << QString { "kamite" };
+			QTest::newRow ("host") << QString { "leechcraft.org" };
+			QTest::newRow ("several words") << QString { "doc.qt.io/ka" };
+			QTest::newRow ("nothing") << QString { "nonexistent" };
+		}
+	}
+
+	void HistoryIndexBench::testMatchesLinearScan_data ()
+	{
+		QTest::addColumn<QString> ("query");
+
+		// The shorter words are only looked for at the beginning of the words.
+		QTest::newRow ("host part") << QString { "git" };
+		QTest::newRow ("title word") << QString { "wiki" };
+		QTest::newRow ("generated word") << QString { "kamite" };
+		QTest::newRow ("several words") << QString { "doc.qt.io/ka" };
+		QTest::newRow ("nothing") << QString { "nonexistent" };
+	}
+
+	void HistoryIndexBench::testMatchesLinearScan ()
+	{
+		QFETCH (QString, query);
+
+		auto expected = GetURLs (LinearScan (Items_, query));
+		auto actual = GetURLs (Index_->Find (query, -1));
+		expected.sort ();
+		actual.sort ();
+		QCOMPARE (actual, expected);
+	}
+
+	void HistoryIndexBench::benchBuild ()
+	{
+		QBENCHMARK_ONCE
+		{
+			HistoryIndex index;
+			index.Add (Items_);
+		}
+	}
+
+	void HistoryIndexBench::benchFind_data ()
+	{
+		AddQueryRows ();
+	}
+
+	void HistoryIndexBench::benchFind ()
+	{
+		QFETCH (QString, query);
+
+		QBENCHMARK
+		{
+			Index_->Find (query, 100);
+		}
+	}
+
+	void HistoryIndexBench::benchLinearScan_data ()
+	{
+		AddQueryRows ();
+	}
+
+	void HistoryIndexBench::benchLinearScan ()
+	{
+		QFETCH (QString, query);
+
+		QBENCHMARK_ONCE
+		{
+			LinearScan (Items_, query);
+		}
+	}
+}
@@ -0,0 +1,44 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <QObject>
+#include <interfaces/poshuku/poshukutypes.h>
+
+namespace LC::Poshuku
+{
+	class HistoryIndex;
+
+	class Q_DECL_EXPORT HistoryIndexBench : public QObject
+	{
+		Q_OBJECT
+
+		history_items_t Items_;
+		std::unique_ptr<HistoryIndex> Index_;
+	public:
+		HistoryIndexBench ();
+		~HistoryIndexBench () override;
+	private slots:
+		void initTestCase ();
+
+		void testFind ();
+		void testRemoveOlderThan ();
+		void testMatchesLinearScan_data ();
+		void testMatchesLinearScan ();
+
+		void benchBuild ();
+		void benchFind_data ();
+		void benchFind ();
+		void benchLinearScan_data ();
+		void benchLinearScan ();
+	};
+}
+
+using TheTestObject = LC::Poshuku::HistoryIndexBench;
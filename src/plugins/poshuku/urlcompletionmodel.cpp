@@ -12,6 +12,7 @@
 #include <QTimer>
 #include <QApplication>
 #include <QtDebug>
+#include <util/threads/futures.h>
 #include <util/xpc/defaulthookproxy.h>
 #include <interfaces/core/icoreproxy.h>
 #include "core.h"
@@ -107,26 +108,69 @@ namespace Poshuku
 		Valid_ = false;
 		Base_ = str;
 
+		CancelPending ();
+
 		ValidateTimer_->stop ();
 		ValidateTimer_->start ();
 	}
 
+	namespace
+	{
+		// The completer popup never shows more than a few dozens of them anyway.
+		constexpr int MaxHistoryItems = 100;
+	}
+
 	void URLCompletionModel::validate ()
 	{
-		PopulateNonHook ();
+		CancelPending ();
 
-		Util::DefaultHookProxy_ptr proxy (new Util::DefaultHookProxy);
-		int size = Items_.size ();
-		emit hookURLCompletionNewStringRequested (proxy, this, Base_, size);
-		if (!proxy->IsCancelled ())
+		if (Valid_)
+		{
+			RequestHookItems ();
 			return;
+		}
 
-		if (size)
+		if (Base_.startsWith ('!'))
 		{
-			beginRemoveRows ({}, 0, size - 1);
-			Items_.erase (Items_.begin (), Items_.begin () + size);
-			endRemoveRows ();
+			auto cats = Core::Instance ().GetProxy ()->GetSearchCategories ();
+			cats.sort ();
+
+			history_items_t items;
+			for (const auto& cat : cats)
+				items.push_back ({ cat, {}, "!" + cat });
+			SetItems (std::move (items));
+			RequestHookItems ();
+			return;
+		}
+
+		QFuture<history_items_t> future;
+		const auto cancelled = std::make_shared<std::atomic_bool> (false);
+		try
+		{
+			future = Core::Instance ().GetStorageBackend ()->LoadResemblingHistoryAsync (Base_,
+					MaxHistoryItems, cancelled);
 		}
+		catch (const std::runtime_error& e)
+		{
+			qWarning () << Q_FUNC_INFO << e.what ();
+			SetItems ({});
+			Valid_ = false;
+			RequestHookItems ();
+			return;
+		}
+
+		PendingCancelled_ = cancelled;
+		Util::Sequence (this, future) >>
+				[this, cancelled] (const history_items_t& items)
+				{
+					// The base has changed while the history was searched.
+					if (*cancelled)
+						return;
+
+					PendingCancelled_.reset ();
+					SetItems (items);
+					RequestHookItems ();
+				};
 	}
 
 	void URLCompletionModel::handleItemAdded (const HistoryItem&)
@@ -134,11 +178,17 @@ namespace Poshuku
 		Valid_ = false;
 	}
 
-	void URLCompletionModel::PopulateNonHook ()
+	void URLCompletionModel::CancelPending ()
 	{
-		if (Valid_)
+		if (!PendingCancelled_)
 			return;
 
+		*PendingCancelled_ = true;
+		PendingCancelled_.reset ();
+	}
+
+	void URLCompletionModel::SetItems (history_items_t newItems)
+	{
 		Valid_ = true;
 
 		if (!Items_.isEmpty ())
@@ -149,27 +199,6 @@ namespace Poshuku
 			endRemoveRows ();
 		}
 
-		history_items_t newItems;
-		if (Base_.startsWith ('!'))
-		{
-			auto cats = Core::Instance ().GetProxy ()->GetSearchCategories ();
-			cats.sort ();
-			for (const auto& cat : cats)
-				newItems.push_back ({ cat, {}, "!" + cat });
-		}
-		else
-		{
-			try
-			{
-				newItems = Core::Instance ().GetStorageBackend ()->LoadResemblingHistory (Base_);
-			}
-			catch (const std::runtime_error& e)
-			{
-				qWarning () << Q_FUNC_INFO << e.what ();
-				Valid_ = false;
-			}
-		}
-
 		if (newItems.isEmpty ())
 			return;
 
@@ -177,5 +206,21 @@ namespace Poshuku
 		Items_ = std::move (newItems);
 		endInsertRows ();
 	}
+
+	void URLCompletionModel::RequestHookItems ()
+	{
+		Util::DefaultHookProxy_ptr proxy (new Util::DefaultHookProxy);
+		int size = Items_.size ();
+		emit hookURLCompletionNewStringRequested (proxy, this, Base_, size);
+		if (!proxy->IsCancelled ())
+			return;
+
+		if (size)
+		{
+			beginRemoveRows ({}, 0, size - 1);
+			Items_.erase (Items_.begin (), Items_.begin () + size);
+			endRemoveRows ();
+		}
+	}
 }
 }
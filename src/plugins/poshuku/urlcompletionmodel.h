@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <QAbstractItemModel>
 #include <interfaces/core/ihookproxy.h>
 #include <interfaces/poshuku/iurlcompletionmodel.h>
@@ -31,6 +33,8 @@ namespace Poshuku
 		QString Base_;
 
 		QTimer * const ValidateTimer_;
+
+		std::shared_ptr<std::atomic_bool> PendingCancelled_;
 	public:
 		enum
 		{
@@ -48,7 +52,9 @@ namespace Poshuku
 
 		void AddItem (const QString& title, const QString& url, size_t pos) override;
 	private:
-		void PopulateNonHook ();
+		void CancelPending ();
+		void SetItems (history_items_t);
+		void RequestHookItems ();
 	private slots:
 		void validate ();
 	public slots:
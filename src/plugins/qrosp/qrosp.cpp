@@ -91,6 +91,15 @@ namespace Qrosp
 		*entity.Additional_ ["Object"].value<QObject**> () = new WrapperObject (language, path);
 	}
 
+	QList<EntityCapability> Plugin::GetEntityCapabilities () const
+	{
+		EntityCapability cap;
+		cap.Mimes_ = QStringList { "x-leechcraft/script-wrap-request" };
+		cap.RequiredFields_ = QStringList { "Object" };
+		cap.NeedsQuery_ = true;
+		return { cap };
+	}
+
 	IScriptLoaderInstance_ptr Plugin::CreateScriptLoaderInstance (const QString& relPath)
 	{
 		return std::make_shared<ScriptLoaderInstance> (relPath);
@@ -13,6 +13,7 @@
 #include <interfaces/iinfo.h>
 #include <interfaces/ipluginadaptor.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/iscriptloader.h>
 
 namespace LC
@@ -23,10 +24,11 @@ namespace Qrosp
 				 , public IInfo
 				 , public IPluginAdaptor
 				 , public IEntityHandler
+				 , public IHaveEntityCapabilities
 				 , public IScriptLoader
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IPluginAdaptor IEntityHandler IScriptLoader)
+		Q_INTERFACES (IInfo IPluginAdaptor IEntityHandler IHaveEntityCapabilities IScriptLoader)
 
 		LC_PLUGIN_METADATA ("org.LeechCraft.Qrosp")
 	public:
@@ -44,6 +46,8 @@ namespace Qrosp
 		EntityTestHandleResult CouldHandle (const Entity&) const;
 		void Handle (Entity);
 
+		QList<EntityCapability> GetEntityCapabilities () const;
+
 		IScriptLoaderInstance_ptr CreateScriptLoaderInstance (const QString&);
 	};
 }
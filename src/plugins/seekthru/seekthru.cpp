@@ -127,6 +127,24 @@ namespace LC::SeekThru
 		Core::Instance ().Handle (e);
 	}
 
+	QList<EntityCapability> SeekThru::GetEntityCapabilities () const
+	{
+		EntityCapability filter;
+		filter.Mimes_ = QStringList { "x-leechcraft/data-filter-request" };
+		filter.NeedsQuery_ = true;
+
+		EntityCapability description;
+		description.Mimes_ = QStringList { "application/opensearchdescription+xml" };
+		description.Priority_ = EntityTestHandleResult::PIdeal;
+		description.Predicate_ = [] (const Entity& e)
+		{
+			const auto& scheme = e.Entity_.toUrl ().scheme ();
+			return e.Entity_.canConvert<QUrl> () && (scheme == "http" || scheme == "https");
+		};
+
+		return { filter, description };
+	}
+
 	QString SeekThru::GetFilterVerb () const
 	{
 		return tr ("Search in OpenSearch engines");
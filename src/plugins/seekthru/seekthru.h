@@ -14,6 +14,7 @@
 #include <interfaces/ifinder.h>
 #include <interfaces/ihavesettings.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 #include <interfaces/idatafilter.h>
 #include <interfaces/istartupwizard.h>
 #include <interfaces/isyncable.h>
@@ -26,6 +27,7 @@ namespace LC::SeekThru
 					, public IFinder
 					, public IHaveSettings
 					, public IEntityHandler
+					, public IHaveEntityCapabilities
 					, public IDataFilter
 					, public IStartupWizard
 					, public ISyncable
@@ -35,6 +37,7 @@ namespace LC::SeekThru
 				IFinder
 				IHaveSettings
 				IEntityHandler
+				IHaveEntityCapabilities
 				IDataFilter
 				IStartupWizard
 				ISyncable)
@@ -64,6 +67,8 @@ namespace LC::SeekThru
 		EntityTestHandleResult CouldHandle (const LC::Entity&) const override;
 		void Handle (LC::Entity) override;
 
+		QList<EntityCapability> GetEntityCapabilities () const override;
+
 		QString GetFilterVerb () const override;
 		QList<FilterVariant> GetFilterVariants (const QVariant&) const override;
 
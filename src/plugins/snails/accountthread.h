@@ -235,7 +235,7 @@ namespace Snails
 
 		template<typename F, typename... Args>
 		auto Schedule (QFutureInterface<WrapFunctionType_t<F, Args...>> iface,
-				TaskPriority, const F& func, const Args&... args)
+				TaskPriority prio, const F& func, const Args&... args)
 		{
 			auto reporting = [this, func, iface, args...] (AccountThreadWorker *w) mutable
 			{
@@ -247,7 +247,8 @@ namespace Snails
 				IsRunning_ = false;
 			};
 
-			ScheduleImpl (std::move (reporting));
+			ScheduleImpl (prio == TaskPriority::High ? Priority::High : Priority::Low,
+					std::move (reporting));
 
 			return iface.future ();
 		}
@@ -55,10 +55,14 @@ namespace Sysnotify
 				SLOT (handleNotificationClosed (uint, uint)));
 	}
 
+	bool NotificationManager::IsAvailable () const
+	{
+		return Connection_.get () && Connection_->isValid ();
+	}
+
 	bool NotificationManager::CouldNotify (const Entity& e) const
 	{
-		return Connection_.get () &&
-				Connection_->isValid () &&
+		return IsAvailable () &&
 				e.Mime_ == "x-leechcraft/notification" &&
 				!e.Additional_ ["Text"].toString ().isEmpty ();
 	}
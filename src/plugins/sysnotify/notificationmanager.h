@@ -48,6 +48,7 @@ namespace Sysnotify
 	public:
 		NotificationManager (QObject* = 0);
 
+		bool IsAvailable () const;
 		bool CouldNotify (const Entity&) const;
 		void HandleNotification (const Entity&);
 	private:
@@ -63,6 +63,19 @@ namespace Sysnotify
 	{
 		Manager_->HandleNotification (e);
 	}
+
+	QList<EntityCapability> Plugin::GetEntityCapabilities () const
+	{
+		// Checked once, as the notifications service is looked up once.
+		if (!Manager_ || !Manager_->IsAvailable ())
+			return {};
+
+		EntityCapability cap;
+		cap.Mimes_ = QStringList { "x-leechcraft/notification" };
+		cap.Priority_ = EntityTestHandleResult::PHigh;
+		cap.Predicate_ = [] (const Entity& e) { return !e.Additional_ ["Text"].toString ().isEmpty (); };
+		return { cap };
+	}
 }
 }
 
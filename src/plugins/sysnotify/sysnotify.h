@@ -11,6 +11,7 @@
 #include <QObject>
 #include <interfaces/iinfo.h>
 #include <interfaces/ientityhandler.h>
+#include <interfaces/ihaveentitycapabilities.h>
 
 namespace LC
 {
@@ -21,9 +22,10 @@ namespace Sysnotify
 	class Plugin : public QObject
 				 , public IInfo
 				 , public IEntityHandler
+				 , public IHaveEntityCapabilities
 	{
 		Q_OBJECT
-		Q_INTERFACES (IInfo IEntityHandler)
+		Q_INTERFACES (IInfo IEntityHandler IHaveEntityCapabilities)
 
 		LC_PLUGIN_METADATA ("org.LeechCraft.SysNotify")
 
@@ -39,6 +41,8 @@ namespace Sysnotify
 
 		EntityTestHandleResult CouldHandle (const Entity&) const;
 		void Handle (Entity);
+
+		QList<EntityCapability> GetEntityCapabilities () const;
 	};
 }
 }
@@ -8,18 +8,25 @@
 
 #pragma once
 
+#include <algorithm>
+#include <iterator>
 #include <stdexcept>
 #include <type_traits>
 #include <memory>
 #include <optional>
+#include <ranges>
+#include <unordered_map>
 #include <boost/preprocessor/stringize.hpp>
 #include <boost/preprocessor/tuple.hpp>
 #include <QStringList>
 #include <QDateTime>
+#include <QDataStream>
 #include <QPair>
+#include <QSet>
 #include <QSqlQuery>
 #include <QSqlRecord>
 #include <QVariant>
+#include <QVector>
 #include <QDateTime>
 #include <QtDebug>
 #include <util/sll/ctstringutils.h>
@@ -397,6 +404,10 @@ namespace LC::Util::oral
 			return std::tuple { std::get<FieldIndex<Ptrs> ()> (FieldNames<Seq>)... };
 		}
 
+		template<typename R, typename Seq>
+		concept RecordsRange = std::ranges::forward_range<const R> &&
+				std::is_same_v<std::ranges::range_reference_t<const R>, const Seq&>;
+
 		template<typename Seq>
 		class AdaptInsert
 		{
@@ -431,6 +442,25 @@ namespace LC::Util::oral
 			{
 				return Run<ImplFactory> (t, action);
 			}
+
+			/** @brief Inserts all the \em records using multi-row INSERT statements.
+			 *
+			 * The records are split into chunks fitting into the bound
+			 * parameters limit of the backend, and all the chunks are
+			 * inserted in a single transaction. The autogenerated primary
+			 * keys (if any) are not reported back.
+			 */
+			template<RecordsRange<Seq> R, typename Action = InsertAction::DefaultTag>
+			void operator() (const R& records, Action action = {}) const
+			{
+				RunMany<SQLite::ImplFactory> (records, action);
+			}
+
+			template<typename ImplFactory, RecordsRange<Seq> R>
+			void operator() (ImplFactory, const R& records, auto action) const
+			{
+				RunMany<ImplFactory> (records, action);
+			}
 		private:
 			template<typename ImplFactory, typename Action>
 			constexpr static auto MakeInsertSuffix (Action action)
@@ -473,6 +503,153 @@ namespace LC::Util::oral
 						return lastId;
 				}
 			}
+
+			constexpr static int InsertedFieldsCount_ = SeqSize<Seq> - (HasAutogen_ ? 1 : 0);
+
+			static QString MakeInsertedFieldsList ()
+			{
+				QStringList names;
+				[&]<size_t... Ix> (std::index_sequence<Ix...>)
+				{
+					((HasAutogen_ && IsPKey<ValueAtC_t<Seq, Ix>>::value ?
+							void () :
+							void (names << ToString<std::get<Ix> (FieldNames<Seq>)> ())), ...);
+				} (SeqIndices<Seq>);
+				return names.join (", ");
+			}
+
+			template<typename ImplFactory>
+			static QString MakeMultiRowQuery (auto action, int rowsCount)
+			{
+				constexpr auto prefix = ImplFactory::GetInsertPrefix (action) + " INTO " + Seq::ClassName + " (";
+				constexpr auto suffix = MakeInsertSuffix<ImplFactory> (action);
+
+				static const auto fields = MakeInsertedFieldsList ();
+				static const auto row = []
+				{
+					QStringList placeholders;
+					for (int i = 0; i < InsertedFieldsCount_; ++i)
+						placeholders << QStringLiteral ("?");
+					return "(" + placeholders.join (", ") + ")";
+				} ();
+
+				QStringList rows;
+				rows.reserve (rowsCount);
+				for (int i = 0; i < rowsCount; ++i)
+					rows << row;
+
+				return ToString<prefix> () + fields + ") VALUES " + rows.join (", ") + " " + ToString<suffix> ();
+			}
+
+			template<size_t... Ix>
+			static QByteArray SerializeConflictKey (const Seq& seq, std::index_sequence<Ix...>)
+			{
+				QByteArray result;
+				QDataStream ostr { &result, QIODevice::WriteOnly };
+				((ostr << ToVariantF (Get<Ix> (seq))), ...);
+				return result;
+			}
+
+			static std::optional<QByteArray> GetConflictKey (const Seq&, InsertAction::DefaultTag)
+			{
+				return {};
+			}
+
+			static std::optional<QByteArray> GetConflictKey (const Seq&, InsertAction::IgnoreTag)
+			{
+				return {};
+			}
+
+			static std::optional<QByteArray> GetConflictKey (const Seq& seq, InsertAction::Replace::PKeyType)
+			{
+				return SerializeConflictKey (seq, std::index_sequence<PKeyIndex_v<Seq>> {});
+			}
+
+			template<auto... Ptrs>
+			static std::optional<QByteArray> GetConflictKey (const Seq& seq, InsertAction::Replace::FieldsType<Ptrs...>)
+			{
+				return SerializeConflictKey (seq, std::index_sequence<FieldIndex<Ptrs> ()...> {});
+			}
+
+			static void BindRow (const Seq& seq, QSqlQuery& query, int& position)
+			{
+				[&]<size_t... Ix> (std::index_sequence<Ix...>)
+				{
+					((HasAutogen_ && IsPKey<ValueAtC_t<Seq, Ix>>::value ?
+							void () :
+							query.bindValue (position++, ToVariantF (Get<Ix> (seq)))), ...);
+				} (SeqIndices<Seq>);
+			}
+
+			template<typename ImplFactory, typename R>
+			void RunMany (const R& records, auto action) const
+			{
+				if (std::ranges::empty (records))
+					return;
+
+				constexpr auto maxRows = std::max (1, ImplFactory::MaxBoundParams / std::max (1, InsertedFieldsCount_));
+
+				auto db = DB_;
+				DBLock lock { db };
+				lock.Init ();
+
+				std::optional<QSqlQuery> fullChunkQuery;
+
+				QVector<const Seq*> chunk;
+				chunk.reserve (maxRows);
+				QSet<QByteArray> chunkKeys;
+
+				auto flush = [&]
+				{
+					if (chunk.isEmpty ())
+						return;
+
+					std::optional<QSqlQuery> partialChunkQuery;
+					auto& query = [&] () -> QSqlQuery&
+					{
+						auto& target = chunk.size () == maxRows ? fullChunkQuery : partialChunkQuery;
+						if (!target)
+						{
+							target.emplace (db);
+							target->prepare (MakeMultiRowQuery<ImplFactory> (action, chunk.size ()));
+						}
+						return *target;
+					} ();
+
+					int position = 0;
+					for (const auto record : chunk)
+						BindRow (*record, query, position);
+
+					if (!query.exec ())
+					{
+						qCritical () << "multi-row insert query execution failed";
+						DBLock::DumpError (query);
+						throw QueryException ("multi-row insert query execution failed", query);
+					}
+
+					chunk.clear ();
+					chunkKeys.clear ();
+				};
+
+				for (const auto& record : records)
+				{
+					// A row cannot be upserted twice by a single statement, so
+					// a repeated conflict key starts a new chunk.
+					if (const auto key = GetConflictKey (record, action))
+					{
+						if (chunkKeys.contains (*key))
+							flush ();
+						chunkKeys << *key;
+					}
+
+					chunk << &record;
+					if (chunk.size () == maxRows)
+						flush ();
+				}
+				flush ();
+
+				lock.Good ();
+			}
 		};
 
 		template<typename Seq>
@@ -1013,7 +1190,7 @@ namespace LC::Util::oral
 				} (std::make_index_sequence<sizeof... (Ptrs)> {});
 		}
 
-		enum class SelectBehaviour { Some, One };
+		enum class SelectBehaviour { Some, One, Cursor };
 
 		struct OrderNone {};
 		struct GroupNone {};
@@ -1114,9 +1291,14 @@ namespace LC::Util::oral
 		template<typename F, typename R>
 		HandleSelectorResult (QString, F, R) -> HandleSelectorResult<F, R>;
 
+		template<CtString>
+		inline constexpr char QueryKey = 0;
+
 		class SelectWrapperCommon
 		{
 			const QSqlDatabase DB_;
+
+			mutable std::unordered_map<const void*, QSqlQuery> CachedQueries_;
 		public:
 			SelectWrapperCommon (const QSqlDatabase& db) noexcept
 			: DB_ { db }
@@ -1127,17 +1309,120 @@ namespace LC::Util::oral
 					auto&& binder) const
 			{
 				QSqlQuery query { DB_ };
+				query.setForwardOnly (true);
 				query.prepare (queryStr);
 				binder (query);
+				Exec (query);
+				return query;
+			}
+
+			/** Returns the query prepared once per each distinct query text.
+			 *
+			 * The caller is expected to finish () the query after fetching
+			 * the results so that the statement doesn't keep holding locks.
+			 */
+			template<CtString Query>
+			QSqlQuery& RunCachedQuery (auto&& binder) const
+			{
+				auto pos = CachedQueries_.find (&QueryKey<Query>);
+				if (pos == CachedQueries_.end ())
+				{
+					QSqlQuery query { DB_ };
+					query.setForwardOnly (true);
+					query.prepare (ToString<Query> ());
+					pos = CachedQueries_.emplace (&QueryKey<Query>, query).first;
+				}
 
+				auto& query = pos->second;
+				binder (query);
+				Exec (query);
+				return query;
+			}
+		private:
+			static void Exec (QSqlQuery& query)
+			{
 				if (!query.exec ())
 				{
 					qCritical () << "select query execution failed";
 					DBLock::DumpError (query);
 					throw QueryException ("fetch query execution failed", std::make_shared<QSqlQuery> (query));
 				}
+			}
+		};
 
-				return query;
+		/** @brief Lazily fetches the results of a select query one by one.
+		 *
+		 * The records can be either pulled via Next() or iterated over
+		 * with a range-based for loop, but only once.
+		 */
+		template<typename HS>
+		class SelectCursor
+		{
+			QSqlQuery Query_;
+		public:
+			using Value_t = decltype (HS::Initializer (std::declval<const QSqlQuery&> (), 0));
+
+			explicit SelectCursor (const QSqlQuery& query) noexcept
+			: Query_ { query }
+			{
+			}
+
+			std::optional<Value_t> Next ()
+			{
+				if (!Query_.next ())
+				{
+					Query_.finish ();
+					return {};
+				}
+
+				return HS::Initializer (Query_, 0);
+			}
+
+			class Iterator
+			{
+				SelectCursor *Cursor_;
+				std::optional<Value_t> Current_;
+			public:
+				using iterator_category = std::input_iterator_tag;
+				using value_type = Value_t;
+				using difference_type = std::ptrdiff_t;
+
+				explicit Iterator (SelectCursor& cursor)
+				: Cursor_ { &cursor }
+				, Current_ { cursor.Next () }
+				{
+				}
+
+				const Value_t& operator* () const noexcept
+				{
+					return *Current_;
+				}
+
+				Iterator& operator++ ()
+				{
+					Current_ = Cursor_->Next ();
+					return *this;
+				}
+
+				void operator++ (int)
+				{
+					++*this;
+				}
+
+				bool operator== (std::default_sentinel_t) const noexcept
+				{
+					return !Current_;
+				}
+			};
+
+			Iterator begin ()
+			{
+				return Iterator { *this };
+			}
+
+			std::default_sentinel_t end () const noexcept
+			{
+				return {};
 			}
 		};
 
@@ -1408,30 +1693,40 @@ namespace LC::Util::oral
 						HandleOrder (std::forward<Order> (order)) +
 						HandleGroup (std::forward<Group> (group)) +
 						LimitOffsetToString<Limit, Offset> ();
-				auto selectResult = Select<HS> (ToString<query> (),
-						binder);
-				return HandleResultBehaviour<HS::ResultBehaviour_v> (std::move (selectResult));
+				if constexpr (SelectBehaviour == SelectBehaviour::Cursor)
+				{
+					static_assert (HS::ResultBehaviour_v == ResultBehaviour::All,
+							"aggregate queries cannot be fetched lazily");
+					return SelectCursor<HS> { RunQuery (ToString<query> (), binder) };
+				}
+				else
+				{
+					auto selectResult = Select<HS, query> (binder);
+					return HandleResultBehaviour<HS::ResultBehaviour_v> (std::move (selectResult));
+				}
 			}
 		private:
-			template<typename HS, typename Binder>
-			auto Select (const QString& queryStr,
-					Binder&& binder) const
+			template<typename HS, CtString QueryStr, typename Binder>
+			auto Select (Binder&& binder) const
 			{
-				auto query = RunQuery (queryStr, binder);
+				auto& query = RunCachedQuery<QueryStr> (binder);
 
 				if constexpr (SelectBehaviour == SelectBehaviour::Some)
 				{
 					QList<decltype (HS::Initializer (query, 0))> result;
 					while (query.next ())
 						result << HS::Initializer (query, 0);
+					query.finish ();
 					return result;
 				}
 				else
 				{
 					using RetType_t = std::optional<decltype (HS::Initializer (query, 0))>;
-					return query.next () ?
+					auto result = query.next () ?
 						RetType_t { HS::Initializer (query, 0) } :
 						RetType_t {};
+					query.finish ();
+					return result;
 				}
 			}
 
@@ -1629,6 +1924,7 @@ namespace LC::Util::oral
 
 		detail::SelectWrapper<T, detail::SelectBehaviour::Some> Select;
 		detail::SelectWrapper<T, detail::SelectBehaviour::One> SelectOne;
+		detail::SelectWrapper<T, detail::SelectBehaviour::Cursor> SelectCursor;
 		detail::DeleteByFieldsWrapper<T> DeleteBy;
 
 		using ObjectType_t = T;
@@ -1652,6 +1948,7 @@ namespace LC::Util::oral
 			{ db },
 			{ db },
 			{ db },
+			{ db },
 		};
 	}
 
@@ -24,6 +24,9 @@ namespace LC::Util::oral::detail::PostgreSQL
 
 		inline constexpr static CtString LimitNone { "ALL" };
 
+		// The wire protocol encodes the parameters count as a 16-bit integer.
+		inline constexpr static int MaxBoundParams = 65535;
+
 		constexpr static auto GetInsertPrefix (auto)
 		{
 			return "INSERT"_ct;
@@ -24,6 +24,9 @@ namespace LC::Util::oral::detail::SQLite
 
 		inline constexpr static CtString LimitNone { "-1" };
 
+		// The default SQLITE_MAX_VARIABLE_NUMBER prior to SQLite 3.32.
+		inline constexpr static int MaxBoundParams = 999;
+
 		constexpr static auto GetInsertPrefix (InsertAction::DefaultTag)
 		{
 			return "INSERT"_ct;
@@ -49,6 +49,53 @@ namespace Util
 		QCOMPARE (list, (QList<SimpleRecord> { { 0, "0" } }));
 	}
 
+	void OralTest_SimpleRecord::testSimpleRecordInsertRangeSelect ()
+	{
+		auto db = MakeDatabase ();
+
+		auto adapted = Util::oral::AdaptPtr<SimpleRecord, OralFactory> (db);
+		adapted->Insert (OralFactory {}, QList<SimpleRecord> { { 0, "0" }, { 1, "1" }, { 2, "2" } }, lco::InsertAction::Default);
+
+		const auto& list = adapted->Select ();
+		QCOMPARE (list, (QList<SimpleRecord> { { 0, "0" }, { 1, "1" }, { 2, "2" } }));
+	}
+
+	void OralTest_SimpleRecord::testSimpleRecordInsertRangeReplaceSelect ()
+	{
+		auto adapted = PrepareRecords<SimpleRecord> (MakeDatabase ());
+		const QList<SimpleRecord> records { { 1, "a" }, { 3, "b" }, { 1, "c" }, { 4, "d" }, { 3, "e" } };
+		adapted->Insert (OralFactory {}, records, lco::InsertAction::Replace::PKey);
+
+		const auto& list = adapted->Select ();
+		QCOMPARE (list, (QList<SimpleRecord> { { 0, "0" }, { 1, "c" }, { 2, "2" }, { 3, "e" }, { 4, "d" } }));
+	}
+
+	void OralTest_SimpleRecord::testSimpleRecordInsertRangeIgnoreSelect ()
+	{
+		auto adapted = PrepareRecords<SimpleRecord> (MakeDatabase ());
+		const QList<SimpleRecord> records { { 1, "a" }, { 3, "b" }, { 1, "c" }, { 4, "d" }, { 3, "e" } };
+		adapted->Insert (OralFactory {}, records, lco::InsertAction::Ignore);
+
+		const auto& list = adapted->Select ();
+		QCOMPARE (list, (QList<SimpleRecord> { { 0, "0" }, { 1, "1" }, { 2, "2" }, { 3, "b" }, { 4, "d" } }));
+	}
+
+	void OralTest_SimpleRecord::testSimpleRecordInsertRangeManyChunks ()
+	{
+		auto db = MakeDatabase ();
+
+		const int count = 5000;
+		QVector<SimpleRecord> records;
+		for (int i = 0; i < count; ++i)
+			records.push_back ({ i, QString::number (i) });
+
+		auto adapted = Util::oral::AdaptPtr<SimpleRecord, OralFactory> (db);
+		adapted->Insert (OralFactory {}, records, lco::InsertAction::Default);
+
+		QCOMPARE (adapted->Select (sph::count<>), count);
+		QCOMPARE (adapted->SelectOne (sph::f<&SimpleRecord::ID_> == count - 1), (std::optional<SimpleRecord> { { count - 1, QString::number (count - 1) } }));
+	}
+
 	void OralTest_SimpleRecord::testSimpleRecordInsertSelectByPos ()
 	{
 		auto adapted = PrepareRecords<SimpleRecord> (MakeDatabase ());
@@ -250,6 +297,58 @@ namespace Util
 		QCOMPARE (list, (QList<SimpleRecord> { { 0, "foo" }, { 2, "foobar" } }));
 	}
 
+	void OralTest_SimpleRecord::testSimpleRecordInsertSelectRepeated ()
+	{
+		auto adapted = PrepareRecords<SimpleRecord> (MakeDatabase ());
+		for (int i = 0; i < 3; ++i)
+		{
+			const auto& list = adapted->Select (sph::f<&SimpleRecord::ID_> >= i);
+			QCOMPARE (list.size (), 3 - i);
+			QCOMPARE (list.value (0), (SimpleRecord { i, QString::number (i) }));
+		}
+	}
+
+	void OralTest_SimpleRecord::testSimpleRecordInsertSelectOneRepeated ()
+	{
+		auto adapted = PrepareRecords<SimpleRecord> (MakeDatabase ());
+		for (int i = 0; i < 4; ++i)
+		{
+			const auto& single = adapted->SelectOne (sph::fields<&SimpleRecord::Value_>, sph::f<&SimpleRecord::ID_> == i);
+			QCOMPARE (single, i < 3 ? std::optional { QString::number (i) } : std::optional<QString> {});
+		}
+	}
+
+	void OralTest_SimpleRecord::testSimpleRecordInsertSelectCursor ()
+	{
+		auto adapted = PrepareRecords<SimpleRecord> (MakeDatabase ());
+
+		QList<SimpleRecord> list;
+		for (const auto& record : adapted->SelectCursor ())
+			list << record;
+		QCOMPARE (list, (QList<SimpleRecord> { { 0, "0" }, { 1, "1" }, { 2, "2" } }));
+	}
+
+	void OralTest_SimpleRecord::testSimpleRecordInsertSelectCursorByFields ()
+	{
+		auto adapted = PrepareRecords<SimpleRecord> (MakeDatabase ());
+
+		QList<QString> list;
+		for (const auto& value : adapted->SelectCursor (sph::fields<&SimpleRecord::Value_>, sph::f<&SimpleRecord::ID_> > 0))
+			list << value;
+		QCOMPARE (list, (QList<QString> { "1", "2" }));
+	}
+
+	void OralTest_SimpleRecord::testSimpleRecordInsertSelectCursorNext ()
+	{
+		auto adapted = PrepareRecords<SimpleRecord> (MakeDatabase ());
+
+		auto cursor = adapted->SelectCursor (sph::f<&SimpleRecord::ID_> < 2);
+		QCOMPARE (cursor.Next (), (std::optional<SimpleRecord> { { 0, "0" } }));
+		QCOMPARE (cursor.Next (), (std::optional<SimpleRecord> { { 1, "1" } }));
+		QCOMPARE (cursor.Next (), std::optional<SimpleRecord> {});
+		QCOMPARE (cursor.Next (), std::optional<SimpleRecord> {});
+	}
+
 	void OralTest_SimpleRecord::testSimpleRecordUpdate ()
 	{
 		auto adapted = PrepareRecords<SimpleRecord> (MakeDatabase ());
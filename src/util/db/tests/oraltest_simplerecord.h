@@ -22,6 +22,11 @@ namespace Util
 		void testSimpleRecordInsertReplaceSelect ();
 		void testSimpleRecordInsertIgnoreSelect ();
 
+		void testSimpleRecordInsertRangeSelect ();
+		void testSimpleRecordInsertRangeReplaceSelect ();
+		void testSimpleRecordInsertRangeIgnoreSelect ();
+		void testSimpleRecordInsertRangeManyChunks ();
+
 		void testSimpleRecordInsertSelectByPos ();
 		void testSimpleRecordInsertSelectByPos2 ();
 		void testSimpleRecordInsertSelectByPos3 ();
@@ -58,6 +63,13 @@ namespace Util
 
 		void testSimpleRecordInsertSelectLike ();
 
+		void testSimpleRecordInsertSelectRepeated ();
+		void testSimpleRecordInsertSelectOneRepeated ();
+
+		void testSimpleRecordInsertSelectCursor ();
+		void testSimpleRecordInsertSelectCursorByFields ();
+		void testSimpleRecordInsertSelectCursorNext ();
+
 		void testSimpleRecordUpdate ();
 		void testSimpleRecordUpdateExprTree ();
 		void testSimpleRecordUpdateMultiExprTree ();
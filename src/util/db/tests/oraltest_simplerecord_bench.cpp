@@ -50,6 +50,119 @@ namespace Util
 		QBENCHMARK { adapted.Insert ({ 0, "0" }, lco::InsertAction::Ignore); }
 	}
 
+	namespace
+	{
+		QVector<SimpleRecord> MakeBenchRecords ()
+		{
+			const int count = 100000;
+
+			QVector<SimpleRecord> records;
+			records.reserve (count);
+			for (int i = 0; i < count; ++i)
+				records.push_back ({ i, QString::number (i) });
+			return records;
+		}
+	}
+
+	void OralTest_SimpleRecord_Bench::benchSimpleRecordInsert100kLoop ()
+	{
+		auto db = MakeDatabase ();
+		const auto& adapted = Util::oral::Adapt<SimpleRecord, OralFactory> (db);
+		const auto& records = MakeBenchRecords ();
+
+		QBENCHMARK
+		{
+			for (const auto& record : records)
+				adapted.Insert (OralFactory {}, record, lco::InsertAction::Replace::PKey);
+		}
+	}
+
+	void OralTest_SimpleRecord_Bench::benchSimpleRecordInsert100kLoopTransaction ()
+	{
+		auto db = MakeDatabase ();
+		const auto& adapted = Util::oral::Adapt<SimpleRecord, OralFactory> (db);
+		const auto& records = MakeBenchRecords ();
+
+		QBENCHMARK
+		{
+			DBLock lock { db };
+			lock.Init ();
+			for (const auto& record : records)
+				adapted.Insert (OralFactory {}, record, lco::InsertAction::Replace::PKey);
+			lock.Good ();
+		}
+	}
+
+	void OralTest_SimpleRecord_Bench::benchSimpleRecordInsert100kRange ()
+	{
+		auto db = MakeDatabase ();
+		const auto& adapted = Util::oral::Adapt<SimpleRecord, OralFactory> (db);
+		const auto& records = MakeBenchRecords ();
+
+		QBENCHMARK { adapted.Insert (OralFactory {}, records, lco::InsertAction::Replace::PKey); }
+	}
+
+	void OralTest_SimpleRecord_Bench::benchBaselineSelectOne ()
+	{
+		auto db = MakeDatabase ();
+		const auto& adapted = Util::oral::Adapt<SimpleRecord, OralFactory> (db);
+		adapted.Insert (OralFactory {}, MakeBenchRecords (), lco::InsertAction::Default);
+
+		int id = 0;
+		QBENCHMARK
+		{
+			QSqlQuery query { db };
+			query.prepare ("SELECT SimpleRecord.ID, SimpleRecord.Value FROM SimpleRecord WHERE SimpleRecord.ID = :id");
+			query.bindValue (":id", id++ % 100000);
+			query.exec ();
+			query.next ();
+		}
+	}
+
+	void OralTest_SimpleRecord_Bench::benchSimpleRecordSelectOne ()
+	{
+		auto db = MakeDatabase ();
+		const auto& adapted = Util::oral::Adapt<SimpleRecord, OralFactory> (db);
+		adapted.Insert (OralFactory {}, MakeBenchRecords (), lco::InsertAction::Default);
+
+		int id = 0;
+		QBENCHMARK
+		{
+			const auto key = id++ % 100000;
+			adapted.SelectOne (sph::f<&SimpleRecord::ID_> == key);
+		}
+	}
+
+	void OralTest_SimpleRecord_Bench::benchSimpleRecordSelect100k ()
+	{
+		auto db = MakeDatabase ();
+		const auto& adapted = Util::oral::Adapt<SimpleRecord, OralFactory> (db);
+		adapted.Insert (OralFactory {}, MakeBenchRecords (), lco::InsertAction::Default);
+
+		QBENCHMARK
+		{
+			qint64 sum = 0;
+			for (const auto& record : adapted.Select ())
+				sum += *record.ID_;
+			QVERIFY (sum > 0);
+		}
+	}
+
+	void OralTest_SimpleRecord_Bench::benchSimpleRecordSelectCursor100k ()
+	{
+		auto db = MakeDatabase ();
+		const auto& adapted = Util::oral::Adapt<SimpleRecord, OralFactory> (db);
+		adapted.Insert (OralFactory {}, MakeBenchRecords (), lco::InsertAction::Default);
+
+		QBENCHMARK
+		{
+			qint64 sum = 0;
+			for (const auto& record : adapted.SelectCursor ())
+				sum += *record.ID_;
+			QVERIFY (sum > 0);
+		}
+	}
+
 	void OralTest_SimpleRecord_Bench::benchBaselineUpdate ()
 	{
 		auto db = MakeDatabase ();
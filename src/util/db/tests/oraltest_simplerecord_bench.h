@@ -23,6 +23,16 @@ namespace Util
 		void benchBaselineInsert ();
 		void benchSimpleRecordInsert ();
 
+		void benchSimpleRecordInsert100kLoop ();
+		void benchSimpleRecordInsert100kLoopTransaction ();
+		void benchSimpleRecordInsert100kRange ();
+
+		void benchBaselineSelectOne ();
+		void benchSimpleRecordSelectOne ();
+
+		void benchSimpleRecordSelect100k ();
+		void benchSimpleRecordSelectCursor100k ();
+
 		void benchBaselineUpdate ();
 		void benchSimpleRecordUpdate ();
 	};
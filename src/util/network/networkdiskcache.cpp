@@ -7,12 +7,15 @@
  **********************************************************************/
 
 #include "networkdiskcache.h"
+#include <cstring>
 #include <QtDebug>
+#include <QCryptographicHash>
 #include <QDir>
+#include <QFileInfo>
 #include <QMutexLocker>
 #include <util/sys/paths.h>
-#include <util/threads/futures.h>
 #include "networkdiskcachegc.h"
+#include "networkdiskcacheindex.h"
 
 namespace LC::Util
 {
@@ -22,25 +25,49 @@ namespace LC::Util
 		{
 			return GetUserDir (UserDir::Cache, "network/" + subpath).absolutePath ();
 		}
+
+		/* Mirrors QNetworkDiskCachePrivate::cacheFileName(), returning the
+		 * path relative to the cache directory. If Qt ever changes the
+		 * layout, the files just won't be found after insert(), and the
+		 * index will be rebuilt by walking the directory.
+		 */
+		QString GetCacheFilePath (const QUrl& url)
+		{
+			auto cleanUrl = url;
+			cleanUrl.setPassword ({});
+			cleanUrl.setFragment ({});
+
+			const auto& hash = QCryptographicHash::hash (cleanUrl.toEncoded (), QCryptographicHash::Sha1);
+			qlonglong hashPrefix = 0;
+			std::memcpy (&hashPrefix, hash.constData (), sizeof (hashPrefix));
+
+			const auto& id = QByteArray::number (hashPrefix, 36).left (8);
+			const auto code = static_cast<uint> (id.at (id.size () - 1)) % 16;
+			return "data8/" + QString::number (code, 16) + '/' + QString::fromLatin1 (id) + ".d";
+		}
 	}
 
 	NetworkDiskCache::NetworkDiskCache (const QString& subpath, QObject *parent)
 	: QNetworkDiskCache (parent)
 	, GcGuard_ (NetworkDiskCacheGC::Instance ().RegisterDirectory (GetCacheDir (subpath),
 			[this] { return maximumCacheSize (); }))
+	, Index_ (NetworkDiskCacheGC::Instance ().GetIndex (GetCacheDir (subpath)))
 	{
 		setCacheDirectory (GetCacheDir (subpath));
 	}
 
 	qint64 NetworkDiskCache::cacheSize () const
 	{
-		return CurrentSize_;
+		return Index_->IsLoaded () ? Index_->GetTotalSize () : -1;
 	}
 
 	QIODevice* NetworkDiskCache::data (const QUrl& url)
 	{
 		QMutexLocker lock (&InsertRemoveMutex_);
-		return QNetworkDiskCache::data (url);
+		const auto dev = QNetworkDiskCache::data (url);
+		if (dev)
+			Index_->RecordAccess (GetCacheFilePath (url));
+		return dev;
 	}
 
 	void NetworkDiskCache::insert (QIODevice *device)
@@ -53,10 +80,23 @@ namespace LC::Util
 			return;
 		}
 
-		PendingUrl2Devs_ [PendingDev2Url_.take (device)].removeAll (device);
+		const auto& url = PendingDev2Url_.take (device);
+		PendingUrl2Devs_ [url].removeAll (device);
 
-		CurrentSize_ += device->size ();
 		QNetworkDiskCache::insert (device);
+
+		const auto& path = GetCacheFilePath (url);
+		const QFileInfo info { QDir { cacheDirectory () }.filePath (path) };
+		if (info.exists ())
+			Index_->RecordInsert (path, info.size ());
+		else
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "cache file not found for"
+					<< url
+					<< path;
+			Index_->Invalidate ();
+		}
 	}
 
 	QNetworkCacheMetaData NetworkDiskCache::metaData (const QUrl& url)
@@ -79,6 +119,7 @@ namespace LC::Util
 		QMutexLocker lock (&InsertRemoveMutex_);
 		for (const auto dev : PendingUrl2Devs_.take (url))
 			PendingDev2Url_.remove (dev);
+		Index_->RecordRemove (GetCacheFilePath (url));
 		return QNetworkDiskCache::remove (url);
 	}
 
@@ -88,17 +129,19 @@ namespace LC::Util
 		QNetworkDiskCache::updateMetaData (metaData);
 	}
 
-	qint64 NetworkDiskCache::expire ()
+	void NetworkDiskCache::clear ()
 	{
-		if (CurrentSize_ < 0)
-		{
-			const auto& dir = cacheDirectory ();
-			Util::Sequence (this, NetworkDiskCacheGC::Instance ().GetCurrentSize (dir)) >>
-					[this] (qint64 res) { CurrentSize_ = res; };
+		// QNetworkDiskCache::clear() relies on expire() to remove the files.
+		QMutexLocker lock (&InsertRemoveMutex_);
+		Index_->Collect (0);
+	}
 
+	qint64 NetworkDiskCache::expire ()
+	{
+		// The actual collection is done by NetworkDiskCacheGC in background.
+		if (!Index_->IsLoaded ())
 			return maximumCacheSize () * 8 / 10;
-		}
 
-		return CurrentSize_;
+		return Index_->GetTotalSize ();
 	}
 }
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <memory>
 #include <QNetworkDiskCache>
 #include <QRecursiveMutex>
 #include <QHash>
@@ -16,6 +17,8 @@
 
 namespace LC::Util
 {
+	class NetworkDiskCacheIndex;
+
 	/** @brief A thread-safe garbage-collected network disk cache.
 	 *
 	 * This class is thread-safe unlike the original QNetworkDiskCache,
@@ -26,6 +29,9 @@ namespace LC::Util
 	 * also triggered manually via the collectGarbage() slot.
 	 *
 	 * The garbage is collected until cache takes 90% of its maximum size.
+	 * The least recently used files are removed first, and the files
+	 * are tracked in an index as they are written, read and removed, so
+	 * the collection doesn't need to walk the whole cache directory.
 	 *
 	 * @ingroup NetworkUtil
 	 */
@@ -33,14 +39,13 @@ namespace LC::Util
 	{
 		Q_OBJECT
 
-		qint64 CurrentSize_ = -1;
-
 		mutable QRecursiveMutex InsertRemoveMutex_;
 
 		QHash<QIODevice*, QUrl> PendingDev2Url_;
 		QHash<QUrl, QList<QIODevice*>> PendingUrl2Devs_;
 
 		const Util::DefaultScopeGuard GcGuard_;
+		const std::shared_ptr<NetworkDiskCacheIndex> Index_;
 	public:
 		/** @brief Constructs the new disk cache.
 		 *
@@ -81,6 +86,10 @@ namespace LC::Util
 		/** @brief Reimplemented from QNetworkDiskCache.
 		 */
 		void updateMetaData (const QNetworkCacheMetaData& metaData) override;
+
+		/** @brief Reimplemented from QNetworkDiskCache.
+		 */
+		void clear () override;
 	protected:
 		/** @brief Reimplemented from QNetworkDiskCache.
 		 */
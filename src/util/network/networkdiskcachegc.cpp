@@ -17,6 +17,7 @@
 #include <util/sll/prelude.h>
 #include <util/sll/util.h>
 #include <util/threads/futures.h>
+#include "networkdiskcacheindex.h"
 
 namespace LC::Util
 {
@@ -38,25 +39,17 @@ namespace LC::Util
 
 	namespace
 	{
-		struct SizeCollectInfo
+		qint64 CollectSize (const QString& cacheDirectory)
 		{
-			QMultiMap<QDateTime, QString> Items_;
-			qint64 TotalSize_ = 0;
-		};
-
-		SizeCollectInfo CollectSizes (const QString& cacheDirectory)
-		{
-			SizeCollectInfo result;
+			qint64 result = 0;
 
 			const QDir::Filters filters = QDir::AllDirs | QDir:: Files | QDir::NoDotAndDotDot;
 			QDirIterator it { cacheDirectory, filters, QDirIterator::Subdirectories };
 
 			while (it.hasNext ())
 			{
-				const auto& path = it.next ();
-				const auto& info = it.fileInfo ();
-				result.Items_.insert (info.birthTime (), path);
-				result.TotalSize_ += info.size ();
+				it.next ();
+				result += it.fileInfo ().size ();
 			}
 
 			return result;
@@ -65,12 +58,23 @@ namespace LC::Util
 
 	QFuture<qint64> NetworkDiskCacheGC::GetCurrentSize (const QString& path) const
 	{
-		return QtConcurrent::run ([path] { return CollectSizes (path).TotalSize_; });
+		if (const auto& index = Indexes_.value (path);
+				index && index->IsLoaded ())
+			return MakeReadyFuture (index->GetTotalSize ());
+
+		return QtConcurrent::run ([path] { return CollectSize (path); });
 	}
 
 	Util::DefaultScopeGuard NetworkDiskCacheGC::RegisterDirectory (const QString& path,
 			const std::function<int ()>& sizeGetter)
 	{
+		if (!Indexes_.contains (path))
+		{
+			const auto index = std::make_shared<NetworkDiskCacheIndex> (path);
+			Indexes_ [path] = index;
+			QtConcurrent::run ([index] { index->Load (); });
+		}
+
 		auto& list = Directories_ [path];
 		list.push_front (sizeGetter);
 		const auto thisItem = list.begin ();
@@ -78,6 +82,11 @@ namespace LC::Util
 		return Util::MakeScopeGuard ([this, path, thisItem] { UnregisterDirectory (path, thisItem); }).EraseType ();
 	}
 
+	std::shared_ptr<NetworkDiskCacheIndex> NetworkDiskCacheGC::GetIndex (const QString& path) const
+	{
+		return Indexes_.value (path);
+	}
+
 	void NetworkDiskCacheGC::UnregisterDirectory (const QString& path, CacheSizeGetters_t::iterator pos)
 	{
 		if (!Directories_.contains (path))
@@ -96,31 +105,23 @@ namespace LC::Util
 
 		Directories_.remove (path);
 		LastSizes_.remove (path);
+		Indexes_.remove (path);
 	}
 
 	namespace
 	{
-		qint64 Collector (const QString& cacheDirectory, qint64 goal)
+		qint64 Collector (const QString& cacheDirectory, NetworkDiskCacheIndex& index, qint64 goal)
 		{
 			if (cacheDirectory.isEmpty ())
 				return 0;
 
 			qDebug () << Q_FUNC_INFO << "running..." << cacheDirectory << goal;
 
-			auto sizeInfoResult = CollectSizes (cacheDirectory);
-
-			for (auto i = sizeInfoResult.Items_.constBegin ();
-					i != sizeInfoResult.Items_.constEnd () && sizeInfoResult.TotalSize_ > goal;
-					++i)
-			{
-				QFile file { *i };
-				sizeInfoResult.TotalSize_ -= file.size ();
-				file.remove ();
-			}
+			const auto size = index.Collect (goal);
 
-			qDebug () << "collector finished" << sizeInfoResult.TotalSize_;
+			qDebug () << "collector finished" << size;
 
-			return sizeInfoResult.TotalSize_;
+			return size;
 		}
 	};
 
@@ -133,13 +134,22 @@ namespace LC::Util
 			return;
 		}
 
-		QList<QPair<QString, int>> dirs;
+		struct DirInfo
+		{
+			QString Path_;
+			std::shared_ptr<NetworkDiskCacheIndex> Index_;
+			int Goal_;
+		};
+
+		QList<DirInfo> dirs;
 		for (const auto& pair : Util::Stlize (Directories_))
 		{
 			const auto& getters = pair.second;
 			const auto minSize = (*std::min_element (getters.begin (), getters.end (),
 						Util::ComparingBy (Apply))) ();
-			dirs.append ({ pair.first, minSize });
+			if (const auto& index = Indexes_.value (pair.first);
+					index && index->IsLoaded ())
+				dirs.append ({ pair.first, index, minSize });
 		}
 
 		if (dirs.isEmpty ())
@@ -151,8 +161,8 @@ namespace LC::Util
 				QtConcurrent::run ([dirs]
 						{
 							QMap<QString, qint64> sizes;
-							for (const auto& pair : dirs)
-								sizes [pair.first] = Collector (pair.first, pair.second);
+							for (const auto& dir : dirs)
+								sizes [dir.Path_] = Collector (dir.Path_, *dir.Index_, dir.Goal_);
 							return sizes;
 						})) >>
 				[this] (const QMap<QString, qint64>& sizes)
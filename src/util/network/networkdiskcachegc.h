@@ -10,6 +10,7 @@
 
 #include <functional>
 #include <list>
+#include <memory>
 #include <QObject>
 #include <QMap>
 #include <util/sll/util.h>
@@ -19,6 +20,8 @@ class QFuture;
 
 namespace LC::Util
 {
+	class NetworkDiskCacheIndex;
+
 	/** @brief Garbage collection for a set of network disk caches.
 	 *
 	 * This GC manager class aids having multiple network disk caches at
@@ -34,6 +37,8 @@ namespace LC::Util
 
 		QMap<QString, qint64> LastSizes_;
 
+		QMap<QString, std::shared_ptr<NetworkDiskCacheIndex>> Indexes_;
+
 		bool IsCollecting_ = false;
 
 		NetworkDiskCacheGC ();
@@ -49,9 +54,11 @@ namespace LC::Util
 
 		/** @brief Schedules calculation of the \em path total size.
 		 *
-		 * The calculation is performed asynchronously in a separate
-		 * thread, and a future object is returned which can be used to
-		 * be notified when the calculation finishes.
+		 * If the \em path is registered and its index is loaded, the
+		 * size is known right away, and a ready future is returned.
+		 * Otherwise the calculation is performed asynchronously in a
+		 * separate thread, and a future object is returned which can be
+		 * used to be notified when the calculation finishes.
 		 *
 		 * @param[in] path The path which total size should be calculated
 		 * @return The future object for the asynchronous path size
@@ -81,6 +88,20 @@ namespace LC::Util
 		 */
 		Util::DefaultScopeGuard RegisterDirectory (const QString& path,
 				const std::function<int ()>& sizeGetter);
+
+		/** @brief Returns the size and access time index of the \em path.
+		 *
+		 * The caches are expected to record the files they write, read
+		 * and remove in the index, so that the collection doesn't need to
+		 * walk the whole directory. The index is loaded (or built) in
+		 * background when the \em path is registered for the first time.
+		 *
+		 * @param[in] path The path previously registered via
+		 * RegisterDirectory().
+		 * @return The index of the \em path, or a null pointer if the
+		 * \em path isn't registered.
+		 */
+		std::shared_ptr<NetworkDiskCacheIndex> GetIndex (const QString& path) const;
 	private:
 		void UnregisterDirectory (const QString&, CacheSizeGetters_t::iterator);
 		void HandleCollect ();
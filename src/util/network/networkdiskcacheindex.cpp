@@ -0,0 +1,317 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "networkdiskcacheindex.h"
+#include <utility>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QSaveFile>
+#include <QStringList>
+#include <QtDebug>
+
+namespace LC::Util
+{
+	namespace
+	{
+		const QString IndexFileName = QStringLiteral ("lc_gc_index");
+
+		constexpr quint32 IndexMagic = 0x4c434349;
+		constexpr quint32 IndexVersion = 1;
+
+		// How many files are taken out of the index at once during the
+		// collection, so that the index isn't locked for too long.
+		constexpr int CollectBatchSize = 256;
+	}
+
+	NetworkDiskCacheIndex::NetworkDiskCacheIndex (const QString& dir)
+	: Dir_ { dir }
+	{
+	}
+
+	NetworkDiskCacheIndex::~NetworkDiskCacheIndex ()
+	{
+		Save ();
+	}
+
+	void NetworkDiskCacheIndex::Load ()
+	{
+		LoadImpl (true);
+	}
+
+	void NetworkDiskCacheIndex::Save ()
+	{
+		QMutexLocker locker { &Mutex_ };
+		if (!IsLoaded_ || !IsDirty_)
+			return;
+
+		QSaveFile file { GetIndexPath () };
+		if (!file.open (QIODevice::WriteOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< file.fileName ()
+					<< file.errorString ();
+			return;
+		}
+
+		QDataStream ostr { &file };
+		ostr << IndexMagic << IndexVersion << static_cast<qint32> (Entries_.size ());
+		for (auto i = Entries_.begin (), end = Entries_.end (); i != end; ++i)
+			ostr << i.key () << i->Size_ << i->LastAccess_;
+
+		if (!file.commit ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to save"
+					<< file.fileName ()
+					<< file.errorString ();
+			return;
+		}
+
+		IsDirty_ = false;
+	}
+
+	bool NetworkDiskCacheIndex::IsLoaded () const
+	{
+		QMutexLocker locker { &Mutex_ };
+		return IsLoaded_;
+	}
+
+	qint64 NetworkDiskCacheIndex::GetTotalSize () const
+	{
+		QMutexLocker locker { &Mutex_ };
+		return TotalSize_;
+	}
+
+	void NetworkDiskCacheIndex::RecordInsert (const QString& path, qint64 size)
+	{
+		Record ({ PendingOp::Type::Insert, path, size, QDateTime::currentMSecsSinceEpoch () });
+	}
+
+	void NetworkDiskCacheIndex::RecordAccess (const QString& path)
+	{
+		Record ({ PendingOp::Type::Access, path, 0, QDateTime::currentMSecsSinceEpoch () });
+	}
+
+	void NetworkDiskCacheIndex::RecordRemove (const QString& path)
+	{
+		Record ({ PendingOp::Type::Remove, path, 0, 0 });
+	}
+
+	void NetworkDiskCacheIndex::Invalidate ()
+	{
+		QMutexLocker locker { &Mutex_ };
+		NeedsRebuild_ = true;
+	}
+
+	qint64 NetworkDiskCacheIndex::Collect (qint64 goal)
+	{
+		{
+			QMutexLocker locker { &Mutex_ };
+			if (!IsLoaded_)
+				return -1;
+		}
+
+		bool needsRebuild = false;
+		{
+			QMutexLocker locker { &Mutex_ };
+			needsRebuild = std::exchange (NeedsRebuild_, false);
+		}
+		if (needsRebuild)
+			LoadImpl (false);
+
+		const QDir dir { Dir_ };
+		while (true)
+		{
+			QStringList victims;
+
+			{
+				QMutexLocker locker { &Mutex_ };
+				while (TotalSize_ > goal && !Lru_.empty () && victims.size () < CollectBatchSize)
+				{
+					const auto path = Lru_.begin ()->second;
+					RemoveEntry (path);
+					victims << path;
+				}
+
+				if (!victims.isEmpty ())
+					IsDirty_ = true;
+			}
+
+			if (victims.isEmpty ())
+				break;
+
+			for (const auto& path : victims)
+				QFile::remove (dir.filePath (path));
+		}
+
+		Save ();
+
+		return GetTotalSize ();
+	}
+
+	void NetworkDiskCacheIndex::LoadImpl (bool readIndexFile)
+	{
+		{
+			QMutexLocker locker { &Mutex_ };
+			IsLoaded_ = false;
+		}
+
+		auto entries = readIndexFile ? ReadIndex () : std::nullopt;
+		if (!entries)
+		{
+			qDebug () << Q_FUNC_INFO
+					<< "rebuilding index for"
+					<< Dir_;
+			entries = ScanDirectory ();
+		}
+
+		// If we crash before the next save, the index will be rebuilt
+		// from scratch instead of missing the changes done since now.
+		QFile::remove (GetIndexPath ());
+
+		QMutexLocker locker { &Mutex_ };
+		Reset (std::move (*entries));
+		IsLoaded_ = true;
+		IsDirty_ = true;
+
+		for (const auto& op : std::exchange (PendingOps_, {}))
+			Apply (op);
+	}
+
+	void NetworkDiskCacheIndex::Record (PendingOp op)
+	{
+		QMutexLocker locker { &Mutex_ };
+		if (!IsLoaded_)
+		{
+			PendingOps_ << std::move (op);
+			return;
+		}
+
+		Apply (op);
+		IsDirty_ = true;
+	}
+
+	void NetworkDiskCacheIndex::Apply (const PendingOp& op)
+	{
+		switch (op.Type_)
+		{
+		case PendingOp::Type::Insert:
+			SetEntry (op.Path_, { op.Size_, op.Time_ });
+			break;
+		case PendingOp::Type::Access:
+			if (const auto pos = Entries_.constFind (op.Path_); pos != Entries_.constEnd ())
+				SetEntry (op.Path_, { pos->Size_, op.Time_ });
+			break;
+		case PendingOp::Type::Remove:
+			RemoveEntry (op.Path_);
+			break;
+		}
+	}
+
+	void NetworkDiskCacheIndex::SetEntry (const QString& path, Entry entry)
+	{
+		RemoveEntry (path);
+
+		Entries_ [path] = entry;
+		Lru_.insert ({ entry.LastAccess_, path });
+		TotalSize_ += entry.Size_;
+	}
+
+	void NetworkDiskCacheIndex::RemoveEntry (const QString& path)
+	{
+		const auto pos = Entries_.find (path);
+		if (pos == Entries_.end ())
+			return;
+
+		Lru_.erase ({ pos->LastAccess_, path });
+		TotalSize_ -= pos->Size_;
+		Entries_.erase (pos);
+	}
+
+	void NetworkDiskCacheIndex::Reset (QHash<QString, Entry>&& entries)
+	{
+		Entries_ = std::move (entries);
+
+		Lru_.clear ();
+		TotalSize_ = 0;
+		for (auto i = Entries_.begin (), end = Entries_.end (); i != end; ++i)
+		{
+			Lru_.insert ({ i->LastAccess_, i.key () });
+			TotalSize_ += i->Size_;
+		}
+	}
+
+	QString NetworkDiskCacheIndex::GetIndexPath () const
+	{
+		return QDir { Dir_ }.filePath (IndexFileName);
+	}
+
+	auto NetworkDiskCacheIndex::ReadIndex () const -> std::optional<QHash<QString, Entry>>
+	{
+		QFile file { GetIndexPath () };
+		if (!file.open (QIODevice::ReadOnly))
+			return {};
+
+		QDataStream istr { &file };
+
+		quint32 magic = 0;
+		quint32 version = 0;
+		qint32 count = 0;
+		istr >> magic >> version >> count;
+		if (magic != IndexMagic || version != IndexVersion || count < 0)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unknown index format in"
+					<< file.fileName ();
+			return {};
+		}
+
+		QHash<QString, Entry> result;
+		result.reserve (count);
+		for (qint32 i = 0; i < count; ++i)
+		{
+			QString path;
+			Entry entry {};
+			istr >> path >> entry.Size_ >> entry.LastAccess_;
+			result [path] = entry;
+		}
+
+		if (istr.status () != QDataStream::Ok)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "corrupted index"
+					<< file.fileName ();
+			return {};
+		}
+
+		return result;
+	}
+
+	auto NetworkDiskCacheIndex::ScanDirectory () const -> QHash<QString, Entry>
+	{
+		QHash<QString, Entry> result;
+
+		const QDir dir { Dir_ };
+		QDirIterator it { Dir_, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories };
+		while (it.hasNext ())
+		{
+			const auto& path = dir.relativeFilePath (it.next ());
+			if (path == IndexFileName)
+				continue;
+
+			const auto& info = it.fileInfo ();
+			result [path] = { info.size (), info.lastModified ().toMSecsSinceEpoch () };
+		}
+
+		return result;
+	}
+}
@@ -0,0 +1,135 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <optional>
+#include <set>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+namespace LC::Util
+{
+	/** @brief Persistent size and access time index of a cache directory.
+	 *
+	 * The index tracks every file in the directory by its path relative
+	 * to the directory, along with the file size and the time it was
+	 * last accessed. This allows evicting the least recently used files
+	 * without walking the whole directory.
+	 *
+	 * The index is saved to a file in the directory itself. If there is
+	 * no such file (or it's unreadable), the index is rebuilt by walking
+	 * the directory once.
+	 *
+	 * All the methods are thread-safe.
+	 */
+	class NetworkDiskCacheIndex
+	{
+		const QString Dir_;
+
+		struct Entry
+		{
+			qint64 Size_;
+			qint64 LastAccess_;
+		};
+
+		struct PendingOp
+		{
+			enum class Type
+			{
+				Insert,
+				Access,
+				Remove
+			} Type_;
+
+			QString Path_;
+			qint64 Size_;
+			qint64 Time_;
+		};
+
+		mutable QMutex Mutex_;
+
+		bool IsLoaded_ = false;
+		bool IsDirty_ = false;
+		bool NeedsRebuild_ = false;
+
+		QHash<QString, Entry> Entries_;
+		std::set<std::pair<qint64, QString>> Lru_;
+		qint64 TotalSize_ = 0;
+
+		QVector<PendingOp> PendingOps_;
+	public:
+		explicit NetworkDiskCacheIndex (const QString& dir);
+
+		/** @brief Saves the index if it has been changed.
+		 */
+		~NetworkDiskCacheIndex ();
+
+		NetworkDiskCacheIndex (const NetworkDiskCacheIndex&) = delete;
+		NetworkDiskCacheIndex& operator= (const NetworkDiskCacheIndex&) = delete;
+
+		/** @brief Loads the index from disk or rebuilds it.
+		 *
+		 * This function may take a while and is intended to be called
+		 * from a background thread. The changes recorded while it runs
+		 * are applied after the index is loaded.
+		 */
+		void Load ();
+
+		/** @brief Saves the index to disk if it has been changed.
+		 */
+		void Save ();
+
+		bool IsLoaded () const;
+
+		/** @brief Returns the total size of the files in the index.
+		 */
+		qint64 GetTotalSize () const;
+
+		/** @brief Records that the file at \em path has been written.
+		 */
+		void RecordInsert (const QString& path, qint64 size);
+
+		/** @brief Records that the file at \em path has been read.
+		 */
+		void RecordAccess (const QString& path);
+
+		/** @brief Records that the file at \em path has been removed.
+		 */
+		void RecordRemove (const QString& path);
+
+		/** @brief Requests the index to be rebuilt on next collection.
+		 *
+		 * This is used when the index is found to be out of sync with the
+		 * directory contents.
+		 */
+		void Invalidate ();
+
+		/** @brief Removes the least recently used files until the total
+		 * size is at most \em goal.
+		 *
+		 * @return The total size after the collection.
+		 */
+		qint64 Collect (qint64 goal);
+	private:
+		void LoadImpl (bool readIndexFile);
+
+		void Record (PendingOp);
+		void Apply (const PendingOp&);
+		void SetEntry (const QString&, Entry);
+		void RemoveEntry (const QString&);
+		void Reset (QHash<QString, Entry>&&);
+
+		QString GetIndexPath () const;
+
+		std::optional<QHash<QString, Entry>> ReadIndex () const;
+		QHash<QString, Entry> ScanDirectory () const;
+	};
+}
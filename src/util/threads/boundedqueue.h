@@ -0,0 +1,146 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <optional>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+
+namespace LC::Util
+{
+	/** @brief A blocking queue of bounded capacity.
+	 *
+	 * This queue is intended for connecting the stages of a pipeline
+	 * running in different threads: a producer blocks in Push() while
+	 * the queue is full, thus slowing down to the pace of the consumers,
+	 * and a consumer blocks in Pop() while the queue is empty.
+	 *
+	 * Once the producers are done, the queue is closed via Close(). The
+	 * consumers still get the remaining items, and Pop() returns an
+	 * empty optional after that. Cancel() additionally drops the
+	 * remaining items.
+	 *
+	 * All the methods are thread-safe.
+	 *
+	 * @tparam T The type of the items in the queue.
+	 */
+	template<typename T>
+	class BoundedQueue
+	{
+		const int Capacity_;
+
+		mutable QMutex Mutex_;
+		QWaitCondition NotFull_;
+		QWaitCondition NotEmpty_;
+
+		std::deque<T> Items_;
+		bool IsClosed_ = false;
+	public:
+		/** @brief Constructs the queue holding at most \em capacity items.
+		 */
+		explicit BoundedQueue (int capacity)
+		: Capacity_ { std::max (capacity, 1) }
+		{
+		}
+
+		BoundedQueue (const BoundedQueue&) = delete;
+		BoundedQueue& operator= (const BoundedQueue&) = delete;
+
+		/** @brief Appends the \em item, waiting while the queue is full.
+		 *
+		 * @return Whether the item has been added, that is, whether the
+		 * queue hasn't been closed.
+		 */
+		bool Push (T item)
+		{
+			QMutexLocker locker { &Mutex_ };
+			while (!IsClosed_ && static_cast<int> (Items_.size ()) >= Capacity_)
+				NotFull_.wait (&Mutex_);
+
+			if (IsClosed_)
+				return false;
+
+			Items_.push_back (std::move (item));
+			NotEmpty_.wakeOne ();
+			return true;
+		}
+
+		/** @brief Takes the oldest item, waiting while the queue is empty.
+		 *
+		 * @return The oldest item, or an empty optional if the queue is
+		 * closed and has no more items.
+		 */
+		std::optional<T> Pop ()
+		{
+			QMutexLocker locker { &Mutex_ };
+			while (!IsClosed_ && Items_.empty ())
+				NotEmpty_.wait (&Mutex_);
+
+			if (Items_.empty ())
+				return {};
+
+			return TakeFront ();
+		}
+
+		/** @brief Takes at most \em max oldest items without waiting.
+		 */
+		QList<T> TryPopMany (int max)
+		{
+			QList<T> result;
+
+			QMutexLocker locker { &Mutex_ };
+			while (!Items_.empty () && result.size () < max)
+				result << TakeFront ();
+			return result;
+		}
+
+		/** @brief Closes the queue for the producers.
+		 *
+		 * The items already in the queue can still be popped.
+		 */
+		void Close ()
+		{
+			QMutexLocker locker { &Mutex_ };
+			IsClosed_ = true;
+			NotFull_.wakeAll ();
+			NotEmpty_.wakeAll ();
+		}
+
+		/** @brief Closes the queue and drops the items in it.
+		 */
+		void Cancel ()
+		{
+			QMutexLocker locker { &Mutex_ };
+			IsClosed_ = true;
+			Items_.clear ();
+			NotFull_.wakeAll ();
+			NotEmpty_.wakeAll ();
+		}
+
+		/** @brief Returns whether the queue is closed and has no items.
+		 */
+		bool IsDrained () const
+		{
+			QMutexLocker locker { &Mutex_ };
+			return IsClosed_ && Items_.empty ();
+		}
+	private:
+		T TakeFront ()
+		{
+			auto item = std::move (Items_.front ());
+			Items_.pop_front ();
+			NotFull_.wakeOne ();
+			return item;
+		}
+	};
+}
@@ -0,0 +1,106 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <optional>
+
+namespace LC::Util
+{
+	/** @brief A lock-free unbounded multiple producers single consumer queue.
+	 *
+	 * Push() may be called concurrently from any number of threads,
+	 * while Pop() must only be called from a single (consumer) thread.
+	 *
+	 * This is the intrusive-list-based queue by Dmitry Vyukov: pushing
+	 * is wait-free and boils down to a single atomic exchange, while
+	 * popping is lock-free. A pushed element might not be visible to the
+	 * consumer until the corresponding Push() call returns.
+	 *
+	 * @tparam T The type of the elements in the queue.
+	 */
+	template<typename T>
+	class MpscQueue
+	{
+		struct Node
+		{
+			std::atomic<Node*> Next_ { nullptr };
+			std::optional<T> Value_;
+		};
+
+		std::atomic<Node*> Head_;
+		Node *Tail_;
+
+		std::atomic<size_t> Size_ { 0 };
+	public:
+		MpscQueue ()
+		: Head_ { new Node }
+		, Tail_ { Head_.load () }
+		{
+		}
+
+		~MpscQueue ()
+		{
+			while (Pop ())
+				;
+			delete Tail_;
+		}
+
+		MpscQueue (const MpscQueue&) = delete;
+		MpscQueue& operator= (const MpscQueue&) = delete;
+
+		/** @brief Appends the \em value to the queue.
+		 *
+		 * This function is thread-safe.
+		 */
+		void Push (T value)
+		{
+			const auto node = new Node;
+			node->Value_.emplace (std::move (value));
+
+			Size_.fetch_add (1, std::memory_order_relaxed);
+
+			const auto prev = Head_.exchange (node, std::memory_order_acq_rel);
+			prev->Next_.store (node, std::memory_order_release);
+		}
+
+		/** @brief Takes the oldest element out of the queue.
+		 *
+		 * This function must only be called from the consumer thread.
+		 *
+		 * @return The oldest element, or an empty optional if the queue
+		 * is empty.
+		 */
+		std::optional<T> Pop ()
+		{
+			const auto next = Tail_->Next_.load (std::memory_order_acquire);
+			if (!next)
+				return {};
+
+			std::optional<T> result { std::move (next->Value_) };
+			next->Value_.reset ();
+
+			delete Tail_;
+			Tail_ = next;
+
+			Size_.fetch_sub (1, std::memory_order_relaxed);
+
+			return result;
+		}
+
+		/** @brief Returns the approximate number of elements in the queue.
+		 *
+		 * This function is thread-safe.
+		 */
+		size_t GetSize () const
+		{
+			return Size_.load (std::memory_order_relaxed);
+		}
+	};
+}
@@ -0,0 +1,92 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+ **********************************************************************/
+
+#include "workerthreadbench.h"
+#include <thread>
+#include <vector>
+#include <QtTest>
+#include <workerthreadbase.h>
+
+QTEST_MAIN (LC::Util::WorkerThreadBench)
+
+namespace LC::Util
+{
+	namespace
+	{
+		struct Counter
+		{
+			int Count_ = 0;
+
+			void Increment ()
+			{
+				++Count_;
+			}
+		};
+
+		using Prio = WorkerThreadBase::Priority;
+
+		constexpr int TasksPerProducer = 100000;
+
+		void RunProducers (WorkerThread<Counter>& worker, int producersCount, bool withHighPriority)
+		{
+			std::vector<std::thread> producers;
+			for (int i = 0; i < producersCount; ++i)
+				producers.emplace_back ([&worker, i, withHighPriority]
+						{
+							const auto prio = withHighPriority && !i ? Prio::High : Prio::Normal;
+							for (int j = 0; j < TasksPerProducer; ++j)
+								worker.ScheduleImpl (prio, &Counter::Increment);
+						});
+			for (auto& producer : producers)
+				producer.join ();
+
+			// the lanes are processed in order, so this one finishes last
+			auto last = worker.ScheduleImpl (Prio::Low, [] (Counter *c) { return c->Count_; });
+			last.waitForFinished ();
+			QVERIFY (last.result () >= producersCount * TasksPerProducer);
+		}
+
+		void Bench (int producersCount, bool withHighPriority)
+		{
+			WorkerThread<Counter> worker;
+			worker.SetAutoQuit (true);
+			worker.SetQuitWait (5000);
+			worker.start ();
+
+			QBENCHMARK { RunProducers (worker, producersCount, withHighPriority); }
+
+			const auto& high = worker.GetQueueStats (Prio::High);
+			const auto& normal = worker.GetQueueStats (Prio::Normal);
+			auto avg = [] (const WorkerThreadBase::QueueStats& stats)
+			{
+				return stats.Processed_ ?
+						std::chrono::duration_cast<std::chrono::microseconds> (stats.TotalLatency_).count () / stats.Processed_ :
+						0;
+			};
+			qDebug () << "high priority: avg latency" << avg (high) << "us, max"
+					<< std::chrono::duration_cast<std::chrono::microseconds> (high.MaxLatency_).count () << "us";
+			qDebug () << "normal priority: avg latency" << avg (normal) << "us, max"
+					<< std::chrono::duration_cast<std::chrono::microseconds> (normal.MaxLatency_).count () << "us";
+		}
+	}
+
+	void WorkerThreadBench::benchSingleProducer ()
+	{
+		Bench (1, false);
+	}
+
+	void WorkerThreadBench::benchMultipleProducers ()
+	{
+		Bench (4, false);
+	}
+
+	void WorkerThreadBench::benchMultipleProducersWithHighPriority ()
+	{
+		Bench (4, true);
+	}
+}
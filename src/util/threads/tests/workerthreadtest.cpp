@@ -74,4 +74,51 @@ namespace LC::Util
 		spin ();
 		QCOMPARE (val, 16);
 	}
+
+	void WorkerThreadTest::testPriorities ()
+	{
+		QEventLoop loop;
+		auto spin = [&loop]
+		{
+			QTimer::singleShot (100, &loop, &QEventLoop::quit);
+			loop.exec ();
+		};
+
+		int val = 0;
+		WorkerThread<Worker> worker { &val, QThread::currentThread () };
+		worker.SetAutoQuit (true);
+		worker.SetQuitWait (1000);
+		worker.start ();
+
+		using Prio = WorkerThreadBase::Priority;
+
+		QList<int> order;
+		auto recorder = [&order] (int n) { return [&order, n] (Worker*) { order << n; }; };
+
+		worker.SetPaused (true);
+		worker.ScheduleImpl (Prio::Low, recorder (1));
+		worker.ScheduleImpl (Prio::Normal, recorder (2));
+		worker.ScheduleImpl (Prio::High, recorder (3));
+		worker.ScheduleImpl (Prio::Low, recorder (4));
+		worker.ScheduleImpl (recorder (5));
+		worker.ScheduleImpl (Prio::High, recorder (6));
+
+		spin ();
+		QCOMPARE (order, QList<int> {});
+		QCOMPARE (worker.GetQueueSize (), size_t { 6 });
+
+		worker.SetPaused (false);
+
+		spin ();
+		QCOMPARE (order, (QList<int> { 3, 6, 2, 5, 1, 4 }));
+		QCOMPARE (worker.GetQueueSize (), size_t { 0 });
+
+		QCOMPARE (worker.GetQueueStats (Prio::High).Processed_, quint64 { 2 });
+		QCOMPARE (worker.GetQueueStats (Prio::Normal).Processed_, quint64 { 2 });
+		QCOMPARE (worker.GetQueueStats (Prio::Low).Processed_, quint64 { 2 });
+
+		const auto& lowStats = worker.GetQueueStats (Prio::Low);
+		QVERIFY (lowStats.MaxLatency_ >= std::chrono::milliseconds { 100 });
+		QVERIFY (lowStats.TotalLatency_ >= lowStats.MaxLatency_);
+	}
 }
@@ -17,5 +17,6 @@ namespace LC::Util
 		Q_OBJECT
 	private slots:
 		void testWorkerThread ();
+		void testPriorities ();
 	};
 }
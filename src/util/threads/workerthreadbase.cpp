@@ -18,13 +18,26 @@ namespace LC::Util
 
 		IsPaused_ = paused;
 		if (!paused)
-			emit rotateFuncs ();
+			Wakeup ();
 	}
 
 	size_t WorkerThreadBase::GetQueueSize ()
 	{
-		QMutexLocker locker { &FunctionsMutex_ };
-		return Functions_.size ();
+		size_t result = 0;
+		for (const auto& lane : Lanes_)
+			result += lane.Queue_.GetSize ();
+		return result;
+	}
+
+	WorkerThreadBase::QueueStats WorkerThreadBase::GetQueueStats (Priority prio) const
+	{
+		const auto& lane = Lanes_ [static_cast<size_t> (prio)];
+		return
+		{
+			.Processed_ = lane.Processed_.load (std::memory_order_relaxed),
+			.TotalLatency_ = std::chrono::nanoseconds { lane.TotalLatency_.load (std::memory_order_relaxed) },
+			.MaxLatency_ = std::chrono::nanoseconds { lane.MaxLatency_.load (std::memory_order_relaxed) },
+		};
 	}
 
 	void WorkerThreadBase::run ()
@@ -46,21 +59,60 @@ namespace LC::Util
 		Cleanup ();
 	}
 
+	void WorkerThreadBase::Enqueue (Priority prio, std::function<void ()> func)
+	{
+		Lanes_ [static_cast<size_t> (prio)].Queue_.Push ({ std::move (func), std::chrono::steady_clock::now () });
+		Wakeup ();
+	}
+
+	void WorkerThreadBase::Wakeup ()
+	{
+		// At most one rotation request is in flight at any time: it is
+		// reset by RotateFuncs() before it looks at the queues, so any
+		// function enqueued after that will trigger a new one.
+		if (!IsWakeupPending_.exchange (true, std::memory_order_acq_rel))
+			emit rotateFuncs ();
+	}
+
 	void WorkerThreadBase::RotateFuncs ()
 	{
+		// The acquire part pairs with the release part of Wakeup(), so
+		// the functions pushed before it are seen by the Pop()s below.
+		IsWakeupPending_.exchange (false, std::memory_order_acq_rel);
+
 		if (IsPaused_)
 			return;
 
-		decltype (Functions_) funcs;
-
+		// Run at most as many functions as there are queued now, like a
+		// single batch, so that the thread's event loop isn't starved
+		// by a continuous flood of new ones.
+		auto budget = GetQueueSize ();
+		while (budget && !IsPaused_)
 		{
-			QMutexLocker locker { &FunctionsMutex_ };
+			Lane *lane = nullptr;
+			std::optional<Task> task;
+			for (auto& candidate : Lanes_)
+				if ((task = candidate.Queue_.Pop ()))
+				{
+					lane = &candidate;
+					break;
+				}
+
+			if (!task)
+				break;
+
+			--budget;
+
+			const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now () - task->Scheduled_).count ();
+			++lane->Processed_;
+			lane->TotalLatency_ += latency;
+			if (latency > lane->MaxLatency_)
+				lane->MaxLatency_ = latency;
 
-			using std::swap;
-			swap (funcs, Functions_);
+			task->Func_ ();
 		}
 
-		for (const auto& func : funcs)
-			func ();
+		if (!budget && !IsPaused_ && GetQueueSize ())
+			Wakeup ();
 	}
 }
@@ -8,15 +8,15 @@
 
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <functional>
 #include <atomic>
 #include <QThread>
-#include <QMutex>
-#include <QMutexLocker>
 #include <QFutureInterface>
 #include <QFuture>
-#include <QList>
 #include "futures.h"
+#include "mpscqueue.h"
 #include "threadsconfig.h"
 
 namespace LC::Util
@@ -24,18 +24,64 @@ namespace LC::Util
 	class UTIL_THREADS_API WorkerThreadBase : public QThread
 	{
 		Q_OBJECT
+	public:
+		/** @brief The priority lane of a scheduled function.
+		 *
+		 * Pending functions from a higher priority lane are always run
+		 * before the functions from the lower priority lanes. Functions
+		 * within the same lane are run in the order they were scheduled.
+		 */
+		enum class Priority
+		{
+			High,
+			Normal,
+			Low
+		};
+
+		/** @brief Statistics on the time the functions spend in a queue.
+		 */
+		struct QueueStats
+		{
+			/** @brief The number of functions run so far.
+			 */
+			quint64 Processed_ = 0;
 
+			/** @brief The sum of the times the functions were waiting to be run.
+			 */
+			std::chrono::nanoseconds TotalLatency_ {};
+
+			/** @brief The longest time a function was waiting to be run.
+			 */
+			std::chrono::nanoseconds MaxLatency_ {};
+		};
+	private:
 		std::atomic_bool IsPaused_ { false };
+		std::atomic_bool IsWakeupPending_ { false };
+
+		struct Task
+		{
+			std::function<void ()> Func_;
+			std::chrono::steady_clock::time_point Scheduled_;
+		};
 
-		QMutex FunctionsMutex_;
-		QList<std::function<void ()>> Functions_;
+		struct Lane
+		{
+			MpscQueue<Task> Queue_;
+
+			std::atomic<quint64> Processed_ { 0 };
+			std::atomic<qint64> TotalLatency_ { 0 };
+			std::atomic<qint64> MaxLatency_ { 0 };
+		};
+
+		static constexpr size_t LanesCount = 3;
+		std::array<Lane, LanesCount> Lanes_;
 	public:
 		using QThread::QThread;
 
 		void SetPaused (bool);
 
 		template<typename F>
-		QFuture<std::result_of_t<F ()>> ScheduleImpl (F func)
+		QFuture<std::result_of_t<F ()>> ScheduleImpl (Priority prio, F func)
 		{
 			QFutureInterface<std::result_of_t<F ()>> iface;
 			iface.reportStarted ();
@@ -45,29 +91,44 @@ namespace LC::Util
 				ReportFutureResult (iface, func);
 			};
 
-			{
-				QMutexLocker locker { &FunctionsMutex_ };
-				Functions_ << reporting;
-			}
-
-			emit rotateFuncs ();
+			Enqueue (prio, std::move (reporting));
 
 			return iface.future ();
 		}
 
+		template<typename F, typename... Args>
+		QFuture<std::result_of_t<F (Args...)>> ScheduleImpl (Priority prio, F f, Args&&... args)
+		{
+			return ScheduleImpl (prio, [f, args...] () mutable { return std::invoke (f, args...); });
+		}
+
+		template<typename F>
+		QFuture<std::result_of_t<F ()>> ScheduleImpl (F func)
+		{
+			return ScheduleImpl (Priority::Normal, std::move (func));
+		}
+
 		template<typename F, typename... Args>
 		QFuture<std::result_of_t<F (Args...)>> ScheduleImpl (F f, Args&&... args)
 		{
-			return ScheduleImpl ([f, args...] () mutable { return std::invoke (f, args...); });
+			return ScheduleImpl (Priority::Normal, f, std::forward<Args> (args)...);
 		}
 
 		virtual size_t GetQueueSize ();
+
+		/** @brief Returns the queueing latency statistics of the given lane.
+		 *
+		 * This function is thread-safe.
+		 */
+		QueueStats GetQueueStats (Priority) const;
 	protected:
 		void run () final;
 
 		virtual void Initialize () = 0;
 		virtual void Cleanup () = 0;
 	private:
+		void Enqueue (Priority, std::function<void ()>);
+		void Wakeup ();
 		void RotateFuncs ();
 	signals:
 		void rotateFuncs ();
@@ -172,10 +233,16 @@ namespace LC::Util
 		using WorkerThreadBase::ScheduleImpl;
 
 		template<typename F, typename... Args>
-		QFuture<std::result_of_t<F (WorkerType*, Args...)>> ScheduleImpl (F f, Args&&... args)
+		QFuture<std::result_of_t<F (WorkerType*, Args...)>> ScheduleImpl (Priority prio, F f, Args&&... args)
 		{
 			const auto fWrapped = [f, this] (auto... args) mutable { return std::invoke (f, Worker_.get (), args...); };
-			return WorkerThreadBase::ScheduleImpl (fWrapped, std::forward<Args> (args)...);
+			return WorkerThreadBase::ScheduleImpl (prio, fWrapped, std::forward<Args> (args)...);
+		}
+
+		template<typename F, typename... Args>
+		QFuture<std::result_of_t<F (WorkerType*, Args...)>> ScheduleImpl (F f, Args&&... args)
+		{
+			return ScheduleImpl (Priority::Normal, f, std::forward<Args> (args)...);
 		}
 	protected:
 		void Initialize () override